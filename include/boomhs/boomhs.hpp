@@ -6,8 +6,11 @@
 
 namespace opengl
 {
+class  DrawHandleManager;
 struct DrawState;
 struct RenderState;
+class  ShaderPrograms;
+class  TextureTable;
 } // namespace opengl
 
 namespace boomhs
@@ -18,6 +21,28 @@ struct Engine;
 class  RNG;
 struct WorldOrientation;
 
+std::string
+floornumber_to_levelfilename(int);
+
+// Create the zone of a floor out of it's level assets, generating the rest of the floor.
+Result<ZoneState, std::string>
+create_zone(EngineState&, EntityRegistry&, LevelAssets&&, int, WorldOrientation const&, RNG&);
+
+// Copy the entity's renderable to the GPU. Cubes and billboards are uploaded now, meshes are
+// streamed once they are needed (see opengl::GpuResidency). The entity's textures must be resolved.
+//
+// Returns whether anything was uploaded.
+bool
+copy_entity_gpu(common::Logger&, opengl::ShaderPrograms&, opengl::TextureTable const&,
+                EntityRegistry&, opengl::DrawHandleManager&, EntityID);
+
+// Copy the next part of the zone's entities and terrain to the GPU, at most "max_uploads" entities
+// or terrain pieces. Returns whether the whole zone is on the GPU (see ZoneUpload).
+//
+// Draw handles refer to the zone, so it must not move after.
+Result<bool, std::string>
+upload_zone_gpu(EngineState&, ZoneState&, ZoneUpload&, size_t);
+
 Result<GameState, std::string>
 create_gamestate(Engine&, EngineState&, WorldOrientation const&, Camera&, RNG&);
 
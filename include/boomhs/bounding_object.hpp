@@ -1,23 +1,30 @@
 #pragma once
+#include <boomhs/entity.hpp>
 #include <boomhs/math.hpp>
 
-#include <opengl/draw_info.hpp>
+#include <common/log.hpp>
 
 namespace boomhs
 {
+class ObjStore;
 
 // AxisAlignedBoundingBox
 struct AABoundingBox
 {
   Cube cube;
 
-  opengl::DrawInfo draw_info;
-
   // ctor
-  AABoundingBox(glm::vec3 const&, glm::vec3 const&, opengl::DrawInfo&&);
+  AABoundingBox(glm::vec3 const&, glm::vec3 const&);
+
+  static AABoundingBox& add_to_entity(EntityID, EntityRegistry&, glm::vec3 const&,
+                                      glm::vec3 const&);
+
+  // Give the entity a bounding box enclosing it's mesh (see MeshRenderable).
+  static AABoundingBox& add_mesh_to_entity(common::Logger&, ObjStore const&, EntityID,
+                                           EntityRegistry&);
 
-  static AABoundingBox& add_to_entity(common::Logger&, opengl::ShaderPrograms&, EntityID,
-                                      EntityRegistry&, glm::vec3 const&, glm::vec3 const&);
+  // Give every mesh or cube entity without a bounding box one.
+  static void add_to_all_entities(common::Logger&, ObjStore const&, EntityRegistry&);
 };
 
 } // namespace boomhs
@@ -55,6 +55,11 @@ namespace boomhs::collision
 bool
 intersects(common::Logger&, Ray const&, Transform const&, Cube const&, float&);
 
+// Same as above, but uses the Transform's already computed world matrix (see WorldMatrix) instead
+// of computing it again.
+bool
+intersects(common::Logger&, Ray const&, Transform const&, ModelMatrix const&, Cube const&, float&);
+
 // Determine whether an axis-aligned Point and the RectFloat intersect.
 // Point: A point within a 2-dimensional coordinate system.
 // Rect: A rectangle in a 2-dimensionsional coordinate system.
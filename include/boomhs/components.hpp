@@ -6,27 +6,36 @@
 
 #include <common/log.hpp>
 
+#include <opengl/texture_handle.hpp>
+
 #include <cassert>
 #include <string>
 
-namespace opengl
-{
-struct TextureInfo;
-} // namespace opengl
-
 namespace boomhs
 {
 
-// Attached to other entities to keep two entities the same relative distance from one another over
-// time.
+// Places the entity in a transform hierarchy, underneath another entity (the parent).
 //
-// This component is used to automatically update an entity (passed into the constructor).
-struct FollowTransform
+// The entity's Transform component still holds it's world transform, it is recomputed each frame
+// by TransformSystem::update_hierarchy() from the parent's world transform and the "local"
+// transform stored here. Rotation and scale are only inherited when requested, otherwise the
+// entity's own rotation/scale are left untouched.
+struct Parent
 {
-  EntityID  target_eid;
-  glm::vec3 target_offset;
+  EntityID  eid;
+  Transform local;
 
-  explicit FollowTransform(EntityID);
+  bool inherit_rotation = true;
+  bool inherit_scale    = true;
+
+  explicit Parent(EntityID);
+};
+
+// Assigning or removing a Parent changes the order TransformSystem walks the hierarchy in. To move
+// an entity to another parent, remove it's Parent and assign a new one.
+template <>
+struct IsHierarchyComponent<Parent> : std::true_type
+{
 };
 
 struct HealthPoints
@@ -152,9 +161,36 @@ struct MeshRenderable
   }
 };
 
+// The entity's mesh is uploaded to the GPU on demand (see opengl::GpuResidency), instead of when
+// the zone is loaded. A placeholder is drawn in it's place until the upload finishes.
+struct StreamedMesh
+{
+};
+
+// The LOD the entity's mesh is drawn with (see LodSelector), picked once per frame from the main
+// camera by Visibility::build.
+struct MeshLodState
+{
+  size_t lod = 0;
+
+  // The number of LODs (including LOD 0) of the entity's mesh on the GPU.
+  size_t num_lods = 1;
+};
+
+// The entity hides what is behind it (see OcclusionBuffer).
+//
+// The box (in the entity's model space) must lie inside the entity's mesh, ie: the walls of a
+// house, not it's bounding box.
+struct Occluder
+{
+  Cube box;
+};
+
 struct TextureRenderable
 {
-  opengl::TextureInfo* texture_info = nullptr;
+  // The texture's name in the TextureTable, and it's handle (see LevelLoader::resolve_textures()).
+  std::string           texture;
+  opengl::TextureHandle handle;
 };
 
 inline auto
@@ -2,14 +2,18 @@
 #include <boomhs/controller.hpp>
 #include <boomhs/game_config.hpp>
 #include <boomhs/io_behavior.hpp>
+#include <boomhs/keyboard.hpp>
 #include <boomhs/main_menu.hpp>
 #include <boomhs/math.hpp>
 #include <boomhs/mouse.hpp>
+#include <boomhs/simulation.hpp>
+#include <boomhs/simulation_thread.hpp>
 #include <boomhs/viewport.hpp>
 #include <boomhs/ui_state.hpp>
 
 #include <gl_sdl/sdl_window.hpp>
 
+#include <common/frame_arena.hpp>
 #include <common/log.hpp>
 #include <common/time.hpp>
 #include <common/type_macros.hpp>
@@ -24,19 +28,11 @@ struct PlayerBehavior;
 struct DeviceStates
 {
   ControllerStates controller;
+  KeyboardState    keyboard;
   MouseStates      mouse;
   CursorManager    cursors;
 };
 
-struct MovementState
-{
-  glm::vec3 forward, backward, left, right;
-
-  glm::vec3 mouse_forward;
-
-  NO_COPY_OR_MOVE(MovementState);
-};
-
 struct EngineState
 {
   common::Logger&   logger;
@@ -48,6 +44,12 @@ struct EngineState
   common::Time    time;
   PlayerBehaviors behaviors;
 
+  // Memory for containers that only live for the current frame, reset at the end of every frame.
+  common::FrameArena frame_arena;
+
+  // Steps the simulation while the frame is drawn.
+  SimulationThread simulation_thread;
+
   bool                 quit                  = false;
   bool                 game_running          = false;
   bool                 update_orbital_bodies = true;
@@ -86,6 +88,12 @@ struct EngineState
   bool draw_normals;
   bool draw_skybox;
 
+  // Draw meshes with a simplified LOD when they are small on screen.
+  bool mesh_lods;
+
+  // Skip drawing entities hidden behind the terrain (or other occluders).
+  bool occlusion_culling;
+
   bool show_global_axis;
 
   bool show_player_localspace_vectors;
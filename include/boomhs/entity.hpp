@@ -1,9 +1,12 @@
 #pragma once
 #include <boomhs/transform.hpp>
+#include <common/frame_arena.hpp>
 #include <common/type_macros.hpp>
 #include <extlibs/entt.hpp>
 #include <extlibs/glm.hpp>
 
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace boomhs
@@ -12,18 +15,67 @@ namespace boomhs
 using EntityID                    = uint32_t;
 static auto constexpr EntityIDMAX = UINT32_MAX;
 
+// Components that place an entity in the transform hierarchy (specialized to true for them).
+template <typename T>
+struct IsHierarchyComponent : std::false_type
+{
+};
+
+// The transform hierarchy, flattened into packed arrays ordered so every parent comes before it's
+// children: the entities with a Parent, and the roots they hang from (entities without a Parent).
+//
+// Built by TransformSystem::update_hierarchy, and only built again after the registry marks it
+// dirty (a Parent was assigned or removed, or an entity destroyed). The matrices are filled in and
+// propagated every update.
+struct TransformHierarchy
+{
+  // Bits of "inherit", the parts of the parent's world transform a child inherits (it always
+  // inherits the translation).
+  static uint8_t constexpr INHERIT_ROTATION = 1 << 0;
+  static uint8_t constexpr INHERIT_SCALE    = 1 << 1;
+
+  std::vector<EntityID> eids;
+
+  // The index of each entity's parent in these arrays, -1 for the roots.
+  std::vector<int> parent_index;
+
+  std::vector<uint8_t> inherit;
+
+  // Each child's transform relative to it's parent (a root's is it's world transform), and it's
+  // world transform.
+  std::vector<glm::mat4> local;
+  std::vector<glm::mat4> world;
+
+  bool dirty = true;
+
+  auto size() const { return eids.size(); }
+};
+
 class EntityRegistry
 {
   entt::DefaultRegistry registry_;
+  TransformHierarchy    hierarchy_;
+
+  // The entities destroyed since the list was last taken.
+  std::vector<EntityID> destroyed_;
+
+  template <typename T>
+  void changed_structure()
+  {
+    if constexpr (IsHierarchyComponent<T>::value) {
+      hierarchy_.dirty = true;
+    }
+  }
 
 public:
-  EntityRegistry() = default;
+  EntityRegistry();
   MOVE_CONSTRUCTIBLE_ONLY(EntityRegistry);
 
   template <typename Component, typename... Args>
   Component& assign(EntityID const eid, Args&&... args)
   {
     assert(!has<Component>(eid));
+    changed_structure<Component>();
     return registry_.assign<Component>(eid, FORWARD(args));
   }
 
@@ -61,6 +113,7 @@ public:
   void remove(EntityID const eid)
   {
     assert(eid != EntityIDMAX);
+    changed_structure<T>();
     registry_.remove<T>(eid);
   }
 
@@ -69,6 +122,95 @@ public:
   {
     return registry_.view<Args...>();
   }
+
+  bool valid(EntityID const eid) const { return registry_.valid(eid); }
+
+  // Create the (empty) pools of the components "T...", if they don't exist yet.
+  //
+  // Creating a pool modifies the registry, views create the pools they walk. Threads walking views
+  // of the registry at the same time must have their pools created first.
+  template <typename... T>
+  void add_pools()
+  {
+    (registry_.reserve<T>(0), ...);
+  }
+
+  // Remove the component "T" from every entity that has one.
+  template <typename T>
+  void reset()
+  {
+    changed_structure<T>();
+    registry_.reset<T>();
+  }
+
+  // Destroy every entity, and all of their components.
+  void clear()
+  {
+    hierarchy_.dirty = true;
+    registry_.each([this](auto const eid) { destroyed_.emplace_back(eid); });
+    registry_.reset();
+  }
+
+  // The entities destroyed since the last call, so state kept per entity outside of the registry
+  // (see GpuResidency) can be released.
+  std::vector<EntityID> take_destroyed() { return std::exchange(destroyed_, {}); }
+
+  auto&       hierarchy() { return hierarchy_; }
+  auto const& hierarchy() const { return hierarchy_; }
+
+  // Invoke "fn" with every entity that is still alive.
+  template <typename FN>
+  void each(FN&& fn) const
+  {
+    registry_.each(std::forward<FN>(fn));
+  }
+
+  // Raw access to the pool of components "T".
+  //
+  // Entity data<T>()[i] owns the component raw<T>()[i], for every i in [0, size<T>()).
+  template <typename T>
+  size_t size() const
+  {
+    return registry_.size<T>();
+  }
+
+  template <typename T>
+  EntityID const* data() const
+  {
+    return registry_.data<T>();
+  }
+
+  template <typename T>
+  T const* raw() const
+  {
+    return registry_.raw<T>();
+  }
+
+  template <typename T>
+  T* raw()
+  {
+    return registry_.raw<T>();
+  }
+
+  // Sort the pool of components "T" using the comparison function.
+  //
+  // Uses an insertion sort, pools that are re-sorted every frame are already (nearly) sorted so
+  // keeping them sorted is close to linear.
+  template <typename T, typename Compare>
+  void sort(Compare&& compare)
+  {
+    if (registry_.size<T>() < 2) {
+      return;
+    }
+    registry_.sort<T>(std::forward<Compare>(compare), entt::InsertionSort{});
+  }
+
+  // Arrange the pool of components "To" in the same order as the pool of components "From".
+  template <typename To, typename From>
+  void sort()
+  {
+    registry_.sort<To, From>();
+  }
 };
 
 class EnttLookup
@@ -104,14 +246,27 @@ public:
   void set_eid(EntityID const eid) { eid_ = eid; }
 };
 
-class EntityArray
+template <typename Alloc>
+class BasicEntityArray
 {
-  std::vector<EntityID> data_;
+  std::vector<EntityID, Alloc> data_;
 public:
+  BasicEntityArray() = default;
+  explicit BasicEntityArray(Alloc const& alloc)
+      : data_(alloc)
+  {
+  }
+
+  void reserve(size_t const n) { data_.reserve(n); }
 
   DEFINE_VECTOR_LIKE_WRAPPER_FNS(data_);
 };
 
+using EntityArray = BasicEntityArray<std::allocator<EntityID>>;
+
+// EntityArray allocated from the per-frame arena, only valid until the end of the frame.
+using FrameEntityArray = BasicEntityArray<common::FrameAllocator<EntityID>>;
+
 template <typename ...C>
 class EntitySearchResults : public EntityArray
 {
@@ -178,6 +333,21 @@ find_all_entities_with_component(EntityRegistry& registry)
   return result;
 }
 
+// Same as find_all_entities_with_component(), except the results are allocated from the per-frame
+// arena.
+template <typename... C>
+auto
+find_all_entities_with_component(EntityRegistry& registry, common::FrameArena& arena)
+{
+  FrameEntityArray result{common::FrameAllocator<EntityID>{arena}};
+  auto const       view = registry.view<C...>();
+  result.reserve(view.size());
+  for (auto const e : view) {
+    result.emplace_back(e);
+  }
+  return result;
+}
+
 inline auto
 all_nearby_entities(glm::vec3 const& pos, float const max_distance, EntityRegistry& registry)
 {
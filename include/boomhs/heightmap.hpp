@@ -8,12 +8,6 @@
 #include <string>
 #include <vector>
 
-namespace opengl
-{
-struct ImageData;
-class TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
 
@@ -54,15 +48,9 @@ struct TerrainConfig;
 namespace boomhs::heightmap
 {
 
-HeightmapResult
-load_fromtable(common::Logger&, opengl::TextureTable const&, std::string const&);
-
 boomhs::ObjVertices
 generate_normals(int, int, bool, Heightmap const&);
 
-HeightmapResult
-parse(opengl::ImageData const&);
-
 HeightmapResult
 parse(common::Logger&, char const*);
 
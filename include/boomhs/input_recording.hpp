@@ -0,0 +1,89 @@
+#pragma once
+#include <boomhs/frame_time.hpp>
+#include <boomhs/keyboard.hpp>
+#include <boomhs/mouse.hpp>
+
+#include <common/result.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/sdl.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Record and replay of play sessions.
+//
+// A recording holds everything a frame of the game reads from the outside world:
+//   * The seed the game's RNG was constructed with.
+//   * The frame's time (FrameTime) values.
+//   * The SDL events dispatched during the frame.
+//   * The keyboard and mouse state at the start of the frame.
+//
+// Feeding a recording back into the game reproduces the recorded session, which gives repeatable
+// runs of the real gameplay code for benchmarking.
+//
+// File layout (native endianness, the file is only meant to be replayed by the same build):
+//   header: magic "BHSR", uint32_t version, uint64_t rng seed, freq_t timer frequency
+//   frame:  ticks_t delta, ticks_t since_start,
+//           uint32_t event count, followed by that many raw SDL_Event's,
+//           uint16_t pressed key count, followed by that many uint16_t SDL_Scancode's,
+//           int32_t mouse x, int32_t mouse y, uint32_t mouse button mask
+namespace boomhs
+{
+
+// Everything read from outside the game during a single frame.
+struct InputFrame
+{
+  ticks_t delta       = 0.0;
+  ticks_t since_start = 0.0;
+
+  std::vector<SDL_Event> events;
+  KeyboardState          keyboard;
+  MouseState             mouse;
+
+  InputFrame() = default;
+  MOVE_DEFAULT_ONLY(InputFrame);
+
+  // Empty the frame so it can be reused for the next frame without reallocating.
+  void clear();
+};
+
+class InputRecorder
+{
+  std::ofstream file_;
+
+  explicit InputRecorder(std::ofstream&&);
+
+public:
+  MOVE_DEFAULT_ONLY(InputRecorder);
+
+  void write_frame(InputFrame const&);
+
+  static Result<InputRecorder, std::string> create(std::string const&, uint64_t, freq_t);
+};
+
+class InputReplayer
+{
+  std::ifstream file_;
+  uint64_t      seed_;
+  freq_t        frequency_;
+
+  explicit InputReplayer(std::ifstream&&, uint64_t, freq_t);
+
+public:
+  MOVE_DEFAULT_ONLY(InputReplayer);
+
+  auto seed() const { return seed_; }
+  auto frequency() const { return frequency_; }
+
+  // Read the next recorded frame into the frame passed in.
+  //
+  // Returns false once every recorded frame has been read.
+  bool read_frame(InputFrame&);
+
+  static Result<InputReplayer, std::string> open(std::string const&);
+};
+
+} // namespace boomhs
@@ -40,7 +40,10 @@ public:
 
 class Inventory
 {
+public:
   size_t static constexpr MAX_ITEMS = 40;
+
+private:
   std::array<InventorySlot, MAX_ITEMS> slots_;
   bool                                 open_ = false;
 
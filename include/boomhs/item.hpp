@@ -3,7 +3,6 @@
 #include <boomhs/entity.hpp>
 #include <boomhs/item.hpp>
 #include <common/type_macros.hpp>
-#include <opengl/texture.hpp>
 
 #include <string>
 #include <vector>
@@ -41,10 +40,11 @@ public:
 
 struct Item
 {
-  char const*          name        = "UNNAMED";
-  char const*          tooltip     = "TOOLTIP NOT SET";
+  std::string          name        = "UNNAMED";
+  std::string          tooltip     = "TOOLTIP NOT SET";
   bool                 is_pickedup = false;
-  opengl::TextureInfo* ui_tinfo;
+  std::string          ui_texture  = "RedX";
+  opengl::TextureInfo* ui_tinfo    = nullptr;
 
 private:
   PreviousOwners owners_;
@@ -60,7 +60,7 @@ public:
     assert(is_currently_owned());
     return owners_[0];
   }
-  auto const& all_owners() { return owners_; }
+  auto const& all_owners() const { return owners_; }
 
   bool ever_owned_by(char const*) const;
   bool was_previously_owned() const;
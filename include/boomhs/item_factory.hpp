@@ -1,11 +1,6 @@
 #pragma once
 #include <boomhs/entity.hpp>
 
-namespace opengl
-{
-class TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
 class RNG;
@@ -14,11 +9,17 @@ struct ItemFactory
 {
   ItemFactory() = delete;
 
-  static EntityID create_empty(EntityRegistry&, opengl::TextureTable&);
+  // The items' textures are named, the renderer resolves them (see
+  // LevelLoader::resolve_textures()).
+  static EntityID create_empty(EntityRegistry&);
+
+  static EntityID create_book(EntityRegistry&);
+  static EntityID create_spear(EntityRegistry&);
+  static EntityID create_torch(EntityRegistry&);
 
-  static EntityID create_book(EntityRegistry&, opengl::TextureTable&);
-  static EntityID create_spear(EntityRegistry&, opengl::TextureTable&);
-  static EntityID create_torch(EntityRegistry&, opengl::TextureTable&);
+  // The flickering light of a torch (Torch, PointLight and LightFlicker components), without
+  // anything needed to render or pick up the torch.
+  static void add_torchlight(EntityRegistry&, EntityID);
 };
 
 } // namespace boomhs
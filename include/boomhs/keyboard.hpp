@@ -0,0 +1,29 @@
+#pragma once
+#include <common/type_macros.hpp>
+#include <extlibs/sdl.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace boomhs
+{
+
+// The state of every key on the keyboard, captured once per frame.
+//
+// Game code reads the keyboard through this instead of SDL_GetKeyboardState(), so a recorded
+// session can substitute the keyboard state it captured.
+class KeyboardState
+{
+  std::array<uint8_t, SDL_NUM_SCANCODES> keys_ = {};
+
+public:
+  KeyboardState() = default;
+  COPYMOVE_DEFAULT(KeyboardState);
+
+  bool pressed(SDL_Scancode const sc) const { return keys_[sc] != 0; }
+  void set_pressed(SDL_Scancode const sc, bool const v) { keys_[sc] = v ? 1 : 0; }
+
+  static KeyboardState from_sdl();
+};
+
+} // namespace boomhs
@@ -0,0 +1,203 @@
+#pragma once
+#include <boomhs/billboard.hpp>
+#include <boomhs/color.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/material.hpp>
+#include <boomhs/mesh_lod.hpp>
+
+#include <opengl/vertex_attribute.hpp>
+
+#include <common/binary_io.hpp>
+#include <common/log.hpp>
+#include <common/result.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compiled levels.
+//
+// Levels are authored as TOML (engine.toml, levels/resources.toml and levels/<level>.toml). The
+// level compiler parses the TOML sources once, resolves every reference by name (shader to vertex
+// layout, entity to shader/mesh/texture/material/attenuation, geometry strings, ...) to an index
+// and stores the result as a CompiledLevel.
+//
+// tools/level_compiler.cxx writes CompiledLevel's to disk ahead of time. At runtime the
+// LevelLoader reads the compiled file, only compiling the TOML sources itself when the compiled
+// file is missing or out of date.
+//
+// The level's meshes are cooked into the compiled file as well (loaded from their OBJ files,
+// optimized and simplified into LOD chains), so that work only runs at runtime when the TOML
+// sources are compiled.
+namespace boomhs
+{
+
+// Index of an entry in one of the CompiledLevel's tables.
+using LevelIndex                              = uint32_t;
+static LevelIndex constexpr LEVEL_INDEX_NONE = UINT32_MAX;
+
+struct CompiledVertexLayout
+{
+  std::string                               name;
+  std::vector<opengl::AttributePointerInfo> apis;
+};
+
+struct CompiledShader
+{
+  std::string name;
+  std::string vertex;
+  std::string fragment;
+  LevelIndex  vertex_layout  = LEVEL_INDEX_NONE;
+  bool        is_2d          = false;
+  int32_t     instance_count = -1;
+};
+
+struct CompiledMesh
+{
+  std::string name;
+  std::string path;
+
+  // The mesh loaded from it's OBJ file, with it's vertices and indices reordered for the vertex
+  // cache, see MeshOptimizer.
+  ObjData obj;
+
+  // The mesh's LOD chain (not including LOD 0), simplified from the optimized mesh and optimized
+  // themselves, see MeshSimplifier and MeshOptimizer.
+  std::vector<MeshLod> lods;
+};
+
+struct CompiledTexture
+{
+  std::string name;
+  bool        is_3dcube    = false;
+  GLenum      format       = GL_RGBA;
+  GLint       wrap         = 0;
+  float       uv_max       = 1.0f;
+  uint32_t    texture_unit = 0;
+
+  // Uploaded while it's used instead of when the level loads (see opengl::GpuResidency).
+  bool streamed = false;
+
+  // One filename for 2d textures, six (front, right, back, left, top, bottom) for cube textures.
+  std::vector<std::string> filenames;
+};
+
+struct CompiledAttenuation
+{
+  std::string name;
+  Attenuation value;
+};
+
+struct CompiledMaterial
+{
+  std::string name;
+  Material    value;
+};
+
+enum class CompiledGeometry : uint8_t
+{
+  NONE = 0,
+  CUBE,
+  MESH,
+  BILLBOARD
+};
+
+enum class CompiledTree : uint8_t
+{
+  NONE = 0,
+  LOWPOLY,
+  TREE2
+};
+
+// An entity, with every value the runtime needs already parsed and resolved.
+struct CompiledEntity
+{
+  std::string name;
+  LevelIndex  shader = LEVEL_INDEX_NONE;
+
+  glm::vec3 position = glm::vec3{0.0f};
+  glm::vec3 scale    = glm::vec3{1.0f};
+  glm::quat rotation = glm::quat{};
+  bool      hidden   = false;
+  bool      junk     = false;
+
+  CompiledGeometry geometry  = CompiledGeometry::NONE;
+  LevelIndex       mesh      = LEVEL_INDEX_NONE;
+  BillboardType    billboard = BillboardType::INVALID;
+  glm::vec3        cube_min  = glm::vec3{1.0f};
+  glm::vec3        cube_max  = glm::vec3{1.0f};
+  CompiledTree     tree      = CompiledTree::NONE;
+
+  bool      has_color = false;
+  ColorRGBA color;
+  LevelIndex texture  = LEVEL_INDEX_NONE;
+  LevelIndex material = LEVEL_INDEX_NONE;
+
+  bool      has_orbital    = false;
+  glm::vec3 orbital_radius = glm::vec3{0.0f};
+  float     orbital_offset = 0.0f;
+
+  bool       has_pointlight = false;
+  LevelIndex attenuation    = LEVEL_INDEX_NONE;
+  Light      light;
+
+  // The box (in model space) the entity hides things behind, see OcclusionBuffer.
+  bool      has_occluder = false;
+  glm::vec3 occluder_min = glm::vec3{0.0f};
+  glm::vec3 occluder_max = glm::vec3{0.0f};
+};
+
+struct CompiledLevel
+{
+  // engine.toml
+  std::vector<CompiledVertexLayout> vertex_layouts;
+  std::vector<CompiledShader>       shaders;
+
+  // levels/resources.toml
+  std::vector<CompiledMesh>        meshes;
+  std::vector<CompiledTexture>     textures;
+  std::vector<CompiledMaterial>    materials;
+  std::vector<CompiledAttenuation> attenuations;
+
+  // levels/<level>.toml
+  ColorRGB         ambient;
+  DirectionalLight directional;
+  float            fog_density  = 0.0f;
+  float            fog_gradient = 0.0f;
+  ColorRGBA        fog_color;
+
+  // The texture (resource) the terrain's heights are read from.
+  LevelIndex heightmap = LEVEL_INDEX_NONE;
+
+  std::vector<CompiledEntity> entities;
+
+  CompiledLevel() = default;
+  MOVE_DEFAULT_ONLY(CompiledLevel);
+};
+
+class LevelCompiler
+{
+  LevelCompiler() = delete;
+
+public:
+  // Parse and resolve the TOML sources of the level.
+  static Result<CompiledLevel, std::string> compile(common::Logger&, std::string const&);
+
+  static common::ByteBuffer                  serialize(CompiledLevel const&);
+  static Result<CompiledLevel, std::string> deserialize(common::ByteBuffer const&);
+
+  // Path of the compiled file for the level, ie: "area0.toml" -> "levels/area0.bin".
+  static std::string compiled_path(std::string const&);
+
+  // Whether the compiled file of the level exists and is newer than all of it's TOML sources.
+  static bool is_compiled_uptodate(std::string const&);
+
+  // Whether the compiled file of the level is newer than all of the OBJ files it's meshes were
+  // cooked from.
+  static bool are_meshes_uptodate(CompiledLevel const&, std::string const&);
+};
+
+} // namespace boomhs
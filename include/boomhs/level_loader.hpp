@@ -1,5 +1,8 @@
 #pragma once
+#include <boomhs/entity.hpp>
 #include <boomhs/fog.hpp>
+#include <boomhs/heightmap.hpp>
+#include <boomhs/level_compiler.hpp>
 #include <boomhs/material.hpp>
 #include <boomhs/obj_store.hpp>
 
@@ -12,12 +15,13 @@
 #include <common/result.hpp>
 #include <common/type_macros.hpp>
 
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace boomhs
 {
-class EntityRegistry;
+class TerrainGrid;
 
 struct NameAttenuation
 {
@@ -37,15 +41,58 @@ struct LevelAssets
   opengl::TextureTable   texture_table;
   opengl::ShaderPrograms shader_programs;
 
+  std::optional<Heightmap> heightmap;
+
   MOVE_CONSTRUCTIBLE_ONLY(LevelAssets);
 };
 
+// The CPU side of a level: the compiled level and the mesh data it references.
+//
+// Reading a LevelSource doesn't touch OpenGL, so it can be done on any thread.
+struct LevelSource
+{
+  CompiledLevel level;
+  ObjStore      obj_store;
+
+  // The heights of the level's terrain, if the level names a heightmap.
+  std::optional<Heightmap> heightmap;
+
+  MOVE_CONSTRUCTIBLE_ONLY(LevelSource);
+};
+
 struct LevelLoader
 {
   LevelLoader() = delete;
 
+  // Read the level's compiled file, falling back to compiling the TOML sources when the compiled
+  // file is missing, older than it's sources or was written by a different version of the compiler.
+  static Result<CompiledLevel, std::string>
+  read_compiled_level(common::Logger&, std::string const&);
+
+  static Result<LevelSource, std::string> read_level(common::Logger&, std::string const&);
+
+  static MaterialTable load_materials(CompiledLevel const&);
+
+  // Create the level's entities without touching OpenGL, returning them in the order of the
+  // level's entities. Textures are only named, see resolve_textures().
+  static EntityArray instantiate_entities(common::Logger&, EntityRegistry&, CompiledLevel const&);
+
+  // The functions below are the OpenGL half of the loader (level_loader_gl.cxx).
+
+  // Upload the level's shaders and textures and create it's entities. Must be called on the thread
+  // owning the OpenGL context.
+  static Result<LevelAssets, std::string>
+  instantiate_level(common::Logger&, EntityRegistry&, LevelSource&&);
+
+  // read_level() followed by instantiate_level().
   static Result<LevelAssets, std::string>
   load_level(common::Logger&, EntityRegistry&, std::string const&);
+
+  // Give every TextureRenderable and Item without a texture the texture they name.
+  static void resolve_textures(common::Logger&, opengl::TextureTable&, EntityRegistry&);
+
+  // Give every terrain piece the handles of the textures it's bound to.
+  static void resolve_textures(common::Logger&, opengl::TextureTable const&, TerrainGrid&);
 };
 
 } // namespace boomhs
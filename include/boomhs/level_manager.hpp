@@ -1,35 +1,41 @@
 #pragma once
 #include <boomhs/zone_state.hpp>
 #include <common/type_macros.hpp>
+
+#include <optional>
 #include <vector>
 
 namespace boomhs
 {
+
+// Holds the zones (one per floor) that are currently loaded.
+//
+// There is a slot for every floor, but only the slots of loaded floors hold a ZoneState. The slots
+// are allocated up front and never reallocated, so references to a loaded ZoneState stay valid
+// while other zones are loaded and unloaded.
 class LevelManager
 {
-  ZoneStates zstates_;
-  int        active_ = 0;
+  std::vector<std::optional<ZoneState>> zstates_;
+  int                                   active_ = 0;
 
 public:
   NOCOPY_MOVE_DEFAULT(LevelManager);
-  explicit LevelManager(ZoneStates&&);
+  explicit LevelManager(int);
 
   ZoneState const& active() const;
   ZoneState&       active();
 
+  // The floor must be loaded.
   void make_active(int);
   int  num_levels() const;
   int  active_zone() const;
 
-  BEGIN_END_FORWARD_FNS(zstates_);
+  bool             is_loaded(int) const;
+  ZoneState const& zone(int) const;
+  ZoneState&       zone(int);
 
-  /*
-  void
-  add_zone(ZoneState &&zone)
-  {
-    zstates_.add_zone(MOVE(zone));
-  }
-  */
+  void add_zone(int, ZoneState&&);
+  void remove_zone(int);
 };
 
 } // namespace boomhs
@@ -90,9 +90,9 @@ struct PointLights
 };
 
 inline auto
-find_pointlights(EntityRegistry& registry)
+find_pointlights(EntityRegistry& registry, common::FrameArena& arena)
 {
-  return find_all_entities_with_component<PointLight>(registry);
+  return find_all_entities_with_component<PointLight>(registry, arena);
 }
 
 } // namespace boomhs
@@ -163,10 +163,15 @@ compute_cube_dimensions(glm::vec3 const& min, glm::vec3 const& max)
 inline ModelMatrix
 compute_modelmatrix(glm::vec3 const& translation, glm::quat const& rotation, glm::vec3 const& scale)
 {
-  auto const tmatrix = glm::translate(glm::mat4{}, translation);
-  auto const rmatrix = glm::toMat4(rotation);
-  auto const smatrix = glm::scale(glm::mat4{}, scale);
-  return tmatrix * rmatrix * smatrix;
+  // Equivalent to (T * R * S), composed directly instead of through two full 4x4 matrix
+  // multiplications. The rotation's basis vectors are scaled per-axis and the translation is
+  // written into the last column. No branches, so batched callers vectorize well.
+  ModelMatrix m = glm::toMat4(rotation);
+  m[0] *= scale.x;
+  m[1] *= scale.y;
+  m[2] *= scale.z;
+  m[3] = glm::vec4{translation, 1.0f};
+  return m;
 }
 
 inline ModelMatrix
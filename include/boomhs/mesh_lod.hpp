@@ -0,0 +1,78 @@
+#pragma once
+#include <boomhs/obj.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace boomhs
+{
+struct AABoundingBox;
+struct Transform;
+
+// A simplified copy of a mesh, one level of the mesh's LOD chain.
+struct MeshLod
+{
+  ObjData data;
+
+  // For each of the LOD's vertices, the index of the vertex (in the original mesh) it was copied
+  // from. Used to copy per-vertex data written after loading (ie: tree colors) onto the LOD.
+  std::vector<uint32_t> source_vertices;
+
+  auto num_triangles() const { return data.indices.size() / 3; }
+};
+
+// Simplifies meshes by collapsing edges, choosing the collapses with the lowest quadric error
+// (Garland and Heckbert).
+//
+// Meshes are loaded with a vertex per face corner, vertices at the same position are collapsed
+// together. The attributes (colors, normals, uvs) of the collapsed vertices are not interpolated,
+// each face corner keeps the attributes of the most similar vertex at it's new position.
+class MeshSimplifier
+{
+  MeshSimplifier() = delete;
+
+public:
+  // The fraction of the original mesh's triangles each LOD keeps, starting at LOD 1.
+  static std::array<float, 3> constexpr LOD_RATIOS = {{0.5f, 0.25f, 0.1f}};
+
+  // The original mesh (LOD 0) and it's simplified copies.
+  static size_t constexpr MAX_LODS = LOD_RATIOS.size() + 1;
+
+  // Meshes with fewer triangles are not worth simplifying.
+  static size_t constexpr MIN_TRIANGLES = 64;
+
+  // Simplify the mesh until it has (at most) the target number of triangles, or no more edges
+  // can be collapsed without flipping a triangle.
+  static MeshLod simplify(ObjData const&, size_t);
+
+  // Generate the mesh's LOD chain (not including the original mesh). Levels that failed to remove
+  // a significant number of triangles are left out, the chain may be empty.
+  static std::vector<MeshLod> generate_lods(ObjData const&);
+};
+
+// Picks the LOD to draw an entity with, based on how large the entity appears on screen.
+class LodSelector
+{
+  LodSelector() = delete;
+
+public:
+  // Screen sizes at which each LOD (starting at LOD 1) is switched to. The screen size is the
+  // height of the entity's bounding sphere, divided by the height of the screen.
+  static std::array<float, 3> constexpr SCREEN_SIZES = {{0.25f, 0.1f, 0.04f}};
+
+  // How far (as a fraction of the threshold) the screen size has to move past a threshold before
+  // switching LODs, so entities near a threshold don't switch back and forth every frame.
+  static float constexpr HYSTERESIS = 0.15f;
+
+  static float screen_size(glm::mat4 const&, glm::mat4 const&, Transform const&,
+                           AABoundingBox const&);
+
+  // Pick the LOD for the screen size, given the entity's current LOD and the number of LODs
+  // (including LOD 0) it's mesh has.
+  static size_t select(float, size_t, size_t);
+};
+
+} // namespace boomhs
@@ -0,0 +1,71 @@
+#pragma once
+#include <boomhs/obj.hpp>
+
+#include <extlibs/glew.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace boomhs
+{
+struct MeshLod;
+
+// A mesh's average cache miss ratio (ACMR) and vertex count, before and after it was optimized.
+struct MeshOptimizeStats
+{
+  float  acmr_before         = 0.0f;
+  float  acmr_after          = 0.0f;
+  size_t num_vertices_before = 0;
+  size_t num_vertices_after  = 0;
+};
+
+// Reorders a mesh's triangles for the GPU's post-transform vertex cache (Tipsify, Sander et al.),
+// then sorts clusters of the triangles so the outward facing clusters are drawn first, reducing
+// overdraw. Finally the vertices are reordered to follow the order the triangles use them in.
+//
+// The cache is measured by the ACMR of a simulated FIFO cache, the number of vertices transformed
+// per triangle. It ranges from 3 (no vertex is reused) to about 0.5 for large regular meshes.
+class MeshOptimizer
+{
+  MeshOptimizer() = delete;
+
+public:
+  // The size of the simulated (and optimized for) vertex cache.
+  static size_t constexpr CACHE_SIZE = 16;
+
+  // Clusters are split where their ACMR so far is within this factor of the ACMR of the whole
+  // cluster. Smaller clusters sort better, at the cost of a few cache misses.
+  static float constexpr OVERDRAW_THRESHOLD = 1.05f;
+
+  // Grids are drawn in bands (of this many vertices across), so the vertices of a row are still
+  // in the cache when the next row is drawn.
+  static size_t constexpr GRID_BAND_WIDTH = CACHE_SIZE / 2;
+
+  // The ACMR of drawing the indices, as GL_TRIANGLES or GL_TRIANGLE_STRIP.
+  static float acmr(ObjIndices const&, size_t, GLenum = GL_TRIANGLES);
+
+  // Merge the vertices whose attributes (and material) are identical, so the triangles can share
+  // them. Returns the number of vertices removed.
+  static size_t deduplicate_vertices(ObjData&);
+
+  // Reorder the triangles for the vertex cache. The first triangle of each cluster of triangles
+  // (starting where the cache had to be refilled) is added to the clusters.
+  static ObjIndices optimize_vertex_cache(ObjIndices const&, size_t, std::vector<uint32_t>&);
+
+  // Reorder the clusters of triangles, outward facing clusters first.
+  static ObjIndices optimize_overdraw(ObjIndices const&, ObjVertices const&,
+                                      std::vector<uint32_t> const&);
+
+  // Reorder the vertices to the order the triangles first use them in. Returns the previous index
+  // of each vertex.
+  static std::vector<uint32_t> optimize_vertex_fetch(ObjData&);
+
+  // Run every optimization on the mesh.
+  static MeshOptimizeStats optimize(ObjData&);
+
+  // Same as above, without merging vertices (the LOD's vertices are a subset of an already
+  // optimized mesh's vertices). The LOD's source vertices are kept up to date.
+  static MeshOptimizeStats optimize(MeshLod&);
+};
+
+} // namespace boomhs
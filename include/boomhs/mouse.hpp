@@ -38,20 +38,27 @@ struct MouseClickPositions {
   glm::ivec2 middle;
 };
 
+// The position and buttons of the mouse, captured once per frame.
 class MouseState
 {
-  auto mask() const { return SDL_GetMouseState(nullptr, nullptr); }
+  glm::ivec2 coords_ = {};
+  uint32_t   mask_   = 0;
 
 public:
   MouseState() = default;
+  MouseState(glm::ivec2 const&, uint32_t);
+
+  glm::ivec2 coords() const { return coords_; }
+  uint32_t   mask() const { return mask_; }
 
-  glm::ivec2 coords() const;
   bool left_pressed() const { return mask() & SDL_BUTTON(SDL_BUTTON_LEFT); }
   bool right_pressed() const { return mask() & SDL_BUTTON(SDL_BUTTON_RIGHT); }
   bool middle_pressed() const { return mask() & SDL_BUTTON(SDL_BUTTON_MIDDLE); }
 
   bool both_pressed() const { return left_pressed() && right_pressed(); }
   bool either_pressed() const { return left_pressed() || right_pressed(); }
+
+  static MouseState from_sdl();
 };
 
 struct MouseStates
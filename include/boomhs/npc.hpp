@@ -4,6 +4,9 @@
 #include <common/log.hpp>
 #include <common/type_macros.hpp>
 
+#include <array>
+#include <optional>
+
 namespace boomhs
 {
 class EntityRegistry;
@@ -36,7 +39,13 @@ class NPC
   NPC() = delete;
 
 public:
-  // Loads a new NPC into the EntityRegistry.
+  // The names NPCs are created with. NPCData::name always points into this table, so zone
+  // snapshots store an NPC's name as it's index in the table.
+  static constexpr std::array<char const*, 2> NAMES = {{"O", "T"}};
+
+  static std::optional<size_t> name_index(char const*);
+
+  // Loads a new NPC into the EntityRegistry, the name must be one of NAMES.
   static void create(EntityRegistry&, char const*, int, glm::vec3 const&);
 
   static void create_random(common::Logger&, TerrainGrid const&, EntityRegistry&, RNG&);
@@ -46,11 +55,11 @@ public:
 };
 
 inline auto
-find_enemies(EntityRegistry& registry)
+find_enemies(EntityRegistry& registry, common::FrameArena& arena)
 {
   using namespace boomhs;
   using namespace opengl;
-  return find_all_entities_with_component<NPCData>(registry);
+  return find_all_entities_with_component<NPCData>(registry, arena);
 }
 
 } // namespace boomhs
@@ -40,6 +40,9 @@ public:
   ObjVertices  uvs;
   ObjIndices   indices;
 
+  // The material of the face each vertex belongs to.
+  std::vector<int> material_ids;
+
   std::vector<tinyobj::shape_t>    shapes;
   std::vector<tinyobj::material_t> materials;
 
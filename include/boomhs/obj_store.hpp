@@ -1,8 +1,7 @@
 #pragma once
+#include <boomhs/mesh_lod.hpp>
 #include <boomhs/obj.hpp>
 #include <common/log.hpp>
-#include <opengl/buffer.hpp>
-#include <opengl/vertex_attribute.hpp>
 
 #include <ostream>
 #include <string>
@@ -12,21 +11,6 @@
 namespace boomhs
 {
 
-struct ObjQuery
-{
-  std::string               name;
-  opengl::BufferFlags const flags;
-};
-
-bool
-operator==(ObjQuery const&, ObjQuery const&);
-
-bool
-operator!=(ObjQuery const&, ObjQuery const&);
-
-std::ostream&
-operator<<(std::ostream&, ObjQuery const&);
-
 /*
 class ObjStore;
 class ObjCache
@@ -58,8 +42,15 @@ operator<<(std::ostream&, ObjCache const&);
 
 class ObjStore
 {
-  using pair_t      = std::pair<std::string, ObjData>;
-  using datastore_t = std::vector<pair_t>;
+  struct Entry
+  {
+    std::string name;
+    ObjData     obj;
+
+    // The obj's simplified copies, lods[0] is LOD 1.
+    std::vector<MeshLod> lods;
+  };
+  using datastore_t = std::vector<Entry>;
 
   // This holds the data
   mutable datastore_t data_;
@@ -73,8 +64,21 @@ public:
   ObjData&       get(common::Logger&, std::string const&);
   ObjData const& get(common::Logger&, std::string const&) const;
 
+  // Store the obj's LOD chain (see MeshSimplifier::generate_lods()).
+  void add_lods(std::string const&, std::vector<MeshLod>&&) const;
+
+  // The number of LODs of the obj, including the obj itself (LOD 0).
+  size_t num_lods(std::string const&) const;
+
+  // The obj's simplified copy for the LOD, which must be between 1 and num_lods() - 1.
+  MeshLod&       get_lod(common::Logger&, std::string const&, size_t);
+  MeshLod const& get_lod(common::Logger&, std::string const&, size_t) const;
+
   auto size() const { return data_.size(); }
   bool empty() const { return data_.empty(); }
+
+  // Size of the vertex and index data of all the objs (and their LODs).
+  size_t num_bytes() const;
 };
 
 std::ostream&
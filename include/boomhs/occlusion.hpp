@@ -0,0 +1,95 @@
+#pragma once
+#include <boomhs/entity.hpp>
+
+#include <common/type_macros.hpp>
+#include <extlibs/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace boomhs
+{
+struct Cube;
+class  TerrainGrid;
+
+// A low resolution depth buffer, rasterized on the CPU from a few large occluders (the terrain,
+// and entities with an Occluder component).
+//
+// Entities are tested against the buffer before being drawn, entities completely hidden behind
+// the occluders are skipped. The occluders only ever cover less than the real geometry does (the
+// terrain is lowered, the Occluder boxes lie inside their meshes), and are rasterized
+// conservatively (only into texels they cover completely, at their farthest depth over the texel),
+// so an entity is never culled while any part of it is visible.
+//
+// The depth buffer is reduced into a hierarchical-Z pyramid (each level holding the farthest depth
+// of 2x2 texels of the level below), so testing a bounding box reads at most 2x2 texels.
+class OcclusionBuffer
+{
+public:
+  static int constexpr WIDTH  = 256;
+  static int constexpr HEIGHT = 128;
+
+  // 256x128 down to 2x1.
+  static size_t constexpr NUM_LEVELS = 8;
+
+  // Each terrain piece is rasterized as a grid of this many cells along one side.
+  static size_t constexpr TERRAIN_CELLS = 16;
+
+  struct Stats
+  {
+    size_t num_triangles = 0;
+    size_t num_tested    = 0;
+    size_t num_culled    = 0;
+  };
+
+private:
+  glm::mat4 camera_matrix_;
+  bool      ready_ = false;
+
+  // Depths are NDC depth remapped to [0, 1], 1 being the far plane.
+  std::array<std::vector<float>, NUM_LEVELS> levels_;
+  Stats                                      stats_;
+
+  void build_hiz();
+
+public:
+  OcclusionBuffer();
+  NO_COPY(OcclusionBuffer);
+  MOVE_DEFAULT(OcclusionBuffer);
+
+  // Clear the buffer, before rasterizing the occluders seen by the camera (projection * view).
+  void begin(glm::mat4 const&);
+
+  // Rasterize an occluder triangle, given in world space. Triangles crossing the near plane are
+  // skipped.
+  void add_triangle(glm::vec3 const&, glm::vec3 const&, glm::vec3 const&);
+
+  // Rasterize the box (the 12 triangles of it's faces), transformed by the model matrix.
+  void add_box(glm::mat4 const&, Cube const&);
+
+  // Rasterize the terrain, lowered to the lowest height of each of it's cells.
+  void add_terrain(TerrainGrid const&);
+
+  // Rasterize the boxes of every (not hidden) entity with an Occluder component.
+  void add_entities(EntityRegistry&);
+
+  // Build the hierarchical-Z pyramid, after every occluder was rasterized.
+  void finish();
+
+  // Forget the occluders, every box is visible until the buffer is built again.
+  void clear();
+
+  // Whether any part of the box (transformed by the model matrix) may be visible to the camera.
+  //
+  // Boxes are only culled when the buffer was built from the same camera, so passes drawing from
+  // another camera (ie: the water reflection) are unaffected.
+  bool visible(glm::mat4 const&, glm::mat4 const&, Cube const&);
+
+  // The depth of the texel at (x, y) within the level.
+  float depth(size_t, int, int) const;
+
+  auto const& stats() const { return stats_; }
+};
+
+} // namespace boomhs
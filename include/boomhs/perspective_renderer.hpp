@@ -9,6 +9,7 @@ struct RenderState;
 namespace boomhs
 {
 class  Camera;
+class  FrameState;
 class  FrameTime;
 class  LevelManager;
 class  RNG;
@@ -18,6 +19,13 @@ struct PerspectiveRenderer
 {
   PerspectiveRenderer() = delete;
 
+  // Cull the frame's entities for every camera the frame is drawn from (and compute the cameras),
+  // reading the registry. Runs before the simulation steps the registry on it's thread, the scene
+  // is drawn after.
+  static void prepare(FrameState const&, LevelManager&, Camera const&);
+
+  // Draw the scene prepared for the frame, reading the registry only for what the simulation
+  // doesn't write (see RenderSnapshot).
   static void draw_scene(opengl::RenderState&, LevelManager&, opengl::DrawState&, Camera&, RNG& rng,
                          StaticRenderers&, FrameTime const&);
 };
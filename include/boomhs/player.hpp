@@ -12,17 +12,11 @@
 #include <optional>
 #include <string>
 
-namespace opengl
-{
-class ShaderPrograms;
-class TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
-struct EngineState;
 class  FrameTime;
-struct ZoneState;
+struct SimulationInput;
+struct SimulationZone;
 
 class PlayerHead
 {
@@ -38,8 +32,7 @@ public:
   // fields
   WorldObject world_object;
 
-  static PlayerHead create(common::Logger&, EntityRegistry&, opengl::ShaderPrograms&,
-                           WorldOrientation const&);
+  static PlayerHead create(common::Logger&, EntityRegistry&, WorldOrientation const&);
 };
 
 class Player
@@ -54,8 +47,7 @@ class Player
 public:
   NO_COPY(Player);
   MOVE_DEFAULT(Player);
-  explicit Player(common::Logger&, EntityID, EntityRegistry&, opengl::ShaderPrograms&,
-                  WorldOrientation const&);
+  explicit Player(common::Logger&, EntityID, EntityRegistry&, WorldOrientation const&);
 
   Inventory    inventory;
   HealthPoints hp{44, 50};
@@ -71,7 +63,7 @@ public:
 
   void try_pickup_nearby_item(common::Logger&, EntityRegistry&, FrameTime const&);
 
-  void update(EngineState&, ZoneState&, FrameTime const&);
+  void update(common::Logger&, SimulationZone&, SimulationInput const&, FrameTime const&);
 
   auto const& transform() const { return registry_->get<Transform>(eid_); }
   Transform&  transform() { return registry_->get<Transform>(eid_); }
@@ -58,11 +58,20 @@ class RNG
 public:
   MOVE_CONSTRUCTIBLE_ONLY(RNG);
   explicit RNG()
-      : seed_(make_seed())
+      : RNG(make_seed())
+  {
+  }
+
+  // Construct a generator that produces the same sequence as every other generator constructed
+  // with the same seed (used to replay recorded sessions).
+  explicit RNG(uint64_t const seed)
+      : seed_(seed)
       , generator_(this->seed_)
   {
   }
 
+  auto seed() const { return seed_; }
+
   float gen_negative1to1()
   {
     auto constexpr FROM = std::make_pair(-255, 255);
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace boomhs
+{
+class EntityRegistry;
+
+// Keeps the component pools read by the hot render loops arranged in the same order.
+//
+// The render passes iterate views such as view<ShaderName, Transform, IsRenderable, AABoundingBox,
+// ...>, which look each component up in it's own pool. When every pool is sorted the same way,
+// those lookups advance through each pool front to back (in lockstep) instead of jumping around
+// memory.
+class RenderGroups
+{
+  RenderGroups() = delete;
+
+public:
+  // Sort the ShaderName pool by shader (so entities drawn with the same shader are adjacent) and
+  // arrange the other render-critical pools to match.
+  //
+  // Called once per frame before rendering. Pools that haven't changed since the previous frame
+  // are already sorted, making this close to linear.
+  static void pack(EntityRegistry&);
+};
+
+} // namespace boomhs
@@ -0,0 +1,159 @@
+#pragma once
+#include <boomhs/entity.hpp>
+#include <boomhs/frame.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/transform.hpp>
+
+#include <common/algorithm.hpp>
+#include <common/type_macros.hpp>
+#include <extlibs/entt.hpp>
+#include <extlibs/glm.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace boomhs
+{
+class FrameTime;
+class NearbyTargets;
+
+// Components the simulation writes while the frame is drawn (specialized to true for them). The
+// renderers read them from the RenderSnapshot, never from the registry.
+template <typename T>
+struct IsSnapshotComponent : std::false_type
+{
+};
+
+template <>
+struct IsSnapshotComponent<Transform> : std::true_type
+{
+};
+
+template <>
+struct IsSnapshotComponent<WorldMatrix> : std::true_type
+{
+};
+
+template <>
+struct IsSnapshotComponent<PointLight> : std::true_type
+{
+};
+
+// A copy of the registry's pool of components "T", looked up by entity like the registry.
+template <typename T>
+class ComponentCopy
+{
+  static uint32_t constexpr EMPTY = std::numeric_limits<uint32_t>::max();
+
+  std::vector<T>        components_;
+  std::vector<EntityID> eids_;
+
+  // The index of each entity's component, indexed by the entity's number (without its version).
+  // EMPTY for entities without the component.
+  std::vector<uint32_t> positions_;
+
+  static auto number(EntityID const eid) { return eid & entt::entt_traits<EntityID>::entity_mask; }
+
+public:
+  void copy(EntityRegistry const& registry)
+  {
+    for (auto const eid : eids_) {
+      positions_[number(eid)] = EMPTY;
+    }
+
+    auto const  size = registry.size<T>();
+    auto const* eids = registry.data<T>();
+    auto const* raw  = registry.raw<T>();
+    eids_.assign(eids, eids + size);
+    components_.assign(raw, raw + size);
+
+    FOR(i, size)
+    {
+      auto const n = number(eids_[i]);
+      if (n >= positions_.size()) {
+        positions_.resize(n + 1, EMPTY);
+      }
+      positions_[n] = static_cast<uint32_t>(i);
+    }
+  }
+
+  bool has(EntityID const eid) const
+  {
+    auto const n = number(eid);
+    return n < positions_.size() && EMPTY != positions_[n] && eid == eids_[positions_[n]];
+  }
+
+  T const& get(EntityID const eid) const
+  {
+    assert(has(eid));
+    return components_[positions_[number(eid)]];
+  }
+};
+
+// The state of the zone a frame is drawn from, copied out of the registry once the frame's update
+// has finished.
+//
+// The renderers draw the frame from the snapshot while the simulation (see SimulationThread)
+// already writes the next frame into the registry. The passes' visible sets (see Visibility) and
+// the cameras they are drawn from are computed before the simulation starts, they complete the
+// snapshot.
+class RenderSnapshot
+{
+public:
+  // The nearby target the player has selected, drawn with a reticle around it.
+  struct Target
+  {
+    EntityID eid;
+
+    // The size of the reticle, it grows to 1.0 after the target was selected.
+    float scale;
+
+    int player_level, target_level;
+  };
+
+  // A camera a pass is drawn from.
+  struct View
+  {
+    glm::vec3      position;
+    CameraMatrices matrices;
+  };
+
+private:
+  std::tuple<ComponentCopy<Transform>, ComponentCopy<WorldMatrix>, ComponentCopy<PointLight>>
+                        components_;
+  std::optional<Target> target_;
+
+public:
+  RenderSnapshot() = default;
+  NOCOPY_MOVE_DEFAULT(RenderSnapshot);
+
+  // The camera the water's reflection is drawn from (beneath the water), when the advanced water
+  // is drawn. Set by PerspectiveRenderer::prepare().
+  View reflection = {};
+
+  // Copy the components the simulation writes, and the selected target.
+  void build(EntityRegistry&, NearbyTargets const&, FrameTime const&);
+
+  template <typename T>
+  bool has(EntityID const eid) const
+  {
+    static_assert(IsSnapshotComponent<T>::value, "Only IsSnapshotComponent's are copied.");
+    return std::get<ComponentCopy<T>>(components_).has(eid);
+  }
+
+  template <typename T>
+  T const& get(EntityID const eid) const
+  {
+    static_assert(IsSnapshotComponent<T>::value, "Only IsSnapshotComponent's are copied.");
+    return std::get<ComponentCopy<T>>(components_).get(eid);
+  }
+
+  auto const& target() const { return target_; }
+};
+
+} // namespace boomhs
@@ -1,4 +1,6 @@
 #pragma once
+#include <boomhs/random.hpp>
+
 #include <opengl/debug_renderer.hpp>
 #include <opengl/entity_renderer.hpp>
 #include <opengl/renderer.hpp>
@@ -20,7 +22,6 @@ namespace boomhs
 class Camera;
 class FrameTime;
 class LevelManager;
-class RNG;
 struct ZoneState;
 
 
@@ -43,6 +44,10 @@ struct StaticRenderers
 
   opengl::static_shaders::BasicMvWithUniformColor color2d;
 
+  // The renderers' own generator (ie: torch flicker), the game's generator belongs to the
+  // simulation stepping while the frame is drawn.
+  RNG rng;
+
   void render(LevelManager&, opengl::RenderState&, Camera&, RNG&, opengl::DrawState&,
               FrameTime const&, bool);
 };
@@ -0,0 +1,80 @@
+#pragma once
+#include <common/log.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/glm.hpp>
+
+namespace common
+{
+class FrameArena;
+} // namespace common
+
+namespace boomhs
+{
+class EntityRegistry;
+class FrameTime;
+class NearbyTargets;
+class RNG;
+class TerrainGrid;
+
+struct MovementState
+{
+  glm::vec3 forward, backward, left, right;
+
+  glm::vec3 mouse_forward;
+
+  NO_COPY_OR_MOVE(MovementState);
+};
+
+// The parts of a zone the simulation reads and writes.
+struct SimulationZone
+{
+  EntityRegistry& registry;
+  TerrainGrid&    terrain;
+  NearbyTargets&  nearby_targets;
+};
+
+// What the player (or whatever is driving the simulation) asks for this tick.
+struct SimulationInput
+{
+  MovementState const& movement;
+
+  // Walking off one edge of the terrain brings the player back on the opposite edge.
+  bool mariolike_edges;
+
+  bool update_orbital_bodies;
+};
+
+// Gameplay systems that only operate on the EntityRegistry.
+//
+// Nothing in here may depend on OpenGL, SDL or OpenAL; the same systems run inside the game and
+// inside the headless simulation (tools/headless_simulation.cxx).
+class Simulation
+{
+  Simulation() = delete;
+
+public:
+  // Move every OrbitalBody along it's orbit around the world origin.
+  static void update_orbital_bodies(EntityRegistry&, FrameTime const&);
+
+  // Keep every living NPC standing on top of the terrain.
+  static void update_npc_positions(common::Logger&, EntityRegistry&, TerrainGrid&);
+
+  // Sort the enemies the player can select by their distance to the player.
+  static void update_nearby_targets(NearbyTargets&, EntityRegistry&, common::FrameArena&);
+
+  // Animate the color and flicker speed of every Torch's light.
+  static void update_torchflicker(EntityRegistry&, common::FrameArena&, RNG&, FrameTime const&);
+
+  // The per-frame gameplay: NPCs, nearby targets, the player (movement and combat), the entity
+  // hierarchy and the torches, in that order.
+  static void update(common::Logger&, SimulationZone&, SimulationInput const&, common::FrameArena&,
+                     RNG&, FrameTime const&);
+
+  // Advance the simulation a single tick; the orbital bodies (if the input asks for it) and
+  // update() followed by the TransformSystem.
+  static void tick(common::Logger&, SimulationZone&, SimulationInput const&, common::FrameArena&,
+                   RNG&, FrameTime const&);
+};
+
+} // namespace boomhs
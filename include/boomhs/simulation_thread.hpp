@@ -0,0 +1,53 @@
+#pragma once
+#include <common/frame_arena.hpp>
+#include <common/type_macros.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace boomhs
+{
+
+// Runs the simulation's steps on a thread of its own, so a step overlaps drawing the previous
+// frame from its RenderSnapshot.
+//
+// One step runs at a time: start() hands the thread a step and returns, wait() blocks until the
+// step has finished. Until then the caller must not touch what the step writes. Steps allocate
+// their per-frame containers from the thread's own FrameArena (reset after every step), the frame
+// arena of the EngineState is only used by the frame thread.
+class SimulationThread
+{
+public:
+  using Step = std::function<void(common::FrameArena&)>;
+
+private:
+  common::FrameArena arena_;
+
+  // The step to run, empty once it has finished. Guarded by "mutex_".
+  Step step_;
+  bool stop_ = false;
+
+  // The thread waits on "started_" for the next step, "finished_" is signalled after every step.
+  std::mutex              mutex_;
+  std::condition_variable started_;
+  std::condition_variable finished_;
+
+  std::thread thread_;
+
+  void run();
+
+public:
+  NO_COPY_OR_MOVE(SimulationThread);
+  explicit SimulationThread(size_t);
+  ~SimulationThread();
+
+  // Run the step on the thread. The previous step must have been waited for.
+  void start(Step&&);
+
+  // Block until the step started last has finished, returns immediately if no step is running.
+  void wait();
+};
+
+} // namespace boomhs
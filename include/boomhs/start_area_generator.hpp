@@ -2,11 +2,6 @@
 #include <boomhs/leveldata.hpp>
 #include <common/log.hpp>
 
-namespace opengl
-{
-class TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
 class  EntityRegistry;
@@ -16,8 +11,8 @@ struct WorldOrientation;
 struct StartAreaGenerator
 {
   static LevelGeneratedData
-  gen_level(common::Logger&, EntityRegistry&, RNG&, opengl::ShaderPrograms&, opengl::TextureTable&,
-            MaterialTable const&, Heightmap const&, WorldOrientation const&);
+  gen_level(common::Logger&, EntityRegistry&, RNG&, MaterialTable const&, Heightmap const&,
+            WorldOrientation const&);
 
   StartAreaGenerator() = delete;
 };
@@ -2,6 +2,7 @@
 #include <boomhs/audio.hpp>
 #include <boomhs/level_manager.hpp>
 #include <boomhs/scene_renderer.hpp>
+#include <boomhs/zone_streamer.hpp>
 #include <optional>
 
 namespace boomhs
@@ -12,21 +13,23 @@ class GameState
 {
   EngineState& es_;
   LevelManager lm_;
+  ZoneStreamer streamer_;
   WaterAudioSystem was_;
 
   std::optional<StaticRenderers> renderers_;
 public:
   MOVE_CONSTRUCTIBLE_ONLY(GameState);
 
-  explicit GameState(EngineState&, LevelManager&&, WaterAudioSystem&&);
+  explicit GameState(EngineState&, LevelManager&&, ZoneStreamer&&, WaterAudioSystem&&);
 
   void set_renderers(StaticRenderers&& sr)
   {
-    renderers_ = std::make_optional(MOVE(sr));
+    renderers_.emplace(MOVE(sr));
   }
 
   auto& engine_state() { return es_; }
   auto& level_manager() { return lm_; }
+  auto& zone_streamer() { return streamer_; }
   auto& water_audio() { return was_; }
 
   auto& static_renderers()
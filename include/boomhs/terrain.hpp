@@ -1,23 +1,20 @@
 #pragma once
 #include <boomhs/heightmap.hpp>
-#include <opengl/draw_info.hpp>
+#include <boomhs/obj.hpp>
 
 #include <common/algorithm.hpp>
 #include <common/log.hpp>
 #include <common/type_macros.hpp>
 
+#include <opengl/texture_handle.hpp>
+
+#include <extlibs/glew.hpp>
 #include <extlibs/glm.hpp>
 
 #include <array>
 #include <functional>
 #include <vector>
 
-namespace opengl
-{
-class ShaderProgram;
-class TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
 
@@ -49,31 +46,33 @@ struct TerrainConfig
   std::string to_string() const;
 };
 
+// The CPU side of a piece of terrain, the renderer keeps it's mesh on the GPU (see
+// opengl::DrawHandleManager::upload_terrain()).
 class Terrain
 {
-  glm::vec2              pos_;
-  opengl::DrawInfo       di_;
-  opengl::ShaderProgram* sp_;
+  glm::vec2 pos_;
 
 public:
   NO_COPY(Terrain);
   MOVE_DEFAULT(Terrain);
 
-  Terrain(TerrainConfig const&, glm::vec2 const&, opengl::DrawInfo&&, opengl::ShaderProgram&,
-          Heightmap&&);
+  Terrain(TerrainConfig const&, glm::vec2 const&, Heightmap&&);
 
   // public members
   TerrainConfig       config;
   Heightmap           heightmap;
   TerrainTextureNames bound_textures;
 
-  auto&       draw_info() { return di_; }
+  // The handles of the bound textures, in the same order (see LevelLoader::resolve_textures()).
+  std::vector<opengl::TextureHandle> texture_handles;
+
   auto const& position() const { return pos_; }
 
   std::string&       texture_name(size_t);
   std::string const& texture_name(size_t) const;
 
-  auto&       shader() { return *sp_; }
+  opengl::TextureHandle texture_handle(size_t) const;
+
   std::string to_string() const;
 };
 
@@ -177,15 +176,17 @@ visit_each(TerrainGrid const& tgrid, FN const& fn, Args&&... args)
 namespace boomhs::terrain
 {
 
+// The vertices, normals, uvs and indices of the terrain piece's mesh.
+ObjData
+generate_data(common::Logger&, TerrainGridConfig const&, Terrain const&);
+
 Terrain
-generate_piece(common::Logger&, glm::vec2 const&, TerrainGridConfig const&, TerrainConfig const&,
-               Heightmap const&, opengl::ShaderProgram&);
+generate_piece(common::Logger&, glm::vec2 const&, TerrainConfig const&, Heightmap const&);
+
 TerrainGrid
-generate_grid(common::Logger&, TerrainConfig const&, Heightmap const&, opengl::ShaderProgram&,
-              TerrainGrid const&);
+generate_grid(common::Logger&, TerrainConfig const&, Heightmap const&, TerrainGrid const&);
 
 TerrainGrid
-generate_grid(common::Logger&, TerrainGridConfig const&, TerrainConfig const&, Heightmap const&,
-              opengl::ShaderProgram&);
+generate_grid(common::Logger&, TerrainGridConfig const&, TerrainConfig const&, Heightmap const&);
 
 } // namespace boomhs::terrain
@@ -210,6 +210,30 @@ struct Transform
 };
 #undef DECLARE_TRANSFORM_COMMON_MEMBER_FUNCTIONS
 
+// Cached result of Transform::model_matrix().
+//
+// Every entity with a Transform is automatically given a WorldMatrix by the EntityRegistry. The
+// cached value is only recomputed (by TransformSystem) when the entity's translation, rotation
+// or scale differ from the values the matrix was last computed from.
+struct WorldMatrix
+{
+  glm::mat4 value;
+
+  // The Transform values "value" was computed from.
+  glm::vec3 translation;
+  glm::quat rotation;
+  glm::vec3 scale;
+
+  // Starts out dirty, so the first update always computes the matrix.
+  WorldMatrix();
+
+  bool is_dirty(Transform const&) const;
+  void recompute(Transform const&);
+
+  // Cache a matrix already computed for the transform (see TransformSystem::update_hierarchy).
+  void assign(Transform const&, glm::mat4 const&);
+};
+
 } // namespace boomhs
 
 namespace boomhs::transform
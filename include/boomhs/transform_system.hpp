@@ -0,0 +1,33 @@
+#pragma once
+
+namespace boomhs
+{
+class EntityRegistry;
+
+class TransformSystem
+{
+  TransformSystem() = delete;
+
+public:
+  // Recompute the world Transform of every entity with a Parent component, from it's parent's world
+  // transform and it's local transform.
+  //
+  // The registry keeps the hierarchy flattened into packed local/world matrix arrays, ordered so
+  // parents always precede their children (the order is only rebuilt after a Parent is assigned or
+  // removed). The world matrices are propagated in a single linear pass over those arrays, without
+  // allocating, and the children's WorldMatrix is written along with their Transform. Entities in
+  // a parent cycle, or whose parent was destroyed, are skipped.
+  //
+  // Must run after the simulation moves entities, and before update_world_matrices().
+  static void update_hierarchy(EntityRegistry&);
+
+  // Recompute the cached WorldMatrix of every entity whose Transform changed since the last
+  // update.
+  //
+  // Called once per frame after the simulation has run and before anything is rendered, so every
+  // consumer of the model matrix (renderers, raycasting, ...) reads the cached value instead of
+  // recomputing it.
+  static void update_world_matrices(EntityRegistry&);
+};
+
+} // namespace boomhs
@@ -64,8 +64,9 @@ class Tree
   Tree() = delete;
 
 public:
-  static void
-  update_colors(common::Logger&, opengl::VertexAttribute const&, opengl::DrawInfo&, TreeComponent&);
+  // Write the tree entity's colors into it's mesh (and the mesh's LODs), and their GPU buffers.
+  static void update_colors(common::Logger&, opengl::VertexAttribute const&,
+                            opengl::DrawHandleManager&, ObjStore&, EntityRegistry&, EntityID);
 
   // static std::pair<EntityID, opengl::DrawInfo>
   // add_toregistry(common::Logger&, EntityID, ObjStore&, opengl::ShaderPrograms&, EntityRegistry&);
@@ -6,6 +6,8 @@
 #include <common/type_macros.hpp>
 
 #include <array>
+#include <cstdint>
+#include <optional>
 
 namespace boomhs
 {
@@ -76,11 +78,21 @@ struct LogBuffer
   int log_level = 2;
 };
 
+struct ProfilerBuffer
+{
+  // The frame shown in the flame view, the latest frame when not set.
+  std::optional<uint64_t> selected_frame;
+
+  // Show the spike frames, instead of the recent frames.
+  bool show_spikes = false;
+};
+
 struct Buffers
 {
   AudioUiBuffer  audio;
   DrawTimeBuffer draw_time_window;
   LogBuffer      log;
+  ProfilerBuffer profiler;
   SkyboxBuffer   skybox;
   TerrainBuffer  terrain;
   WaterBuffer    water;
@@ -109,9 +121,10 @@ struct UiDebugState
   bool show_environment_window = false;
   bool show_devicewindow       = false;
 
-  bool show_playerwindow = false;
-  bool show_skyboxwindow = false;
-  bool show_time_window  = false;
+  bool show_playerwindow    = false;
+  bool show_profiler_window = false;
+  bool show_skyboxwindow    = false;
+  bool show_time_window     = false;
 
   bool show_terrain_editor_window = false;
   bool show_water_window          = false;
@@ -0,0 +1,104 @@
+#pragma once
+#include <boomhs/entity.hpp>
+
+#include <common/type_macros.hpp>
+#include <extlibs/glm.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace boomhs
+{
+class OcclusionBuffer;
+
+// The cameras a frame's entities are drawn from.
+//
+// The water refraction and sunshaft silhouette passes are drawn from the main camera, so they share
+// it's visible set.
+enum class VisibilityPass
+{
+  Camera = 0,
+  Reflection,
+
+  MAX
+};
+
+// The groups the entity renderers draw entities in, in drawing order. An entity belongs to every
+// group it has the components of.
+enum class RenderBucket
+{
+  Torch = 0,
+  Book,
+  Weapon,
+  Junk,
+  Tree,
+  Pointlight,
+  NPC,
+  Player,
+  OrbitalBody,
+
+  MAX
+};
+
+// The entities one pass draws, already culled, as a compact list of ids per bucket.
+class VisibleSet
+{
+  std::array<EntityArray, static_cast<size_t>(RenderBucket::MAX)> buckets_;
+
+public:
+  VisibleSet() = default;
+  MOVE_DEFAULT(VisibleSet);
+  NO_COPY(VisibleSet);
+
+  auto const& bucket(RenderBucket const b) const { return buckets_[static_cast<size_t>(b)]; }
+  auto&       bucket(RenderBucket const b) { return buckets_[static_cast<size_t>(b)]; }
+
+  // The number of entities in every bucket.
+  size_t size() const;
+
+  void clear();
+};
+
+// Culls the entities once per frame for every pass, instead of each pass walking the registry and
+// culling every entity again.
+//
+// Each entity is classified (which buckets it belongs to) and it's bounding sphere computed once,
+// then tested against each active pass' frustum (and the occlusion buffer, for the main camera).
+// The visible entities are appended to the buckets of that pass' VisibleSet.
+//
+// The LOD of the entities the main camera sees is picked here too (see MeshLodState), so every
+// pass draws the same LOD and the LOD's hysteresis advances once per frame.
+class Visibility
+{
+  struct Pass
+  {
+    glm::mat4  view, proj;
+    bool       active = false;
+    VisibleSet visible;
+  };
+  std::array<Pass, static_cast<size_t>(VisibilityPass::MAX)> passes_;
+
+  Pass&       pass(VisibilityPass const p) { return passes_[static_cast<size_t>(p)]; }
+  Pass const& pass(VisibilityPass const p) const { return passes_[static_cast<size_t>(p)]; }
+
+public:
+  Visibility() = default;
+  MOVE_DEFAULT(Visibility);
+  NO_COPY(Visibility);
+
+  // Forget last frame's passes.
+  void begin();
+
+  // Cull for the pass, drawn from the camera (view and projection matrices) this frame.
+  void add_pass(VisibilityPass, glm::mat4 const&, glm::mat4 const&);
+
+  // Walk the entities once, filling the visible set of every pass added since begin().
+  //
+  // Every mesh is drawn at LOD 0 when "mesh_lods" is false.
+  void build(EntityRegistry&, OcclusionBuffer&, bool mesh_lods);
+
+  // The pass' visible set, nullptr if the pass wasn't added this frame.
+  VisibleSet const* find(VisibilityPass) const;
+};
+
+} // namespace boomhs
@@ -10,25 +10,13 @@
 #include <array>
 #include <extlibs/glm.hpp>
 
-namespace opengl
-{
-class  DrawInfo;
-class  ShaderPrograms;
-struct TextureInfo;
-class  TextureTable;
-} // namespace opengl
-
 namespace boomhs
 {
 class EntityRegistry;
 
-opengl::ShaderProgram&
-graphics_mode_to_water_shader(common::Logger&, boomhs::GameGraphicsMode, opengl::ShaderPrograms&);
-
 struct WaterInfo
 {
-  EntityID             eid;
-  opengl::TextureInfo* tinfo = nullptr;
+  EntityID eid;
 
   glm::vec2    dimensions;
   unsigned int num_vertexes;
@@ -51,8 +39,8 @@ struct WaterFactory
 {
   static ObjData generate_water_data(common::Logger&, glm::vec2 const&, size_t);
 
-  static WaterInfo& make_default(common::Logger&, opengl::ShaderPrograms&, opengl::TextureTable&,
-                                 EntityID, EntityRegistry&);
+  // The water's texture and GPU buffers are set up with the rest of the zone's GPU data.
+  static WaterInfo& make_default(common::Logger&, EntityID, EntityRegistry&);
 };
 
 } // namespace boomhs
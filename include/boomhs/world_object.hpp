@@ -9,7 +9,6 @@
 
 namespace boomhs
 {
-class Camera;
 
 struct WorldOrientation
 {
@@ -52,6 +51,9 @@ public:
 
   std::string display() const;
 
+  EntityID                eid() const { return eid_; }
+  WorldOrientation const& world_orientation() const { return *world_orientation_; }
+
   Transform&       transform() { return registry_->get<Transform>(eid_); }
   Transform const& transform() const { return registry_->get<Transform>(eid_); }
 
@@ -61,7 +63,8 @@ public:
   WorldObject& move(glm::vec3 const&);
 
   void rotate_degrees(float const, math::EulerAxis);
-  void rotate_to_match_camera_rotation(Camera const&);
+  // Takes the camera's Camera::eye_forward().
+  void rotate_to_match_camera_rotation(glm::vec3 const&);
 
   void move_to(glm::vec3 const& pos) { transform().translation = pos; }
   void move_to(float const x, float const y, float const z) { move_to(glm::vec3{x, y, z}); }
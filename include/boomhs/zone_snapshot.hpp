@@ -0,0 +1,55 @@
+#pragma once
+#include <boomhs/entity.hpp>
+#include <common/binary_io.hpp>
+#include <common/log.hpp>
+#include <common/result.hpp>
+
+#include <string>
+
+namespace boomhs
+{
+class  LevelData;
+struct ZoneState;
+
+// Binary snapshots of a zone's gameplay state, used for save games.
+//
+// A snapshot holds the LevelData's runtime values (fog, wind, lighting, ...) and the zone's
+// EntityRegistry stored one component column at a time; each column is the pool's entity array
+// followed by the pool's components. Columns of POD components are written and read with a single
+// memcpy, so saving and loading is bound by memory bandwidth instead of per-entity work.
+//
+// Only the gameplay state is part of a snapshot. Components that own runtime resources (GPU
+// buffers, texture pointers, references into the GameState, ...) are created when the zone is
+// loaded and are left as they are; the snapshot holds the names they are looked up by instead
+// (NPC names are stored as their index in NPC::NAMES). A snapshot is therefore always loaded into
+// the (already loaded) zone it was taken from.
+//
+// Loading restores the zone's entities to the ones alive when the snapshot was taken: entities
+// created since are destroyed, and entities destroyed since are created again (under new entity
+// id's). The whole snapshot is decoded and checked before the zone is modified, a snapshot that
+// fails to load leaves the zone untouched.
+class ZoneSnapshot
+{
+  ZoneSnapshot() = delete;
+
+public:
+  using Buffer = common::ByteBuffer;
+
+  // The zone's LevelData and EntityRegistry only (no GfxState is needed).
+  //
+  // Yields the entities that were created again, they have no GPU resources or resolved textures.
+  static Buffer save(LevelData const&, EntityRegistry const&);
+  static Result<EntityArray, std::string> load(common::Logger&, LevelData&, EntityRegistry&,
+                                               Buffer const&);
+
+  // The functions below also give the entities created again their GPU resources
+  // (zone_snapshot_gl.cxx).
+  static Buffer save(ZoneState&);
+  static Result<common::none_t, std::string> load(common::Logger&, ZoneState&, Buffer const&);
+
+  static Result<common::none_t, std::string> save_to_file(ZoneState&, std::string const&);
+  static Result<common::none_t, std::string> load_from_file(common::Logger&, ZoneState&,
+                                                            std::string const&);
+};
+
+} // namespace boomhs
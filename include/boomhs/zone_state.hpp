@@ -3,13 +3,18 @@
 #include <boomhs/level_loader.hpp>
 #include <boomhs/leveldata.hpp>
 #include <boomhs/nearby_targets.hpp>
+#include <boomhs/occlusion.hpp>
+#include <boomhs/render_snapshot.hpp>
+#include <boomhs/visibility.hpp>
 #include <boomhs/world_object.hpp>
 
 #include <boomhs/color.hpp>
 #include <boomhs/lighting.hpp>
 #include <opengl/draw_info.hpp>
+#include <opengl/gpu_residency.hpp>
 #include <opengl/shader.hpp>
 #include <opengl/texture.hpp>
+#include <opengl/uniform_buffer.hpp>
 #include <optional>
 #include <vector>
 
@@ -19,8 +24,19 @@ namespace boomhs
 struct GfxState
 {
   opengl::DrawHandleManager draw_handles;
+  opengl::GpuResidency      residency;
   opengl::ShaderPrograms    sps;
   opengl::TextureTable      texture_table;
+  opengl::UniformBlocks     uniform_blocks;
+
+  // The occluders seen by the camera this frame.
+  OcclusionBuffer occlusion;
+
+  // The entities each pass draws this frame.
+  Visibility visibility;
+
+  // The state the frame is drawn from, while the simulation updates the registry.
+  RenderSnapshot snapshot;
 
   explicit GfxState(opengl::ShaderPrograms&& sp, opengl::TextureTable&& tt)
       : sps(MOVE(sp))
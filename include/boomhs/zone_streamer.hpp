@@ -0,0 +1,129 @@
+#pragma once
+#include <boomhs/level_loader.hpp>
+#include <boomhs/world_object.hpp>
+
+#include <common/result.hpp>
+#include <common/type_macros.hpp>
+
+#include <cstdint>
+#include <future>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace boomhs
+{
+struct Engine;
+struct EngineState;
+class  LevelManager;
+
+// How far copying a zone to the GPU got, see upload_zone_gpu().
+struct ZoneUpload
+{
+  // The zone's entities, taken when the upload starts.
+  std::vector<EntityID> eids;
+
+  size_t num_entities = 0;
+  size_t num_terrain  = 0;
+  bool   started      = false;
+};
+
+// Loads zones (floors) into a LevelManager ahead of time, and unloads the least recently used ones.
+//
+// The floors next to the active floor are preloaded, so switching floors doesn't wait on loading:
+//   1. The level's files are read and parsed on a background thread (LevelLoader::read_level).
+//   2. The OpenGL work is then done on the main thread, one step per frame (see update()). The
+//      zone's entities and terrain are copied to the GPU a few at a time, over many frames.
+//
+// Once the (estimated) memory used by the loaded zones exceeds the memory budget, the least
+// recently used zones are unloaded. The active zone is never unloaded.
+//
+// Every floor is generated with it's own RNG, seeded from the game's seed and the floor number, so
+// the floors don't depend on when they finished loading.
+class ZoneStreamer
+{
+public:
+  static size_t constexpr DEFAULT_MEMORY_BUDGET = 512 * 1024 * 1024;
+
+  // The entities (or terrain pieces) copied to the GPU by one UPLOAD step.
+  static size_t constexpr UPLOADS_PER_STEP = 16;
+
+private:
+  using ReadResult = Result<LevelSource, std::string>;
+
+  // The steps of loading a zone done on the main thread, one per frame.
+  enum class LoadStep
+  {
+    INSTANTIATE = 0, // upload the shaders and textures, create the level's entities
+    GENERATE,        // generate the terrain and the rest of the floor
+    UPLOAD           // copy the entities to the GPU, over as many steps as it takes
+  };
+
+  struct PendingZone
+  {
+    int                        floor;
+    LoadStep                   step = LoadStep::INSTANTIATE;
+    std::future<ReadResult>    read;
+    std::optional<LevelAssets> assets;
+    ZoneUpload                 upload;
+  };
+  using PendingIterator = std::list<PendingZone>::iterator;
+
+  struct LoadedZone
+  {
+    int    floor;
+    size_t num_bytes;
+  };
+
+  WorldOrientation wo_;
+  uint64_t         seed_;
+  size_t           memory_budget_;
+
+  std::list<PendingZone> pending_;
+
+  // Least recently used first.
+  std::vector<LoadedZone> loaded_;
+
+  // Floors that have no level, or failed to load.
+  std::vector<int> unavailable_;
+
+  PendingIterator find_pending(int);
+  bool            is_pending(int) const;
+  bool            is_unavailable(int) const;
+  void            start_reading(common::Logger&, int, std::launch);
+
+  Result<bool, std::string> step(EngineState&, Engine&, LevelManager&, PendingZone&);
+
+  // Do the next step of loading the zone, returns whether the zone finished loading.
+  Result<bool, std::string> advance(EngineState&, Engine&, LevelManager&, PendingIterator);
+
+  void touch(int);
+  void evict(EngineState&, Engine&, LevelManager&);
+
+public:
+  MOVE_CONSTRUCTIBLE_ONLY(ZoneStreamer);
+  explicit ZoneStreamer(WorldOrientation const&, uint64_t, size_t = DEFAULT_MEMORY_BUDGET);
+
+  auto memory_budget() const { return memory_budget_; }
+  void set_memory_budget(size_t const bytes) { memory_budget_ = bytes; }
+
+  size_t memory_used() const;
+  bool   is_ready(LevelManager const&, int) const;
+
+  // Start loading the floor in the background, unless it's already loaded or loading.
+  void preload(EngineState&, LevelManager const&, int);
+  void preload_neighbours(EngineState&, LevelManager const&);
+
+  // Do the next step of loading one of the preloading floors. Call once per frame.
+  void update(EngineState&, Engine&, LevelManager&);
+
+  // Finish loading the floor right now, blocking until it's loaded.
+  Result<common::none_t, std::string> load_now(EngineState&, Engine&, LevelManager&, int);
+
+  // Make the floor the active zone, loading it first if it isn't ready, then start preloading
+  // it's neighbours and unload zones over the memory budget.
+  Result<common::none_t, std::string> make_active(EngineState&, Engine&, LevelManager&, int);
+};
+
+} // namespace boomhs
@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace common
+{
+
+using ByteBuffer = std::vector<uint8_t>;
+
+// Appends trivially copyable values (and strings) to a ByteBuffer, in native endianness.
+class ByteWriter
+{
+  ByteBuffer& buffer_;
+
+public:
+  explicit ByteWriter(ByteBuffer& b)
+      : buffer_(b)
+  {
+  }
+
+  auto size() const { return buffer_.size(); }
+
+  void write_bytes(void const* src, size_t const num_bytes)
+  {
+    auto const* bytes = static_cast<uint8_t const*>(src);
+    buffer_.insert(buffer_.end(), bytes, bytes + num_bytes);
+  }
+
+  template <typename T>
+  void write(T const& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+    write_bytes(&value, sizeof(T));
+  }
+
+  void write_string(std::string const& value)
+  {
+    write(static_cast<uint32_t>(value.size()));
+    write_bytes(value.data(), value.size());
+  }
+
+  // Overwrite a value written earlier, at the given offset.
+  template <typename T>
+  void patch(size_t const offset, T const& value)
+  {
+    std::memcpy(buffer_.data() + offset, &value, sizeof(T));
+  }
+};
+
+// Reads values written by a ByteWriter back out of a buffer.
+//
+// Every read checks the remaining size of the buffer and returns false instead of reading past the
+// end of the buffer.
+class ByteReader
+{
+  uint8_t const* pos_;
+  uint8_t const* end_;
+
+public:
+  explicit ByteReader(ByteBuffer const& b)
+      : pos_(b.data())
+      , end_(b.data() + b.size())
+  {
+  }
+
+  auto const* position() const { return pos_; }
+  size_t      remaining() const { return end_ - pos_; }
+
+  bool skip(size_t const num_bytes)
+  {
+    if (remaining() < num_bytes) {
+      return false;
+    }
+    pos_ += num_bytes;
+    return true;
+  }
+
+  bool read_bytes(void* dst, size_t const num_bytes)
+  {
+    if (remaining() < num_bytes) {
+      return false;
+    }
+    std::memcpy(dst, pos_, num_bytes);
+    pos_ += num_bytes;
+    return true;
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+    return read_bytes(&value, sizeof(T));
+  }
+
+  // Bools are written as a single byte, anything but 0 or 1 means the buffer is corrupt.
+  bool read_bool(bool& value)
+  {
+    uint8_t byte = 0;
+    if (!read(byte) || byte > 1) {
+      return false;
+    }
+    value = (1 == byte);
+    return true;
+  }
+
+  // Read the number of elements that follow, each at least "min_bytes" long. The count comes from
+  // the buffer, so it's checked against the bytes left before the caller allocates for it.
+  bool read_count(uint32_t& count, size_t const min_bytes)
+  {
+    return read(count) && (remaining() / min_bytes) >= count;
+  }
+
+  bool read_string(std::string& value)
+  {
+    uint32_t length = 0;
+    if (!read(length) || remaining() < length) {
+      return false;
+    }
+    value.assign(reinterpret_cast<char const*>(pos_), length);
+    pos_ += length;
+    return true;
+  }
+};
+
+// Read the entire contents of a file into a buffer.
+inline bool
+read_file_bytes(std::string const& path, ByteBuffer& buffer)
+{
+  std::ifstream file{path, std::ios::in | std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+  return true;
+}
+
+// Read the entire contents of a (text) file into a string.
+inline bool
+read_file_text(std::string const& path, std::string& text)
+{
+  std::ifstream file{path, std::ios::in | std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  text.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+  return true;
+}
+
+// Replace the contents of a file with the contents of the buffer.
+inline bool
+write_file_bytes(std::string const& path, ByteBuffer const& buffer)
+{
+  std::ofstream file{path, std::ios::out | std::ios::binary | std::ios::trunc};
+  return file && file.write(reinterpret_cast<char const*>(buffer.data()), buffer.size());
+}
+
+} // namespace common
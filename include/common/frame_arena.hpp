@@ -0,0 +1,92 @@
+#pragma once
+#include <common/type_macros.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace common
+{
+
+// Linear ("bump") allocator for memory that only lives until the end of the current frame.
+//
+// Allocating is a pointer bump, deallocating individual allocations does nothing; all the memory is
+// reclaimed at once by reset(). Allocations that don't fit in the buffer fall back to the heap,
+// and the next reset() grows the buffer so the following frames fit.
+class FrameArena
+{
+  std::unique_ptr<std::byte[]> buffer_;
+  size_t                       capacity_;
+  size_t                       offset_ = 0;
+
+  // Heap allocations made this frame because the buffer was full, freed by reset().
+  std::vector<std::unique_ptr<std::byte[]>> overflow_;
+  size_t                                    overflow_bytes_ = 0;
+
+public:
+  NO_COPY_OR_MOVE(FrameArena);
+  explicit FrameArena(size_t);
+
+  void* allocate(size_t, size_t);
+
+  // Release every allocation made since the last reset. Any container still holding memory from
+  // the arena is invalid after this call.
+  void reset();
+
+  auto bytes_used() const { return offset_ + overflow_bytes_; }
+  auto capacity() const { return capacity_; }
+};
+
+// Standard allocator interface over a FrameArena, so standard containers can allocate from it.
+template <typename T>
+class FrameAllocator
+{
+  FrameArena* arena_;
+
+  template <typename U>
+  friend class FrameAllocator;
+
+public:
+  using value_type = T;
+
+  explicit FrameAllocator(FrameArena& arena)
+      : arena_(&arena)
+  {
+  }
+
+  template <typename U>
+  FrameAllocator(FrameAllocator<U> const& other)
+      : arena_(other.arena_)
+  {
+  }
+
+  T* allocate(size_t const n)
+  {
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) {}
+
+  template <typename U>
+  bool operator==(FrameAllocator<U> const& other) const
+  {
+    return arena_ == other.arena_;
+  }
+  template <typename U>
+  bool operator!=(FrameAllocator<U> const& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+// Convenience function for constructing an empty FrameVector.
+template <typename T>
+auto
+make_framevector(FrameArena& arena)
+{
+  return FrameVector<T>{FrameAllocator<T>{arena}};
+}
+
+} // namespace common
@@ -0,0 +1,354 @@
+#pragma once
+#include <common/type_macros.hpp>
+#include <extlibs/fmt.hpp>
+#include <extlibs/spdlog.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace common::impl
+{
+
+enum class LogLevel {
+  trace = 0,
+  debug,
+  info,
+  warn,
+  error,
+  MAX,
+};
+
+// The subsystem a log message is about, each category has it's own log level.
+enum class LogCategory {
+  general = 0,
+  render,
+  terrain,
+  collision,
+  io,
+  audio,
+  loader,
+  MAX,
+};
+
+auto constexpr NUM_LOG_CATEGORIES = static_cast<size_t>(LogCategory::MAX);
+
+// Flag controlling which fmt policy the logger uses.
+enum class FormatPolicy {
+  none = 0,
+  sprintf,
+  format
+};
+
+// What happens when a message is logged while the log queue is full.
+enum class OverflowPolicy {
+  block = 0,       // wait for the logging thread to make room
+  discard,         // drop the message
+  discard_verbose, // drop trace and debug messages, wait for room for the rest
+};
+
+// The type a log argument is copied as, so it can be formatted after the call returns.
+//
+// Character pointers and arrays are copied into a std::string, the memory they point to may not
+// outlive the call.
+template <typename T>
+using LogArgument =
+    std::conditional_t<std::is_same_v<std::decay_t<T>, char*> ||
+                           std::is_same_v<std::decay_t<T>, char const*>,
+                       std::string, std::decay_t<T>>;
+
+template <typename Message, typename... Args>
+std::string
+format_log_message(FormatPolicy const policy, Message const& msg, Args const&... args)
+{
+  switch (policy) {
+  case FormatPolicy::none:
+    // The message isn't a format string, any arguments are ignored.
+    return fmt::format("{}", msg);
+  case FormatPolicy::sprintf:
+    return fmt::sprintf(msg, args...);
+  case FormatPolicy::format:
+    return fmt::format(msg, args...);
+  default:
+    break;
+  }
+  std::abort();
+}
+
+// A single entry in the log queue.
+//
+// Holds either a control request for the logging thread, or a message whose arguments have been
+// copied into the record's inline storage. Formatting the message is left to the logging thread.
+class LogRecord
+{
+public:
+  enum class Kind {
+    message = 0,
+    flush,
+    stop
+  };
+
+  static size_t constexpr STORAGE_SIZE = 224;
+
+private:
+  template <typename... Args>
+  struct Arguments
+  {
+    std::tuple<Args...> values;
+
+    static std::string format(FormatPolicy const policy, void* p)
+    {
+      auto const fn = [&policy](auto const&... args) {
+        return format_log_message(policy, args...);
+      };
+      return std::apply(fn, static_cast<Arguments*>(p)->values);
+    }
+
+    static void destroy(void* p) { static_cast<Arguments*>(p)->~Arguments(); }
+  };
+
+  using FormatFN  = std::string (*)(FormatPolicy, void*);
+  using DestroyFN = void (*)(void*);
+
+  FormatFN  format_fn_  = nullptr;
+  DestroyFN destroy_fn_ = nullptr;
+
+  alignas(std::max_align_t) unsigned char storage_[STORAGE_SIZE];
+
+  template <typename... Args, typename... Params>
+  void emplace(Params&&... p)
+  {
+    using A = Arguments<Args...>;
+    new (storage_) A{std::tuple<Args...>{FORWARD(p)}};
+    format_fn_  = &A::format;
+    destroy_fn_ = &A::destroy;
+  }
+
+public:
+  Kind         kind   = Kind::message;
+  LogLevel     level  = LogLevel::trace;
+  FormatPolicy policy = FormatPolicy::none;
+
+  LogRecord() = default;
+  NO_COPY_OR_MOVE(LogRecord);
+  ~LogRecord() { reset(); }
+
+  template <typename... Params>
+  void set_message(LogLevel const l, FormatPolicy const fp, Params&&... p)
+  {
+    kind  = Kind::message;
+    level = l;
+
+    using A = Arguments<LogArgument<Params>...>;
+    if constexpr (sizeof(A) <= STORAGE_SIZE && alignof(A) <= alignof(std::max_align_t)) {
+      policy = fp;
+      emplace<LogArgument<Params>...>(FORWARD(p));
+    }
+    else {
+      // The arguments don't fit in the record, format them now instead.
+      policy = FormatPolicy::none;
+      emplace<std::string>(format_log_message(fp, p...));
+    }
+  }
+
+  void set_control(Kind const k) { kind = k; }
+
+  // Format the message, destroying the copied arguments.
+  std::string take_message()
+  {
+    auto message = format_fn_(policy, storage_);
+    reset();
+    return message;
+  }
+
+  void reset()
+  {
+    if (destroy_fn_) {
+      destroy_fn_(storage_);
+    }
+    format_fn_  = nullptr;
+    destroy_fn_ = nullptr;
+  }
+};
+
+// A bounded, lock-free, multiple producer multiple consumer queue of LogRecords.
+//
+// The records are pre-allocated and filled in place (D. Vyukov's bounded MPMC queue), so logging
+// doesn't allocate from the queue.
+class LogQueue
+{
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    LogRecord           record;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t                  mask_;
+
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+
+public:
+  NO_COPY_OR_MOVE(LogQueue);
+
+  // The capacity must be a power of two.
+  explicit LogQueue(size_t);
+
+  // Claim an empty record and pass it to "fill". Returns false (without calling "fill") if the
+  // queue is full.
+  template <typename FN>
+  bool try_push(FN&& fill)
+  {
+    Cell*  cell = nullptr;
+    size_t pos  = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell                = &cells_[pos & mask_];
+      auto const     seq  = cell->sequence.load(std::memory_order_acquire);
+      intptr_t const diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    fill(cell->record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // True if the oldest record hasn't been filled yet (or there isn't one).
+  bool empty() const
+  {
+    auto const pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  // Pass the oldest record to "consume", then release it. Returns false if the queue is empty.
+  template <typename FN>
+  bool try_pop(FN&& consume)
+  {
+    Cell*  cell = nullptr;
+    size_t pos  = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell                = &cells_[pos & mask_];
+      auto const     seq  = cell->sequence.load(std::memory_order_acquire);
+      intptr_t const diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    consume(cell->record);
+    cell->record.reset();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+// Logs through a spdlog logger on a background thread.
+//
+// Logging copies the message's arguments into the queue and returns, the logging thread formats
+// the message and writes it to the sinks. Errors wait for the logging thread to write them. Only the logging thread touches the spdlog logger
+// (except for set_level()), so it's sinks don't need to be thread-safe.
+class AsyncLogger
+{
+  LoggerPointer  logger_;
+  LogQueue       queue_;
+  OverflowPolicy overflow_;
+
+  std::array<std::atomic<int>, NUM_LOG_CATEGORIES> levels_;
+
+  std::atomic<uint64_t> num_discarded_{0};
+  std::atomic<uint64_t> flush_requests_{0};
+  std::atomic<uint64_t> flushes_done_{0};
+
+  // The logging thread waits on "wakeup_" once the queue is empty, "flushed_" is signalled after
+  // every flush.
+  std::mutex              mutex_;
+  std::condition_variable wakeup_;
+  std::condition_variable flushed_;
+  std::atomic<bool>       sleeping_{false};
+
+  std::thread thread_;
+
+  void push_control(LogRecord::Kind);
+  void wake();
+  void sleep();
+  void update_logger_level();
+  bool write(LogRecord&);
+  void run();
+
+public:
+  static size_t constexpr DEFAULT_QUEUE_SIZE = 8192;
+
+  NO_COPY_OR_MOVE(AsyncLogger);
+  explicit AsyncLogger(LoggerPointer&&, OverflowPolicy, size_t = DEFAULT_QUEUE_SIZE);
+  ~AsyncLogger();
+
+  bool should_log(LogCategory const category, LogLevel const level) const
+  {
+    auto const& category_level = levels_[static_cast<size_t>(category)];
+    return static_cast<int>(level) >= category_level.load(std::memory_order_relaxed);
+  }
+
+  // The caller is expected to check should_log() first, before evaluating the arguments.
+  //
+  // Errors are often followed by std::abort(), they're never discarded and have been written (and
+  // the sinks flushed) by the time this returns.
+  template <typename... Params>
+  void log(LogLevel const level, FormatPolicy const policy, Params&&... p)
+  {
+    bool const is_error    = level >= LogLevel::error;
+    bool const may_discard = !is_error && ((overflow_ == OverflowPolicy::discard) ||
+                                           (overflow_ == OverflowPolicy::discard_verbose &&
+                                            level <= LogLevel::debug));
+
+    auto const fill = [&](LogRecord& record) { record.set_message(level, policy, FORWARD(p)); };
+    while (!queue_.try_push(fill)) {
+      if (may_discard) {
+        num_discarded_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      std::this_thread::yield();
+    }
+    wake();
+
+    if (is_error) {
+      flush();
+    }
+  }
+
+  // Set the level of every category, or of a single category.
+  void set_level(spdlog::level::level_enum);
+  void set_level(LogCategory, spdlog::level::level_enum);
+
+  // Block until every message logged before the call has been written, and the sinks flushed.
+  void flush();
+};
+
+} // namespace common::impl
@@ -2,40 +2,28 @@
 #include <common/auto_resource.hpp>
 #include <common/compiler.hpp>
 #include <common/type_macros.hpp>
+#include <common/impl/async_log.hpp>
 #include <extlibs/fmt.hpp>
 
+#include <memory>
+
 namespace common::impl
 {
 
-enum class LogLevel {
-  trace = 0,
-  debug,
-  info,
-  warn,
-  error,
-  MAX,
-};
-
-// Flag controlling which fmt policy the logger uses.
-enum class FormatPolicy {
-  none = 0,
-  sprintf,
-  format
-};
-
 // Log adapter class.
 //
 // Adapts an underlying logger to the standard logging interface.
 //
-// It is assumed the value passed in has unique_ptr semantics.
+// Messages are handed to an AsyncLogger, which formats and writes them on it's own thread. Errors
+// have been written to the sinks by the time the call returns.
 class LogAdapter
 {
-  LoggerPointer logger_;
+  std::unique_ptr<AsyncLogger> logger_;
 
 public:
   MOVE_CONSTRUCTIBLE_ONLY(LogAdapter);
-  explicit LogAdapter(LoggerPointer &&logger)
-      : logger_(MOVE(logger))
+  explicit LogAdapter(LoggerPointer &&logger, OverflowPolicy const overflow)
+      : logger_(std::make_unique<AsyncLogger>(MOVE(logger), overflow))
   {
   }
 
@@ -44,23 +32,7 @@ public:
   auto&                                                                                            \
   macro_callmeonly_##FN_NAME(FormatPolicy const policy, Params &&... p)                            \
   {                                                                                                \
-    switch(policy) {                                                                               \
-      case FormatPolicy::none:                                                                     \
-        {                                                                                          \
-          auto const passthrough = [](auto const msg, auto &&...) { return msg; };                 \
-          this->logger_->FN_NAME(passthrough(FORWARD(p)));                                         \
-        }                                                                                          \
-        break;                                                                                     \
-      case FormatPolicy::sprintf:                                                                  \
-        this->logger_->FN_NAME(fmt::sprintf(FORWARD(p)));                                          \
-        break;                                                                                     \
-      case FormatPolicy::format:                                                                   \
-        this->logger_->FN_NAME(fmt::format(FORWARD(p)));                                           \
-        break;                                                                                     \
-      default:                                                                                     \
-        std::abort();                                                                              \
-        break;                                                                                     \
-    }                                                                                              \
+    this->logger_->log(LogLevel::FN_NAME, policy, FORWARD(p));                                     \
     return *this;                                                                                  \
   }
 
@@ -72,14 +44,25 @@ public:
 
 #undef DEFINE_LOG_ADAPTER_METHOD
 
+  bool should_log(LogCategory const category, LogLevel const level) const
+  {
+    return logger_->should_log(category, level);
+  }
+
   void set_level(spdlog::level::level_enum const level)
   {
     logger_->set_level(level);
   }
 
+  void set_level(LogCategory const category, spdlog::level::level_enum const level)
+  {
+    logger_->set_level(category, level);
+  }
+
   void destroy_impl()
   {
-    flush();
+    // Stops the logging thread, after it writes the remaining messages.
+    logger_.reset();
   }
 
   void flush()
@@ -116,11 +99,21 @@ public:
   DEFINE_LOGWRITER_FN(warn)
   DEFINE_LOGWRITER_FN(error)
 
+  bool should_log(LogCategory const category, LogLevel const level) const
+  {
+    return flusher_->should_log(category, level);
+  }
+
   void set_level(spdlog::level::level_enum const level)
   {
     flusher_->set_level(level);
   }
 
+  void set_level(LogCategory const category, spdlog::level::level_enum const level)
+  {
+    flusher_->set_level(category, level);
+  }
+
   void flush()
   {
     flusher_->flush();
@@ -1,5 +1,6 @@
 #pragma once
 #include <extlibs/spdlog.hpp>
+#include <iterator>
 #include <memory>
 
 // clang-format off
@@ -9,20 +10,67 @@
 #undef LOG_WARN
 #undef LOG_ERROR
 
+// The lowest level of the log messages compiled in, per category. Messages below it compile to
+// nothing, their arguments aren't even evaluated.
+//
+// LOG_MIN_LEVEL sets every category, LOG_MIN_LEVEL_<CATEGORY> overrides a single category.
+//   ie: -DLOG_MIN_LEVEL=warn -DLOG_MIN_LEVEL_LOADER=trace
+//
+// Optimized builds keep warnings and errors.
+#ifndef LOG_MIN_LEVEL
 #ifdef NDEBUG
-#define LOG_TRACE_IMPL(...)
-#define LOG_DEBUG_IMPL(...)
-#define LOG_INFO_IMPL(...)
-#define LOG_WARN_IMPL(...)
-#define LOG_ERROR_IMPL(...)
+#define LOG_MIN_LEVEL warn
 #else
-#define LOG_TRACE_IMPL(fmtpolicy, ...) logger.macro_callmeonly_trace(fmtpolicy, __VA_ARGS__)
-#define LOG_DEBUG_IMPL(fmtpolicy, ...) logger.macro_callmeonly_debug(fmtpolicy, __VA_ARGS__)
-#define LOG_INFO_IMPL(fmtpolicy, ...)  logger.macro_callmeonly_info(fmtpolicy, __VA_ARGS__)
-#define LOG_WARN_IMPL(fmtpolicy, ...)  logger.macro_callmeonly_warn(fmtpolicy, __VA_ARGS__)
-#define LOG_ERROR_IMPL(fmtpolicy, ...) logger.macro_callmeonly_error(fmtpolicy, __VA_ARGS__)
+#define LOG_MIN_LEVEL trace
+#endif
+#endif
+
+#ifndef LOG_MIN_LEVEL_GENERAL
+#define LOG_MIN_LEVEL_GENERAL LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_RENDER
+#define LOG_MIN_LEVEL_RENDER LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_TERRAIN
+#define LOG_MIN_LEVEL_TERRAIN LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_COLLISION
+#define LOG_MIN_LEVEL_COLLISION LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_IO
+#define LOG_MIN_LEVEL_IO LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_AUDIO
+#define LOG_MIN_LEVEL_AUDIO LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_LOADER
+#define LOG_MIN_LEVEL_LOADER LOG_MIN_LEVEL
 #endif
 
+// The category of the messages logged by the current file. A source file about a single subsystem
+// redefines it, after it's includes:
+//
+//   #undef  LOG_CATEGORY
+//   #define LOG_CATEGORY ::common::LogCategory::render
+#define LOG_CATEGORY ::common::LogCategory::general
+
+// Both the compile-time and the runtime level are checked before the arguments are evaluated.
+#define LOG_IMPL(LEVEL, fmtpolicy, ...)                                                            \
+  do {                                                                                             \
+    auto constexpr LOG_IMPL_level_ = ::common::impl::LogLevel::LEVEL;                              \
+    if constexpr (::common::impl::log_compiled_in(LOG_CATEGORY, LOG_IMPL_level_)) {                \
+      if (logger.should_log(LOG_CATEGORY, LOG_IMPL_level_)) {                                      \
+        logger.macro_callmeonly_##LEVEL(fmtpolicy, __VA_ARGS__);                                   \
+      }                                                                                            \
+    }                                                                                              \
+  } while (false)
+
+#define LOG_TRACE_IMPL(fmtpolicy, ...) LOG_IMPL(trace, fmtpolicy, __VA_ARGS__)
+#define LOG_DEBUG_IMPL(fmtpolicy, ...) LOG_IMPL(debug, fmtpolicy, __VA_ARGS__)
+#define LOG_INFO_IMPL(fmtpolicy, ...)  LOG_IMPL(info, fmtpolicy, __VA_ARGS__)
+#define LOG_WARN_IMPL(fmtpolicy, ...)  LOG_IMPL(warn, fmtpolicy, __VA_ARGS__)
+#define LOG_ERROR_IMPL(fmtpolicy, ...) LOG_IMPL(error, fmtpolicy, __VA_ARGS__)
+
 #define LOG_TRACE(...) LOG_TRACE_IMPL(::common::impl::FormatPolicy::none, __VA_ARGS__)
 #define LOG_DEBUG(...) LOG_DEBUG_IMPL(::common::impl::FormatPolicy::none, __VA_ARGS__)
 #define LOG_INFO(...)  LOG_INFO_IMPL(::common::impl::FormatPolicy::none, __VA_ARGS__)
@@ -49,9 +97,28 @@ using LoggerPointer = std::unique_ptr<spdlog::logger>;
 
 #include <common/impl/log_impl.hpp>
 
+namespace common::impl
+{
+
+LogLevel constexpr LOG_COMPILED_LEVELS[] = {
+    LogLevel::LOG_MIN_LEVEL_GENERAL, LogLevel::LOG_MIN_LEVEL_RENDER,
+    LogLevel::LOG_MIN_LEVEL_TERRAIN, LogLevel::LOG_MIN_LEVEL_COLLISION,
+    LogLevel::LOG_MIN_LEVEL_IO,      LogLevel::LOG_MIN_LEVEL_AUDIO,
+    LogLevel::LOG_MIN_LEVEL_LOADER};
+static_assert(std::size(LOG_COMPILED_LEVELS) == NUM_LOG_CATEGORIES);
+
+constexpr bool
+log_compiled_in(LogCategory const category, LogLevel const level)
+{
+  return level >= LOG_COMPILED_LEVELS[static_cast<size_t>(category)];
+}
+
+} // namespace common::impl
+
 namespace common
 {
-using Logger = ::common::impl::LogWriter;
+using Logger      = ::common::impl::LogWriter;
+using LogCategory = ::common::impl::LogCategory;
 
 struct LogFactory
 {
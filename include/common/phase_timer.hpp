@@ -0,0 +1,110 @@
+#pragma once
+#include <common/result.hpp>
+#include <common/type_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace common
+{
+
+struct PhaseTiming
+{
+  std::string name;
+
+  // How many phases this phase is nested inside of.
+  int depth = 0;
+
+  double   wall_ms    = 0.0;
+  double   cpu_ms     = 0.0;
+  uint64_t bytes_read = 0;
+};
+
+// Collects how long each phase of a long running operation (starting the game, loading a level,
+// ...) took.
+//
+// Phases are timed by ScopedPhase instances, and nest. A ScopedPhase records into the PhaseReport
+// installed on the current thread, so the code being timed doesn't need a reference to the report.
+// When no report is installed (ie: on the zone streamer's loading thread) nothing is recorded.
+class PhaseReport
+{
+  std::vector<PhaseTiming> phases_;
+  std::vector<size_t>      open_;
+
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  NOCOPY_MOVE_DEFAULT(PhaseReport);
+  PhaseReport();
+
+  auto const& phases() const { return phases_; }
+  double      total_ms() const;
+
+  size_t begin_phase(std::string&&);
+  void   end_phase(size_t, double, double);
+
+  // Count the bytes against every phase that is currently open.
+  void add_bytes_read(uint64_t);
+
+  std::string to_json() const;
+
+  // Compare the report against a baseline report (the to_json() output of an earlier run).
+  //
+  // Returns a description of every phase whose wall time grew by more than "tolerance" (a
+  // fraction, 0.2 == 20%) compared to the phase with the same name in the baseline.
+  Result<std::vector<std::string>, std::string> compare_to_baseline(std::string const&,
+                                                                    double) const;
+
+  static PhaseReport* installed();
+
+  // Install the report for the current thread, nullptr uninstalls it.
+  static void install(PhaseReport*);
+};
+
+// Record bytes read from disk into the installed PhaseReport, if there is one.
+void
+record_bytes_read(uint64_t);
+
+// Times a phase, from construction until destruction, into the installed PhaseReport.
+class ScopedPhase
+{
+  PhaseReport* report_;
+  size_t       index_ = 0;
+
+  std::chrono::steady_clock::time_point wall_start_;
+  double                                cpu_start_ms_ = 0.0;
+
+  void begin(std::string&&);
+
+public:
+  NO_COPY_OR_MOVE(ScopedPhase);
+
+  // "make_name" is only called while a report is installed, so no name is built for phases that
+  // aren't recorded.
+  template <typename FN>
+  explicit ScopedPhase(FN const& make_name)
+      : report_(PhaseReport::installed())
+  {
+    if (report_) {
+      begin(make_name());
+    }
+  }
+  ~ScopedPhase();
+};
+
+} // namespace common
+
+#define PHASE_TIMER_CONCAT_IMPL(VAR_NAME, COUNTER) VAR_NAME##COUNTER
+#define PHASE_TIMER_CONCAT(VAR_NAME, COUNTER) PHASE_TIMER_CONCAT_IMPL(VAR_NAME, COUNTER)
+
+// PHASE_TIMER
+//
+// Time the rest of the enclosing scope as a phase named "name". The name is only evaluated when a
+// PhaseReport is installed.
+#define PHASE_TIMER(name)                                                                          \
+  ::common::ScopedPhase PHASE_TIMER_CONCAT(_PHASE_TIMER_, __COUNTER__)                             \
+  {                                                                                                \
+    [&]() { return std::string{name}; }                                                            \
+  }
@@ -0,0 +1,112 @@
+#pragma once
+#include <common/result.hpp>
+#include <common/type_macros.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace common
+{
+
+// A single timed zone.
+struct ProfileEvent
+{
+  // Zone names are string literals, so recording a zone never copies (or allocates) a string.
+  char const* name;
+
+  // Nanoseconds, read from std::chrono::steady_clock.
+  uint64_t begin_ns;
+  uint64_t end_ns;
+
+  uint32_t thread;
+
+  // How many zones (on the same thread) this zone is nested inside of.
+  uint32_t depth;
+
+  auto duration_ns() const { return end_ns - begin_ns; }
+};
+
+// Every zone that ended during one frame.
+struct ProfileFrame
+{
+  uint64_t number   = 0;
+  uint64_t begin_ns = 0;
+  uint64_t end_ns   = 0;
+
+  std::vector<ProfileEvent> events;
+
+  auto   duration_ns() const { return end_ns - begin_ns; }
+  double duration_ms() const { return duration_ns() / 1000000.0; }
+};
+
+// Collects the zones timed by PROFILE_ZONE into frames.
+//
+// Each thread records zones into it's own buffer, without locking. The frame thread (the thread
+// calling begin_frame() and end_frame()) moves it's buffer into the frame when the frame ends.
+// Other threads hand their buffer over (under a lock) each time their outermost zone ends, it's
+// events are added to the frame that is open at the time.
+//
+// The most recent frames are kept in a history, frames slower than the spike threshold are also
+// kept (separately) after they leave the history, so spikes can be found in long sessions.
+//
+// Except for the zones themselves, the Profiler should only be used from the frame thread.
+class Profiler
+{
+  Profiler() = delete;
+
+public:
+  static size_t constexpr HISTORY_SIZE = 240;
+  static size_t constexpr MAX_SPIKES   = 32;
+
+  static double constexpr DEFAULT_SPIKE_THRESHOLD_MS = 33.3;
+
+  // Where the trace is written to at exit (when there were spikes), and from the profiler window.
+  static char constexpr TRACE_PATH[] = "build-system/bin/logs/profile-trace.json";
+
+  static bool enabled();
+  static void set_enabled(bool);
+
+  static double spike_threshold_ms();
+  static void   set_spike_threshold_ms(double);
+
+  static void begin_frame();
+  static void end_frame();
+
+  // The most recent frames (oldest first), and the slowest frames of the session.
+  static std::deque<ProfileFrame> const& history();
+  static std::vector<ProfileFrame> const& spikes();
+
+  static void clear();
+
+  // The history and the spikes, in the Chrome trace event format (chrome://tracing).
+  static std::string to_chrome_trace();
+  static Result<none_t, std::string> write_chrome_trace(char const*);
+
+  static uint64_t now_ns();
+};
+
+// Times a zone, from construction until destruction.
+class ProfileZone
+{
+  char const* name_;
+  uint64_t    begin_ns_ = 0;
+  bool        active_;
+
+public:
+  NO_COPY_OR_MOVE(ProfileZone);
+  explicit ProfileZone(char const*);
+  ~ProfileZone();
+};
+
+} // namespace common
+
+#define PROFILE_ZONE_CONCAT_IMPL(VAR_NAME, COUNTER) VAR_NAME##COUNTER
+#define PROFILE_ZONE_CONCAT(VAR_NAME, COUNTER) PROFILE_ZONE_CONCAT_IMPL(VAR_NAME, COUNTER)
+
+// PROFILE_ZONE
+//
+// Time the rest of the enclosing scope as a zone named "name" (a string literal).
+#define PROFILE_ZONE(name)                                                                         \
+  ::common::ProfileZone PROFILE_ZONE_CONCAT(_PROFILE_ZONE_, __COUNTER__) { name }
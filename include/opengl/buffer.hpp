@@ -1,7 +1,10 @@
 #pragma once
 #include <boomhs/color.hpp>
 #include <boomhs/obj.hpp>
+
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace opengl
 {
@@ -39,6 +42,9 @@ struct VertexBuffer
   boomhs::ObjIndices  indices;
   BufferFlags const   flags;
 
+  // The vertices packed into a quantized vertex layout. When set, "vertices" is empty.
+  std::vector<uint8_t> packed;
+
 private:
   VertexBuffer(BufferFlags const&);
   COPY_CONSTRUCTIBLE(VertexBuffer);
@@ -50,12 +56,18 @@ public:
 
   std::string to_string() const;
 
+  bool is_packed() const { return !packed.empty(); }
+
   // Public copy method
   VertexBuffer copy() const;
 
   void set_colors(boomhs::Color const&);
   static VertexBuffer
   create_interleaved(common::Logger&, boomhs::ObjData const&, BufferFlags const&);
+
+  // Interleave the attributes the vertex layout uses, packing them if the layout is quantized.
+  static VertexBuffer
+  create_interleaved(common::Logger&, boomhs::ObjData const&, VertexAttribute const&);
 };
 
 } // namespace opengl
@@ -5,20 +5,25 @@
 #include <opengl/vertex_attribute.hpp>
 
 #include <boomhs/entity.hpp>
+#include <boomhs/mesh_lod.hpp>
 
 #include <common/log.hpp>
 #include <common/type_macros.hpp>
 
+#include <array>
+#include <memory>
 #include <optional>
 #include <string>
 
 namespace boomhs
 {
 class ObjStore;
+class TerrainGrid;
 } // namespace boomhs
 
 namespace opengl
 {
+class GeometryArena;
 class ShaderPrograms;
 
 class BufferHandles
@@ -31,6 +36,7 @@ class BufferHandles
 
 public:
   friend class DrawInfo;
+  friend class GeometryArena;
   ~BufferHandles();
 
   // move-construction OK.
@@ -47,17 +53,44 @@ public:
 std::ostream&
 operator<<(std::ostream&, BufferHandles const&);
 
+// The GPU buffers (and vertex array) a DrawInfo draws. Shared by every DrawInfo drawing the same
+// geometry, the buffers are freed when the last of them is destroyed.
+//
+// The geometry either has buffers of it's own, or is a range of a GeometryArena's buffers.
+struct DrawBuffers
+{
+  size_t vertex_bytes;
+  GLuint num_indices;
+
+  // Where the geometry starts within the arena's buffers, the indices are relative to base_vertex.
+  GLint  base_vertex = 0;
+  GLuint first_index = 0;
+
+  std::shared_ptr<GeometryArena> arena;
+  std::optional<BufferHandles>   handles;
+  std::optional<VAO>             vao;
+
+  NO_COPY_OR_MOVE(DrawBuffers);
+  explicit DrawBuffers(size_t, GLuint);
+  ~DrawBuffers();
+
+  size_t num_bytes() const { return vertex_bytes + (num_indices * sizeof(GLuint)); }
+};
+
 class DrawInfo
 {
-  size_t        num_vertexes_;
-  GLuint        num_indices_;
-  BufferHandles handles_;
-  VAO           vao_;
+  std::shared_ptr<DrawBuffers> buffers_;
+
+  explicit DrawInfo(std::shared_ptr<DrawBuffers>&&);
+  friend class GeometryCache;
+  friend class GeometryPool;
 
 public:
   DebugBoundCheck debug_check;
 
   NO_COPY(DrawInfo);
+
+  // Geometry with buffers of it's own.
   explicit DrawInfo(size_t, GLuint);
 
   DrawInfo(DrawInfo&&);
@@ -67,13 +100,30 @@ public:
   void unbind_impl(common::Logger&);
   DEFAULT_WHILEBOUND_MEMBERFN_DECLATION();
 
-  auto vbo() const { return handles_.vbo(); }
-  auto ebo() const { return handles_.ebo(); }
-  auto num_vertexes() const { return num_vertexes_; }
-  auto num_indices() const { return num_indices_; }
+  // Another DrawInfo, drawing the same GPU buffers.
+  DrawInfo share() const;
 
-  auto&       vao() { return vao_; }
-  auto const& vao() const { return vao_; }
+  // True if other DrawInfos draw the same GPU buffers. Shared buffers must not be written to.
+  bool is_shared() const { return buffers_.use_count() > 1; }
+
+  // The number of DrawInfos (this one included) drawing the same GPU buffers.
+  size_t num_sharers() const { return buffers_.use_count(); }
+
+  // True if the geometry is a range of a GeometryArena's buffers.
+  bool is_pooled() const { return nullptr != buffers_->arena; }
+
+  GLuint vbo() const;
+  GLuint ebo() const;
+  auto   vertex_bytes() const { return buffers_->vertex_bytes; }
+  auto   num_indices() const { return buffers_->num_indices; }
+  auto   num_bytes() const { return buffers_->num_bytes(); }
+
+  // Draw with glDrawElementsBaseVertex, starting at the first index.
+  auto base_vertex() const { return buffers_->base_vertex; }
+  auto first_index() const { return buffers_->first_index; }
+
+  VAO&       vao();
+  VAO const& vao() const;
 
   std::string to_string() const;
 };
@@ -96,13 +146,17 @@ class EntityDrawHandleMap
   std::vector<opengl::DrawInfo> drawinfos_;
   std::vector<boomhs::EntityID> entities_;
 
-  friend class DrawHandleManager;
-
+public:
+  // Public so the DrawHandleManager can hold an array of them, only it can add or remove entities.
   EntityDrawHandleMap() = default;
   NO_COPY(EntityDrawHandleMap);
   MOVE_DEFAULT(EntityDrawHandleMap);
 
+private:
+  friend class DrawHandleManager;
+
   DrawInfoHandle add(boomhs::EntityID, opengl::DrawInfo&&);
+  void           remove(boomhs::EntityID);
 
   bool empty() const { return drawinfos_.empty(); }
   bool has(DrawInfoHandle) const;
@@ -123,6 +177,15 @@ class DrawHandleManager
   // These slots get a value when memory is loaded, set to none when memory is not.
   EntityDrawHandleMap entities_;
 
+  // The entities' simplified meshes, lods_[0] holds LOD 1.
+  std::array<EntityDrawHandleMap, boomhs::MeshSimplifier::MAX_LODS - 1> lods_;
+
+  // The terrain pieces' meshes, in the same order as the pieces in the TerrainGrid.
+  std::vector<DrawInfo> terrain_;
+
+  // A wireframe cube from (0, 0, 0) to (1, 1, 1), scaled to every bounding box drawn.
+  std::optional<DrawInfo> boundingbox_;
+
   EntityDrawHandleMap&       entities();
   EntityDrawHandleMap const& entities() const;
 
@@ -134,12 +197,58 @@ public:
   // methods
   DrawInfoHandle add_entity(boomhs::EntityID, DrawInfo&&);
 
+  bool has_entity(boomhs::EntityID) const;
+
+  // Destroy the entity's DrawInfo, freeing it's GPU memory.
+  void remove_entity(boomhs::EntityID);
+
   DrawInfo&       lookup_entity(common::Logger&, boomhs::EntityID);
   DrawInfo const& lookup_entity(common::Logger&, boomhs::EntityID) const;
 
+  // The entity's DrawInfo for the LOD (0 being the full mesh).
+  DrawInfo& lookup_entity_lod(common::Logger&, boomhs::EntityID, size_t);
+
+  // The number of LODs on the GPU for the entity, including the full mesh.
+  size_t num_lods(boomhs::EntityID) const;
+
+  // The number of bytes of vertex and index buffers (of every LOD) removing the entity would free.
+  //
+  // Buffers shared with other entities (see GeometryCache) aren't counted, they stay on the GPU
+  // until the last entity drawing them is removed.
+  size_t num_bytes(common::Logger&, boomhs::EntityID) const;
+
+  // The entity's share of the bytes of vertex and index buffers (of every LOD) it draws. Buffers
+  // drawn by N entities count 1/N towards each of them, so the shares of every entity add up to
+  // the buffers' size.
+  size_t share_bytes(common::Logger&, boomhs::EntityID) const;
+
+  // Copy the entity's mesh to the GPU, and give the entity a bounding box.
   void add_mesh(common::Logger&, ShaderPrograms&, boomhs::ObjStore&, boomhs::EntityID,
                 boomhs::EntityRegistry&);
+
+  // Copy the entity's mesh to the GPU, the entity's bounding box (see
+  // boomhs::AABoundingBox::add_mesh_to_entity()) can exist while the mesh isn't on the GPU.
+  //
+  // The mesh's LODs are uploaded along with it.
+  DrawInfo& upload_mesh(common::Logger&, ShaderPrograms&, boomhs::ObjStore&, boomhs::EntityID,
+                        boomhs::EntityRegistry&);
+
   void add_cube(common::Logger&, ShaderPrograms&, boomhs::EntityID, boomhs::EntityRegistry&);
+
+  // Copy every piece of the terrain grid to the GPU, replacing the previous pieces.
+  void upload_terrain(common::Logger&, ShaderPrograms&, boomhs::TerrainGrid const&);
+
+  // Copy a single (regenerated) piece of the terrain grid to the GPU.
+  void upload_terrain_piece(common::Logger&, ShaderPrograms&, boomhs::TerrainGrid const&, size_t);
+
+  // Copy the next piece of the terrain grid to the GPU, the pieces are added in order.
+  void add_terrain_piece(common::Logger&, ShaderPrograms&, boomhs::TerrainGrid const&, size_t);
+  auto num_terrain_pieces() const { return terrain_.size(); }
+
+  DrawInfo& lookup_terrain(size_t);
+
+  // The wireframe cube bounding boxes are drawn with, uploaded the first time it's needed.
+  DrawInfo& boundingbox(common::Logger&, ShaderPrograms&);
 };
 
 } // namespace opengl
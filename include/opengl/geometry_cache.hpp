@@ -0,0 +1,68 @@
+#pragma once
+#include <opengl/draw_info.hpp>
+
+#include <extlibs/glew.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace opengl
+{
+class VertexAttribute;
+
+// Shares the GPU buffers of identical geometry between DrawInfos, so geometry drawn by many
+// entities (NPCs using the same mesh, the water grids, bounding box wireframes) is uploaded and
+// stored on the GPU once.
+//
+// Geometry is found by it's vertex layout, sizes and a 64 bit hash of it's vertex bytes and
+// indices. The cache keeps no copy of the geometry, the caller confirms the buffers found hold it's
+// geometry (so a hash collision can't share the wrong buffers). The cache only keeps weak
+// references to the buffers, they are freed when the last DrawInfo drawing them is destroyed.
+// Since the buffers may be shared, they are never written to after the upload.
+//
+// Geometry rebuilt every frame isn't cached (see BufferStorage), it's never drawn twice.
+//
+// Only used from the thread owning the GL context.
+class GeometryCache
+{
+  GeometryCache() = delete;
+
+public:
+  struct Key
+  {
+    uint64_t hash;
+    size_t   vertex_bytes;
+    size_t   num_indices;
+
+    // The vertex layout (stride and attributes), as bytes.
+    std::vector<uint8_t> layout;
+
+    bool operator==(Key const&) const;
+    bool operator!=(Key const& other) const { return !(*this == other); }
+  };
+
+  static Key make_key(VertexAttribute const&, void const*, size_t, GLuint const*, size_t);
+
+  // Whether the buffers found by a key hold the caller's geometry.
+  using Matches = std::function<bool(DrawBuffers const&)>;
+
+  // The buffers of the geometry, if they are still on the GPU and hold the geometry.
+  static std::shared_ptr<DrawBuffers> find(Key const&, Matches const&);
+
+  // Let the DrawInfo's buffers be found by the key.
+  static void insert(Key&&, DrawInfo const&);
+
+  // A DrawInfo drawing buffers found in the cache.
+  static DrawInfo share(std::shared_ptr<DrawBuffers>&& buffers) { return DrawInfo{MOVE(buffers)}; }
+
+  // The number of uploads avoided, and made, by the cache.
+  static size_t num_hits();
+  static size_t num_misses();
+
+  // The number of buffers in the cache still on the GPU.
+  static size_t num_entries();
+};
+
+} // namespace opengl
@@ -0,0 +1,147 @@
+#pragma once
+#include <opengl/draw_info.hpp>
+#include <opengl/vao.hpp>
+#include <opengl/vertex_attribute.hpp>
+
+#include <common/log.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/glew.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace opengl
+{
+
+// Hands out ranges of a fixed number of elements (vertices or indices), first fit. Freed ranges are
+// merged with the free ranges next to them.
+class RangeAllocator
+{
+  // The free ranges, offset -> count.
+  std::map<size_t, size_t> free_;
+
+  size_t capacity_;
+  size_t num_free_;
+
+public:
+  explicit RangeAllocator(size_t);
+
+  // The offset of a range of "count" elements, if there is a free range large enough.
+  std::optional<size_t> allocate(size_t);
+  void                  free(size_t, size_t);
+
+  // Mark the first "count" elements used and the rest free, after the elements were compacted.
+  void compact(size_t);
+
+  auto capacity() const { return capacity_; }
+  auto num_free() const { return num_free_; }
+  auto num_used() const { return capacity_ - num_free_; }
+  auto num_free_ranges() const { return free_.size(); }
+};
+
+// A vertex buffer and an index buffer, shared by many meshes with the same vertex layout.
+//
+// Each mesh is given a range of the vertices and a range of the indices. The mesh's indices start
+// at zero, the mesh is drawn with glDrawElementsBaseVertex starting at it's first index. Every mesh
+// uses the arena's vertex array, so meshes in the same arena can be drawn back to back without
+// binding another vertex array.
+//
+// The buffers start small, and double in size as geometry is added (up to a maximum size).
+class GeometryArena : public std::enable_shared_from_this<GeometryArena>
+{
+  VertexAttribute va_;
+  BufferHandles   handles_;
+  VAO             vao_;
+
+  RangeAllocator vertices_;
+  RangeAllocator indices_;
+
+  // The size the buffers start at (and never shrink below), and the size they can grow to.
+  size_t min_vertices_, min_indices_;
+  size_t max_vertices_, max_indices_;
+
+  // The geometry allocated from the arena, their ranges move when the arena is compacted.
+  std::vector<DrawBuffers*> allocations_;
+
+  // Size the buffers and describe them (and the vertex layout) to the vertex array.
+  void create_buffers(common::Logger&);
+
+  // Copy every range to the start of new buffers of the given size (vertices and indices).
+  void relocate(common::Logger&, size_t, size_t);
+
+public:
+  NO_COPY_OR_MOVE(GeometryArena);
+
+  // The buffers start with room for the first number of vertices and indices, and grow to the
+  // second.
+  explicit GeometryArena(common::Logger&, VertexAttribute const&, size_t, size_t, size_t, size_t);
+  ~GeometryArena();
+
+  // Give the geometry a range of vertices and indices, growing the buffers if they are too small or
+  // compacting them if they have enough room (just not in one piece). Returns false if the geometry
+  // doesn't fit, even after growing the buffers to their maximum size.
+  bool allocate(common::Logger&, DrawBuffers&);
+  void free(DrawBuffers&);
+
+  // Copy the geometry's vertices and indices into it's ranges.
+  void upload(DrawBuffers const&, void const*, GLuint const*);
+
+  // Move every range to the start of the buffers, leaving the free space in one piece.
+  void compact(common::Logger&);
+
+  // Halve the buffers while less than a quarter of them is used. Returns true if they shrank.
+  bool shrink(common::Logger&);
+
+  auto const& va() const { return va_; }
+  auto        vbo() const { return handles_.vbo(); }
+  auto        ebo() const { return handles_.ebo(); }
+
+  auto&       vao() { return vao_; }
+  auto const& vao() const { return vao_; }
+
+  auto vertex_capacity() const { return vertices_.capacity(); }
+  auto index_capacity() const { return indices_.capacity(); }
+  auto num_allocations() const { return allocations_.size(); }
+
+  // The size of the arena's buffers, used or not.
+  size_t num_bytes() const;
+};
+
+// Copies static geometry into large buffers shared by every mesh with the same vertex layout (see
+// GeometryArena), instead of buffers of it's own.
+//
+// Arenas are created as needed, and freed when the last geometry in them is destroyed. Only used
+// from the thread owning the GL context.
+class GeometryPool
+{
+  GeometryPool() = delete;
+
+public:
+  // The size of a new arena's buffers, and the size they grow to before another arena is created.
+  static size_t constexpr ARENA_MIN_VERTEX_BYTES = 256 * 1024;
+  static size_t constexpr ARENA_MIN_INDICES      = 64 * 1024;
+  static size_t constexpr ARENA_MAX_VERTEX_BYTES = 16 * 1024 * 1024;
+  static size_t constexpr ARENA_MAX_INDICES      = 4 * 1024 * 1024;
+
+  // glDrawElementsBaseVertex is core in GL 3.2 (the context is 3.1), the pool is only used when the
+  // driver has the extension.
+  static bool supported();
+
+  // Suballocate the geometry from an arena for it's vertex layout, and copy it to the GPU. Geometry
+  // larger than an arena gets an arena of it's own.
+  //
+  // Returns none when the pool isn't supported.
+  static std::optional<DrawInfo> copy(common::Logger&, VertexAttribute const&, void const*, size_t,
+                                      GLuint const*, size_t);
+
+  // Shrink the arenas mostly left empty by the geometry freed from them, see GeometryArena::shrink.
+  static void trim(common::Logger&);
+
+  // The number of arenas with geometry in them.
+  static size_t num_arenas();
+};
+
+} // namespace opengl
@@ -0,0 +1,112 @@
+#pragma once
+#include <extlibs/glew.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opengl
+{
+
+// The kinds of GL calls that go through GLState.
+enum class GLStateCall
+{
+  Program = 0,
+  VertexArray,
+  ActiveTexture,
+  Texture,
+  Framebuffer,
+  Capability,
+  BlendFunc,
+  CullFace,
+  FrontFace,
+  Viewport,
+  Scissor,
+
+  MAX
+};
+
+// How many calls of each kind reached GL, and how many were filtered out (because they wouldn't
+// have changed anything).
+struct GLStateCounters
+{
+  static auto constexpr NUM_CALLS = static_cast<size_t>(GLStateCall::MAX);
+
+  std::array<uint64_t, NUM_CALLS> issued   = {};
+  std::array<uint64_t, NUM_CALLS> filtered = {};
+
+  uint64_t total_issued() const;
+  uint64_t total_filtered() const;
+
+  std::string to_string() const;
+
+  static char const* name(GLStateCall);
+};
+
+struct BlendFunc
+{
+  GLenum source_rgb, dest_rgb;
+  GLenum source_alpha, dest_alpha;
+};
+
+// A CPU side copy (shadow) of the GL state the renderer changes.
+//
+// Every change to the tracked state goes through here. Calls that wouldn't change the state are
+// filtered out before reaching the driver, and the state can be read back (to save and restore it)
+// without a glGet* round trip.
+//
+// The shadow is read from GL once (sync), after that GL and the shadow are assumed to agree. Code
+// that changes the state behind GLState's back (ImGui's renderer) has to restore it afterwards.
+//
+// Deleting a bound object unbinds it, the delete functions keep the shadow in step.
+class GLState
+{
+  GLState() = delete;
+
+public:
+  // Texture bindings are tracked for this many texture units (binding textures to units past these
+  // is never filtered).
+  static size_t constexpr MAX_TEXTURE_UNITS = 16;
+
+  // Read the tracked state from GL.
+  static void sync();
+
+  static void use_program(GLuint);
+  static void bind_vertex_array(GLuint);
+  static void bind_framebuffer(GLuint);
+
+  // GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP bindings are tracked for each unit.
+  static void active_texture(GLenum);
+  static void bind_texture(GLenum, GLuint);
+
+  // GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST and GL_SCISSOR_TEST are tracked, other capabilities are
+  // passed through.
+  static void enable(GLenum);
+  static void disable(GLenum);
+  static void set_enabled(GLenum, bool);
+  static bool is_enabled(GLenum);
+
+  static void blend_func(GLenum, GLenum);
+  static void blend_func_separate(BlendFunc const&);
+  static BlendFunc const& blend_func();
+
+  static void   cull_face(GLenum);
+  static GLenum cull_face();
+
+  static void   front_face(GLenum);
+  static GLenum front_face();
+
+  static void viewport(GLint, GLint, GLsizei, GLsizei);
+  static void scissor(GLint, GLint, GLsizei, GLsizei);
+
+  static void delete_program(GLuint);
+  static void delete_vertex_array(GLuint);
+  static void delete_texture(GLuint);
+  static void delete_framebuffer(GLuint);
+
+  static GLStateCounters const& counters();
+  static void                   reset_counters();
+};
+
+} // namespace opengl
@@ -1,4 +1,5 @@
 #pragma once
+#include <opengl/gl_state.hpp>
 #include <opengl/types.hpp>
 #include <extlibs/static_string.hpp>
 
@@ -9,13 +10,15 @@
 // Here be dragons.
 namespace opengl::global
 {
-static auto const vao_bind   = [](auto& vao) { glBindVertexArray(vao.gl_raw_value()); };
-static auto const vao_unbind = []() { glBindVertexArray(0); };
+static auto const vao_bind   = [](auto& vao) { GLState::bind_vertex_array(vao.gl_raw_value()); };
+static auto const vao_unbind = []() { GLState::bind_vertex_array(0); };
 
 static auto const texture_bind = [](auto const& texture) {
-  glBindTexture(texture.target, texture.id);
+  GLState::bind_texture(texture.target, texture.id);
+};
+static auto const texture_unbind = [](auto const& texture) {
+  GLState::bind_texture(texture.target, 0);
 };
-static auto const texture_unbind = [](auto const& texture) { glBindTexture(texture.target, 0); };
 
 // Define a name for the default "View" matrix OpenGL assumes. (if you pass in a Identity matrix to
 // all view computations, OpenGL transforms the data the same as if you used this matrix as the
@@ -29,40 +29,17 @@ struct GridVerticesIndices;
 namespace opengl::gpu
 {
 
-namespace detail
+// Where geometry is copied to on the GPU.
+//
+// Static geometry (kept for the life of an entity) is shared with identical geometry already on the
+// GPU (see GeometryCache), and can be pooled into buffers shared with other geometry (see
+// GeometryPool). Geometry rebuilt every frame gets buffers of it's own, and skips the cache.
+enum class BufferStorage
 {
-
-template <typename VERTICES, typename INDICES>
-void
-copy_synchronous(common::Logger& logger, VertexAttribute const& va, DrawInfo &dinfo,
-                 VERTICES const& vertices, INDICES const& indices)
-{
-  auto const bind_and_copy = [&]() {
-    glBindBuffer(GL_ARRAY_BUFFER, dinfo.vbo());
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, dinfo.ebo());
-
-    va.upload_vertex_format_to_glbound_vao(logger);
-
-    // copy the vertices
-    LOG_DEBUG_SPRINTF("inserting '%i' vertices into GL_BUFFER_ARRAY\n", vertices.size());
-    auto const  vertices_size = vertices.size() * sizeof(GLfloat);
-    auto const& vertices_data = vertices.data();
-    glBufferData(GL_ARRAY_BUFFER, vertices_size, vertices_data, GL_STATIC_DRAW);
-
-    // copy the vertice rendering order
-    LOG_DEBUG_SPRINTF("inserting '%i' indices into GL_ELEMENT_BUFFER_ARRAY\n", indices.size());
-    auto const  indices_size = sizeof(GLuint) * indices.size();
-    auto const& indices_data = indices.data();
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_size, indices_data, GL_STATIC_DRAW);
-  };
-
-  LOG_TRACE("Starting synchronous cpu -> gpu copy");
-  auto &vao = dinfo.vao();
-  vao.while_bound(logger, bind_and_copy);
-  LOG_TRACE("cpu -> gpu copy complete");
-}
-
-} // namespace detail
+  OWN = 0,
+  SHARED,
+  POOLED
+};
 
 DrawInfo
 copy(common::Logger &, VertexAttribute const&, boomhs::VertexFactory::ArrowVertices const&);
@@ -76,10 +53,12 @@ copy(common::Logger&, VertexAttribute const&, boomhs::VertexFactory::GridVertice
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Cubes
 DrawInfo
-copy_cube_gpu(common::Logger&, boomhs::CubeVertices const&, VertexAttribute const&);
+copy_cube_gpu(common::Logger&, boomhs::CubeVertices const&, VertexAttribute const&,
+              BufferStorage = BufferStorage::OWN);
 
 DrawInfo
-copy_cube_wireframe_gpu(common::Logger&, boomhs::CubeVertices const&, VertexAttribute const&);
+copy_cube_wireframe_gpu(common::Logger&, boomhs::CubeVertices const&, VertexAttribute const&,
+                        BufferStorage = BufferStorage::OWN);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Rectangles
@@ -90,7 +69,8 @@ DrawInfo
 copy_rectangle(common::Logger&, VertexAttribute const&, boomhs::RectLineBuffer const&);
 
 DrawInfo
-copy_rectangle(common::Logger&, VertexAttribute const&, boomhs::RectangleUvVertices const&);
+copy_rectangle(common::Logger&, VertexAttribute const&, boomhs::RectangleUvVertices const&,
+               BufferStorage = BufferStorage::OWN);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // General
@@ -101,11 +81,15 @@ create_modelnormals(common::Logger&, VertexAttribute const&, glm::mat4 const&, b
                     boomhs::Color const&);
 
 DrawInfo
-copy_gpu(common::Logger&, VertexAttribute const&, boomhs::ObjData const&);
+copy_gpu(common::Logger&, VertexAttribute const&, boomhs::ObjData const&,
+         BufferStorage = BufferStorage::OWN);
 
 DrawInfo
-copy_gpu(common::Logger&, VertexAttribute const&, VertexBuffer const&);
+copy_gpu(common::Logger&, VertexAttribute const&, VertexBuffer const&,
+         BufferStorage = BufferStorage::OWN);
 
+// Replace the DrawInfo's vertices (and indices) with the ObjData's. The DrawInfo is given new
+// buffers, other DrawInfos sharing it's old buffers are unaffected.
 void
 overwrite_vertex_buffer(common::Logger&, VertexAttribute const&, DrawInfo&, boomhs::ObjData const&);
 
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace opengl
+{
+
+// The bytes of GPU memory allocated for buffers and textures.
+//
+// Counted where the memory is allocated and freed (DrawBuffers with buffers of their own,
+// GeometryArena, textures), so memory drawn by many entities is counted once, and memory is no
+// longer counted once it's actually freed.
+//
+// Only used from the thread owning the GL context.
+class GpuMemory
+{
+  GpuMemory() = delete;
+
+public:
+  enum Kind
+  {
+    BUFFERS = 0,
+    ARENAS,
+    TEXTURES,
+    MAX
+  };
+
+  static void allocated(Kind, size_t);
+  static void freed(Kind, size_t);
+
+  static size_t bytes(Kind);
+  static size_t total();
+};
+
+} // namespace opengl
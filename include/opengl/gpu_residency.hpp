@@ -0,0 +1,117 @@
+#pragma once
+#include <boomhs/entity.hpp>
+#include <opengl/texture.hpp>
+
+#include <common/log.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace boomhs
+{
+class ObjStore;
+} // namespace boomhs
+
+namespace opengl
+{
+class DrawHandleManager;
+class ShaderPrograms;
+
+// Keeps the meshes of StreamedMesh entities, and the streamed textures of the TextureTable, on the
+// GPU only while they are being used.
+//
+// A mesh is uploaded the first time it's requested (the renderer requests entities that pass
+// culling), or when predicted to be needed soon (the entity is close to the player). A texture is
+// uploaded the first time it's handle is resolved, a grey placeholder is drawn until then. Uploads
+// are queued and done in update(), a few per frame.
+//
+// Only the memory of the resident meshes and streamed textures counts against the budget, the rest
+// of the GPU memory (the terrain, the UI textures, ...) can't be evicted. Geometry drawn by many
+// entities counts once (see DrawHandleManager::share_bytes()). Once over the budget, the least
+// recently used meshes and textures are evicted. Those used during the current frame are never
+// evicted.
+//
+// Destroyed entities are forgotten (and their meshes removed) during the next update().
+class GpuResidency
+{
+public:
+  static size_t constexpr DEFAULT_VRAM_BUDGET       = 256 * 1024 * 1024;
+  static size_t constexpr DEFAULT_UPLOADS_PER_FRAME = 8;
+
+  // Textures are decoded from their image files when uploaded, fewer fit in a frame.
+  static size_t constexpr DEFAULT_TEXTURE_UPLOADS_PER_FRAME = 2;
+
+private:
+  struct Entry
+  {
+    bool     resident  = false;
+    uint64_t last_used = 0;
+  };
+
+  // Every requested entity, resident or waiting to be uploaded.
+  std::unordered_map<boomhs::EntityID, Entry> entries_;
+
+  // Entities waiting to be uploaded, in the order they were requested.
+  std::vector<boomhs::EntityID> upload_queue_;
+
+  // The same for the streamed textures, by their handles.
+  std::unordered_map<TextureHandle::value_type, Entry> texture_entries_;
+  std::vector<TextureHandle>                           texture_queue_;
+
+  // Drawn instead of the streamed textures not on the GPU yet, created when first needed.
+  std::optional<Texture> placeholder_;
+
+  size_t   vram_budget_;
+  size_t   uploads_per_frame_;
+  uint64_t frame_ = 0;
+
+  // The bytes of the resident meshes and streamed textures, as of the last update().
+  size_t bytes_used_ = 0;
+
+  // Set once the meshes and textures used in a frame didn't fit within the budget (and it was warned about),
+  // until they fit again.
+  bool over_budget_ = false;
+
+  void enqueue(boomhs::EntityID);
+  void forget(boomhs::EntityID, DrawHandleManager&);
+  void upload_textures(common::Logger&, TextureTable&);
+  void evict(common::Logger&, TextureTable&, DrawHandleManager&);
+
+public:
+  NOCOPY_MOVE_DEFAULT(GpuResidency);
+  explicit GpuResidency(size_t = DEFAULT_VRAM_BUDGET, size_t = DEFAULT_UPLOADS_PER_FRAME);
+
+  auto vram_budget() const { return vram_budget_; }
+  void set_vram_budget(size_t const bytes) { vram_budget_ = bytes; }
+
+  // The GPU memory of the resident meshes and streamed textures, counted against the budget.
+  auto bytes_used() const { return bytes_used_; }
+  auto num_pending() const { return upload_queue_.size() + texture_queue_.size(); }
+
+  // Returns true if the entity's mesh is on the GPU, marking it as used this frame.
+  //
+  // Otherwise the upload is queued and false is returned, the caller should draw a placeholder.
+  bool request(boomhs::EntityID);
+
+  // Queue uploads for every StreamedMesh entity within "distance" of "position".
+  void predict(boomhs::EntityRegistry&, glm::vec3 const&, float);
+
+  // The texture to draw for the handle, marking it as used this frame.
+  //
+  // Textures that aren't streamed are always on the GPU. A streamed texture not on the GPU has it's
+  // upload queued, and the placeholder is returned instead.
+  TextureInfo& texture(common::Logger&, TextureTable&, TextureHandle);
+
+  // Forget the destroyed entities, upload the queued meshes and textures (up to the per-frame
+  // limits), then evict meshes and textures until the budget is met. Call once per frame, after
+  // rendering.
+  void update(common::Logger&, ShaderPrograms&, boomhs::ObjStore&, boomhs::EntityRegistry&,
+              TextureTable&, DrawHandleManager&);
+};
+
+} // namespace opengl
@@ -4,7 +4,6 @@
 namespace boomhs
 {
 struct Material;
-class EntityRegistry;
 } // namespace boomhs
 
 namespace opengl
@@ -17,8 +16,10 @@ class LightRenderer
   LightRenderer() = delete;
 
 public:
-  static void set_light_uniforms(RenderState&, boomhs::EntityRegistry&, ShaderProgram&,
-                                 boomhs::Material const&, glm::vec3 const&, glm::mat4 const&, bool);
+  // Set the normal matrix (when the bool is true) and the material of a lit entity. The lights are
+  // in the LightingBlock uniform block, see UniformBlocks.
+  static void set_light_uniforms(RenderState&, ShaderProgram&, boomhs::Material const&,
+                                 glm::mat4 const&, bool);
 };
 
 } // namespace opengl
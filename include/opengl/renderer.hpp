@@ -5,6 +5,7 @@
 #include <boomhs/color.hpp>
 #include <boomhs/lighting.hpp>
 
+#include <opengl/gl_state.hpp>
 #include <opengl/shader.hpp>
 #include <common/log.hpp>
 
@@ -24,6 +25,7 @@ struct Material;
 struct EngineState;
 class  Player;
 struct Transform;
+class  VisibleSet;
 struct ZoneState;
 } // namespace boomhs
 
@@ -51,6 +53,10 @@ struct RenderState
   boomhs::FrameState& fs;
   DrawState&          ds;
 
+  // The entities visible to the pass, already culled. When nullptr, the entity renderers walk the
+  // registry and cull each entity themselves.
+  boomhs::VisibleSet const* visible = nullptr;
+
   explicit RenderState(boomhs::FrameState& f, DrawState& d)
       : fs(f)
       , ds(d)
@@ -94,17 +100,17 @@ struct BlendState
 
 #define ENABLE_ALPHA_BLENDING_UNTIL_SCOPE_EXIT()                                                   \
   PUSH_BLEND_STATE_UNTIL_END_OF_SCOPE();                                                           \
-  glEnable(GL_BLEND);                                                                              \
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  ::opengl::GLState::enable(GL_BLEND);                                                             \
+  ::opengl::GLState::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 #define ENABLE_ADDITIVE_BLENDING_UNTIL_SCOPE_EXIT()                                                \
   PUSH_BLEND_STATE_UNTIL_END_OF_SCOPE();                                                           \
-  glEnable(GL_BLEND);                                                                              \
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+  ::opengl::GLState::enable(GL_BLEND);                                                             \
+  ::opengl::GLState::blend_func(GL_SRC_ALPHA, GL_ONE);
 
 #define ENABLE_SCISSOR_TEST_UNTIL_SCOPE_EXIT()                                                     \
-  glEnable(GL_SCISSOR_TEST);                                                                       \
-  ON_SCOPE_EXIT([]() { glDisable(GL_SCISSOR_TEST); })
+  ::opengl::GLState::enable(GL_SCISSOR_TEST);                                                      \
+  ON_SCOPE_EXIT([]() { ::opengl::GLState::disable(GL_SCISSOR_TEST); })
 
 namespace opengl::render
 {
@@ -160,8 +166,10 @@ draw_2delements(common::Logger&, GLenum, ShaderProgram&, GLuint, DrawState&);
 void
 draw_2delements(common::Logger&, GLenum, ShaderProgram&, TextureInfo&, GLuint, DrawState&);
 
+// The indices may start past the beginning of the element buffer, and be relative to a base vertex
+// (for geometry suballocated from a GeometryArena).
 void
-draw_elements(common::Logger&, GLenum, ShaderProgram&, GLuint, DrawState&);
+draw_elements(common::Logger&, GLenum, ShaderProgram&, GLuint, DrawState&, GLuint = 0, GLint = 0);
 
 //////////
 
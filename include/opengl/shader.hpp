@@ -12,6 +12,9 @@
 
 #include <algorithm>
 #include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace opengl
 {
@@ -77,10 +80,68 @@ struct PathToShaderSources
 };
 #endif
 
+// Gives each distinct uniform name a small integer id, the first time the name is seen.
+class UniformNames
+{
+  UniformNames() = delete;
+
+public:
+  static size_t      intern(char const*);
+  static char const* name(size_t);
+};
+
+// A handle to a uniform, created once (ie: as a static) and used to set the uniform on any
+// ShaderProgram. Programs cache the uniform's location by the handle's id, so setting a uniform
+// through a handle doesn't hash (or format) the uniform's name.
+//
+// The handle's type is the type of value the uniform is set with.
+template <typename T>
+class Uniform
+{
+  size_t id_;
+
+public:
+  using value_type = T;
+
+  // Handles are only created from a name, so "Uniform<T> const U_X{U_X}" doesn't compile.
+  NO_COPY_OR_MOVE(Uniform);
+  explicit Uniform(char const* name)
+      : id_(UniformNames::intern(name))
+  {
+  }
+
+  auto id() const { return id_; }
+  auto name() const { return UniformNames::name(id_); }
+};
+
+// The location of every active uniform of a linked program, read once with glGetActiveUniform.
+//
+// Elements of arrays are found by name ("u_array[1]") as well as the array itself ("u_array").
+class UniformTable
+{
+  std::unordered_map<std::string, GLint> locations_;
+
+  // The locations by Uniform id, looked up in the table the first time each id is used.
+  std::vector<GLint> by_id_;
+
+  static GLint constexpr UNRESOLVED = -2;
+
+public:
+  NOCOPY_MOVE_DEFAULT(UniformTable);
+  explicit UniformTable(GLuint);
+
+  // -1 (the same as glGetUniformLocation) if the program has no such active uniform.
+  GLint find(GLchar const*) const;
+  GLint find(size_t);
+
+  auto size() const { return locations_.size(); }
+};
+
 class ShaderProgram
 {
-  ProgramHandle program_;
+  ProgramHandle   program_;
   VertexAttribute va_;
+  UniformTable    uniforms_;
 
 #ifdef DEBUG_BUILD
   PathToShaderSources source_paths_;
@@ -96,6 +157,7 @@ public:
                          )
       : program_(MOVE(ph))
       , va_(MOVE(va))
+      , uniforms_(program_.handle())
 #ifdef DEBUG_BUILD
       , source_paths_(MOVE(sources))
 #endif
@@ -120,6 +182,11 @@ public:
   std::string to_string() const;
 
   GLint get_uniform_location(common::Logger&, GLchar const*);
+
+  // The location of the uniform with the Uniform id.
+  GLint get_uniform_location(common::Logger&, size_t);
+
+  auto const& uniforms() const { return uniforms_; }
 };
 
 class ShaderPrograms
@@ -275,12 +342,7 @@ set_uniform_matrix(GLint const loc, F const& f, T const& matrix)
   f(loc, COUNT, TRANSPOSE_MATRICES, glm::value_ptr(matrix));
 }
 
-} // namespace detail
-
-namespace shader
-{
-
-// Set a uniform variable for the shader program (argument).
+// Set the uniform at the location, "name" is only used for logging.
 //
 // This function maps user types to types understood by OpenGL, ie: primitives, array's, and
 // matrices.
@@ -288,26 +350,23 @@ namespace shader
 // This mapping from user-type to OpenGL type happens at compile time.
 template <typename Uniform>
 void
-set_uniform(common::Logger& logger, ShaderProgram& sp, GLchar const* name, Uniform const& uniform)
+set_uniform_at(common::Logger& logger, GLint const loc, GLchar const* name, Uniform const& uniform)
 {
   static_assert(!std::is_const<Uniform>::value);
   static_assert(!std::is_reference<Uniform>::value);
 
   using namespace boomhs;
-  DEBUG_ASSERT_BOUND(sp);
-
-  // Lookup the location of the uniform in the shader program.
-  auto const loc = sp.get_uniform_location(logger, name);
 
   // Helper function that firsts log's information about the uniform varible being set, and then
-  // executes the function to set the uniform variable.
-  auto const log_then_set = [&](char const* type_name, auto const& data_string,
+  // executes the function to set the uniform variable. The data is only converted to a string when
+  // the log line is written.
+  auto const log_then_set = [&](char const* type_name, auto const& data_string_fn,
                                 auto const& set_uniform_fn, auto&&... args) {
     LOG_DEBUG_SPRINTF("Setting OpenGL Program uniform, name: '%s:%s' location: '%d' data: '%s'",
                       name,
                       type_name,
                       loc,
-                      data_string);
+                      data_string_fn());
     set_uniform_fn(FORWARD(args));
   };
 
@@ -315,15 +374,15 @@ set_uniform(common::Logger& logger, ShaderProgram& sp, GLchar const* name, Unifo
   // the table below as simple as possible.
   auto const set_pod = [&](auto const& gl_fn, auto const& value, char const* type_name) {
     auto const fn = [&]() { detail::set_uniform_value(loc, gl_fn, value); };
-    log_then_set(type_name, std::to_string(value), fn);
+    log_then_set(type_name, [&]() { return std::to_string(value); }, fn);
   };
   auto const set_array = [&](auto const& gl_fn, auto const& array, char const* type_name) {
     auto const fn = [&]() { detail::set_uniform_array(loc, gl_fn, array.data()); };
-    log_then_set(type_name, common::stringify(array), fn);
+    log_then_set(type_name, [&]() { return common::stringify(array); }, fn);
   };
   auto const set_vecn = [&](auto const& gl_fn, auto const& vecn, char const* type_name) {
     auto const fn = [&]() { detail::set_uniform_array(loc, gl_fn, glm::value_ptr(vecn)); };
-    log_then_set(type_name, glm::to_string(vecn), fn);
+    log_then_set(type_name, [&]() { return glm::to_string(vecn); }, fn);
   };
   auto const set_color = [&](auto const& gl_fn, auto const& color, char const* type_name) {
     if constexpr(TYPES_MATCH(Uniform, ColorRGB)) {
@@ -339,7 +398,7 @@ set_uniform(common::Logger& logger, ShaderProgram& sp, GLchar const* name, Unifo
   };
   auto const set_matrix = [&](auto const& gl_fn, auto const& matrix, char const* type_name) {
     auto const fn = [&]() { detail::set_uniform_matrix(loc, gl_fn, matrix); };
-    log_then_set(type_name, glm::to_string(matrix), fn);
+    log_then_set(type_name, [&]() { return glm::to_string(matrix); }, fn);
   };
 
   // clang-format on
@@ -401,6 +460,33 @@ set_uniform(common::Logger& logger, ShaderProgram& sp, GLchar const* name, Unifo
 #undef ELIF_MAP_TYPE
 }
 
+} // namespace detail
+
+namespace shader
+{
+
+// Set a uniform variable for the shader program (argument), the program must be bound.
+//
+// Prefer setting uniforms through a Uniform handle in code running per-entity or per-light.
+template <typename T>
+void
+set_uniform(common::Logger& logger, ShaderProgram& sp, Uniform<T> const& handle,
+            typename Uniform<T>::value_type const& value)
+{
+  DEBUG_ASSERT_BOUND(sp);
+  auto const loc = sp.get_uniform_location(logger, handle.id());
+  detail::set_uniform_at(logger, loc, handle.name(), value);
+}
+
+template <typename T>
+void
+set_uniform(common::Logger& logger, ShaderProgram& sp, GLchar const* name, T const& value)
+{
+  DEBUG_ASSERT_BOUND(sp);
+  auto const loc = sp.get_uniform_location(logger, name);
+  detail::set_uniform_at(logger, loc, name, value);
+}
+
 template <typename T>
 void
 set_uniform(common::Logger& logger, ShaderProgram& sp, std::string const& name, T const& value)
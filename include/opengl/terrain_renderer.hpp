@@ -18,6 +18,7 @@ class  Terrain;
 
 namespace opengl
 {
+class GpuResidency;
 struct RenderState;
 class ShaderProgram;
 class TextureTable;
@@ -35,8 +36,9 @@ public:
   void render(RenderState&, boomhs::MaterialTable const&, boomhs::EntityRegistry& registry,
               boomhs::FrameTime const&, glm::vec4 const&);
 
-  void bind_impl(common::Logger&, boomhs::Terrain const&, opengl::TextureTable&);
-  void unbind_impl(common::Logger&, boomhs::Terrain const&, opengl::TextureTable&);
+  // The terrain's textures are resolved through the GpuResidency, see Terrain::texture_handles.
+  void bind_impl(common::Logger&, boomhs::Terrain const&, GpuResidency&, TextureTable&);
+  void unbind_impl(common::Logger&, boomhs::Terrain const&, GpuResidency&, TextureTable&);
   DEFAULT_WHILEBOUND_MEMBERFN_DECLATION();
 
   std::string to_string() const;
@@ -1,5 +1,6 @@
 #pragma once
 #include <opengl/bind.hpp>
+#include <opengl/texture_handle.hpp>
 
 #include <common/auto_resource.hpp>
 #include <common/log.hpp>
@@ -28,6 +29,9 @@ struct TextureInfo
   GLint width = 0, height = 0;
   float uv_max = -1.0;
 
+  // The GPU memory of the texture's images (and mipmaps), counted by GpuMemory.
+  size_t num_bytes = 0;
+
   // constructors
   TextureInfo();
   NOCOPY_MOVE_DEFAULT(TextureInfo);
@@ -41,6 +45,9 @@ struct TextureInfo
 
   void gen_texture(common::Logger&, GLsizei);
 
+  // Count the GPU memory of "num_images" images of the texture's size and format, with mipmaps.
+  void count_gpu_memory(size_t);
+
   GLint get_fieldi(GLenum);
   void  set_fieldi(GLenum, GLint);
 
@@ -66,17 +73,29 @@ operator<(TextureFilenames const& a, TextureFilenames const& b)
 }
 
 using Texture = common::AutoResource<TextureInfo>;
+
+// The textures of a level, by name.
+//
+// Most textures are uploaded when the level loads and stay on the GPU. Streamed textures are only
+// uploaded while they are used (see GpuResidency), until then their TextureInfo only holds the
+// parameters they are uploaded with (it's id is 0). Streamed textures are only drawn through their
+// handles, never found by name.
 class TextureTable
 {
-  using pair_t = std::pair<TextureFilenames, Texture>;
-  std::map<TextureFilenames, Texture> data_;
+  using map_t  = std::map<TextureFilenames, Texture>;
+  using pair_t = map_t::value_type;
+  map_t data_;
+
+  // The textures in the order they were added, indexed by their handles.
+  std::vector<map_t::iterator> handles_;
+  std::vector<bool>            streamed_;
 
 public:
   TextureTable() = default;
   NOCOPY_MOVE_DEFAULT(TextureTable);
   BEGIN_END_FORWARD_FNS(data_);
 
-  void add_texture(TextureFilenames&&, Texture&&);
+  void add_texture(TextureFilenames&&, Texture&&, bool = false);
 
   // Get a concatenated list of all texture names as a single string.
   //
@@ -89,6 +108,21 @@ public:
   TextureFilenames const* lookup_nickname(std::string const&) const;
   TextureInfo*            find(std::string const&);
   TextureInfo const*      find(std::string const&) const;
+
+  // The handle of the texture, an invalid handle if there is no texture by that name.
+  TextureHandle handle(std::string const&) const;
+
+  // The texture, whether or not it's on the GPU.
+  TextureInfo&       get(TextureHandle);
+  TextureInfo const& get(TextureHandle) const;
+
+  bool is_streamed(TextureHandle) const;
+  bool is_resident(TextureHandle) const;
+
+  // Upload the streamed texture to the GPU, or free it's GPU memory. The texture keeps the
+  // parameters it's uploaded with.
+  Result<common::none_t, std::string> upload(common::Logger&, TextureHandle);
+  void                                evict(TextureHandle);
 };
 
 using ImageDataPointer = std::unique_ptr<unsigned char, void (*)(unsigned char*)>;
@@ -109,13 +143,14 @@ using TextureResult = Result<Texture, std::string>;
 ImageResult
 load_image(common::Logger&, char const*, GLenum const);
 
-GLint
-wrap_mode_from_string(char const*);
-
 TextureResult
 upload_2d_texture(common::Logger&, std::string const&, TextureInfo&&);
 
 TextureResult
 upload_3dcube_texture(common::Logger&, std::vector<std::string> const&, TextureInfo&&);
 
+// A 1x1 grey texture, drawn instead of streamed textures not on the GPU yet.
+TextureResult
+upload_placeholder_texture(common::Logger&);
+
 } // namespace opengl::texture
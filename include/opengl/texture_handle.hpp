@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace opengl
+{
+
+// A texture of a TextureTable, valid for as long as the table is.
+//
+// Unlike a TextureInfo pointer, a handle stays valid while it's texture is evicted from (and
+// uploaded to) the GPU again. It's resolved to the texture every frame it's drawn, see
+// GpuResidency::texture().
+struct TextureHandle
+{
+  using value_type = uint32_t;
+  static value_type constexpr INVALID = std::numeric_limits<value_type>::max();
+
+  value_type value = INVALID;
+
+  bool valid() const { return INVALID != value; }
+};
+
+} // namespace opengl
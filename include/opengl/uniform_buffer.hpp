@@ -0,0 +1,163 @@
+#pragma once
+#include <common/type_macros.hpp>
+
+#include <extlibs/glew.hpp>
+#include <extlibs/glm.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boomhs
+{
+class FrameState;
+} // namespace boomhs
+
+namespace opengl
+{
+
+// A GL_UNIFORM_BUFFER holding the contents of one uniform block.
+//
+// The contents are kept on the CPU too, uploading the same contents again (ie: the lighting of each
+// pass within a frame) is skipped.
+class UniformBuffer
+{
+  GLuint id_ = 0;
+  GLuint binding_;
+
+  std::vector<uint8_t> contents_;
+
+  NO_COPY(UniformBuffer);
+
+public:
+  explicit UniformBuffer(GLuint, size_t);
+  ~UniformBuffer();
+
+  UniformBuffer(UniformBuffer&&);
+  NO_MOVE_ASSIGN(UniformBuffer);
+
+  auto id() const { return id_; }
+  auto binding() const { return binding_; }
+  auto size() const { return contents_.size(); }
+
+  // Bind the buffer to it's binding point, uploading the contents if they changed.
+  void update(void const*);
+
+  template <typename T>
+  void update(T const& block)
+  {
+    assert(sizeof(T) == size());
+    update(static_cast<void const*>(&block));
+  }
+};
+
+// The std140 layout of the uniform blocks declared in shaders/3d_common.glsl_both and
+// shaders/3d_common.glsl_frag. Every vec3 (and struct) starts on a 16 byte boundary, so they're
+// stored as vec4's here.
+namespace std140
+{
+
+struct CameraBlock
+{
+  glm::mat4 view           = glm::mat4{1.0f};
+  glm::mat4 invview        = glm::mat4{1.0f};
+  glm::vec4 world_position = glm::vec4{0.0f};
+};
+
+struct FogBlock
+{
+  float density       = 0.0f;
+  float gradient      = 0.0f;
+  float mix_intensity = 0.0f;
+  float pad0          = 0.0f;
+
+  glm::vec4 color     = glm::vec4{0.0f};
+  glm::vec4 mix_color = glm::vec4{0.0f};
+};
+
+struct Attenuation
+{
+  float constant  = 0.0f;
+  float linear    = 0.0f;
+  float quadratic = 0.0f;
+  float pad0      = 0.0f;
+};
+
+struct DirectionalLight
+{
+  glm::vec4 direction       = glm::vec4{0.0f};
+  glm::vec4 diffuse         = glm::vec4{0.0f};
+  glm::vec4 specular        = glm::vec4{0.0f};
+  glm::vec2 screenspace_pos = glm::vec2{0.0f};
+  glm::vec2 pad0            = glm::vec2{0.0f};
+
+  Attenuation attenuation;
+};
+
+struct PointLight
+{
+  glm::vec4 position = glm::vec4{0.0f};
+  glm::vec4 diffuse  = glm::vec4{0.0f};
+  glm::vec4 specular = glm::vec4{0.0f};
+
+  Attenuation attenuation;
+};
+
+struct LightingBlock
+{
+  // Same as MAX_NUM_POINTLIGHTS in the shaders.
+  static size_t constexpr MAX_POINTLIGHTS = 6;
+
+  glm::vec4        ambient = glm::vec4{0.0f};
+  DirectionalLight dirlight;
+
+  std::array<PointLight, MAX_POINTLIGHTS> pointlights;
+
+  float reflectivity = 0.0f;
+  float pad0[3]      = {};
+};
+
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock doesn't match it's std140 layout");
+static_assert(sizeof(FogBlock) == 48, "FogBlock doesn't match it's std140 layout");
+static_assert(sizeof(DirectionalLight) == 80, "DirectionalLight doesn't match std140");
+static_assert(sizeof(PointLight) == 64, "PointLight doesn't match it's std140 layout");
+static_assert(offsetof(LightingBlock, pointlights) == 96, "LightingBlock doesn't match std140");
+static_assert(offsetof(LightingBlock, reflectivity) == 480, "LightingBlock doesn't match std140");
+
+} // namespace std140
+
+// The camera, fog and lighting uniforms every program shares, as uniform blocks.
+//
+// They're uploaded once per pass (each pass may use a different camera), instead of being set on
+// each program for every entity drawn. Only the per-entity uniforms (model matrices, material) are
+// still set for each draw.
+class UniformBlocks
+{
+  UniformBuffer camera_;
+  UniformBuffer fog_;
+  UniformBuffer lighting_;
+
+public:
+  // The binding point of each block, and the block's name in the shaders.
+  static GLuint constexpr CAMERA_BINDING   = 0;
+  static GLuint constexpr FOG_BINDING      = 1;
+  static GLuint constexpr LIGHTING_BINDING = 2;
+
+  static std::array<char const*, 3> constexpr BLOCK_NAMES = {
+      {"CameraBlock", "FogBlock", "LightingBlock"}};
+
+  UniformBlocks();
+  MOVE_CONSTRUCTIBLE_ONLY(UniformBlocks);
+
+  // Upload (and bind) the camera, fog and lighting of the frame state, at the start of a pass.
+  void update(boomhs::FrameState const&);
+
+  // Connect the program's uniform blocks to their binding points, after the program is linked.
+  //
+  // GLSL ES 3.00 has no layout(binding = N) qualifier, so this is done once per program instead.
+  static void bind_program(GLuint);
+};
+
+} // namespace opengl
@@ -26,7 +26,11 @@ public:
 
   explicit VAO() { glGenVertexArrays(NUM_BUFFERS, &vao_); }
 
-  ~VAO() { glDeleteVertexArrays(NUM_BUFFERS, &vao_); }
+  ~VAO()
+  {
+    GLState::delete_vertex_array(vao_);
+    glDeleteVertexArrays(NUM_BUFFERS, &vao_);
+  }
 
   // move-construction OK.
   VAO(VAO&& other)
@@ -39,7 +43,16 @@ public:
   auto gl_raw_value() const { return vao_; }
 
   void bind_impl(common::Logger&) { global::vao_bind(*this); }
-  void unbind_impl(common::Logger&) { global::vao_unbind(); }
+
+  // Every GL_ELEMENT_ARRAY_BUFFER bind happens while it's VAO is bound, so leaving the VAO bound
+  // afterwards is harmless. Skipping the unbind lets back to back draws of the same VAO (the
+  // pooled geometry) skip rebinding it.
+  void unbind_impl(common::Logger&)
+  {
+#ifdef DEBUG_BUILD
+    global::vao_unbind();
+#endif
+  }
   DEFAULT_WHILEBOUND_MEMBERFN_DECLATION();
 
   std::string to_string() const;
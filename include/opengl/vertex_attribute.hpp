@@ -1,7 +1,10 @@
 #pragma once
 #include <common/log.hpp>
 #include <extlibs/glew.hpp>
+
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace opengl
 {
@@ -20,6 +23,16 @@ enum class AttributeType
 AttributeType
 attribute_type_from_string(char const*);
 
+// The GL datatype named by the string ("float", "half_float", "unsigned_byte" or
+// "int_2_10_10_10_rev"), or AttributePointerInfo::INVALID_TYPE.
+GLint
+datatype_from_string(char const*);
+
+// Describes one attribute of a vertex.
+//
+// The vertex data is always built as floats, "component_count" of them for this attribute. When
+// the datatype isn't GL_FLOAT, the floats are quantized to the datatype before they are copied to
+// the GPU (see VertexAttribute::pack()).
 struct AttributePointerInfo
 {
   static constexpr auto INVALID_TYPE = -1;
@@ -30,14 +43,25 @@ struct AttributePointerInfo
   AttributeType typezilla       = AttributeType::OTHER;
   GLsizei       component_count = 0;
 
+  // Integer datatypes are mapped to [0, 1] (unsigned) or [-1, 1] (signed) when read by the shader.
+  bool normalized = false;
+
   // constructors
   AttributePointerInfo() = default;
-  AttributePointerInfo(GLuint const, GLint const, AttributeType const, GLsizei const);
+  AttributePointerInfo(GLuint const, GLint const, AttributeType const, GLsizei const,
+                       bool const = false);
 
   COPYMOVE_DEFAULT(AttributePointerInfo);
 
   // methods
   std::string to_string() const;
+
+  // The number of components GL reads, GL_INT_2_10_10_10_REV always packs four.
+  GLint gl_component_count() const;
+
+  // The number of bytes the attribute takes up within a vertex, padded to a multiple of four so
+  // every attribute stays aligned.
+  GLsizei size_in_bytes() const;
 };
 
 std::ostream&
@@ -49,8 +73,9 @@ public:
   static constexpr GLsizei API_BUFFER_SIZE = 4;
 
 private:
-  size_t                                            num_apis_;
-  GLsizei                                           stride_;
+  size_t  num_apis_;
+  GLsizei stride_;
+
   std::array<AttributePointerInfo, API_BUFFER_SIZE> apis_;
 
   COPY_DEFAULT(VertexAttribute);
@@ -60,13 +85,30 @@ public:
                            std::array<AttributePointerInfo, API_BUFFER_SIZE>&&);
 
   void upload_vertex_format_to_glbound_vao(common::Logger&) const;
+
+  // The size of a vertex, in bytes.
   auto stride() const { return stride_; }
 
+  // The number of floats a vertex is built from, before it's packed.
+  GLsizei float_stride() const;
+
   bool has_vertices() const;
   bool has_normals() const;
   bool has_colors() const;
   bool has_uvs() const;
 
+  // True if any attribute isn't stored as floats on the GPU.
+  bool is_quantized() const;
+
+  // Pack interleaved float vertices (float_stride() floats per vertex) into this layout.
+  std::vector<uint8_t> pack(float const*, size_t) const;
+
+  template <typename T>
+  auto pack(T const& floats) const
+  {
+    return pack(floats.data(), floats.size());
+  }
+
   auto clone() const { return *this; }
 
   std::string to_string() const;
@@ -90,7 +132,7 @@ make_vertex_attribute(ITB const begin, ITE const end)
 
   GLsizei stride = 0;
   for (auto it = begin; it != end; std::advance(it, 1)) {
-    stride += it->component_count;
+    stride += it->size_in_bytes();
   }
 
   return VertexAttribute{num_vas, stride, MOVE(infos)};
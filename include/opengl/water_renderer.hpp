@@ -2,6 +2,7 @@
 #include <boomhs/camera.hpp>
 #include <boomhs/engine.hpp>
 #include <boomhs/frame.hpp>
+#include <boomhs/game_config.hpp>
 #include <boomhs/level_manager.hpp>
 #include <boomhs/viewport.hpp>
 
@@ -30,6 +31,9 @@ static float constexpr CUTOFF_HEIGHT      = 0.4f;
 static glm::vec4 constexpr ABOVE_VECTOR   = {0, -1, 0, CUTOFF_HEIGHT};
 static glm::vec4 constexpr BENEATH_VECTOR = {0, 1, 0, -CUTOFF_HEIGHT};
 
+ShaderProgram&
+graphics_mode_to_water_shader(common::Logger&, boomhs::GameGraphicsMode, ShaderPrograms&);
+
 class SilhouetteWaterRenderer
 {
   opengl::ShaderProgram* sp_;
@@ -44,11 +48,11 @@ public:
 class BasicWaterRenderer
 {
   opengl::ShaderProgram* sp_;
-  opengl::TextureInfo*   diffuse_;
-  opengl::TextureInfo*   normal_;
+  opengl::TextureHandle  diffuse_;
+  opengl::TextureHandle  normal_;
 
 public:
-  BasicWaterRenderer(common::Logger&, opengl::TextureInfo&, opengl::TextureInfo&,
+  BasicWaterRenderer(common::Logger&, opengl::TextureHandle, opengl::TextureHandle,
                      opengl::ShaderProgram&);
   NOCOPY_MOVE_DEFAULT(BasicWaterRenderer);
 
@@ -58,11 +62,11 @@ public:
 class MediumWaterRenderer
 {
   opengl::ShaderProgram* sp_;
-  opengl::TextureInfo*   diffuse_;
-  opengl::TextureInfo*   normal_;
+  opengl::TextureHandle  diffuse_;
+  opengl::TextureHandle  normal_;
 
 public:
-  MediumWaterRenderer(common::Logger&, opengl::TextureInfo&, opengl::TextureInfo&,
+  MediumWaterRenderer(common::Logger&, opengl::TextureHandle, opengl::TextureHandle,
                       opengl::ShaderProgram&);
   NOCOPY_MOVE_DEFAULT(MediumWaterRenderer);
 
@@ -94,9 +98,9 @@ struct RefractionBuffers
 class AdvancedWaterRenderer
 {
   opengl::ShaderProgram* sp_;
-  opengl::TextureInfo*   diffuse_;
-  opengl::TextureInfo*   dudv_;
-  opengl::TextureInfo*   normal_;
+  opengl::TextureHandle  diffuse_;
+  opengl::TextureHandle  dudv_;
+  opengl::TextureHandle  normal_;
 
   ReflectionBuffers reflection_;
   RefractionBuffers refraction_;
@@ -138,51 +142,56 @@ public:
   NOCOPY_MOVE_DEFAULT(AdvancedWaterRenderer);
 
   explicit AdvancedWaterRenderer(common::Logger&, boomhs::Viewport const&,
-                                 ShaderProgram&, TextureInfo&, TextureInfo&, TextureInfo&);
+                                 ShaderProgram&, TextureHandle, TextureHandle, TextureHandle);
+
+  // The FrameState the reflection is rendered from, the camera moved beneath the water.
+  static boomhs::FrameState
+  reflection_framestate(boomhs::EngineState&, boomhs::ZoneState&, boomhs::Camera const&);
 
+  // Drawn from the frame's RenderSnapshot::reflection camera, the main pass' FrameState gives the
+  // camera's mode.
   template <typename TerrainRenderer, typename EntityRenderer>
-  void render_reflection(boomhs::EngineState& es, DrawState& ds, boomhs::LevelManager& lm,
-                         boomhs::Camera& camera, EntityRenderer& er, SkyboxRenderer& sr,
-                         TerrainRenderer& tr, boomhs::RNG& rng, boomhs::FrameTime const& ft)
+  void render_reflection(boomhs::FrameState const& main, DrawState& ds, boomhs::LevelManager& lm,
+                         EntityRenderer& er, SkyboxRenderer& sr, TerrainRenderer& tr,
+                         boomhs::RNG& rng, boomhs::FrameTime const& ft)
   {
+    auto&       es        = main.es;
     auto&       logger    = es.logger;
     auto&       zs        = lm.active();
     auto&       ldata     = zs.level_data;
     auto&       registry  = zs.registry;
     auto const& fog_color = ldata.fog.color;
 
-    // Compute the camera position beneath the water for capturing the reflective image the camera
-    // will see.
-    //
-    // By inverting the camera's Y position before computing the view matrices, we can render the
-    // world as if the camera was beneath the water's surface. This is how computing the reflection
-    // texture works.
-    glm::vec3 camera_pos = camera.position();
-    camera_pos.y         = -camera_pos.y;
-
-    auto fs = boomhs::FrameState::from_camera_withposition(
-        es, zs, camera, camera.view_settings_ref(), es.frustum, camera_pos);
-    RenderState rstate{fs, ds};
+    auto const& view = zs.gfx_state.snapshot.reflection;
+    boomhs::CameraFrameState cfs{view.position, view.matrices, es.frustum, main.camera_mode()};
+    boomhs::FrameState       fs{es, zs, MOVE(cfs)};
+    RenderState              rstate{fs, ds};
+    rstate.visible = zs.gfx_state.visibility.find(boomhs::VisibilityPass::Reflection);
+    zs.gfx_state.uniform_blocks.update(fs);
 
     with_reflection_fbo(logger,
                         [&]() { advanced_common(rstate, es, lm, ds, er, sr, tr, rng, ft); });
   }
 
+  // Drawn from the main pass' camera.
   template <typename TerrainRenderer, typename EntityRenderer>
-  void render_refraction(boomhs::EngineState& es, DrawState& ds, boomhs::LevelManager& lm,
-                         boomhs::Camera& camera, EntityRenderer& er, SkyboxRenderer& sr,
-                         TerrainRenderer& tr, boomhs::RNG& rng, boomhs::FrameTime const& ft)
+  void render_refraction(boomhs::FrameState& fs, DrawState& ds, boomhs::LevelManager& lm,
+                         EntityRenderer& er, SkyboxRenderer& sr, TerrainRenderer& tr,
+                         boomhs::RNG& rng, boomhs::FrameTime const& ft)
   {
+    auto&       es        = fs.es;
     auto&       zs        = lm.active();
     auto&       logger    = es.logger;
     auto&       ldata     = zs.level_data;
     auto&       registry  = zs.registry;
     auto const& fog_color = ldata.fog.color;
 
-    auto fs =
-        boomhs::FrameState::from_camera(es, zs, camera, camera.view_settings_ref(), es.frustum);
     RenderState rstate{fs, ds};
 
+    // Drawn from the main camera, so the main camera's visible set is reused.
+    rstate.visible = zs.gfx_state.visibility.find(boomhs::VisibilityPass::Camera);
+    zs.gfx_state.uniform_blocks.update(fs);
+
     with_refraction_fbo(logger,
                         [&]() { advanced_common(rstate, es, lm, ds, er, sr, tr, rng, ft); });
   }
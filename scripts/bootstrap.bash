@@ -89,6 +89,60 @@ file(GLOB         MAIN_SOURCE_FILE         ${PROJECT_DIR}/source/main.cxx)
 file(GLOB_RECURSE SUBDIR_SOURCE_FILES      ${PROJECT_DIR}/source/**/*.cxx)
 file(GLOB         DEMO_COMMON_SOURCE_FILES ${PROJECT_DIR}/demo/source/*.cxx)
 
+## The gameplay simulation and the CPU halves of the level loader and zone snapshots. Nothing in
+## these files may call into OpenGL, SDL or OpenAL; the headless simulation and tests link only
+## these.
+set(SIMULATION_SOURCE_FILES
+  ${PROJECT_DIR}/source/common/async_log.cxx
+  ${PROJECT_DIR}/source/common/frame_arena.cxx
+  ${PROJECT_DIR}/source/common/log.cxx
+  ${PROJECT_DIR}/source/common/phase_timer.cxx
+  ${PROJECT_DIR}/source/common/profiler.cxx
+  ${PROJECT_DIR}/source/common/time.cxx
+  ${PROJECT_DIR}/source/common/timer.cxx
+  ${PROJECT_DIR}/source/boomhs/billboard.cxx
+  ${PROJECT_DIR}/source/boomhs/bounding_object.cxx
+  ${PROJECT_DIR}/source/boomhs/components.cxx
+  ${PROJECT_DIR}/source/boomhs/entity.cxx
+  ${PROJECT_DIR}/source/boomhs/euler.cxx
+  ${PROJECT_DIR}/source/boomhs/gcd.cxx
+  ${PROJECT_DIR}/source/boomhs/heightmap.cxx
+  ${PROJECT_DIR}/source/boomhs/inventory.cxx
+  ${PROJECT_DIR}/source/boomhs/item.cxx
+  ${PROJECT_DIR}/source/boomhs/item_factory.cxx
+  ${PROJECT_DIR}/source/boomhs/level_compiler.cxx
+  ${PROJECT_DIR}/source/boomhs/level_loader.cxx
+  ${PROJECT_DIR}/source/boomhs/leveldata.cxx
+  ${PROJECT_DIR}/source/boomhs/lighting.cxx
+  ${PROJECT_DIR}/source/boomhs/material.cxx
+  ${PROJECT_DIR}/source/boomhs/math.cxx
+  ${PROJECT_DIR}/source/boomhs/mesh.cxx
+  ${PROJECT_DIR}/source/boomhs/mesh_lod.cxx
+  ${PROJECT_DIR}/source/boomhs/mesh_optimizer.cxx
+  ${PROJECT_DIR}/source/boomhs/nearby_targets.cxx
+  ${PROJECT_DIR}/source/boomhs/npc.cxx
+  ${PROJECT_DIR}/source/boomhs/obj.cxx
+  ${PROJECT_DIR}/source/boomhs/obj_store.cxx
+  ${PROJECT_DIR}/source/boomhs/occlusion.cxx
+  ${PROJECT_DIR}/source/boomhs/player.cxx
+  ${PROJECT_DIR}/source/boomhs/render_snapshot.cxx
+  ${PROJECT_DIR}/source/boomhs/simulation.cxx
+  ${PROJECT_DIR}/source/boomhs/simulation_thread.cxx
+  ${PROJECT_DIR}/source/boomhs/skybox.cxx
+  ${PROJECT_DIR}/source/boomhs/start_area_generator.cxx
+  ${PROJECT_DIR}/source/boomhs/terrain.cxx
+  ${PROJECT_DIR}/source/boomhs/transform.cxx
+  ${PROJECT_DIR}/source/boomhs/transform_system.cxx
+  ${PROJECT_DIR}/source/boomhs/water.cxx
+  ${PROJECT_DIR}/source/boomhs/world_object.cxx
+  ${PROJECT_DIR}/source/boomhs/zone_snapshot.cxx
+  ${PROJECT_DIR}/source/opengl/geometry_cache.cxx
+  ${PROJECT_DIR}/source/opengl/vertex_attribute.cxx
+  ${EXTERNAL_DIR}/tinyobj/source/tinyobj.cxx)
+
+list(REMOVE_ITEM SUBDIR_SOURCE_FILES ${SIMULATION_SOURCE_FILES})
+list(REMOVE_ITEM EXTERNAL_SOURCES    ${SIMULATION_SOURCE_FILES})
+
 set(SUBDIR_AND_EXTERNAL_SOURCE_FILES ${EXTERNAL_SOURCES}                 ${SUBDIR_SOURCE_FILES})
 set(DEMO_AND_EXTERNAL_SOURCE_FILES   ${EXTERNAL_SOURCES}                 ${DEMO_COMMON_SOURCE_FILES})
 set(ALL_SOURCE_FILES                 ${SUBDIR_AND_EXTERNAL_SOURCE_FILES} ${MAIN_SOURCE_FILE})
@@ -104,6 +158,7 @@ find_package(DL REQUIRED)
 find_package(OpenAL REQUIRED)
 find_package(OpenGL REQUIRED)
 find_package(GLEW REQUIRED)
+find_package(PNG REQUIRED)
 find_package(SOIL REQUIRED)
 find_package(ZLIB REQUIRED)
 
@@ -146,9 +201,16 @@ pkg_search_module(SDL2 REQUIRED sdl2)
 ## Static Libraries
 ###################################################################################################
 
+add_library(SIMULATION_SOURCE_CODE  STATIC ${SIMULATION_SOURCE_FILES})
 add_library(PROJECT_SOURCE_CODE     STATIC ${SUBDIR_AND_EXTERNAL_SOURCE_FILES})
 add_library(DEMO_COMMON_SOURCE_CODE STATIC ${DEMO_AND_EXTERNAL_SOURCE_FILES})
 
+target_include_directories(SIMULATION_SOURCE_CODE PUBLIC
+  ${EXTERNAL_INCLUDE_DIRS}
+  ${GLEW_INCLUDE_DIRS}
+  ${PNG_INCLUDE_DIRS}
+  )
+
 target_include_directories(DEMO_COMMON_SOURCE_CODE PUBLIC
   ${DEMO_DIRECTORY_INCLUDE_DIR}
   ${EXTERNAL_INCLUDE_DIRS}
@@ -181,6 +243,9 @@ target_include_directories(PROJECT_SOURCE_CODE PUBLIC
 ## target_link_libraries(Opengl_LIB External_LIB COMMON_LIB ${BFD_LIB} ${STACKTRACE_LIB})
 ## target_link_libraries(GL_SSTACKTRACE_LIB External_LIB Opengl_LIB COMMON_LIB ${BFD_LIB} ${STACKTRACE_LIB})
 
+target_link_libraries(SIMULATION_SOURCE_CODE ${PNG_LIBRARIES})
+target_link_libraries(PROJECT_SOURCE_CODE    SIMULATION_SOURCE_CODE)
+
 ###################################################################################################
 ## Executables
 ###################################################################################################
@@ -212,6 +277,34 @@ add_executable(BUILD_POSTPROCESSING ${TOOLS_DIRECTORY}/build_postprocessing.cxx)
 target_include_directories(BUILD_POSTPROCESSING PUBLIC ${EXTERNAL_INCLUDE_DIRS})
 target_link_libraries(     BUILD_POSTPROCESSING stdc++ stdc++fs)
 
+###################################################################################################
+## COMPILE -- Headless Simulation
+##
+## Runs the gameplay simulation without a window, OpenGL context or audio device and reports the
+## ticks per second achieved. It links only the simulation's code (not OpenGL, SDL or OpenAL), so
+## it builds and runs on machines without them.
+add_executable(headless_simulation ${TOOLS_DIRECTORY}/headless_simulation.cxx)
+
+target_link_libraries(headless_simulation
+  SIMULATION_SOURCE_CODE
+  stdc++
+  m
+  pthread
+  )
+
+###################################################################################################
+## COMPILE -- Level Compiler
+##
+## Compiles the TOML sources of levels into the binary level format loaded by the main executable.
+## The main executable compiles a level itself (slowly) if it's compiled file is missing or stale.
+add_executable(level_compiler ${TOOLS_DIRECTORY}/level_compiler.cxx)
+
+target_link_libraries(level_compiler
+  PROJECT_SOURCE_CODE
+  ${SYSTEM_LIBS}
+  ${EXTERNAL_LIBS}
+  )
+
 ###################################################################################################
 ## COMPILE -- Multiple Viewports Mouse Selection Demo
 ##
@@ -258,6 +351,36 @@ target_link_libraries(debug-membug
 
 target_include_directories(debug-membug PUBLIC)
 
+###################################################################################################
+## COMPILE -- Headless Tests
+##
+## Tests that need no window or OpenGL context, run them with ctest from the build directory. Like
+## the headless simulation they link only the simulation's code, so they build and run on machines
+## without OpenGL, SDL or OpenAL.
+enable_testing()
+
+function(add_headless_test NAME)
+  add_executable(test-${NAME} ${TEST_DIRECTORY}/${NAME}.cxx)
+
+  target_link_libraries(test-${NAME}
+    SIMULATION_SOURCE_CODE
+    stdc++
+    m
+    pthread
+    )
+  add_test(NAME ${NAME} COMMAND test-${NAME})
+endfunction()
+
+add_headless_test(frame_arena)
+add_headless_test(geometry_cache)
+add_headless_test(level_compiler)
+add_headless_test(log_queue)
+add_headless_test(mesh_lod)
+add_headless_test(mesh_optimizer)
+add_headless_test(occlusion)
+add_headless_test(render_snapshot)
+add_headless_test(zone_snapshot)
+
 ###################################################################################################
 ## COMPILE -- Main Executable
 add_executable(boomhs ${MAIN_SOURCE_FILE})
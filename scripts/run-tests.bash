@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+source "scripts/common.bash"
+
+cd ${BUILD} && ctest --output-on-failure "$@"
@@ -4,16 +4,10 @@ in vec4 v_color;
 in float v_visibility;
 
 uniform Material         u_material;
-uniform AmbientLight     u_ambient;
-uniform PointLight       u_pointlights[MAX_NUM_POINTLIGHTS];
-uniform DirectionalLight u_dirlight;
 
 uniform int   u_drawnormals;
-uniform float u_reflectivity;
 
-uniform Fog u_fog;
 uniform mat4 u_modelmatrix;
-uniform mat4 u_invviewmatrix;
 
 out vec4 fragment_color;
 
@@ -7,8 +7,6 @@ uniform mat4 u_mv;
 uniform mat3 u_normalmatrix;
 
 // FOG
-uniform Fog u_fog;
-uniform mat4 u_viewmatrix;
 uniform mat4 u_modelmatrix;
 
 out vec4 v_position;
@@ -6,16 +6,10 @@ in float v_visibility;
 uniform sampler2D u_sampler;
 
 uniform Material         u_material;
-uniform PointLight       u_pointlights[MAX_NUM_POINTLIGHTS];
-uniform AmbientLight     u_ambient;
-uniform DirectionalLight u_dirlight;
 
 uniform int   u_drawnormals;
-uniform float u_reflectivity;
 
-uniform Fog u_fog;
 uniform mat4 u_modelmatrix;
-uniform mat4 u_invviewmatrix;
 
 out vec4 fragment_color;
 
@@ -7,8 +7,6 @@ out vec3 v_surfacenormal;
 out vec2 v_uv;
 out float v_visibility;
 
-uniform Fog u_fog;
-uniform mat4 u_viewmatrix;
 uniform mat4 u_modelmatrix;
 
 uniform mat4 u_mv;
@@ -4,7 +4,6 @@ out vec4 fragment_color;
 
 uniform samplerCube u_cube_sampler0;
 uniform samplerCube u_cube_sampler1;
-uniform Fog u_fog;
 uniform float u_blend_factor;
 
 const float limit_lower = 0.0;
@@ -4,7 +4,6 @@ out vec3 v_uv;
 out float v_visibility;
 
 uniform mat4 u_mv;
-uniform Fog u_fog;
 
 void main()
 {
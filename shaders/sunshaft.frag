@@ -2,9 +2,6 @@ in vec2 v_uv;
 
 uniform sampler2D u_sampler;
 
-// The center (in screen coordinates) of the light source
-uniform DirectionalLight u_dirlight;
-
 // The width of the blur (the smaller it is the further each pixel is going to sample)
 const float blurWidth = -0.85;
 
@@ -14,7 +11,7 @@ out vec4 fragment_color;
 
 void main()
 {
-  // compute ray from pixel to light center
+  // compute ray from pixel to light center (the light's screen coordinates, from LightingBlock)
   vec2 sun_pos = u_dirlight.screenspace_pos;
 
   vec2 ray = v_uv - sun_pos;
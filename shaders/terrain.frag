@@ -11,16 +11,10 @@ uniform sampler2D u_bsampler;
 uniform sampler2D u_blendsampler;
 
 uniform Material         u_material;
-uniform PointLight       u_pointlights[MAX_NUM_POINTLIGHTS];
-uniform AmbientLight     u_ambient;
-uniform DirectionalLight u_dirlight;
 
 uniform int   u_drawnormals;
-uniform float u_reflectivity;
 
-uniform Fog u_fog;
 uniform mat4 u_modelmatrix;
-uniform mat4 u_invviewmatrix;
 uniform float u_uvmodifier;
 
 out vec4 fragment_color;
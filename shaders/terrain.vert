@@ -8,8 +8,6 @@ out vec2 v_uv;
 out float v_visibility;
 out float clip_distance;
 
-uniform Fog u_fog;
-uniform mat4 u_viewmatrix;
 uniform mat4 u_modelmatrix;
 
 uniform mat4 u_mv;
@@ -14,22 +14,16 @@ uniform sampler2D u_normal_sampler;
 uniform sampler2D u_depth_sampler;
 
 uniform Material         u_material;
-uniform PointLight       u_pointlights[MAX_NUM_POINTLIGHTS];
-uniform AmbientLight     u_ambient;
-uniform DirectionalLight u_dirlight;
 
 uniform int   u_drawnormals;
-uniform float u_reflectivity;
 
 uniform float u_far;
 uniform float u_near;
 uniform float u_fresnel_reflect_power;
 uniform float u_depth_divider;
 
-uniform Fog u_fog;
 uniform Water u_water;
 uniform mat4 u_modelmatrix;
-uniform mat4 u_invviewmatrix;
 
 // water related
 uniform float u_wave_offset;
@@ -9,13 +9,10 @@ out float v_clipdistance;
 out vec2 v_fbouv;
 out vec3 v_tocamera;
 
-uniform Fog u_fog;
-uniform mat4 u_viewmatrix;
 uniform mat4 u_modelmatrix;
 
 uniform mat4 u_mv;
 uniform vec4 u_clipPlane;
-uniform vec3 u_camera_position;
 
 const float TILING = 4.0;
 
@@ -32,5 +29,5 @@ void main()
   v_clipdistance = dot(model_pos, u_clipPlane);
 
   v_fbouv = vec2(v_position.xy/2.0 + 0.5) * TILING;
-  v_tocamera = u_camera_position - model_pos.xyz;
+  v_tocamera = u_camera_position.xyz - model_pos.xyz;
 }
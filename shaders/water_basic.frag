@@ -9,7 +9,6 @@ uniform sampler2D u_normal_sampler;
 
 uniform int   u_drawnormals;
 
-uniform Fog u_fog;
 uniform Water u_water;
 uniform mat4 u_modelmatrix;
 uniform float u_time_offset;
@@ -7,8 +7,6 @@ out vec4 v_clipspace;
 out float v_visibility;
 out float v_clipdistance;
 
-uniform Fog u_fog;
-uniform mat4 u_viewmatrix;
 uniform mat4 u_modelmatrix;
 
 uniform mat4 u_mv;
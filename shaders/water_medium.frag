@@ -8,17 +8,11 @@ uniform sampler2D u_diffuse_sampler;
 uniform sampler2D u_normal_sampler;
 
 uniform Material         u_material;
-uniform PointLight       u_pointlights[MAX_NUM_POINTLIGHTS];
-uniform AmbientLight     u_ambient;
-uniform DirectionalLight u_dirlight;
 
 uniform int   u_drawnormals;
-uniform float u_reflectivity;
 
-uniform Fog u_fog;
 uniform Water u_water;
 uniform mat4 u_modelmatrix;
-uniform mat4 u_invviewmatrix;
 uniform float u_time_offset;
 uniform vec2 u_flowdir;
 
@@ -1,5 +1,8 @@
 #include <boomhs/audio.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::audio
+
 namespace boomhs
 {
 
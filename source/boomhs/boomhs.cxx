@@ -27,21 +27,29 @@
 #include <boomhs/player.hpp>
 
 #include <boomhs/random.hpp>
+#include <boomhs/render_groups.hpp>
+#include <boomhs/simulation.hpp>
 #include <boomhs/skybox.hpp>
 #include <boomhs/start_area_generator.hpp>
 #include <boomhs/state.hpp>
 #include <boomhs/terrain.hpp>
+#include <boomhs/transform_system.hpp>
 #include <boomhs/tree.hpp>
 #include <boomhs/ui_debug.hpp>
 #include <boomhs/ui_ingame.hpp>
 #include <boomhs/vertex_factory.hpp>
 #include <boomhs/vertex_interleave.hpp>
 #include <boomhs/water.hpp>
+#include <boomhs/zone_streamer.hpp>
 
+#include <opengl/buffer.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/texture.hpp>
 
 #include <common/log.hpp>
+#include <common/phase_timer.hpp>
+#include <common/profiler.hpp>
 #include <common/result.hpp>
 
 #include <extlibs/fastnoise.hpp>
@@ -110,179 +118,37 @@ update_playaudio(common::Logger& logger, EngineState& es, LevelData& ldata,
   }
 }
 
-void
-set_heights_ontop_terrain(common::Logger& logger, TerrainGrid& terrain, EntityRegistry& registry,
-                          EntityID const eid)
-{
-  auto&       transform = registry.get<Transform>(eid);
-  auto const& bbox      = registry.get<AABoundingBox>(eid).cube;
-  auto&       tr        = transform.translation;
-  float const height    = terrain.get_height(logger, tr.x, tr.z);
-
-  // update original transform
-  tr.y = bbox.half_widths().y + height;
-}
-
-void
-update_npcpositions(common::Logger& logger, EntityRegistry& registry, TerrainGrid& terrain,
-                    FrameTime const& ft)
-{
-  auto const update = [&](auto const eid) {
-    auto& npcdata = registry.get<NPCData>(eid);
-    auto& npc_hp  = npcdata.health;
-    if (NPC::is_dead(npc_hp)) {
-      return;
-    }
-    set_heights_ontop_terrain(logger, terrain, registry, eid);
-  };
-  for (auto const eid : registry.view<NPCData, Transform, AABoundingBox>()) {
-    update(eid);
-  }
-}
-
-void
-update_nearbytargets(NearbyTargets& nbt, EntityRegistry& registry, FrameTime const& ft)
-{
-  auto const& player = find_player(registry);
-
-  auto const enemies = find_enemies(registry);
-  using pair_t       = std::pair<float, EntityID>;
-  std::vector<pair_t> pairs;
-  for (auto const eid : enemies) {
-    if (registry.get<IsRenderable>(eid).hidden) {
-      continue;
-    }
-    auto const& etransform = registry.get<Transform>(eid);
-    float const distance   = glm::distance(player.transform().translation, etransform.translation);
-    pairs.emplace_back(std::make_pair(distance, eid));
-  }
-
-  auto const sort_fn = [](auto const& a, auto const& b) { return a.first < b.first; };
-  std::sort(pairs.begin(), pairs.end(), sort_fn);
-
-  auto const selected_o = nbt.selected();
-  nbt.clear();
-  for (auto const& it : pairs) {
-    nbt.add_target(it.second);
-  }
-
-  if (selected_o) {
-    nbt.set_selected(*selected_o);
-  }
-}
-
 void
 update_orbital_bodies(EngineState& es, LevelData& ldata, glm::mat4 const& view_matrix,
                       glm::mat4 const& proj_matrix, EntityRegistry& registry, FrameTime const& ft)
 {
-  auto& logger      = es.logger;
-  auto& directional = ldata.global_light.directional;
-
-  // Must recalculate zs and registry, possibly changed since call to move_between()
-  auto const update_orbitals = [&](auto const eid, bool const first) {
-    auto& transform = registry.get<Transform>(eid);
-    auto& orbital   = registry.get<OrbitalBody>(eid);
-    auto& pos       = transform.translation;
-
-    auto constexpr SLOWDOWN_FACTOR = 5.0f;
-    auto const  time               = ft.since_start_seconds() / SLOWDOWN_FACTOR;
-    float const cos_time           = std::cos(time + orbital.offset);
-    float const sin_time           = std::sin(time + orbital.offset);
-
-    pos.x = orbital.radius.x * cos_time;
-    pos.y = orbital.radius.y * sin_time;
-    pos.z = orbital.radius.z * sin_time;
-
-    // TODO: HACK
-    if (first) {
-      auto const orbital_to_origin = glm::normalize(-pos);
-      directional.direction        = orbital_to_origin;
-
-      auto const mvp  = (proj_matrix * view_matrix) * transform.model_matrix();
-      auto const clip = mvp * glm::vec4{pos, 1.0f};
-      auto const ndc  = glm::vec3{clip.x, clip.y, clip.z} / clip.w;
-
-      auto const wx = ((ndc.x + 1.0f) / 2.0f); // + 256.0;
-      auto const wy = ((ndc.y + 1.0f) / 2.0f); // + 192.0;
-
-      glm::vec2 const wpos{wx, wy};
-      directional.screenspace_pos = wpos;
-    }
-  };
-
-  auto const eids = find_orbital_bodies(registry);
-  if (es.update_orbital_bodies) {
-    bool first = true;
-    for (auto const eid : eids) {
-      update_orbitals(eid, first);
-      first = false;
-    }
+  if (!es.update_orbital_bodies) {
+    return;
   }
-}
+  Simulation::update_orbital_bodies(registry, ft);
 
-inline auto
-find_torches(EntityRegistry& registry)
-{
-  EntityArray torches;
-  auto        view = registry.view<Torch>();
-  for (auto const eid : view) {
-    assert(registry.has<Transform>(eid));
-    torches.emplace_back(eid);
+  // TODO: HACK
+  // The first orbital body doubles as the directional light source.
+  auto const eids = find_orbital_bodies(registry);
+  if (eids.empty()) {
+    return;
   }
-  return torches;
-}
-
-void
-update_torchflicker(LevelData const& ldata, EntityRegistry& registry, RNG& rng, FrameTime const& ft)
-{
-  auto const update_torch = [&](auto const eid) {
-    auto& pointlight = registry.get<PointLight>(eid);
-
-    auto const v       = std::sin(ft.since_start_millis() * M_PI);
-    auto&      flicker = registry.get<LightFlicker>(eid);
-    auto&      light   = pointlight.light;
-    light.diffuse      = color::lerp(flicker.colors[0], flicker.colors[1], v);
-    light.specular     = light.diffuse;
-
-    auto& item            = registry.get<Item>(eid);
-    auto& torch_transform = registry.get<Transform>(eid);
-    if (item.is_pickedup) {
-      // Player has picked up the torch, make it follow player around
-      auto const& player     = find_player(registry);
-      auto const& player_pos = player.world_position();
-
-      torch_transform.translation = player_pos;
-
-      // Move the light above the player's head
-      torch_transform.translation.y = 1.0f;
-    }
-
-    auto const torch_pos   = torch_transform.translation;
-    auto&      attenuation = pointlight.attenuation;
-
-    auto const attenuate = [&rng](float& value, float const gen_range, float const base_value) {
-      value += rng.gen_float_range(-gen_range, gen_range);
+  auto const& transform   = registry.get<Transform>(eids.front());
+  auto const& pos         = transform.translation;
+  auto&       directional = ldata.global_light.directional;
 
-      auto const clamp = gen_range * 2.0f;
-      value            = glm::clamp(value, base_value - clamp, base_value + clamp);
-    };
-
-    static float constexpr CONSTANT = 0.1f;
-    // attenuate(attenuation.constant, CONSTANT, torch.default_attenuation.constant);
+  auto const orbital_to_origin = glm::normalize(-pos);
+  directional.direction        = orbital_to_origin;
 
-    // static float constexpr LINEAR = 0.015f;
-    // attenuate(attenuation.linear, LINEAR, torch.default_attenuation.linear);
+  auto const mvp  = (proj_matrix * view_matrix) * transform.model_matrix();
+  auto const clip = mvp * glm::vec4{pos, 1.0f};
+  auto const ndc  = glm::vec3{clip.x, clip.y, clip.z} / clip.w;
 
-    // static float constexpr QUADRATIC = LINEAR * LINEAR;
-    // attenuate(attenuation.quadratic, QUADRATIC, torch.default_attenuation.quadratic);
+  auto const wx = ((ndc.x + 1.0f) / 2.0f); // + 256.0;
+  auto const wy = ((ndc.y + 1.0f) / 2.0f); // + 192.0;
 
-    static float constexpr SPEED_DELTA = 0.24f;
-    attenuate(flicker.current_speed, SPEED_DELTA, flicker.base_speed);
-  };
-  auto const torches = find_torches(registry);
-  for (auto const eid : torches) {
-    update_torch(eid);
-  }
+  glm::vec2 const wpos{wx, wy};
+  directional.screenspace_pos = wpos;
 }
 
 void
@@ -299,10 +165,11 @@ update_visible_entities(LevelManager& lm, EntityRegistry& registry)
 }
 
 void
-update_everything(EngineState& es, LevelManager& lm, RNG& rng, FrameState const& fstate,
-                  Camera& camera, StaticRenderers& static_renderers, WaterAudioSystem& water_audio,
+update_everything(EngineState& es, LevelManager& lm, FrameState const& fstate, Camera& camera,
+                  StaticRenderers& static_renderers, WaterAudioSystem& water_audio,
                   SDLWindow& window, FrameTime const& ft)
 {
+  PROFILE_ZONE("update_everything");
   auto& logger   = es.logger;
   auto& zs       = lm.active();
   auto& registry = zs.registry;
@@ -311,52 +178,81 @@ update_everything(EngineState& es, LevelManager& lm, RNG& rng, FrameState const&
   auto& skybox = ldata.skybox;
 
   auto& gfx_state = zs.gfx_state;
-  auto& ttable    = gfx_state.texture_table;
-
-  auto& player = find_player(registry);
-  auto& nbt    = ldata.nearby_targets;
+  auto& player    = find_player(registry);
 
   // THIS GOES FIRST ALWAYS.
   es.time.update(ft.since_start_seconds());
 
   // Update the world
-  update_playaudio(logger, es, ldata, registry, water_audio);
-
-  auto const view_matrix = fstate.view_matrix();
-  auto const proj_matrix = fstate.projection_matrix();
-  update_orbital_bodies(es, ldata, view_matrix, proj_matrix, registry, ft);
-  skybox.update(ft);
+  {
+    PROFILE_ZONE("audio");
+    update_playaudio(logger, es, ldata, registry, water_audio);
+  }
 
-  update_visible_entities(lm, registry);
-  update_torchflicker(ldata, registry, rng, ft);
+  {
+    PROFILE_ZONE("orbital_bodies");
+    auto const view_matrix = fstate.view_matrix();
+    auto const proj_matrix = fstate.projection_matrix();
+    update_orbital_bodies(es, ldata, view_matrix, proj_matrix, registry, ft);
+    skybox.update(ft);
+  }
 
-  auto const is_target_selected_and_alive = [](EntityRegistry& registry, NearbyTargets const& nbt) {
-    auto const target = nbt.selected();
-    if (!target) {
-      return false; // target not selected
-    }
-    auto const target_eid = *target;
-    auto&      npcdata    = registry.get<NPCData>(target_eid);
-    auto&      target_hp  = npcdata.health;
-    return !NPC::is_dead(target_hp);
-  };
+  {
+    PROFILE_ZONE("visible_entities");
+    update_visible_entities(lm, registry);
+  }
 
-  // Update these as a chunk, so they stay in the correct order.
-  auto& terrain = ldata.terrain;
-  update_npcpositions(logger, registry, terrain, ft);
-  update_nearbytargets(nbt, registry, ft);
+  {
+    // Start copying the meshes around the player to the GPU before they come into view.
+    PROFILE_ZONE("predict_meshes");
+    float constexpr MESH_PREDICT_DISTANCE = 30.0f;
+    gfx_state.residency.predict(registry, player.transform().translation, MESH_PREDICT_DISTANCE);
+  }
+}
 
-  // LOG_ERROR_SPRINTF("ortho cam pos: %s, player pos: %s",
-  // glm::to_string(camera.ortho.position),
-  // glm::to_string(player.transform().translation));
+bool
+is_target_selected_and_alive(EntityRegistry& registry, NearbyTargets const& nbt)
+{
+  auto const target = nbt.selected();
+  if (!target) {
+    return false; // target not selected
+  }
+  auto const target_eid = *target;
+  auto&      npcdata    = registry.get<NPCData>(target_eid);
+  auto&      target_hp  = npcdata.health;
+  return !NPC::is_dead(target_hp);
+}
 
-  // auto& terrain = ldata.terrain;
-  // for (auto const eid : registry.view<Transform, MeshRenderable>()) {
-  // set_heights_ontop_terrain(logger, terrain, registry, eid);
-  //}
+// Step the simulation (the same gameplay systems the headless simulation runs) on the
+// SimulationThread. Until the step has been waited for, the frame may only read what the
+// simulation doesn't write (see RenderSnapshot).
+void
+start_simulation(EngineState& es, ZoneState& zs, RNG& rng, FrameTime const& ft)
+{
+  // The pools of every component the simulation and the renderers walk views of, neither thread
+  // may create one while the other walks the registry.
+  zs.registry.add_pools<AABoundingBox, BillboardRenderable, Book, CubeRenderable, IsRenderable,
+                        Item, JunkEntityFromFILE, MeshRenderable, NPCData, OrbitalBody, Parent,
+                        Player, PointLight, Selectable, ShaderName, TextureRenderable, Torch,
+                        Transform, TreeComponent, WaterInfo, Weapon, WorldMatrix>();
+
+  es.simulation_thread.start([&es, &zs, &rng, &ft](common::FrameArena& arena) {
+    auto&                 ldata = zs.level_data;
+    SimulationZone        zone{zs.registry, ldata.terrain, ldata.nearby_targets};
+    SimulationInput const input{es.movement_state, es.mariolike_edges, es.update_orbital_bodies};
+    Simulation::update(es.logger, zone, input, arena, rng, ft);
+  });
+}
 
-  bool const previously_alive = is_target_selected_and_alive(registry, nbt);
-  player.update(es, zs, ft);
+// Drop the loot of the selected target, if the simulation's step killed it.
+void
+drop_loot(EngineState& es, ZoneState& zs, bool const previously_alive)
+{
+  auto& logger    = es.logger;
+  auto& registry  = zs.registry;
+  auto& gfx_state = zs.gfx_state;
+  auto& ttable    = gfx_state.texture_table;
+  auto& nbt       = zs.level_data.nearby_targets;
 
   if (previously_alive) {
     auto const target = nbt.selected();
@@ -386,16 +282,16 @@ update_everything(EngineState& es, LevelManager& lm, RNG& rng, FrameState const&
         dhm.add_mesh(logger, sps, obj_store, item_eid, registry);
       };
       if (dead_from_attack) {
-        auto const book_eid = ItemFactory::create_book(registry, ttable);
+        auto const book_eid = ItemFactory::create_book(registry);
         add_worlditem_at_targets_location(book_eid);
 
-        auto const spear_eid = ItemFactory::create_spear(registry, ttable);
+        auto const spear_eid = ItemFactory::create_spear(registry);
         add_worlditem_at_targets_location(spear_eid);
+
+        LevelLoader::resolve_textures(logger, ttable, registry);
       }
     }
   }
-
-  update_mousestates(es);
 }
 
 } // namespace
@@ -403,48 +299,44 @@ update_everything(EngineState& es, LevelManager& lm, RNG& rng, FrameState const&
 namespace boomhs
 {
 
-Result<common::Nothing, std::string>
-copy_assets_gpu(common::Logger& logger, ShaderPrograms& sps, EntityRegistry& registry,
-                ObjStore& obj_store, DrawHandleManager& dhm)
+bool
+copy_entity_gpu(common::Logger& logger, ShaderPrograms& sps, TextureTable const& ttable,
+                EntityRegistry& registry, DrawHandleManager& dhm, EntityID const eid)
 {
-  // copy CUBES to GPU
-  registry.view<ShaderName, CubeRenderable>().each(
-      [&](auto const eid, auto&&...) { dhm.add_cube(logger, sps, eid, registry); });
+  if (!registry.has<ShaderName>(eid)) {
+    return false;
+  }
+
+  bool uploaded = false;
+  if (registry.has<CubeRenderable>(eid)) {
+    dhm.add_cube(logger, sps, eid, registry);
+    uploaded = true;
+  }
 
-  // copy MESHES to GPU
-  registry.view<ShaderName, MeshRenderable>().each(
-      [&](auto const eid, auto&&...) { dhm.add_mesh(logger, sps, obj_store, eid, registry); });
+  // Meshes are streamed onto the GPU once they are needed, see GpuResidency.
+  if (registry.has<MeshRenderable>(eid)) {
+    registry.assign<StreamedMesh>(eid);
+  }
 
   // copy billboarded textures to GPU
-  registry.view<ShaderName, BillboardRenderable, TextureRenderable>().each(
-      [&](auto entity, auto& sn, auto&, auto& texture) {
-        auto& va = sps.ref_sp(logger, sn.value).va();
-        auto* ti = texture.texture_info;
-        assert(ti);
-
-        auto const v        = VertexFactory::build_default();
-        auto const uv       = UvFactory::build_rectangle(ti->uv_max);
-        auto const vertices = vertex_interleave(v, uv);
-        auto       handle   = opengl::gpu::copy_rectangle(logger, va, vertices);
-        dhm.add_entity(entity, MOVE(handle));
-      });
-
-  // Update the tree's to match their initial values.
-  registry.view<ShaderName, MeshRenderable, TreeComponent>().each(
-      [&](auto entity, auto& sn, auto& mesh, auto& tree) {
-        auto& name = registry.get<MeshRenderable>(entity).name;
-
-        auto&          va    = sps.ref_sp(logger, sn.value).va();
-        auto const     flags = BufferFlags::from_va(va);
-        ObjQuery const query{name, flags};
-        auto&          obj = obj_store.get(logger, name);
-
-        auto& tc    = registry.get<TreeComponent>(entity);
-        auto& dinfo = dhm.lookup_entity(logger, entity);
-        Tree::update_colors(logger, va, dinfo, tc);
-      });
-
-  return OK_NONE;
+  if (registry.has<BillboardRenderable>(eid) && registry.has<TextureRenderable>(eid)) {
+    auto& sn = registry.get<ShaderName>(eid);
+    auto& va = sps.ref_sp(logger, sn.value).va();
+    auto const& tr = registry.get<TextureRenderable>(eid);
+    assert(tr.handle.valid());
+
+    // A streamed texture keeps it's parameters while it isn't on the GPU.
+    auto const& ti = ttable.get(tr.handle);
+
+    auto const v        = VertexFactory::build_default();
+    auto const uv       = UvFactory::build_rectangle(ti.uv_max);
+    auto const vertices = vertex_interleave(v, uv);
+    auto const storage  = opengl::gpu::BufferStorage::SHARED;
+    auto       handle   = opengl::gpu::copy_rectangle(logger, va, vertices, storage);
+    dhm.add_entity(eid, MOVE(handle));
+    uploaded = true;
+  }
+  return uploaded;
 }
 
 void
@@ -458,26 +350,22 @@ add_orbitalbodies_and_water(EngineState& es, ZoneState& zs)
   auto& sps          = gfx_state.sps;
   auto& draw_handles = gfx_state.draw_handles;
 
-  auto& obj_store                 = ldata.obj_store;
-  auto& va                        = sps.sp_wireframe(logger).va();
-
   for (auto const eid : registry.view<OrbitalBody>()) {
     auto constexpr MIN = glm::vec3{-1.0f};
     auto constexpr MAX = glm::vec3{-1.0f};
-    AABoundingBox::add_to_entity(logger, sps, eid, registry, MIN, MAX);
+    AABoundingBox::add_to_entity(eid, registry, MIN, MAX);
   }
+
   for (auto const eid : registry.view<WaterInfo>()) {
     {
-      BufferFlags const flags{true, false, false, true};
-
       auto&      wi           = registry.get<WaterInfo>(eid);
       auto const dimensions   = wi.dimensions;
       auto const num_vertexes = wi.num_vertexes;
       auto const data         = WaterFactory::generate_water_data(logger, dimensions, num_vertexes);
-      auto const buffer       = VertexBuffer::create_interleaved(logger, data, flags);
 
-      auto& sp    = graphics_mode_to_water_shader(logger, es.graphics_settings.mode, sps);
-      auto  dinfo = gpu::copy_gpu(logger, sp.va(), buffer);
+      auto&      sp     = graphics_mode_to_water_shader(logger, es.graphics_settings.mode, sps);
+      auto const buffer = VertexBuffer::create_interleaved(logger, data, sp.va());
+      auto       dinfo  = gpu::copy_gpu(logger, sp.va(), buffer, gpu::BufferStorage::SHARED);
 
       draw_handles.add_entity(eid, MOVE(dinfo));
       wi.eid = eid;
@@ -503,58 +391,93 @@ floornumber_to_levelfilename(int const floor_number)
   return "area" + std::to_string(floor_number) + ".toml";
 }
 
-Result<GameState, std::string>
-create_gamestate(Engine& engine, EngineState& es, WorldOrientation const& wo, Camera& camera,
-                 RNG& rng)
+Result<ZoneState, std::string>
+create_zone(EngineState& es, EntityRegistry& registry, LevelAssets&& level_assets,
+            int const floor_number, WorldOrientation const& wo, RNG& rng)
 {
-  auto& logger = es.logger;
+  auto& logger         = es.logger;
+  auto& material_table = level_assets.material_table;
+  auto& obj_store      = level_assets.obj_store;
 
-  int constexpr FLOOR_NUMBER = 0;
+  auto const& heightmap = level_assets.heightmap;
+  if (!heightmap) {
+    return Err(fmt::sprintf("Level for floor %i has no heightmap.", floor_number));
+  }
 
-  std::vector<ZoneState> zstates;
-  zstates.reserve(1);
-  {
-    auto& registry       = engine.registries[FLOOR_NUMBER];
-    auto  level_name     = floornumber_to_levelfilename(FLOOR_NUMBER);
-    auto  level_assets   = TRY_MOVEOUT(LevelLoader::load_level(logger, registry, level_name));
-    auto& ttable         = level_assets.texture_table;
-    auto& material_table = level_assets.material_table;
-    auto& sps            = level_assets.shader_programs;
+  PHASE_TIMER("gen_level");
+  auto gendata =
+      StartAreaGenerator::gen_level(logger, registry, rng, material_table, *heightmap, wo);
+  AABoundingBox::add_to_all_entities(logger, obj_store, registry);
+  return Ok(assemble(MOVE(gendata), MOVE(level_assets), registry));
+}
 
-    char const* HEIGHTMAP_NAME = "Area0-HM";
-    auto const  heightmap = TRY_MOVEOUT(heightmap::load_fromtable(logger, ttable, HEIGHTMAP_NAME));
+Result<bool, std::string>
+upload_zone_gpu(EngineState& es, ZoneState& zs, ZoneUpload& upload, size_t const max_uploads)
+{
+  auto& logger    = es.logger;
+  auto& ldata     = zs.level_data;
+  auto& gfx_state = zs.gfx_state;
+  auto& sps       = gfx_state.sps;
+  auto& ttable    = gfx_state.texture_table;
+  auto& registry  = zs.registry;
 
-    auto gendata = StartAreaGenerator::gen_level(logger, registry, rng, sps, ttable, material_table,
-                                                 heightmap, wo);
+  auto& draw_handles = gfx_state.draw_handles;
+  auto& terrain      = ldata.terrain;
 
-    ZoneState zs = assemble(MOVE(gendata), MOVE(level_assets), registry);
-    zstates.emplace_back(MOVE(zs));
-  }
-  {
-    // copy the first zonestate to GPU
-    assert(zstates.size() > 0);
+  if (!upload.started) {
+    // The generated entities (a torch) only named their textures.
+    LevelLoader::resolve_textures(logger, ttable, registry);
+    LevelLoader::resolve_textures(logger, ttable, terrain);
 
-    auto& zs        = zstates.front();
-    auto& ldata     = zs.level_data;
-    auto& objstore  = ldata.obj_store;
-    auto& gfx_state = zs.gfx_state;
-    auto& sps       = gfx_state.sps;
-    auto& registry  = zs.registry;
+    registry.each([&](auto const eid) { upload.eids.emplace_back(eid); });
+    upload.started = true;
+  }
 
-    auto& draw_handles = gfx_state.draw_handles;
+  // Entities without anything to upload don't count against the limit.
+  auto&  eids        = upload.eids;
+  size_t num_uploads = 0;
+  while (upload.num_entities < eids.size() && num_uploads < max_uploads) {
+    auto const eid = eids[upload.num_entities++];
+    if (copy_entity_gpu(logger, sps, ttable, registry, draw_handles, eid)) {
+      ++num_uploads;
+    }
+  }
+  while (upload.num_terrain < terrain.size() && num_uploads < max_uploads) {
+    draw_handles.add_terrain_piece(logger, sps, terrain, upload.num_terrain++);
+    ++num_uploads;
+  }
+  if (num_uploads == max_uploads) {
+    return Ok(false);
+  }
 
-    auto copy_result = TRY_MOVEOUT(copy_assets_gpu(logger, sps, registry, objstore, draw_handles));
+  {
+    PHASE_TIMER("add_orbitalbodies_and_water");
     add_orbitalbodies_and_water(es, zs);
+  }
+  TransformSystem::update_hierarchy(registry);
+  TransformSystem::update_world_matrices(registry);
 
-    auto& terrain = ldata.terrain;
-    for (auto const eid : registry.view<Transform, AABoundingBox, MeshRenderable>()) {
-      // set_heights_ontop_terrain(logger, terrain, registry, eid);
-    }
+  for (auto const eid : registry.view<Transform, AABoundingBox, MeshRenderable>()) {
+    // set_heights_ontop_terrain(logger, terrain, registry, eid);
   }
+  return Ok(true);
+}
+
+Result<GameState, std::string>
+create_gamestate(Engine& engine, EngineState& es, WorldOrientation const& wo, Camera& camera,
+                 RNG& rng)
+{
+  int constexpr FLOOR_NUMBER = 0;
+
+  LevelManager lm{static_cast<int>(engine.registries.size())};
+  ZoneStreamer streamer{wo, rng.seed()};
+
+  // The first zone is loaded before the game starts, the zones next to it are loaded in the
+  // background once the game is running.
+  TRY_MOVEOUT(streamer.make_active(es, engine, lm, FLOOR_NUMBER));
 
-  auto         water_audio = TRY_MOVEOUT(WaterAudioSystem::create());
-  LevelManager lm{MOVE(zstates)};
-  return Ok(GameState{es, MOVE(lm), MOVE(water_audio)});
+  auto water_audio = TRY_MOVEOUT(WaterAudioSystem::create());
+  return Ok(GameState{es, MOVE(lm), MOVE(streamer), MOVE(water_audio)});
 }
 
 void
@@ -635,40 +558,55 @@ init_gamestate_inplace(GameState& gs, Camera& camera)
   }
 }
 
+// Draw the frame's scene, from the zone's RenderSnapshot (see PerspectiveRenderer::prepare).
 void
-draw_everything(GameState& gs, FrameState& fs, LevelManager& lm, RNG& rng, Camera& camera,
-                StaticRenderers& static_renderers, DrawState& ds, FrameTime const& ft)
+draw_scene(GameState& gs, FrameState& fs, LevelManager& lm, Camera& camera,
+           StaticRenderers& static_renderers, DrawState& ds, FrameTime const& ft)
 {
-  auto& es = fs.es;
-  auto& zs = lm.active();
-  {
-    RenderState rstate{fs, ds};
+  PROFILE_ZONE("draw_everything");
+  auto& es  = fs.es;
+  auto& rng = static_renderers.rng;
 
-    auto const mode = camera.mode();
-    if (CameraMode::FPS == mode || CameraMode::ThirdPerson == mode) {
-      auto const& fr = es.frustum;
-      auto const  vp = Viewport::from_frustum(fr);
-      render::set_viewport_and_scissor(vp, fr.height());
+  RenderState rstate{fs, ds};
 
-      PerspectiveRenderer::draw_scene(rstate, lm, ds, camera, rng, static_renderers, ft);
+  auto const mode = camera.mode();
+  if (CameraMode::FPS == mode || CameraMode::ThirdPerson == mode) {
+    auto const& fr = es.frustum;
+    auto const  vp = Viewport::from_frustum(fr);
+    render::set_viewport_and_scissor(vp, fr.height());
 
-      auto& io       = es.imgui;
-      io.DisplaySize = ImVec2{fr.right_float(), fr.bottom_float()};
-      auto& ui_state = es.ui_state;
-      if (ui_state.draw_ingame_ui) {
-        ui_ingame::draw(fs, camera, static_renderers, ds);
-      }
-      if (ui_state.draw_debug_ui) {
+    PerspectiveRenderer::draw_scene(rstate, lm, ds, camera, rng, static_renderers, ft);
+  }
+  else if (CameraMode::Ortho == mode) {
+    OrthoRenderer::draw_scene(gs, rstate, lm, ds, camera, rng, static_renderers, ft);
+  }
+  else {
+    std::abort();
+  }
+}
 
-        auto static constexpr WINDOW_FLAGS = (0 | ImGuiWindowFlags_AlwaysAutoResize);
-        ui_debug::draw("Perspective", WINDOW_FLAGS, es, lm, camera, ft);
-      }
-    }
-    else if (CameraMode::Ortho == mode) {
-      OrthoRenderer::draw_scene(gs, rstate, lm, ds, camera, rng, static_renderers, ft);
+// Draw the UI on top of the scene. The UI reads the registry, it's drawn once the simulation's
+// step has finished.
+void
+draw_ui(FrameState& fs, LevelManager& lm, Camera& camera, StaticRenderers& static_renderers,
+        DrawState& ds, FrameTime const& ft)
+{
+  auto& es = fs.es;
+
+  auto const mode = camera.mode();
+  if (CameraMode::FPS == mode || CameraMode::ThirdPerson == mode) {
+    auto const& fr = es.frustum;
+    auto&       io = es.imgui;
+    io.DisplaySize = ImVec2{fr.right_float(), fr.bottom_float()};
+    auto& ui_state = es.ui_state;
+    if (ui_state.draw_ingame_ui) {
+      PROFILE_ZONE("ui_ingame");
+      ui_ingame::draw(fs, camera, static_renderers, ds);
     }
-    else {
-      std::abort();
+    if (ui_state.draw_debug_ui) {
+      PROFILE_ZONE("ui_debug");
+      auto static constexpr WINDOW_FLAGS = (0 | ImGuiWindowFlags_AlwaysAutoResize);
+      ui_debug::draw("Perspective", WINDOW_FLAGS, es, lm, camera, ft);
     }
   }
 }
@@ -687,7 +625,9 @@ game_loop(Engine& engine, GameState& gs, RNG& rng, Camera& camera, FrameTime con
   auto& ttable      = gfx_state.texture_table;
   auto& water_audio = gs.water_audio();
 
+  // The GL state changes are counted per frame, like the draw calls.
   DrawState ds{es.wireframe_override};
+  GLState::reset_counters();
 
   auto&      io       = es.imgui;
   auto const viewport = engine.window_viewport();
@@ -703,6 +643,7 @@ game_loop(Engine& engine, GameState& gs, RNG& rng, Camera& camera, FrameTime con
     render::clear_screen(LOC4::BLACK);
     render::set_viewport_and_scissor(viewport, fr.height());
 
+    PROFILE_ZONE("main_menu");
     auto& skybox_renderer = srs.skybox;
     main_menu::draw(es, engine.window, camera, skybox_renderer, ds, lm, viewport, water_audio);
   }
@@ -716,12 +657,54 @@ game_loop(Engine& engine, GameState& gs, RNG& rng, Camera& camera, FrameTime con
     // Disable keyboard shortcuts
     io.ConfigFlags &= ~ImGuiConfigFlags_NavEnableKeyboard;
 
-    IO_SDL::read_devices(SDLReadDevicesArgs{gs, engine.controllers, camera, ft});
-    SDL_SetCursor(es.device_states.cursors.active());
+    {
+      // Spread the work of loading nearby zones over frames, one step each frame.
+      PROFILE_ZONE("zone_streamer");
+      gs.zone_streamer().update(es, engine, lm);
+    }
+
+    {
+      PROFILE_ZONE("read_devices");
+      IO_SDL::read_devices(SDLReadDevicesArgs{gs, engine.controllers, camera, ft});
+      SDL_SetCursor(es.device_states.cursors.active());
+    }
 
     auto fs = FrameState::from_camera(es, zs, camera, camera.view_settings_ref(), fr);
-    update_everything(es, lm, rng, fs, camera, srs, water_audio, engine.window, ft);
-    draw_everything(gs, fs, lm, rng, camera, srs, ds, ft);
+    update_everything(es, lm, fs, camera, srs, water_audio, engine.window, ft);
+
+    {
+      // Nothing moves things until the simulation's next step, bring attached entities and the
+      // cached world matrices up to date before anything reads them.
+      PROFILE_ZONE("transforms");
+      TransformSystem::update_hierarchy(zs.registry);
+      TransformSystem::update_world_matrices(zs.registry);
+      RenderGroups::pack(zs.registry);
+    }
+
+    {
+      // The frame is drawn from the snapshot, and the visible sets and cameras computed now. The
+      // simulation's next step writes the registry meanwhile.
+      PROFILE_ZONE("snapshot");
+      gfx_state.snapshot.build(zs.registry, zs.level_data.nearby_targets, ft);
+      PerspectiveRenderer::prepare(fs, lm, camera);
+    }
+
+    // Frames take as long as the longer of the simulation's step and drawing the scene.
+    auto&      nbt              = zs.level_data.nearby_targets;
+    bool const previously_alive = is_target_selected_and_alive(zs.registry, nbt);
+    start_simulation(es, zs, rng, ft);
+    draw_scene(gs, fs, lm, camera, srs, ds, ft);
+    es.simulation_thread.wait();
+
+    drop_loot(es, zs, previously_alive);
+    update_mousestates(es);
+    draw_ui(fs, lm, camera, srs, ds, ft);
+
+    // Copy the meshes requested while drawing to the GPU, and evict unused meshes.
+    PROFILE_ZONE("gpu_residency");
+    auto& residency = gfx_state.residency;
+    residency.update(logger, sps, zs.level_data.obj_store, zs.registry, gfx_state.texture_table,
+                     gfx_state.draw_handles);
   }
 }
 
@@ -1,38 +1,57 @@
 #include <boomhs/bounding_object.hpp>
 #include <boomhs/components.hpp>
 #include <boomhs/entity.hpp>
-#include <boomhs/leveldata.hpp>
 #include <boomhs/math.hpp>
-#include <boomhs/vertex_factory.hpp>
-
-#include <opengl/gpu.hpp>
-#include <opengl/shader.hpp>
-
-using namespace opengl;
+#include <boomhs/obj_store.hpp>
 
 namespace boomhs
 {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // AABoundingBox
-AABoundingBox::AABoundingBox(glm::vec3 const& minp, glm::vec3 const& maxp, DrawInfo&& dinfo)
+AABoundingBox::AABoundingBox(glm::vec3 const& minp, glm::vec3 const& maxp)
     : cube(Cube{minp, maxp})
-    , draw_info(MOVE(dinfo))
 {
 }
 
 AABoundingBox&
-AABoundingBox::add_to_entity(common::Logger& logger, ShaderPrograms& sps, EntityID const eid,
-                             EntityRegistry& registry, glm::vec3 const& min, glm::vec3 const& max)
+AABoundingBox::add_to_entity(EntityID const eid, EntityRegistry& registry, glm::vec3 const& min,
+                             glm::vec3 const& max)
 {
-  auto& va = sps.sp_wireframe(logger).va();
-
-  auto const cv    = VertexFactory::build_cube(min, max);
-  auto       dinfo = OG::copy_cube_wireframe_gpu(logger, cv, va);
-  auto&      bbox  = registry.assign<AABoundingBox>(eid, min, max, MOVE(dinfo));
+  auto& bbox = registry.assign<AABoundingBox>(eid, min, max);
 
   registry.assign<Selectable>(eid);
   return bbox;
 }
 
+AABoundingBox&
+AABoundingBox::add_mesh_to_entity(common::Logger& logger, ObjStore const& obj_store,
+                                  EntityID const eid, EntityRegistry& registry)
+{
+  auto const& mesh_name = registry.get<MeshRenderable>(eid).name;
+  auto const& obj       = obj_store.get(logger, mesh_name);
+
+  auto const  posbuffer = obj.positions();
+  auto const& min       = posbuffer.min();
+  auto const& max       = posbuffer.max();
+  return add_to_entity(eid, registry, min, max);
+}
+
+void
+AABoundingBox::add_to_all_entities(common::Logger& logger, ObjStore const& obj_store,
+                                   EntityRegistry& registry)
+{
+  for (auto const eid : find_all_entities_with_component<MeshRenderable>(registry)) {
+    if (!registry.has<AABoundingBox>(eid)) {
+      add_mesh_to_entity(logger, obj_store, eid, registry);
+    }
+  }
+  for (auto const eid : find_all_entities_with_component<CubeRenderable>(registry)) {
+    if (!registry.has<AABoundingBox>(eid)) {
+      auto const& cr = registry.get<CubeRenderable>(eid);
+      add_to_entity(eid, registry, cr.min, cr.max);
+    }
+  }
+}
+
 } // namespace boomhs
@@ -8,6 +8,9 @@
 #include <common/algorithm.hpp>
 #include <limits>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::collision
+
 using namespace boomhs;
 using namespace boomhs::math;
 
@@ -90,21 +93,28 @@ ray_obb_intersection(
 }
 
 bool
-ray_obb_intersection(Ray const& ray, Cube cube, Transform tr, float& distance)
+ray_obb_intersection(Ray const& ray, Cube const& cube, Transform const& tr,
+                     ModelMatrix const& world_matrix, float& distance)
 {
-  auto const c  = cube.center();
-  auto const hw = cube.half_widths();
-  auto const s  = tr.scale;
-
   // calculate where the min/max values are from the center of the object after scaling.
   auto const min = cube.scaled_min(tr);
   auto const max = cube.scaled_max(tr);
 
   // For the purposes of the ray_obb intersection algorithm, it is expected the transform has no
   // scaling. We've taking the scaling into account by adjusting the bounding cube min/max points
-  // using the transform's original scale. Set the scaling of the copied transform to all 1's.
-  tr.scale                = glm::vec3{1};
-  auto const model_matrix = tr.model_matrix();
+  // using the transform's original scale. Normalize the (cached) world matrix's basis vectors
+  // instead of recomputing the model matrix from scratch.
+  //
+  // A zero scale collapses a basis vector, the transform's rotation supplies the axis instead.
+  auto const      rotation     = glm::toMat4(tr.rotation);
+  ModelMatrix     model_matrix = world_matrix;
+  float constexpr MIN_LENGTH   = 1e-6f;
+  FOR(i, 3)
+  {
+    auto&       axis   = model_matrix[i];
+    float const length = glm::length(glm::vec3{axis});
+    axis               = length > MIN_LENGTH ? axis / length : rotation[i];
+  }
   return ray_obb_intersection(ray, min, max, model_matrix, distance);
 }
 
@@ -341,6 +351,13 @@ intersects(glm::vec2 const& point, RectFloat const& rect)
 bool
 intersects(common::Logger& logger, Ray const& ray, Transform const& tr, Cube const& cube,
            float& distance)
+{
+  return intersects(logger, ray, tr, tr.model_matrix(), cube, distance);
+}
+
+bool
+intersects(common::Logger& logger, Ray const& ray, Transform const& tr,
+           ModelMatrix const& world_matrix, Cube const& cube, float& distance)
 {
   bool const can_use_simple_test = (tr.rotation == glm::quat{}) && (tr.scale == constants::ONE);
 
@@ -356,7 +373,7 @@ intersects(common::Logger& logger, Ray const& ray, Transform const& tr, Cube con
     //log_intersection("SIMPLE");
   }
   else {
-    intersects = ray_obb_intersection(ray, cube, tr, distance);
+    intersects = ray_obb_intersection(ray, cube, tr, world_matrix, distance);
     //log_intersection("COMPLEX");
   }
   return intersects;
@@ -4,9 +4,9 @@ namespace boomhs
 {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// FollowTransform
-FollowTransform::FollowTransform(EntityID const eid)
-    : target_eid(eid)
+// Parent
+Parent::Parent(EntityID const eid)
+    : eid(eid)
 {
 }
 
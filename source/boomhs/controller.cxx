@@ -2,6 +2,9 @@
 #include <common/algorithm.hpp>
 #include <extlibs/fmt.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::io
+
 using namespace boomhs;
 
 namespace
@@ -8,6 +8,14 @@
 
 using namespace gl_sdl;
 
+namespace
+{
+
+// Starting size of the frame arena, it grows on it's own if a frame needs more.
+size_t constexpr FRAME_ARENA_CAPACITY = 64 * 1024;
+
+} // namespace
+
 namespace boomhs
 {
 
@@ -18,6 +26,8 @@ EngineState::EngineState(common::Logger& l, ALCdevice& al, ImGuiIO& i, Frustum c
     , al_device(al)
     , imgui(i)
     , frustum(f)
+    , frame_arena(FRAME_ARENA_CAPACITY)
+    , simulation_thread(FRAME_ARENA_CAPACITY)
     , disable_controller_input(true)
     , player_collision(false)
     , mariolike_edges(false)
@@ -31,6 +41,8 @@ EngineState::EngineState(common::Logger& l, ALCdevice& al, ImGuiIO& i, Frustum c
     , draw_terrain(true)
     , draw_normals(false)
     , draw_skybox(true)
+    , mesh_lods(true)
+    , occlusion_culling(true)
     , show_global_axis(false)
     , show_player_localspace_vectors(false)
     , show_player_worldspace_vectors(false)
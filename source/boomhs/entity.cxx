@@ -5,6 +5,13 @@ namespace boomhs
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // EntityRegistry
+EntityRegistry::EntityRegistry()
+{
+  // Any entity given a Transform is also given a WorldMatrix, which caches the Transform's model
+  // matrix (see TransformSystem).
+  entt::dependency<WorldMatrix>(registry_.construction<Transform>());
+}
+
 EntityID
 EntityRegistry::create()
 {
@@ -14,6 +21,9 @@ EntityRegistry::create()
 void
 EntityRegistry::destroy(EntityID const eid)
 {
+  // The entity may have been a parent, or had one.
+  hierarchy_.dirty = true;
+  destroyed_.emplace_back(eid);
   registry_.destroy(eid);
 }
 
@@ -1,11 +1,16 @@
 #include <boomhs/heightmap.hpp>
 #include <boomhs/terrain.hpp>
 
-#include <opengl/texture.hpp>
-
 #include <common/algorithm.hpp>
 
-using namespace opengl;
+#include <extlibs/fmt.hpp>
+
+#include <png.h>
+
+#include <cstring>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::terrain
 
 namespace boomhs
 {
@@ -52,23 +57,6 @@ Heightmap::to_string() const
 namespace boomhs::heightmap
 {
 
-HeightmapResult
-load_fromtable(common::Logger& logger, TextureTable const& ttable,
-               std::string const& heightmap_path)
-{
-  auto const* p_heightmap = ttable.lookup_nickname(heightmap_path);
-  if (!p_heightmap) {
-    auto const fmt = fmt::sprintf("ERROR Looking up heightmap: %s (not found)", heightmap_path);
-    LOG_ERROR(fmt);
-    return Err(fmt);
-  }
-  auto const& hm = *p_heightmap;
-  assert(1 == hm.num_filenames());
-  auto const& path = hm.filenames[0];
-
-  return heightmap::parse(logger, path);
-}
-
 ObjVertices
 generate_normals(int const x_length, int const z_length, bool const invert_normals,
                  Heightmap const& heightmap)
@@ -137,39 +125,34 @@ generate_normals(int const x_length, int const z_length, bool const invert_norma
 }
 
 HeightmapResult
-parse(ImageData const& image)
+parse(common::Logger& logger, char const* path)
 {
-  auto const num_pixels_in_image = image.width * image.height;
+  LOG_TRACE_SPRINTF("Loading Heightmap Data from file %s", path);
 
-  // The heightmap's width comes directly from the image data.
-  Heightmap heightmap{image.width};
-
-  size_t const num_pixels = num_pixels_in_image;
-  heightmap.reserve(num_pixels);
-  auto const num_bytes = num_pixels * 4;
-  for (auto i = 0u; i < num_bytes; i += 4) {
-    auto const& data  = image.data.get();
-    auto const  red   = data[i + 0];
-    auto const  green = data[i + 1];
-    auto const  blue  = data[i + 2];
-    auto const  alpha = data[i + 3];
-    assert(red == green);
-    assert(red == blue);
-    assert(255 == alpha);
-    heightmap.add(red);
+  // The heights are the image's gray levels, decoding them with libpng (instead of loading a
+  // texture) keeps OpenGL out of the simulation.
+  png_image image;
+  std::memset(&image, 0, sizeof(image));
+  image.version = PNG_IMAGE_VERSION;
+  if (!png_image_begin_read_from_file(&image, path)) {
+    return Err(fmt::sprintf("Error reading heightmap '%s': %s", path, image.message));
   }
-  assert(heightmap.size() == num_pixels);
+  image.format = PNG_FORMAT_GRAY;
 
-  return Ok(MOVE(heightmap));
-}
+  std::vector<uint8_t> pixels(PNG_IMAGE_SIZE(image));
+  if (!png_image_finish_read(&image, nullptr, pixels.data(), 0, nullptr)) {
+    png_image_free(&image);
+    return Err(fmt::sprintf("Error decoding heightmap '%s': %s", path, image.message));
+  }
 
-HeightmapResult
-parse(common::Logger& logger, char const* path)
-{
-  LOG_TRACE_SPRINTF("Loading Heightmap Data from file %s", path);
-  auto const data = TRY_MOVEOUT(texture::load_image(logger, path, GL_RGBA));
+  // The heightmap's width comes directly from the image data.
+  Heightmap heightmap{static_cast<int>(image.width)};
+  heightmap.reserve(pixels.size());
+  for (auto const height : pixels) {
+    heightmap.add(height);
+  }
   LOG_TRACE("Finished Loading Heightmap");
-  return parse(data);
+  return Ok(MOVE(heightmap));
 }
 
 HeightmapResult
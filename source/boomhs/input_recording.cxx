@@ -0,0 +1,171 @@
+#include <boomhs/input_recording.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#include <array>
+#include <type_traits>
+
+using namespace boomhs;
+
+namespace
+{
+
+std::array<char, 4> constexpr MAGIC = {'B', 'H', 'S', 'R'};
+uint32_t constexpr VERSION          = 1;
+
+template <typename T>
+void
+write_pod(std::ofstream& file, T const& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+  file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool
+read_pod(std::ifstream& file, T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// InputFrame
+void
+InputFrame::clear()
+{
+  delta       = 0.0;
+  since_start = 0.0;
+  events.clear();
+  keyboard = KeyboardState{};
+  mouse    = MouseState{};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// InputRecorder
+InputRecorder::InputRecorder(std::ofstream&& file)
+    : file_(MOVE(file))
+{
+}
+
+void
+InputRecorder::write_frame(InputFrame const& frame)
+{
+  write_pod(file_, frame.delta);
+  write_pod(file_, frame.since_start);
+
+  write_pod(file_, static_cast<uint32_t>(frame.events.size()));
+  file_.write(reinterpret_cast<char const*>(frame.events.data()),
+              frame.events.size() * sizeof(SDL_Event));
+
+  // Most keys are up most of the time, only store the pressed ones.
+  std::array<uint16_t, SDL_NUM_SCANCODES> pressed;
+  uint16_t                                num_pressed = 0;
+  for (int sc = 0; sc < SDL_NUM_SCANCODES; ++sc) {
+    if (frame.keyboard.pressed(static_cast<SDL_Scancode>(sc))) {
+      pressed[num_pressed++] = static_cast<uint16_t>(sc);
+    }
+  }
+  write_pod(file_, num_pressed);
+  file_.write(reinterpret_cast<char const*>(pressed.data()), num_pressed * sizeof(uint16_t));
+
+  auto const coords = frame.mouse.coords();
+  write_pod(file_, static_cast<int32_t>(coords.x));
+  write_pod(file_, static_cast<int32_t>(coords.y));
+  write_pod(file_, static_cast<uint32_t>(frame.mouse.mask()));
+}
+
+Result<InputRecorder, std::string>
+InputRecorder::create(std::string const& path, uint64_t const seed, freq_t const frequency)
+{
+  std::ofstream file{path, std::ios::out | std::ios::binary | std::ios::trunc};
+  if (!file) {
+    return Err(fmt::sprintf("Could not open input recording '%s' for writing.", path));
+  }
+
+  write_pod(file, MAGIC);
+  write_pod(file, VERSION);
+  write_pod(file, seed);
+  write_pod(file, frequency);
+  return Ok(InputRecorder{MOVE(file)});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// InputReplayer
+InputReplayer::InputReplayer(std::ifstream&& file, uint64_t const seed, freq_t const frequency)
+    : file_(MOVE(file))
+    , seed_(seed)
+    , frequency_(frequency)
+{
+}
+
+bool
+InputReplayer::read_frame(InputFrame& frame)
+{
+  frame.clear();
+  if (!read_pod(file_, frame.delta) || !read_pod(file_, frame.since_start)) {
+    return false;
+  }
+
+  uint32_t num_events = 0;
+  if (!read_pod(file_, num_events)) {
+    return false;
+  }
+  frame.events.resize(num_events);
+  if (!file_.read(reinterpret_cast<char*>(frame.events.data()), num_events * sizeof(SDL_Event))) {
+    return false;
+  }
+
+  uint16_t num_pressed = 0;
+  if (!read_pod(file_, num_pressed)) {
+    return false;
+  }
+  for (uint16_t i = 0; i < num_pressed; ++i) {
+    uint16_t sc = 0;
+    if (!read_pod(file_, sc) || sc >= SDL_NUM_SCANCODES) {
+      return false;
+    }
+    frame.keyboard.set_pressed(static_cast<SDL_Scancode>(sc), true);
+  }
+
+  int32_t  x = 0, y = 0;
+  uint32_t mask = 0;
+  if (!read_pod(file_, x) || !read_pod(file_, y) || !read_pod(file_, mask)) {
+    return false;
+  }
+  frame.mouse = MouseState{glm::ivec2{x, y}, mask};
+  return true;
+}
+
+Result<InputReplayer, std::string>
+InputReplayer::open(std::string const& path)
+{
+  std::ifstream file{path, std::ios::in | std::ios::binary};
+  if (!file) {
+    return Err(fmt::sprintf("Could not open input recording '%s' for reading.", path));
+  }
+
+  std::array<char, 4> magic;
+  uint32_t            version   = 0;
+  uint64_t            seed      = 0;
+  freq_t              frequency = 0;
+  if (!read_pod(file, magic) || !read_pod(file, version) || !read_pod(file, seed) ||
+      !read_pod(file, frequency)) {
+    return Err(fmt::sprintf("Input recording '%s' is truncated.", path));
+  }
+  if (magic != MAGIC) {
+    return Err(fmt::sprintf("'%s' is not an input recording.", path));
+  }
+  if (version != VERSION) {
+    return Err(fmt::sprintf("Input recording '%s' has version %u, expected %u.", path, version,
+                            VERSION));
+  }
+  return Ok(InputReplayer{MOVE(file), seed, frequency});
+}
+
+} // namespace boomhs
@@ -31,7 +31,7 @@ InventorySlot::occupied() const
 char const*
 InventorySlot::name(EntityRegistry& registry) const
 {
-  return occupied() ? item(registry).name : "Slot Unoccupied";
+  return occupied() ? item(registry).name.c_str() : "Slot Unoccupied";
 }
 
 void
@@ -9,6 +9,10 @@
 #include <boomhs/raycast.hpp>
 #include <boomhs/state.hpp>
 #include <boomhs/world_object.hpp>
+#include <boomhs/zone_snapshot.hpp>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::io
 
 float constexpr ZOOM_FACTOR = 0.2f;
 
@@ -26,7 +30,7 @@ fps_mousemove(Camera& camera, Player& player, float const xrel, float const yrel
               FrameTime const& ft)
 {
   camera.rotate_radians(xrel, yrel, ft);
-  player.world_object().rotate_to_match_camera_rotation(camera);
+  player.world_object().rotate_to_match_camera_rotation(camera.eye_forward());
 
   player.transform().rotate_degrees(180.0f, EulerAxis::Y);
 }
@@ -58,10 +62,11 @@ using EntityDistances = std::vector<std::pair<EntityID, float>>;
 
 bool
 ray_intersects_cube_entity(common::Logger& logger, EntityID const eid, Ray const& ray,
-                           Transform const& tr, Cube const& cube, EntityDistances& distances)
+                           Transform const& tr, WorldMatrix const& wm, Cube const& cube,
+                           EntityDistances& distances)
 {
   float      distance   = 0.0f;
-  bool const intersects = collision::intersects(logger, ray, tr, cube, distance);
+  bool const intersects = collision::intersects(logger, ray, tr, wm.value, cube, distance);
   if (intersects) {
     distances.emplace_back(PAIR(eid, distance));
   }
@@ -96,9 +101,10 @@ select_mouse_under_cursor(FrameState& fstate, MouseButton const mb)
   for (auto const eid : find_all_entities_with_component<Selectable>(registry)) {
     auto const& cube = registry.get<AABoundingBox>(eid).cube;
     auto const& tr   = registry.get<Transform>(eid);
+    auto const& wm   = registry.get<WorldMatrix>(eid);
     auto&       sel  = registry.get<Selectable>(eid);
 
-    bool const intersects = ray_intersects_cube_entity(logger, eid, ray, tr, cube, distances);
+    bool const intersects = ray_intersects_cube_entity(logger, eid, ray, tr, wm, cube, distances);
     if (intersects) {
       LOG_ERROR("\n\n\n\n\n\n\nIntersects something\n\n\n\n\n\n\n");
       LOG_ERROR_SPRINTF("mouse pos: %s", glm::to_string(mouse_pos));
@@ -311,6 +317,20 @@ PlayerPlayingGameBehavior::keydown(KeyEvent&& ke)
     break;
   case SDLK_q:
     break;
+  case SDLK_F5: {
+    // Quick save the active zone.
+    auto const path     = "zone" + std::to_string(lm.active_zone()) + ".save";
+    auto const on_error = [&logger](auto const& error) { LOG_ERROR(error); };
+    TRY_OR(ZoneSnapshot::save_to_file(active, path), on_error);
+    LOG_INFO_SPRINTF("Saved zone to '%s'.", path);
+  } break;
+  case SDLK_F9: {
+    // Quick load the active zone.
+    auto const path     = "zone" + std::to_string(lm.active_zone()) + ".save";
+    auto const on_error = [&logger](auto const& error) { LOG_ERROR(error); };
+    TRY_OR(ZoneSnapshot::load_from_file(logger, active, path), on_error);
+    LOG_INFO_SPRINTF("Loaded zone from '%s'.", path);
+  } break;
   case SDLK_F11:
     uistate.draw_debug_ui ^= true;
     break;
@@ -318,9 +338,9 @@ PlayerPlayingGameBehavior::keydown(KeyEvent&& ke)
     camera.next_mode();
   } break;
   case SDLK_TAB: {
-    uint8_t const*       keystate = SDL_GetKeyboardState(nullptr);
+    auto const&          keyboard = ds.keyboard;
     CycleDirection const dir =
-        keystate[SDL_SCANCODE_LSHIFT] ? CycleDirection::Forward : CycleDirection::Backward;
+        keyboard.pressed(SDL_SCANCODE_LSHIFT) ? CycleDirection::Forward : CycleDirection::Backward;
     nbt.cycle(dir, ft);
   } break;
   case SDLK_BACKQUOTE: {
@@ -417,7 +437,7 @@ PlayerPlayingGameBehavior::process_mouse_state(MouseAndKeyboardArgs&& mk)
   if (mode == CameraMode::FPS || mode == CameraMode::ThirdPerson) {
     auto& movement = es.movement_state;
     if (both_yes_now) {
-      player.rotate_to_match_camera_rotation(camera);
+      player.rotate_to_match_camera_rotation(camera.eye_forward());
       movement.mouse_forward = player.eye_forward();
     }
     else {
@@ -452,10 +472,6 @@ PlayerPlayingGameBehavior::process_keyboard_state(MouseAndKeyboardArgs&& mk)
   auto&       player = mk.player;
   auto const& ft     = mk.frame_time;
 
-  // continual keypress responses procesed here
-  uint8_t const* keystate = SDL_GetKeyboardState(nullptr);
-  assert(keystate);
-
   auto& es       = state.engine_state();
   auto& logger   = es.logger;
   auto& lm       = state.level_manager();
@@ -465,12 +481,15 @@ PlayerPlayingGameBehavior::process_keyboard_state(MouseAndKeyboardArgs&& mk)
 
   auto& movement = es.movement_state;
 
-  movement.forward  = keystate[SDL_SCANCODE_W] ? player.eye_forward() : ZERO;
-  movement.backward = keystate[SDL_SCANCODE_S] ? player.eye_backward() : ZERO;
+  // continual keypress responses procesed here
+  auto const& keyboard = es.device_states.keyboard;
+
+  movement.forward  = keyboard.pressed(SDL_SCANCODE_W) ? player.eye_forward() : ZERO;
+  movement.backward = keyboard.pressed(SDL_SCANCODE_S) ? player.eye_backward() : ZERO;
 
-  movement.left = keystate[SDL_SCANCODE_A] ? player.eye_left() : ZERO;
+  movement.left = keyboard.pressed(SDL_SCANCODE_A) ? player.eye_left() : ZERO;
 
-  movement.right = keystate[SDL_SCANCODE_D] ? player.eye_right() : ZERO;
+  movement.right = keyboard.pressed(SDL_SCANCODE_D) ? player.eye_right() : ZERO;
 }
 
 void
@@ -518,14 +537,14 @@ PlayerPlayingGameBehavior::process_controller_state(ControllerArgs&& ca)
 
   if (less_threshold(axis_left_x)) {
     movement.left = player_wo.eye_left();
-    player_wo.rotate_to_match_camera_rotation(camera);
+    player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
   }
   else {
     movement.left = ZERO;
   }
   if (greater_threshold(axis_left_x)) {
     movement.right = player_wo.eye_right();
-    player_wo.rotate_to_match_camera_rotation(camera);
+    player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
   }
   else {
     movement.right = ZERO;
@@ -533,14 +552,14 @@ PlayerPlayingGameBehavior::process_controller_state(ControllerArgs&& ca)
   auto const axis_left_y = c.axis_left_y();
   if (less_threshold(axis_left_y)) {
     movement.forward = player_wo.eye_forward();
-    player_wo.rotate_to_match_camera_rotation(camera);
+    player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
   }
   else {
     movement.forward = ZERO;
   }
   if (greater_threshold(axis_left_y)) {
     movement.backward = player_wo.eye_backward();
-    player_wo.rotate_to_match_camera_rotation(camera);
+    player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
   }
   else {
     movement.backward = ZERO;
@@ -552,12 +571,12 @@ PlayerPlayingGameBehavior::process_controller_state(ControllerArgs&& ca)
       if (less_threshold(axis_right_x)) {
         LOG_ERROR("LT");
         camera.rotate_radians(axis_right_x, 0.0, ft);
-        player_wo.rotate_to_match_camera_rotation(camera);
+        player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
       }
       if (greater_threshold(axis_right_x)) {
         LOG_ERROR("GT");
         camera.rotate_radians(axis_right_x, 0.0, ft);
-        player_wo.rotate_to_match_camera_rotation(camera);
+        player_wo.rotate_to_match_camera_rotation(camera.eye_forward());
       }
     }
     {
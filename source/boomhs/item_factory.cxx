@@ -4,35 +4,30 @@
 #include <boomhs/lighting.hpp>
 #include <boomhs/material.hpp>
 #include <boomhs/random.hpp>
-#include <opengl/texture.hpp>
 
 using namespace boomhs;
-using namespace opengl;
 
 namespace
 {
 
 EntityID
-create_item(EntityRegistry& registry, TextureTable& ttable, char const* entity_name,
-            char const* ui_name, char const* mesh_name, char const* texture, char const* shader)
+create_item(EntityRegistry& registry, char const* entity_name, char const* ui_name,
+            char const* mesh_name, char const* texture, char const* shader)
 {
-  auto eid = ItemFactory::create_empty(registry, ttable);
+  auto eid = ItemFactory::create_empty(registry);
 
   registry.get<Name>(eid).value = entity_name;
 
   registry.assign<IsRenderable>(eid);
   registry.assign<MeshRenderable>(eid, mesh_name);
 
-  auto& tr        = registry.assign<TextureRenderable>(eid);
-  auto  texture_o = ttable.find(texture);
-  assert(texture_o);
-  tr.texture_info = &*texture_o;
+  auto& tr   = registry.assign<TextureRenderable>(eid);
+  tr.texture = texture;
 
   registry.assign<ShaderName>(eid, shader);
 
-  auto& item    = registry.get<Item>(eid);
-  item.ui_tinfo = &*ttable.find(ui_name);
-  assert(item.ui_tinfo);
+  auto& item      = registry.get<Item>(eid);
+  item.ui_texture = ui_name;
 
   return eid;
 }
@@ -43,15 +38,14 @@ namespace boomhs
 {
 
 EntityID
-ItemFactory::create_empty(EntityRegistry& registry, TextureTable& ttable)
+ItemFactory::create_empty(EntityRegistry& registry)
 {
   auto eid = registry.create();
   registry.assign<Name>(eid, "Empty Item");
 
   Item& item       = registry.assign<Item>(eid);
   item.is_pickedup = false;
-  item.ui_tinfo    = &*ttable.find("RedX");
-  assert(item.ui_tinfo);
+  item.ui_texture  = "RedX";
 
   item.name    = "RedX";
   item.tooltip = "This is some kind of item";
@@ -63,9 +57,9 @@ ItemFactory::create_empty(EntityRegistry& registry, TextureTable& ttable)
 }
 
 EntityID
-ItemFactory::create_book(EntityRegistry& registry, TextureTable& ttable)
+ItemFactory::create_book(EntityRegistry& registry)
 {
-  auto eid = create_item(registry, ttable, "Book EID", "BookUI", "B", "container", "3dtexture");
+  auto eid = create_item(registry, "Book EID", "BookUI", "B", "container", "3dtexture");
   registry.assign<Book>(eid);
   registry.assign<Material>(eid);
 
@@ -77,10 +71,9 @@ ItemFactory::create_book(EntityRegistry& registry, TextureTable& ttable)
 }
 
 EntityID
-ItemFactory::create_spear(EntityRegistry& registry, opengl::TextureTable& ttable)
+ItemFactory::create_spear(EntityRegistry& registry)
 {
-  auto eid =
-      create_item(registry, ttable, "Spear EID", "SpearUI", "hashtag", "container", "3dtexture");
+  auto eid = create_item(registry, "Spear EID", "SpearUI", "hashtag", "container", "3dtexture");
   registry.assign<Weapon>(eid);
   registry.assign<Material>(eid);
 
@@ -92,15 +85,23 @@ ItemFactory::create_spear(EntityRegistry& registry, opengl::TextureTable& ttable
 }
 
 EntityID
-ItemFactory::create_torch(EntityRegistry& registry, TextureTable& ttable)
+ItemFactory::create_torch(EntityRegistry& registry)
 {
-  auto eid = create_item(registry, ttable, "Torch EID", "TorchUI", "star", "Lava", "torch");
-  registry.assign<Torch>(eid);
+  auto eid = create_item(registry, "Torch EID", "TorchUI", "star", "Lava", "torch");
+  add_torchlight(registry, eid);
 
   auto& item   = registry.get<Item>(eid);
   item.name    = "Torch";
   item.tooltip = "This is a torch";
 
+  return eid;
+}
+
+void
+ItemFactory::add_torchlight(EntityRegistry& registry, EntityID const eid)
+{
+  registry.assign<Torch>(eid);
+
   auto& pointlight         = registry.assign<PointLight>(eid);
   pointlight.light.diffuse = LOC3::YELLOW;
 
@@ -115,8 +116,6 @@ ItemFactory::create_torch(EntityRegistry& registry, TextureTable& ttable)
   att.constant  = 1.0f;
   att.linear    = 0.93f;
   att.quadratic = 0.46f;
-
-  return eid;
 }
 
 } // namespace boomhs
@@ -0,0 +1,22 @@
+#include <boomhs/keyboard.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace boomhs
+{
+
+KeyboardState
+KeyboardState::from_sdl()
+{
+  int            numkeys  = 0;
+  uint8_t const* keystate = SDL_GetKeyboardState(&numkeys);
+  assert(keystate);
+
+  KeyboardState ks;
+  auto const    count = std::min<size_t>(numkeys, ks.keys_.size());
+  std::copy(keystate, keystate + count, ks.keys_.begin());
+  return ks;
+}
+
+} // namespace boomhs
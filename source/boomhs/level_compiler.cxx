@@ -0,0 +1,1120 @@
+#include <boomhs/level_compiler.hpp>
+#include <boomhs/mesh_optimizer.hpp>
+#include <boomhs/transform.hpp>
+
+#include <extlibs/glew.hpp>
+
+#include <common/algorithm.hpp>
+#include <common/phase_timer.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <extlibs/cpptoml.hpp>
+#include <extlibs/fmt.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <sys/stat.h>
+#include <type_traits>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
+using namespace boomhs;
+using namespace opengl;
+
+using CppTableArray = std::shared_ptr<cpptoml::table_array>;
+using CppTable      = std::shared_ptr<cpptoml::table>;
+
+#define TRY_OPTION_GENERAL_EVAL(VAR_NAME, V, expr)                                                 \
+  auto V{expr};                                                                                    \
+  if (!V) {                                                                                        \
+    return cpptoml::option<opengl::AttributePointerInfo>{};                                        \
+  }                                                                                                \
+  VAR_NAME{MOVE(V)};
+
+#define TRY_OPTION_CONCAT(VAR_NAME, TO_CONCAT, expr)                                               \
+  TRY_OPTION_GENERAL_EVAL(VAR_NAME, _TRY_OPTION_TEMPORARY_##TO_CONCAT, expr)
+
+#define TRY_OPTION_EXPAND_VAR(VAR_NAME, to_concat, expr)                                           \
+  TRY_OPTION_CONCAT(VAR_NAME, to_concat, expr)
+
+// TRY_OPTION
+#define TRY_OPTION(VAR_NAME, expr) TRY_OPTION_EXPAND_VAR(VAR_NAME, __COUNTER__, expr)
+
+namespace
+{
+
+char const* ENGINE_FILE    = "engine.toml";
+char const* RESOURCES_FILE = "levels/resources.toml";
+
+std::array<char, 4> constexpr MAGIC = {'B', 'H', 'S', 'L'};
+uint32_t constexpr VERSION          = 7;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// TOML parsing
+
+GLint
+wrap_mode_from_string(char const* name)
+{
+  auto const cmp = [&name](char const* str) {
+    auto const len = std::strlen(str);
+    return std::strncmp(name, str, len) == 0;
+  };
+  if (cmp("clamp")) {
+    return GL_CLAMP_TO_EDGE;
+  }
+  else if (cmp("repeat")) {
+    return GL_REPEAT;
+  }
+  else if (cmp("mirror_repeat")) {
+    return GL_MIRRORED_REPEAT;
+  }
+
+  // Invalid
+  std::abort();
+}
+
+// Parse the TOML file, reading it into memory first so the bytes actually read are recorded.
+CppTable
+parse_toml_file(std::string const& path)
+{
+  std::string text;
+  if (!common::read_file_text(path, text)) {
+    throw cpptoml::parse_exception{path + " could not be opened for parsing"};
+  }
+  common::record_bytes_read(text.size());
+
+  std::istringstream stream{MOVE(text)};
+  cpptoml::parser    parser{stream};
+  return parser.parse();
+}
+
+CppTable
+get_table(CppTable const& table, char const* name)
+{
+  return table->get_table_qualified(name);
+}
+
+CppTable
+get_table_or_abort(CppTable const& table, char const* name)
+{
+
+  auto table_o = get_table(table, name);
+  if (!table_o) {
+    std::abort();
+  }
+  return table_o;
+}
+
+CppTableArray
+get_table_array(CppTable const& table, char const* name)
+{
+  return table->get_table_array(name);
+}
+
+CppTableArray
+get_table_array_or_abort(CppTable const& table, char const* name)
+{
+  auto table_o = get_table_array(table, name);
+  if (!table_o) {
+    std::abort();
+  }
+  return table_o;
+}
+
+template <typename T>
+std::optional<T>
+get_value(CppTable const& table, char const* name)
+{
+  auto cpptoml_option = table->get_as<T>(name);
+  if (!cpptoml_option) {
+    return std::nullopt;
+  }
+  // Move value out of cpptoml and into std::optional
+  auto value = cpptoml_option.move_out();
+  return std::make_optional(MOVE(value));
+}
+
+auto
+get_string(CppTable const& table, char const* name)
+{
+  return get_value<std::string>(table, name);
+}
+
+auto
+get_bool(CppTable const& table, char const* name)
+{
+  return get_value<bool>(table, name);
+}
+
+std::optional<GLsizei>
+get_sizei(CppTable const& table, char const* name)
+{
+  return get_value<GLsizei>(table, name);
+}
+
+template <typename T>
+auto
+get_or_abort(CppTable const& table, char const* name)
+{
+  auto o = table->get_as<T>(name);
+  if (!o) {
+    std::abort();
+  }
+  return *o;
+}
+
+std::string
+get_string_or_abort(CppTable const& table, char const* name)
+{
+  return get_or_abort<std::string>(table, name);
+}
+
+std::optional<Color>
+get_color(CppTable const& table, char const* name)
+{
+  auto const load_colors = table->template get_array_of<double>(name);
+  if (!load_colors) {
+    return std::nullopt;
+  }
+
+  std::vector<double> const& c = *load_colors;
+  assert(4 == c.size() || 3 == c.size());
+
+  auto const alpha = (3 == c.size()) ? 1.0f : c[3];
+  auto color       = color::make_rgba(c[0], c[1], c[2], alpha);
+  return std::make_optional(color);
+}
+
+Color
+get_color_or_abort(CppTable const& table, char const* name)
+{
+  auto const c = get_color(table, name);
+  if (c) {
+    return *c;
+  }
+  std::abort();
+}
+
+auto const&
+get_first_and_only_entry(CppTable const& table, char const* name)
+{
+  auto const ta = get_table_array(table, name);
+
+  // Ensure the value retrieved from the table is itself a table, and get a reference to it.
+  assert(ta->is_table_array());
+  auto const& table_array = ta->get();
+
+  // Confirm there is only one entry in the table array.
+  if (1 != table_array.size()) {
+    std::abort();
+  }
+
+  // Return a reference to the first (and only) entry in the table array.
+  return table_array.front();
+}
+
+std::optional<glm::vec3>
+get_vec3(CppTable const& table, char const* name)
+{
+  auto const load_data = table->template get_array_of<double>(name);
+  if (!load_data) {
+    return std::nullopt;
+  }
+  auto const& ld = *load_data;
+  return glm::vec3{ld[0], ld[1], ld[2]};
+}
+
+glm::vec3
+get_vec3_or_abort(CppTable const& table, char const* name)
+{
+  auto const vec3_data = get_vec3(table, name);
+  if (!vec3_data) {
+    std::abort();
+  }
+  return *vec3_data;
+}
+
+std::optional<unsigned int>
+get_unsignedint(CppTable const& table, char const* name)
+{
+  auto const load_data = get_value<unsigned int>(table, name);
+  if (!load_data) {
+    return std::nullopt;
+  }
+  return std::make_optional(*load_data);
+}
+
+std::optional<float>
+get_float(CppTable const& table, char const* name)
+{
+  auto const load_data = get_value<double>(table, name);
+  if (!load_data) {
+    return std::nullopt;
+  }
+  return std::make_optional(static_cast<float>(*load_data));
+}
+
+float
+get_float_or_abort(CppTable const& table, char const* name)
+{
+  auto const float_data = get_float(table, name);
+  if (!float_data) {
+    std::abort();
+  }
+  return *float_data;
+}
+
+// Find the index of the entry named "name" within "entries".
+template <typename T>
+std::optional<LevelIndex>
+index_of(std::vector<T> const& entries, std::string const& name)
+{
+  auto const cmp = [&name](auto const& entry) { return entry.name == name; };
+  auto const it  = std::find_if(entries.cbegin(), entries.cend(), cmp);
+  if (it == entries.cend()) {
+    return std::nullopt;
+  }
+  return static_cast<LevelIndex>(std::distance(entries.cbegin(), it));
+}
+
+std::vector<CompiledVertexLayout>
+compile_vertex_layouts(CppTable const& table)
+{
+  auto const table_array = table->get_table_array("vas");
+  assert(table_array);
+
+  auto const read_data = [&](auto const& table, char const* fieldname, size_t& index) {
+    // THINKING EXPLAINED:
+    //
+    // If there isn't a field, bail early. However, if there IS a field, ensure it has the fields
+    // we expect.
+    TRY_OPTION(auto data_table, table->get_table(fieldname));
+    auto const datatype_s = get_string_or_abort(data_table, "datatype");
+    auto const datatype   = datatype_from_string(datatype_s.c_str());
+    if (datatype == AttributePointerInfo::INVALID_TYPE) {
+      std::abort();
+    }
+    auto const num        = get_or_abort<int>(data_table, "num");
+    bool const normalized = get_bool(data_table, "normalized").value_or(false);
+
+    auto const uint_index     = static_cast<GLuint>(index);
+    auto const attribute_type = attribute_type_from_string(fieldname);
+
+    opengl::AttributePointerInfo api{uint_index, datatype, attribute_type, num, normalized};
+
+    ++index;
+    return cpptoml::option<opengl::AttributePointerInfo>{MOVE(api)};
+  };
+
+  auto const add_next_found = [&read_data](auto& apis, auto const& table, char const* fieldname,
+                                           size_t& index) {
+    auto       data_o    = read_data(table, fieldname, index);
+    bool const data_read = !!data_o;
+    if (data_read) {
+      auto data = MOVE(*data_o);
+      apis.emplace_back(MOVE(data));
+    }
+  };
+
+  std::vector<CompiledVertexLayout> layouts;
+  for (auto const& it : *table_array) {
+    CompiledVertexLayout layout;
+    layout.name = get_string_or_abort(it, "name");
+
+    size_t i = 0u;
+    add_next_found(layout.apis, it, "position", i);
+    add_next_found(layout.apis, it, "normal", i);
+    add_next_found(layout.apis, it, "color", i);
+    add_next_found(layout.apis, it, "uv", i);
+    layouts.emplace_back(MOVE(layout));
+  }
+  return layouts;
+}
+
+Result<std::vector<CompiledShader>, std::string>
+compile_shaders(CppTable const& table, std::vector<CompiledVertexLayout> const& layouts)
+{
+  std::vector<CompiledShader> shaders;
+
+  auto const shaders_table = get_table_array_or_abort(table, "shaders");
+  for (auto const& it : *shaders_table) {
+    CompiledShader shader;
+    shader.name     = get_string_or_abort(it, "name");
+    shader.vertex   = get_string_or_abort(it, "vertex");
+    shader.fragment = get_string_or_abort(it, "fragment");
+
+    auto const va_name     = get_string_or_abort(it, "va");
+    auto const va_index_o  = index_of(layouts, va_name);
+    if (!va_index_o) {
+      return Err(fmt::sprintf("shader '%s' uses unknown va '%s'", shader.name, va_name));
+    }
+    shader.vertex_layout  = *va_index_o;
+    shader.is_2d          = get_bool(it, "is_2d").value_or(false);
+    shader.instance_count = get_sizei(it, "instance_count").value_or(-1);
+    shaders.emplace_back(MOVE(shader));
+  }
+  return OK_MOVE(shaders);
+}
+
+std::vector<CompiledMesh>
+compile_meshes(CppTable const& table)
+{
+  std::vector<CompiledMesh> meshes;
+
+  auto const mesh_table = get_table_array_or_abort(table, "meshes");
+  for (auto const& it : *mesh_table) {
+    auto name = get_string_or_abort(it, "name");
+    auto path = get_string_or_abort(it, "path");
+    meshes.emplace_back(CompiledMesh{MOVE(name), MOVE(path), {}, {}});
+  }
+  return meshes;
+}
+
+// Load the OBJ file of each mesh, optimize it and cook the mesh's LOD chain.
+Result<common::none_t, std::string>
+cook_meshes(common::Logger& logger, std::vector<CompiledMesh>& meshes)
+{
+  for (auto& mesh : meshes) {
+    PHASE_TIMER("cook_mesh:" + mesh.name);
+    auto const objname = mesh.name + ".obj";
+    mesh.obj =
+        TRY_MOVEOUT(load_objfile(logger, mesh.path, objname).mapErrorMoveOut(loadstatus_to_string));
+
+    auto const stats = MeshOptimizer::optimize(mesh.obj);
+    LOG_INFO_SPRINTF("Mesh '%s' ACMR %.3f -> %.3f, vertices %lu -> %lu", mesh.name,
+                     stats.acmr_before, stats.acmr_after, stats.num_vertices_before,
+                     stats.num_vertices_after);
+
+    mesh.lods = MeshSimplifier::generate_lods(mesh.obj);
+    FOR(i, mesh.lods.size())
+    {
+      auto const lod_stats = MeshOptimizer::optimize(mesh.lods[i]);
+      LOG_DEBUG_SPRINTF("Mesh '%s' LOD %u (%lu triangles) ACMR %.3f -> %.3f", mesh.name, i + 1,
+                        mesh.lods[i].num_triangles(), lod_stats.acmr_before, lod_stats.acmr_after);
+    }
+  }
+  return OK_NONE;
+}
+
+Result<std::vector<CompiledTexture>, std::string>
+compile_textures(CppTable const& table)
+{
+  std::vector<CompiledTexture> textures;
+
+  auto const resource_table = get_table_array_or_abort(table, "resource");
+  for (auto const& resource : *resource_table) {
+    CompiledTexture texture;
+    texture.name = get_string_or_abort(resource, "name");
+
+    auto const type = get_string_or_abort(resource, "type");
+    if (type == "texture:3dcube-RGB") {
+      texture.is_3dcube = true;
+      texture.format    = GL_RGB;
+    }
+    else if (type == "texture:3dcube-RGBA") {
+      texture.is_3dcube = true;
+      texture.format    = GL_RGBA;
+    }
+    else if (type == "texture:2d-RGBA") {
+      texture.format = GL_RGBA;
+    }
+    else if (type == "texture:2d-RGB") {
+      texture.format = GL_RGB;
+    }
+    else {
+      // TODO: implement more.
+      return Err(fmt::sprintf("texture '%s' has unsupported type: %s", texture.name, type));
+    }
+
+    auto const wrap_s    = get_string(resource, "wrap").value_or("clamp");
+    texture.wrap         = wrap_mode_from_string(wrap_s.c_str());
+    texture.uv_max       = get_float(resource, "uvs").value_or(1.0f);
+    texture.texture_unit = get_unsignedint(resource, "texture_unit").value_or(0);
+    texture.streamed     = get_bool(resource, "streamed").value_or(false);
+
+    if (texture.is_3dcube) {
+      for (auto const* side : {"front", "right", "back", "left", "top", "bottom"}) {
+        texture.filenames.emplace_back(get_string_or_abort(resource, side));
+      }
+    }
+    else {
+      texture.filenames.emplace_back(get_string_or_abort(resource, "filename"));
+    }
+    textures.emplace_back(MOVE(texture));
+  }
+  return OK_MOVE(textures);
+}
+
+std::vector<CompiledMaterial>
+compile_materials(CppTable const& table)
+{
+  std::vector<CompiledMaterial> materials;
+
+  auto const table_array = get_table_array(table, "material");
+  for (auto const& it : *table_array) {
+    // clang-format off
+    auto const name      = get_string_or_abort(it, "name");
+    auto const ambient   = get_vec3_or_abort(it,   "ambient");
+    auto const diffuse   = get_vec3_or_abort(it,   "diffuse");
+    auto const specular  = get_vec3_or_abort(it,   "specular");
+    auto const shininess = get_float_or_abort(it,  "shininess");
+    // clang-format on
+
+    materials.emplace_back(CompiledMaterial{name, Material{ambient, diffuse, specular, shininess}});
+  }
+  return materials;
+}
+
+std::vector<CompiledAttenuation>
+compile_attenuations(CppTable const& table)
+{
+  std::vector<CompiledAttenuation> attenuations;
+
+  auto const table_array = get_table_array(table, "attenuation");
+  for (auto const& it : *table_array) {
+    auto const name      = get_string_or_abort(it, "name");
+    auto const constant  = get_float(it, "constant").value_or(0);
+    auto const linear    = get_float(it, "linear").value_or(0);
+    auto const quadratic = get_float(it, "quadratic").value_or(0);
+
+    attenuations.emplace_back(CompiledAttenuation{name, Attenuation{constant, linear, quadratic}});
+  }
+  return attenuations;
+}
+
+void
+compile_global_lighting(CppTable const& table, CompiledLevel& level)
+{
+  auto const global_lighting = get_first_and_only_entry(table, "global-lighting");
+  level.ambient              = get_color_or_abort(global_lighting, "ambient").rgb();
+
+  auto const directinal_table = get_table_or_abort(global_lighting, "directional");
+  auto&      directional      = level.directional;
+  directional.light.diffuse   = get_color_or_abort(directinal_table, "diffuse").rgb();
+  directional.light.specular  = get_color_or_abort(directinal_table, "specular").rgb();
+  directional.direction       = get_vec3_or_abort(directinal_table, "direction");
+}
+
+void
+compile_fog(CppTable const& table, CompiledLevel& level)
+{
+  auto const& data   = get_first_and_only_entry(table, "fog");
+  level.fog_density  = get_float_or_abort(data, "density");
+  level.fog_gradient = get_float_or_abort(data, "gradient");
+  level.fog_color    = get_color_or_abort(data, "color");
+}
+
+Result<common::none_t, std::string>
+compile_heightmap(CppTable const& table, CompiledLevel& level)
+{
+  auto const name = get_string(table, "heightmap");
+  if (!name) {
+    return OK_NONE;
+  }
+  auto const index = index_of(level.textures, *name);
+  if (!index) {
+    return Err(fmt::sprintf("level uses unknown heightmap '%s'", *name));
+  }
+  level.heightmap = *index;
+  return OK_NONE;
+}
+
+Result<CompiledEntity, std::string>
+compile_entity(CppTable const& file, CompiledLevel const& level)
+{
+  CompiledEntity entity;
+
+  // clang-format off
+  entity.name              = get_string(file,          "name").value_or("FromFileUnnamed");
+  auto const shader        = get_string_or_abort(file, "shader");
+  auto const geometry      = get_string_or_abort(file, "geometry");
+  entity.position          = get_vec3_or_abort(file,   "position");
+  auto const scale_o       = get_vec3(file,            "scale");
+  auto const rotation_o    = get_vec3(file,            "rotation");
+  auto const color         = get_color(file,           "color");
+  auto const material_o    = get_string(file,          "material");
+  auto const texture_name  = get_string(file,          "texture");
+  entity.hidden            = get_bool(file,            "hidden").value_or(false);
+  entity.junk              = get_bool(file,            "random_junk_from_file").value_or(false);
+
+  // sub-tables or "inner"-tables
+  auto const orbital_o       = get_table(file, "orbital-body");
+  auto const pointlight_o    = get_table(file, "pointlight");
+  auto const occluder_o      = get_table(file, "occluder");
+  // clang-format on
+
+  auto const& name = entity.name;
+
+  // texture OR color fields, not both
+  if (color && texture_name) {
+    return Err(fmt::sprintf("entity '%s' has both a color and a texture", name));
+  }
+
+  auto const shader_o = index_of(level.shaders, shader);
+  if (!shader_o) {
+    return Err(fmt::sprintf("entity '%s' uses unknown shader '%s'", name, shader));
+  }
+  entity.shader = *shader_o;
+
+  if (scale_o) {
+    entity.scale = *scale_o;
+  }
+  if (rotation_o) {
+    Transform transform;
+    transform.rotate_xyz_degrees(*rotation_o);
+    entity.rotation = transform.rotation;
+  }
+
+  if (orbital_o) {
+    auto const x = get_float_or_abort(orbital_o, "x");
+    auto const y = get_float_or_abort(orbital_o, "y");
+    auto const z = get_float_or_abort(orbital_o, "z");
+
+    entity.has_orbital    = true;
+    entity.orbital_radius = glm::vec3{x, y, z};
+    entity.orbital_offset = get_float(orbital_o, "offset").value_or(0.0);
+  }
+
+  if (geometry == "cube") {
+    auto const cube_vertices_o = get_table_or_abort(file, "cube_vertices");
+    entity.geometry            = CompiledGeometry::CUBE;
+    entity.cube_min            = get_vec3(cube_vertices_o, "min").value_or(glm::vec3{1.0f});
+    entity.cube_max            = get_vec3(cube_vertices_o, "max").value_or(glm::vec3{1.0f});
+  }
+  else if (boost::starts_with(geometry, "mesh:")) {
+    auto const mesh_name = geometry.substr(::strlen("mesh:"));
+    auto const mesh_o    = index_of(level.meshes, mesh_name);
+    if (!mesh_o) {
+      return Err(fmt::sprintf("entity '%s' uses unknown mesh '%s'", name, mesh_name));
+    }
+    entity.geometry = CompiledGeometry::MESH;
+    entity.mesh     = *mesh_o;
+  }
+  else if (boost::starts_with(geometry, "billboard:")) {
+    entity.geometry  = CompiledGeometry::BILLBOARD;
+    entity.billboard = Billboard::from_string(geometry.substr(::strlen("billboard:")));
+  }
+
+  if (color) {
+    entity.has_color = true;
+    entity.color     = *color;
+  }
+  if (texture_name) {
+    auto const texture_o = index_of(level.textures, *texture_name);
+    if (!texture_o) {
+      return Err(fmt::sprintf("entity '%s' uses unknown texture '%s'", name, *texture_name));
+    }
+    entity.texture = *texture_o;
+  }
+
+  if (pointlight_o) {
+    auto const attenuation   = get_string_or_abort(pointlight_o, "attenuation");
+    auto const attenuation_o = index_of(level.attenuations, attenuation);
+    if (!attenuation_o) {
+      return Err(fmt::sprintf("entity '%s' uses unknown attenuation '%s'", name, attenuation));
+    }
+    entity.has_pointlight = true;
+    entity.attenuation    = *attenuation_o;
+
+    // TODO: instead of converting the vec4 to vec3, just read it in as a vec3.
+    entity.light.diffuse  = get_color_or_abort(pointlight_o, "diffuse").rgb();
+    entity.light.specular = get_color_or_abort(pointlight_o, "specular").rgb();
+  }
+
+  if (occluder_o) {
+    entity.has_occluder = true;
+    entity.occluder_min = get_vec3_or_abort(occluder_o, "min");
+    entity.occluder_max = get_vec3_or_abort(occluder_o, "max");
+  }
+
+  if (common::cstrcmp(name.c_str(), "TreeLowpoly")) {
+    entity.tree = CompiledTree::LOWPOLY;
+  }
+  else if (common::cstrcmp(name.c_str(), "Tree2")) {
+    entity.tree = CompiledTree::TREE2;
+  }
+  if (entity.tree != CompiledTree::NONE && entity.geometry != CompiledGeometry::MESH) {
+    return Err(fmt::sprintf("tree entity '%s' must have a mesh geometry", name));
+  }
+
+  // An object receives light, if it has ALL ambient/diffuse/specular fields
+  if (material_o) {
+    auto const index_o = index_of(level.materials, *material_o);
+    if (!index_o) {
+      return Err(fmt::sprintf("entity '%s' uses unknown material '%s'", name, *material_o));
+    }
+    entity.material = *index_o;
+  }
+  return OK_MOVE(entity);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// serialization
+using common::ByteReader;
+using common::ByteWriter;
+
+void
+write_strings(ByteWriter& w, std::vector<std::string> const& strings)
+{
+  w.write(static_cast<uint32_t>(strings.size()));
+  for (auto const& s : strings) {
+    w.write_string(s);
+  }
+}
+
+bool
+read_strings(ByteReader& r, std::vector<std::string>& strings)
+{
+  uint32_t count = 0;
+  if (!r.read_count(count, sizeof(uint32_t))) {
+    return false;
+  }
+  strings.resize(count);
+  for (auto& s : strings) {
+    if (!r.read_string(s)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Vectors of trivially copyable values are written as their count, followed by the values.
+template <typename T>
+void
+write_vector(ByteWriter& w, std::vector<T> const& values)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "values are written as bytes");
+  w.write(static_cast<uint32_t>(values.size()));
+  w.write_bytes(values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+bool
+read_vector(ByteReader& r, std::vector<T>& values)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "values are read as bytes");
+  uint32_t count = 0;
+  if (!r.read_count(count, sizeof(T))) {
+    return false;
+  }
+  values.resize(count);
+  return r.read_bytes(values.data(), count * sizeof(T));
+}
+
+// The vertex attributes and indices of the mesh. The tinyobj shapes and materials are only used
+// while loading the OBJ file, they are not written.
+void
+write_objdata(ByteWriter& w, ObjData const& obj)
+{
+  w.write(obj.num_vertexes);
+  write_vector(w, obj.vertices);
+  write_vector(w, obj.colors);
+  write_vector(w, obj.normals);
+  write_vector(w, obj.uvs);
+  write_vector(w, obj.indices);
+  write_vector(w, obj.material_ids);
+}
+
+bool
+read_objdata(ByteReader& r, ObjData& obj)
+{
+  // clang-format off
+  return r.read(obj.num_vertexes)
+      && read_vector(r, obj.vertices)
+      && read_vector(r, obj.colors)
+      && read_vector(r, obj.normals)
+      && read_vector(r, obj.uvs)
+      && read_vector(r, obj.indices)
+      && read_vector(r, obj.material_ids);
+  // clang-format on
+}
+
+// Check every attribute has a value for each of the mesh's vertices, and every index refers to one
+// of them.
+bool
+objdata_valid(ObjData const& obj)
+{
+  size_t const n     = obj.num_vertexes;
+  auto const   sized = [&n](auto const& values, size_t const num_components) {
+    return values.empty() || values.size() == (n * num_components);
+  };
+  bool const attributes_ok = (obj.vertices.size() == (n * 3)) && sized(obj.colors, 4) &&
+                             sized(obj.normals, 3) && sized(obj.uvs, 2) &&
+                             sized(obj.material_ids, 1);
+  return attributes_ok && (0 == (obj.indices.size() % 3)) &&
+         std::all_of(obj.indices.cbegin(), obj.indices.cend(),
+                     [&n](uint32_t const i) { return i < n; });
+}
+
+// Enums are written as their underlying type, anything past "last" means the buffer is corrupt.
+template <typename E>
+bool
+read_enum(ByteReader& r, E& value, E const last)
+{
+  using U = std::underlying_type_t<E>;
+  U raw;
+  if (!r.read(raw) || raw < U{0} || raw > static_cast<U>(last)) {
+    return false;
+  }
+  value = static_cast<E>(raw);
+  return true;
+}
+
+// Write every element of a table, using "fn" to write each element.
+template <typename T, typename FN>
+void
+write_table(ByteWriter& w, std::vector<T> const& table, FN const& fn)
+{
+  w.write(static_cast<uint32_t>(table.size()));
+  for (auto const& it : table) {
+    fn(it);
+  }
+}
+
+// Read every element of a table, using "fn" to read each element.
+template <typename T, typename FN>
+bool
+read_table(ByteReader& r, std::vector<T>& table, FN const& fn)
+{
+  // Every element starts with it's name.
+  uint32_t count = 0;
+  if (!r.read_count(count, sizeof(uint32_t))) {
+    return false;
+  }
+  table.resize(count);
+  for (auto& it : table) {
+    if (!fn(it)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+write_entity(ByteWriter& w, CompiledEntity const& e)
+{
+  w.write_string(e.name);
+  w.write(e.shader);
+  w.write(e.position);
+  w.write(e.scale);
+  w.write(e.rotation);
+  w.write(e.hidden);
+  w.write(e.junk);
+  w.write(e.geometry);
+  w.write(e.mesh);
+  w.write(e.billboard);
+  w.write(e.cube_min);
+  w.write(e.cube_max);
+  w.write(e.tree);
+  w.write(e.has_color);
+  w.write(e.color);
+  w.write(e.texture);
+  w.write(e.material);
+  w.write(e.has_orbital);
+  w.write(e.orbital_radius);
+  w.write(e.orbital_offset);
+  w.write(e.has_pointlight);
+  w.write(e.attenuation);
+  w.write(e.light);
+  w.write(e.has_occluder);
+  w.write(e.occluder_min);
+  w.write(e.occluder_max);
+}
+
+bool
+read_entity(ByteReader& r, CompiledEntity& e)
+{
+  // clang-format off
+  return r.read_string(e.name)
+      && r.read(e.shader)
+      && r.read(e.position)
+      && r.read(e.scale)
+      && r.read(e.rotation)
+      && r.read_bool(e.hidden)
+      && r.read_bool(e.junk)
+      && read_enum(r, e.geometry, CompiledGeometry::BILLBOARD)
+      && r.read(e.mesh)
+      && read_enum(r, e.billboard, BillboardType::INVALID)
+      && r.read(e.cube_min)
+      && r.read(e.cube_max)
+      && read_enum(r, e.tree, CompiledTree::TREE2)
+      && r.read_bool(e.has_color)
+      && r.read(e.color)
+      && r.read(e.texture)
+      && r.read(e.material)
+      && r.read_bool(e.has_orbital)
+      && r.read(e.orbital_radius)
+      && r.read(e.orbital_offset)
+      && r.read_bool(e.has_pointlight)
+      && r.read(e.attenuation)
+      && r.read(e.light)
+      && r.read_bool(e.has_occluder)
+      && r.read(e.occluder_min)
+      && r.read(e.occluder_max);
+  // clang-format on
+}
+
+// Check every index stored in the level refers to an existing entry.
+bool
+indices_valid(CompiledLevel const& level)
+{
+  auto const valid = [](LevelIndex const index, auto const& table) {
+    return index < table.size();
+  };
+  auto const valid_or_none = [&valid](LevelIndex const index, auto const& table) {
+    return index == LEVEL_INDEX_NONE || valid(index, table);
+  };
+
+  for (auto const& shader : level.shaders) {
+    if (!valid(shader.vertex_layout, level.vertex_layouts)) {
+      return false;
+    }
+  }
+  for (auto const& mesh : level.meshes) {
+    if (!objdata_valid(mesh.obj)) {
+      return false;
+    }
+    auto const from_mesh = [&mesh](uint32_t const v) { return v < mesh.obj.num_vertexes; };
+    for (auto const& lod : mesh.lods) {
+      auto const& sources = lod.source_vertices;
+      if (!objdata_valid(lod.data) || sources.size() != lod.data.num_vertexes ||
+          !std::all_of(sources.cbegin(), sources.cend(), from_mesh)) {
+        return false;
+      }
+    }
+  }
+  if (!valid_or_none(level.heightmap, level.textures)) {
+    return false;
+  }
+  for (auto const& e : level.entities) {
+    bool const ok = valid(e.shader, level.shaders) && valid_or_none(e.mesh, level.meshes) &&
+                    valid_or_none(e.texture, level.textures) &&
+                    valid_or_none(e.material, level.materials) &&
+                    valid_or_none(e.attenuation, level.attenuations);
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+time_t
+modified_time(std::string const& path)
+{
+  struct stat st;
+  return (0 == ::stat(path.c_str(), &st)) ? st.st_mtime : 0;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LevelCompiler
+Result<CompiledLevel, std::string>
+LevelCompiler::compile(common::Logger& logger, std::string const& filename)
+{
+  PHASE_TIMER("compile_level:" + filename);
+  CompiledLevel level;
+
+  LOG_TRACE_SPRINTF("compiling level %s ...", filename);
+  CppTable const engine_table = parse_toml_file(ENGINE_FILE);
+  assert(engine_table);
+  level.vertex_layouts = compile_vertex_layouts(engine_table);
+  level.shaders        = TRY_MOVEOUT(compile_shaders(engine_table, level.vertex_layouts));
+
+  CppTable const resource_table = parse_toml_file(RESOURCES_FILE);
+  assert(resource_table);
+  level.meshes       = compile_meshes(resource_table);
+  TRY_MOVEOUT(cook_meshes(logger, level.meshes));
+  level.textures     = TRY_MOVEOUT(compile_textures(resource_table));
+  level.materials    = compile_materials(resource_table);
+  level.attenuations = compile_attenuations(resource_table);
+
+  auto const level_path = "levels/" + filename;
+  CppTable const level_table = parse_toml_file(level_path);
+  assert(level_table);
+  compile_global_lighting(level_table, level);
+  compile_fog(level_table, level);
+  TRY_MOVEOUT(compile_heightmap(level_table, level));
+
+  auto const entity_table = get_table_array(level_table, "entity");
+  for (auto const& it : *entity_table) {
+    auto entity = TRY_MOVEOUT(compile_entity(it, level));
+    level.entities.emplace_back(MOVE(entity));
+  }
+  LOG_TRACE_SPRINTF("compiled level %s, %lu entities.", filename, level.entities.size());
+  return OK_MOVE(level);
+}
+
+common::ByteBuffer
+LevelCompiler::serialize(CompiledLevel const& level)
+{
+  common::ByteBuffer buffer;
+  ByteWriter         w{buffer};
+  w.write(MAGIC);
+  w.write(VERSION);
+
+  write_table(w, level.vertex_layouts, [&w](auto const& layout) {
+    w.write_string(layout.name);
+    w.write(static_cast<uint32_t>(layout.apis.size()));
+    w.write_bytes(layout.apis.data(), layout.apis.size() * sizeof(AttributePointerInfo));
+  });
+  write_table(w, level.shaders, [&w](auto const& shader) {
+    w.write_string(shader.name);
+    w.write_string(shader.vertex);
+    w.write_string(shader.fragment);
+    w.write(shader.vertex_layout);
+    w.write(shader.is_2d);
+    w.write(shader.instance_count);
+  });
+  write_table(w, level.meshes, [&w](auto const& mesh) {
+    w.write_string(mesh.name);
+    w.write_string(mesh.path);
+    write_objdata(w, mesh.obj);
+    write_table(w, mesh.lods, [&w](auto const& lod) {
+      write_objdata(w, lod.data);
+      write_vector(w, lod.source_vertices);
+    });
+  });
+  write_table(w, level.textures, [&w](auto const& texture) {
+    w.write_string(texture.name);
+    w.write(texture.is_3dcube);
+    w.write(texture.format);
+    w.write(texture.wrap);
+    w.write(texture.uv_max);
+    w.write(texture.texture_unit);
+    w.write(texture.streamed);
+    write_strings(w, texture.filenames);
+  });
+  write_table(w, level.materials, [&w](auto const& material) {
+    w.write_string(material.name);
+    w.write(material.value);
+  });
+  write_table(w, level.attenuations, [&w](auto const& attenuation) {
+    w.write_string(attenuation.name);
+    w.write(attenuation.value);
+  });
+
+  w.write(level.ambient);
+  w.write(level.directional);
+  w.write(level.fog_density);
+  w.write(level.fog_gradient);
+  w.write(level.fog_color);
+  w.write(level.heightmap);
+
+  write_table(w, level.entities, [&w](auto const& entity) { write_entity(w, entity); });
+  return buffer;
+}
+
+Result<CompiledLevel, std::string>
+LevelCompiler::deserialize(common::ByteBuffer const& buffer)
+{
+  ByteReader r{buffer};
+
+  std::array<char, 4> magic;
+  uint32_t            version = 0;
+  if (!r.read(magic) || magic != MAGIC) {
+    return ErrCString("Not a compiled level.");
+  }
+  if (!r.read(version) || version != VERSION) {
+    return Err(fmt::sprintf("Compiled level has version %u, expected %u.", version, VERSION));
+  }
+
+  CompiledLevel level;
+  bool const    ok =
+      read_table(r, level.vertex_layouts,
+                 [&r](auto& layout) {
+                   uint32_t count = 0;
+                   if (!r.read_string(layout.name) ||
+                       !r.read_count(count, sizeof(AttributePointerInfo))) {
+                     return false;
+                   }
+                   layout.apis.resize(count);
+                   return r.read_bytes(layout.apis.data(), count * sizeof(AttributePointerInfo));
+                 }) &&
+      read_table(r, level.shaders,
+                 [&r](auto& shader) {
+                   return r.read_string(shader.name) && r.read_string(shader.vertex) &&
+                          r.read_string(shader.fragment) && r.read(shader.vertex_layout) &&
+                          r.read_bool(shader.is_2d) && r.read(shader.instance_count);
+                 }) &&
+      read_table(r, level.meshes,
+                 [&r](auto& mesh) {
+                   return r.read_string(mesh.name) && r.read_string(mesh.path) &&
+                          read_objdata(r, mesh.obj) &&
+                          read_table(r, mesh.lods, [&r](auto& lod) {
+                            return read_objdata(r, lod.data) &&
+                                   read_vector(r, lod.source_vertices);
+                          });
+                 }) &&
+      read_table(r, level.textures,
+                 [&r](auto& texture) {
+                   return r.read_string(texture.name) && r.read_bool(texture.is_3dcube) &&
+                          r.read(texture.format) && r.read(texture.wrap) &&
+                          r.read(texture.uv_max) && r.read(texture.texture_unit) &&
+                          r.read_bool(texture.streamed) && read_strings(r, texture.filenames);
+                 }) &&
+      read_table(r, level.materials,
+                 [&r](auto& material) {
+                   return r.read_string(material.name) && r.read(material.value);
+                 }) &&
+      read_table(r, level.attenuations,
+                 [&r](auto& attenuation) {
+                   return r.read_string(attenuation.name) && r.read(attenuation.value);
+                 }) &&
+      r.read(level.ambient) && r.read(level.directional) && r.read(level.fog_density) &&
+      r.read(level.fog_gradient) && r.read(level.fog_color) && r.read(level.heightmap) &&
+      read_table(r, level.entities, [&r](auto& entity) { return read_entity(r, entity); });
+
+  if (!ok) {
+    return ErrCString("Compiled level is truncated.");
+  }
+  if (!indices_valid(level)) {
+    return ErrCString("Compiled level contains an invalid index.");
+  }
+  return OK_MOVE(level);
+}
+
+std::string
+LevelCompiler::compiled_path(std::string const& filename)
+{
+  auto const dot  = filename.rfind('.');
+  auto const stem = (dot == std::string::npos) ? filename : filename.substr(0, dot);
+  return "levels/" + stem + ".bin";
+}
+
+bool
+LevelCompiler::is_compiled_uptodate(std::string const& filename)
+{
+  auto const compiled_time = modified_time(compiled_path(filename));
+  if (0 == compiled_time) {
+    return false;
+  }
+
+  auto const level_path = "levels/" + filename;
+  for (auto const& source : {std::string{ENGINE_FILE}, std::string{RESOURCES_FILE}, level_path}) {
+    if (modified_time(source) > compiled_time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+LevelCompiler::are_meshes_uptodate(CompiledLevel const& level, std::string const& filename)
+{
+  auto const compiled_time = modified_time(compiled_path(filename));
+  for (auto const& mesh : level.meshes) {
+    if (modified_time(mesh.path + mesh.name + ".obj") > compiled_time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace boomhs
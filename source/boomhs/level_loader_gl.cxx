@@ -0,0 +1,203 @@
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/item.hpp>
+#include <boomhs/level_compiler.hpp>
+#include <boomhs/level_loader.hpp>
+#include <boomhs/material.hpp>
+#include <boomhs/terrain.hpp>
+#include <boomhs/tree.hpp>
+
+#include <opengl/shader.hpp>
+#include <opengl/texture.hpp>
+
+#include <common/algorithm.hpp>
+#include <common/phase_timer.hpp>
+#include <common/result.hpp>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
+using namespace boomhs;
+using namespace opengl;
+
+namespace
+{
+
+// Upload the level's textures, except the streamed ones GpuResidency uploads while they are used.
+Result<opengl::TextureTable, std::string>
+load_textures(common::Logger& logger, std::vector<CompiledTexture> const& textures)
+{
+  PHASE_TIMER("textures");
+  opengl::TextureTable ttable;
+  for (auto const& texture : textures) {
+    PHASE_TIMER("texture:" + texture.name);
+
+    TextureInfo ti;
+    ti.wrap   = texture.wrap;
+    ti.uv_max = texture.uv_max;
+    ti.format = texture.format;
+
+    opengl::TextureFilenames texture_names{texture.name, texture.filenames};
+    auto const&              filenames = texture_names.filenames;
+
+    if (texture.streamed) {
+      ti.target = texture.is_3dcube ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+      ttable.add_texture(MOVE(texture_names), Texture{MOVE(ti)}, true);
+      continue;
+    }
+
+    auto t = TRY_MOVEOUT(texture.is_3dcube
+                             ? opengl::texture::upload_3dcube_texture(logger, filenames, MOVE(ti))
+                             : opengl::texture::upload_2d_texture(logger, filenames[0], MOVE(ti)));
+    ttable.add_texture(MOVE(texture_names), MOVE(t));
+  }
+  return OK_MOVE(ttable);
+}
+
+auto
+load_attenuations(std::vector<CompiledAttenuation> const& attenuations)
+{
+  std::vector<NameAttenuation> result;
+  for (auto const& it : attenuations) {
+    result.emplace_back(NameAttenuation{it.name, it.value});
+  }
+  return result;
+}
+
+Result<opengl::ShaderPrograms, std::string>
+load_shaders(common::Logger& logger, CompiledLevel const& level)
+{
+  PHASE_TIMER("shaders");
+  opengl::ShaderPrograms sps;
+  for (auto const& shader : level.shaders) {
+    PHASE_TIMER("shader:" + shader.name);
+
+    auto const& layout  = level.vertex_layouts[shader.vertex_layout];
+    auto        va      = make_vertex_attribute(layout.apis);
+    auto        program = TRY_MOVEOUT(
+        opengl::make_shader_program(logger, shader.vertex, shader.fragment, MOVE(va)));
+
+    program.is_2d = shader.is_2d;
+    if (shader.instance_count >= 0) {
+      program.instance_count = shader.instance_count;
+    }
+    sps.add(shader.name, MOVE(program));
+  }
+  return Ok(MOVE(sps));
+}
+
+// The tree's colors are written into their vertex buffers, the TreeComponent keeps them.
+void
+add_trees(common::Logger& logger, CompiledLevel const& level, EntityArray const& eids,
+          ObjStore& obj_store, EntityRegistry& registry)
+{
+  FOR(i, level.entities.size())
+  {
+    auto const& e   = level.entities[i];
+    auto const  eid = eids[i];
+    if (e.tree == CompiledTree::LOWPOLY) {
+      auto& obj = obj_store.get(logger, level.meshes[e.mesh].name);
+      auto& tc  = registry.assign<TreeComponent>(eid, obj);
+      tc.add_color(TreeColorType::Leaf, LOC4::GREEN);
+      tc.add_color(TreeColorType::Leaf, LOC4::PINK);
+      tc.add_color(TreeColorType::Trunk, LOC4::BROWN);
+    }
+    else if (e.tree == CompiledTree::TREE2) {
+      auto& obj = obj_store.get(logger, level.meshes[e.mesh].name);
+      auto& tc  = registry.assign<TreeComponent>(eid, obj);
+      tc.add_color(TreeColorType::Leaf, LOC4::YELLOW);
+      tc.add_color(TreeColorType::Stem, LOC4::RED);
+      tc.add_color(TreeColorType::Stem, LOC4::BLUE);
+      tc.add_color(TreeColorType::Trunk, LOC4::GREEN);
+    }
+  }
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LevelLoader
+Result<LevelAssets, std::string>
+LevelLoader::instantiate_level(common::Logger& logger, EntityRegistry& registry,
+                               LevelSource&& source)
+{
+  PHASE_TIMER("instantiate_level");
+  auto const& level = source.level;
+  auto        sps   = TRY_MOVEOUT(load_shaders(logger, level));
+
+  LOG_TRACE("loading level data begin ...");
+  LOG_TRACE("textures ...");
+  auto texture_table = TRY_MOVEOUT(load_textures(logger, level.textures));
+
+  LOG_TRACE("materials ...");
+  auto material_table = load_materials(level);
+
+  LOG_TRACE("attenuations ...");
+  auto attenuations = load_attenuations(level.attenuations);
+
+  LOG_TRACE("global lighting ...");
+  DirectionalLight directional = level.directional;
+  GlobalLight      glight{level.ambient, MOVE(directional)};
+
+  LOG_TRACE("global fog ...");
+  Fog fog{level.fog_density, level.fog_gradient, level.fog_color};
+
+  LOG_TRACE("loading level finished successfully!");
+  LevelAssets assets{MOVE(glight),           MOVE(fog),           MOVE(material_table),
+                     MOVE(attenuations),
+
+                     MOVE(source.obj_store), MOVE(texture_table), MOVE(sps),
+                     MOVE(source.heightmap)};
+
+  auto const eids = instantiate_entities(logger, registry, level);
+  add_trees(logger, level, eids, assets.obj_store, registry);
+  resolve_textures(logger, assets.texture_table, registry);
+  return OK_MOVE(assets);
+}
+
+Result<LevelAssets, std::string>
+LevelLoader::load_level(common::Logger& logger, EntityRegistry& registry,
+                        std::string const& filename)
+{
+  auto source = TRY_MOVEOUT(read_level(logger, filename));
+  return instantiate_level(logger, registry, MOVE(source));
+}
+
+void
+LevelLoader::resolve_textures(common::Logger& logger, TextureTable& ttable,
+                              EntityRegistry& registry)
+{
+  for (auto const eid : registry.view<TextureRenderable>()) {
+    auto& tr = registry.get<TextureRenderable>(eid);
+    if (!tr.handle.valid()) {
+      tr.handle = ttable.handle(tr.texture);
+      assert(tr.handle.valid());
+    }
+  }
+  for (auto const eid : registry.view<Item>()) {
+    auto& item = registry.get<Item>(eid);
+    if (!item.ui_tinfo) {
+      item.ui_tinfo = ttable.find(item.ui_texture);
+      assert(item.ui_tinfo);
+    }
+  }
+}
+
+void
+LevelLoader::resolve_textures(common::Logger& logger, TextureTable const& ttable,
+                              TerrainGrid& tgrid)
+{
+  for (auto& terrain : tgrid) {
+    auto& handles = terrain.texture_handles;
+    handles.clear();
+    for (auto const& name : terrain.bound_textures.textures) {
+      handles.emplace_back(ttable.handle(name));
+      assert(handles.back().valid());
+    }
+  }
+}
+
+} // namespace boomhs
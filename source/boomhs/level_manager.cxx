@@ -5,26 +5,27 @@ namespace boomhs
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // LevelManager
-LevelManager::LevelManager(ZoneStates&& zs)
-    : zstates_(MOVE(zs))
+LevelManager::LevelManager(int const num_floors)
+    : zstates_(num_floors)
 {
 }
 
 ZoneState const&
 LevelManager::active() const
 {
-  return zstates_[active_];
+  return zone(active_);
 }
 
 ZoneState&
 LevelManager::active()
 {
-  return zstates_[active_];
+  return zone(active_);
 }
 
 void
 LevelManager::make_active(int const level_number)
 {
+  assert(is_loaded(level_number));
   active_ = level_number;
 }
 
@@ -40,4 +41,40 @@ LevelManager::active_zone() const
   return active_;
 }
 
+bool
+LevelManager::is_loaded(int const level_number) const
+{
+  assert(level_number >= 0 && level_number < num_levels());
+  return zstates_[level_number].has_value();
+}
+
+ZoneState const&
+LevelManager::zone(int const level_number) const
+{
+  assert(is_loaded(level_number));
+  return *zstates_[level_number];
+}
+
+ZoneState&
+LevelManager::zone(int const level_number)
+{
+  assert(is_loaded(level_number));
+  return *zstates_[level_number];
+}
+
+void
+LevelManager::add_zone(int const level_number, ZoneState&& zs)
+{
+  assert(!is_loaded(level_number));
+  zstates_[level_number].emplace(MOVE(zs));
+}
+
+void
+LevelManager::remove_zone(int const level_number)
+{
+  assert(level_number != active_);
+  assert(is_loaded(level_number));
+  zstates_[level_number].reset();
+}
+
 } // namespace boomhs
@@ -8,6 +8,7 @@
 #include <boomhs/frame.hpp>
 #include <boomhs/game_config.hpp>
 #include <boomhs/io_sdl.hpp>
+#include <boomhs/level_loader.hpp>
 #include <boomhs/main_menu.hpp>
 #include <boomhs/math.hpp>
 #include <boomhs/player.hpp>
@@ -222,6 +223,8 @@ draw_debugwindow(EngineState& es, ZoneState& zs)
 
   ImGui::Checkbox("Draw Bounding Boxes", &es.draw_bounding_boxes);
   ImGui::Checkbox("Draw Normals", &es.draw_normals);
+  ImGui::Checkbox("Mesh LODs", &es.mesh_lods);
+  ImGui::Checkbox("Occlusion Culling", &es.occlusion_culling);
   ImGui::Checkbox("View View Frustum", &es.draw_view_frustum);
   ImGui::Checkbox("Draw Wireframe Rendering", &es.wireframe_override);
 
@@ -469,6 +472,17 @@ show_water_window(EngineState& es, LevelManager& lm)
   imgui_cxx::with_window(draw, "Water Window");
 }
 
+// Read the heightmap from the file of the texture with the given name.
+HeightmapResult
+parse_heightmap(common::Logger& logger, TextureTable const& ttable, std::string const& name)
+{
+  auto const* texture_names = ttable.lookup_nickname(name);
+  if (!texture_names) {
+    return Err(fmt::sprintf("Error looking up heightmap '%s'", name));
+  }
+  return heightmap::parse(logger, texture_names->filenames[0]);
+}
+
 void
 draw_terrain_editor(EngineState& es, LevelManager& lm)
 {
@@ -498,7 +512,6 @@ draw_terrain_editor(EngineState& es, LevelManager& lm)
 
   auto& ttable      = gfx_state.texture_table;
   auto& ld          = zs.level_data;
-  auto& grid_config = terrain_grid.config;
   auto& sps         = gfx_state.sps;
 
   auto const draw = [&]() -> Result<common::none_t, std::string> {
@@ -512,12 +525,13 @@ draw_terrain_editor(EngineState& es, LevelManager& lm)
       if (ImGui::Button("Generate Terrain")) {
         auto&      terrain_config = tbuffers.terrain_config;
         auto const heightmap      = TRY_MOVEOUT(
-            heightmap::load_fromtable(logger, ttable, terrain_config.texture_names.heightmap_path));
+            parse_heightmap(logger, ttable, terrain_config.texture_names.heightmap_path));
 
         terrain_grid.config = tbuffer_gridconfig;
-        auto& sp            = sps.ref_sp(logger, terrain_config.shader_name);
         ldata.terrain =
-            terrain::generate_grid(logger, terrain_config, heightmap, sp, ldata.terrain);
+            terrain::generate_grid(logger, terrain_config, heightmap, ldata.terrain);
+        LevelLoader::resolve_textures(logger, ttable, ldata.terrain);
+        gfx_state.draw_handles.upload_terrain(logger, sps, ldata.terrain);
       }
     }
     if (ImGui::CollapsingHeader("Rendering Options")) {
@@ -602,12 +616,16 @@ draw_terrain_editor(EngineState& es, LevelManager& lm)
             return Err(fmt);
           }
           else {
-            auto* ti = ttable.find(tn);
-            assert(ti);
-            ti->while_bound(logger, [&]() {
-              ti->set_fieldi(GL_TEXTURE_WRAP_S, terrain_config.wrap_mode);
-              ti->set_fieldi(GL_TEXTURE_WRAP_T, terrain_config.wrap_mode);
-            });
+            // A streamed texture not on the GPU has no wrap mode to set, once evicted it's uploaded
+            // again with the default wrap mode.
+            auto const handle = ttable.handle(tn);
+            if (ttable.is_resident(handle)) {
+              auto& ti = ttable.get(handle);
+              ti.while_bound(logger, [&]() {
+                ti.set_fieldi(GL_TEXTURE_WRAP_S, terrain_config.wrap_mode);
+                ti.set_fieldi(GL_TEXTURE_WRAP_T, terrain_config.wrap_mode);
+              });
+            }
           }
           terrain_texturenames.textures[index] = tn;
           return OK_NONE;
@@ -620,18 +638,18 @@ draw_terrain_editor(EngineState& es, LevelManager& lm)
         terrain_config.shader_name =
             sps.nickname_at_index(tbuffers.selected_shader).value_or(terrain_config.shader_name);
 
-        auto const heightmap = TRY_MOVEOUT(heightmap::load_fromtable(logger, ttable, selected_hm));
+        auto const heightmap = TRY_MOVEOUT(parse_heightmap(logger, ttable, selected_hm));
 
         auto const selected_terrain = tbuffers.selected_terrain;
         int const  row              = selected_terrain / terrain_grid.num_rows();
         int const  col              = selected_terrain % terrain_grid.num_cols();
 
-        auto& sp = sps.ref_sp(logger, terrain_config.shader_name);
-        auto  tp = terrain::generate_piece(logger, glm::vec2{row, col}, grid_config, terrain_config,
-                                          heightmap, sp);
+        auto tp = terrain::generate_piece(logger, glm::vec2{row, col}, terrain_config, heightmap);
 
         LOG_ERROR_SPRINTF("SELECTED TERRAIN %i row %i col %i", selected_terrain, row, col);
         terrain_grid[selected_terrain] = MOVE(tp);
+        LevelLoader::resolve_textures(logger, ttable, terrain_grid);
+        gfx_state.draw_handles.upload_terrain_piece(logger, sps, terrain_grid, selected_terrain);
       }
     }
 
@@ -858,6 +876,7 @@ draw_mainmenu(EngineState& es, LevelManager& lm, SDLWindow& window, DrawState& d
     ImGui::MenuItem("Environment Window", nullptr, &uistate.show_environment_window);
     imgui_cxx::with_menu(log_menu, "Log", es, ldata);
     ImGui::MenuItem("Player", nullptr, &uistate.show_playerwindow);
+    ImGui::MenuItem("Profiler", nullptr, &uistate.show_profiler_window);
     ImGui::MenuItem("Skybox", nullptr, &uistate.show_skyboxwindow);
     ImGui::MenuItem("Terrain", nullptr, &uistate.show_terrain_editor_window);
     ImGui::MenuItem("Time", nullptr, &uistate.show_time_window);
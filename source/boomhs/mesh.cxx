@@ -1,8 +1,11 @@
 #include <boomhs/heightmap.hpp>
 #include <boomhs/mesh.hpp>
+#include <boomhs/mesh_optimizer.hpp>
 #include <cassert>
 #include <common/algorithm.hpp>
 
+#include <algorithm>
+
 using namespace boomhs;
 
 namespace
@@ -42,6 +45,45 @@ create_normal_buffer(size_t const num_vertexes)
   return normals;
 }
 
+// Triangle strip indices for a square grid, in vertical bands "band_width" vertices across.
+//
+// Within a band the rows are drawn one after the other (top to bottom), so when the band is
+// narrow enough the row shared with the previous strip is still in the vertex cache. The strips
+// are joined with degenerate triangles.
+ObjIndices
+generate_strip_indices(size_t const num_vertexes, size_t const band_width)
+{
+  assert(band_width >= 2);
+  auto const x_length = num_vertexes, z_length = num_vertexes;
+
+  ObjIndices buffer;
+  for (size_t x_begin = 0; (x_begin + 1) < x_length; x_begin += band_width - 1) {
+    auto const x_end = std::min(x_begin + band_width, x_length);
+    FOR(z, z_length - 1)
+    {
+      if (!buffer.empty()) {
+        // Degenerate begin: repeat first vertex
+        buffer.emplace_back((z * z_length) + x_begin);
+      }
+
+      for (auto x = x_begin; x < x_end; ++x) {
+        // One part of the strip
+        buffer.emplace_back((z * z_length) + x);
+        buffer.emplace_back(((z + 1) * z_length) + x);
+      }
+
+      // Degenerate end: repeat last vertex
+      buffer.emplace_back(((z + 1) * z_length) + (x_end - 1));
+    }
+  }
+
+  // The last strip isn't joined to another.
+  if (!buffer.empty()) {
+    buffer.pop_back();
+  }
+  return buffer;
+}
+
 } // namespace
 
 namespace boomhs
@@ -132,36 +174,15 @@ MeshFactory::generate_uvs(common::Logger& logger, glm::vec2 const& dimensions,
 ObjIndices
 MeshFactory::generate_indices(common::Logger& logger, size_t const num_vertexes)
 {
-  auto const x_length = num_vertexes, z_length = num_vertexes;
-  auto const strips_required          = z_length - 1;
-  auto const degen_triangles_required = 2 * (strips_required - 1);
-  auto const vertices_perstrip        = 2 * x_length;
-
-  size_t const num_indices = (vertices_perstrip * strips_required) + degen_triangles_required;
-
-  ObjIndices buffer;
-  buffer.resize(num_indices);
-
-  size_t offset = 0;
-  FOR(z, z_length - 1)
-  {
-    if (z > 0) {
-      // Degenerate begin: repeat first vertex
-      buffer[offset++] = z * z_length;
-    }
-
-    FOR(x, x_length)
-    {
-      // One part of the strip
-      buffer[offset++] = (z * z_length) + x;
-      buffer[offset++] = ((z + 1) * z_length) + x;
-    }
-
-    if (z < (z_length - 2)) {
-      // Degenerate end: repeat last vertex
-      buffer[offset++] = ((z + 1) * z_length) + (x_length - 1);
-    }
-  }
+  auto const band_width = std::min(num_vertexes, MeshOptimizer::GRID_BAND_WIDTH);
+  auto       buffer     = generate_strip_indices(num_vertexes, band_width);
+
+  auto const num_vertices = math::squared(num_vertexes);
+  auto const rows_acmr    = MeshOptimizer::acmr(generate_strip_indices(num_vertexes, num_vertexes),
+                                             num_vertices, GL_TRIANGLE_STRIP);
+  auto const bands_acmr   = MeshOptimizer::acmr(buffer, num_vertices, GL_TRIANGLE_STRIP);
+  LOG_DEBUG_SPRINTF("Grid (%lu vertices across) ACMR %.3f -> %.3f", num_vertexes, rows_acmr,
+                    bands_acmr);
   return buffer;
 }
 
@@ -0,0 +1,525 @@
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/mesh_lod.hpp>
+#include <boomhs/transform.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+
+using namespace boomhs;
+
+namespace
+{
+
+// Edges on the mesh's border are weighted more, so the mesh keeps it's outline.
+double constexpr BORDER_WEIGHT = 10.0;
+
+// Collapses turning any triangle further than this (the cosine of the angle) are rejected.
+float constexpr MIN_NORMAL_DOT = 0.2f;
+
+// Added to the attribute distance of vertices with a different material.
+float constexpr MATERIAL_MISMATCH_DISTANCE = 1000.0f;
+
+// A LOD must have at most this fraction of the previous LOD's triangles to be kept.
+float constexpr MAX_LOD_REDUCTION = 0.8f;
+
+// The sum of the (weighted) squared distances to a set of planes, a symmetric 4x4 matrix.
+struct Quadric
+{
+  // a², ab, ac, ad, b², bc, bd, c², cd, d²
+  std::array<double, 10> m = {};
+
+  static Quadric from_plane(glm::vec3 const& normal, float const d, double const weight)
+  {
+    double const a = normal.x, b = normal.y, c = normal.z, dd = d;
+
+    Quadric q;
+    q.m = {{a * a, a * b, a * c, a * dd, b * b, b * c, b * dd, c * c, c * dd, dd * dd}};
+    for (auto& value : q.m) {
+      value *= weight;
+    }
+    return q;
+  }
+
+  Quadric& operator+=(Quadric const& other)
+  {
+    FOR(i, m.size()) { m[i] += other.m[i]; }
+    return *this;
+  }
+
+  double error(glm::vec3 const& p) const
+  {
+    double const x = p.x, y = p.y, z = p.z;
+    // clang-format off
+    return (m[0] * x * x) + (2 * m[1] * x * y) + (2 * m[2] * x * z) + (2 * m[3] * x)
+         + (m[4] * y * y) + (2 * m[5] * y * z) + (2 * m[6] * y)
+         + (m[7] * z * z) + (2 * m[8] * z)
+         + m[9];
+    // clang-format on
+  }
+};
+
+using Triangle = std::array<uint32_t, 3>;
+using EdgeKey  = std::pair<uint32_t, uint32_t>;
+
+// Collapsing an edge moves the "from" position onto the "to" position.
+struct Collapse
+{
+  double   cost;
+  uint32_t from, to;
+};
+
+// The mesh being simplified.
+//
+// Triangles refer to the mesh's vertices, vertices at the same position share a "welded" index.
+// Collapses happen between welded positions, the positions themselves never move.
+struct SimplifyState
+{
+  ObjData const& obj;
+
+  std::vector<uint32_t>              weld;
+  std::vector<glm::vec3>             positions;
+  std::vector<std::vector<uint32_t>> members;
+  std::vector<Quadric>               quadrics;
+  std::vector<Triangle>              triangles;
+
+  explicit SimplifyState(ObjData const& o)
+      : obj(o)
+  {
+  }
+
+  auto position(uint32_t const v) const { return positions[weld[v]]; }
+};
+
+EdgeKey
+make_edgekey(uint32_t const a, uint32_t const b)
+{
+  return a < b ? EdgeKey{a, b} : EdgeKey{b, a};
+}
+
+glm::vec3
+triangle_normal(glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c)
+{
+  // Not normalized, the length is twice the triangle's area.
+  return glm::cross(b - a, c - a);
+}
+
+void
+weld_positions(SimplifyState& state)
+{
+  auto const& vertices     = state.obj.vertices;
+  auto const  num_vertices = vertices.size() / 3;
+
+  std::map<std::array<float, 3>, uint32_t> welded;
+  state.weld.resize(num_vertices);
+  FOR(v, num_vertices)
+  {
+    std::array<float, 3> const key{{vertices[3 * v], vertices[3 * v + 1], vertices[3 * v + 2]}};
+
+    auto const it = welded.find(key);
+    if (it != welded.end()) {
+      state.weld[v] = it->second;
+      state.members[it->second].emplace_back(v);
+      continue;
+    }
+    auto const w  = static_cast<uint32_t>(state.positions.size());
+    welded[key]   = w;
+    state.weld[v] = w;
+    state.positions.emplace_back(key[0], key[1], key[2]);
+    state.members.emplace_back(std::vector<uint32_t>{v});
+  }
+}
+
+void
+add_triangles(SimplifyState& state)
+{
+  auto const& indices = state.obj.indices;
+  for (size_t i = 0; (i + 2) < indices.size(); i += 3) {
+    Triangle const t{{indices[i], indices[i + 1], indices[i + 2]}};
+
+    auto const w0 = state.weld[t[0]], w1 = state.weld[t[1]], w2 = state.weld[t[2]];
+    if (w0 != w1 && w1 != w2 && w0 != w2) {
+      state.triangles.emplace_back(t);
+    }
+  }
+}
+
+void
+compute_quadrics(SimplifyState& state)
+{
+  state.quadrics.resize(state.positions.size());
+
+  // Edges used by a single triangle are on the border, remember the triangle using each edge.
+  std::vector<std::pair<EdgeKey, size_t>> edges;
+  FOR(ti, state.triangles.size())
+  {
+    auto const& t = state.triangles[ti];
+    auto const  a = state.position(t[0]), b = state.position(t[1]), c = state.position(t[2]);
+
+    auto const  n      = triangle_normal(a, b, c);
+    float const length = glm::length(n);
+    if (length > 0.0f) {
+      auto const normal = n / length;
+      auto const q      = Quadric::from_plane(normal, -glm::dot(normal, a), length / 2.0f);
+      for (auto const v : t) {
+        state.quadrics[state.weld[v]] += q;
+      }
+    }
+    FOR(i, 3)
+    {
+      auto const w0 = state.weld[t[i]], w1 = state.weld[t[(i + 1) % 3]];
+      edges.emplace_back(make_edgekey(w0, w1), ti);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+
+  FOR(i, edges.size())
+  {
+    bool const shared_prev = i > 0 && edges[i - 1].first == edges[i].first;
+    bool const shared_next = (i + 1) < edges.size() && edges[i + 1].first == edges[i].first;
+    if (shared_prev || shared_next) {
+      continue;
+    }
+
+    // Add a plane through the border edge, perpendicular to it's triangle.
+    auto const& key = edges[i].first;
+    auto const& t   = state.triangles[edges[i].second];
+    auto const  a = state.position(t[0]), b = state.position(t[1]), c = state.position(t[2]);
+
+    auto const& p0   = state.positions[key.first];
+    auto const  edge = state.positions[key.second] - p0;
+    auto const  n    = glm::cross(edge, triangle_normal(a, b, c));
+    float const len  = glm::length(n);
+    if (len == 0.0f) {
+      continue;
+    }
+    auto const normal = n / len;
+    auto const weight = BORDER_WEIGHT * glm::dot(edge, edge);
+    auto const q      = Quadric::from_plane(normal, -glm::dot(normal, p0), weight);
+    state.quadrics[key.first] += q;
+    state.quadrics[key.second] += q;
+  }
+}
+
+float
+attribute_distance(ObjData const& obj, uint32_t const a, uint32_t const b)
+{
+  auto const distance = [&](ObjVertices const& values, size_t const num_components) {
+    if (values.empty()) {
+      return 0.0f;
+    }
+    float sum = 0.0f;
+    FOR(i, num_components)
+    {
+      float const d = values[num_components * a + i] - values[num_components * b + i];
+      sum += d * d;
+    }
+    return sum;
+  };
+  float const sum = distance(obj.normals, 3) + distance(obj.uvs, 2) + distance(obj.colors, 4);
+
+  // Keep the corner on the same material when possible, materials may be recolored (ie: trees).
+  bool const same_material = obj.material_ids.empty() || obj.material_ids[a] == obj.material_ids[b];
+  return same_material ? sum : (sum + MATERIAL_MISMATCH_DISTANCE);
+}
+
+// The vertex at the welded position whose attributes are most like the vertex's.
+uint32_t
+closest_vertex(SimplifyState const& state, uint32_t const v, uint32_t const welded)
+{
+  auto const& candidates = state.members[welded];
+  assert(!candidates.empty());
+
+  uint32_t closest  = candidates.front();
+  float    min_dist = std::numeric_limits<float>::max();
+  for (auto const candidate : candidates) {
+    float const dist = attribute_distance(state.obj, v, candidate);
+    if (dist < min_dist) {
+      min_dist = dist;
+      closest  = candidate;
+    }
+  }
+  return closest;
+}
+
+// Whether moving "from" onto "to" would flip (or collapse) one of the triangles around "from",
+// that isn't removed by the collapse.
+bool
+collapse_flips(SimplifyState const& state, std::vector<uint32_t> const& around,
+               uint32_t const from, uint32_t const to)
+{
+  for (auto const ti : around) {
+    auto const& t = state.triangles[ti];
+
+    std::array<uint32_t, 3> const w{{state.weld[t[0]], state.weld[t[1]], state.weld[t[2]]}};
+    if (std::find(w.cbegin(), w.cend(), to) != w.cend()) {
+      continue;
+    }
+
+    auto const&              positions = state.positions;
+    std::array<glm::vec3, 3> p{{positions[w[0]], positions[w[1]], positions[w[2]]}};
+    auto const               before = triangle_normal(p[0], p[1], p[2]);
+    FOR(i, 3)
+    {
+      if (w[i] == from) {
+        p[i] = state.positions[to];
+      }
+    }
+    auto const after = triangle_normal(p[0], p[1], p[2]);
+
+    float const lengths = glm::length(before) * glm::length(after);
+    if (lengths == 0.0f || (glm::dot(before, after) / lengths) < MIN_NORMAL_DOT) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Collapse as many edges as possible (cheapest first) without collapsing two edges that share a
+// triangle. Returns false if no edge could be collapsed.
+bool
+collapse_pass(SimplifyState& state, size_t const target)
+{
+  auto const num_welded = state.positions.size();
+
+  std::vector<std::vector<uint32_t>> around(num_welded);
+  std::vector<EdgeKey>               edges;
+  FOR(ti, state.triangles.size())
+  {
+    auto const& t = state.triangles[ti];
+    FOR(i, 3)
+    {
+      auto const w0 = state.weld[t[i]], w1 = state.weld[t[(i + 1) % 3]];
+      around[w0].emplace_back(ti);
+      edges.emplace_back(make_edgekey(w0, w1));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  std::vector<Collapse> collapses;
+  collapses.reserve(edges.size());
+  for (auto const& edge : edges) {
+    auto q = state.quadrics[edge.first];
+    q += state.quadrics[edge.second];
+
+    auto const to_second = q.error(state.positions[edge.second]);
+    auto const to_first  = q.error(state.positions[edge.first]);
+    if (to_second <= to_first) {
+      collapses.emplace_back(Collapse{to_second, edge.first, edge.second});
+    }
+    else {
+      collapses.emplace_back(Collapse{to_first, edge.second, edge.first});
+    }
+  }
+  auto const cmp = [](auto const& a, auto const& b) { return a.cost < b.cost; };
+  std::sort(collapses.begin(), collapses.end(), cmp);
+
+  auto const& obj          = state.obj;
+  auto const  num_vertices = obj.vertices.size() / 3;
+
+  std::vector<uint32_t> remap(num_vertices);
+  std::iota(remap.begin(), remap.end(), 0);
+
+  std::vector<bool> locked(num_welded, false);
+  size_t const      to_remove = state.triangles.size() - target;
+  size_t            removed   = 0;
+  size_t            collapsed = 0;
+  for (auto const& c : collapses) {
+    if (removed >= to_remove) {
+      break;
+    }
+    if (locked[c.from] || locked[c.to] || collapse_flips(state, around[c.from], c.from, c.to)) {
+      continue;
+    }
+
+    // The triangles around "from" change, lock their vertices until the next pass.
+    for (auto const ti : around[c.from]) {
+      auto const& t   = state.triangles[ti];
+      bool        has = false;
+      for (auto const v : t) {
+        locked[state.weld[v]] = true;
+        has |= state.weld[v] == c.to;
+      }
+      removed += has ? 1 : 0;
+    }
+    state.quadrics[c.to] += state.quadrics[c.from];
+    for (auto const v : state.members[c.from]) {
+      remap[v] = closest_vertex(state, v, c.to);
+    }
+    ++collapsed;
+  }
+  if (collapsed == 0) {
+    return false;
+  }
+
+  std::vector<Triangle> triangles;
+  triangles.reserve(state.triangles.size() - removed);
+  for (auto const& t : state.triangles) {
+    Triangle const r{{remap[t[0]], remap[t[1]], remap[t[2]]}};
+
+    auto const w0 = state.weld[r[0]], w1 = state.weld[r[1]], w2 = state.weld[r[2]];
+    if (w0 != w1 && w1 != w2 && w0 != w2) {
+      triangles.emplace_back(r);
+    }
+  }
+  state.triangles = MOVE(triangles);
+  return true;
+}
+
+void
+copy_vertex(ObjVertices const& from, size_t const num_components, uint32_t const v,
+            ObjVertices& to)
+{
+  if (from.empty()) {
+    return;
+  }
+  FOR(i, num_components) { to.emplace_back(from[num_components * v + i]); }
+}
+
+// Copy the vertices the triangles use into the LOD, in the order they are first used.
+MeshLod
+make_lod(SimplifyState const& state)
+{
+  auto const& obj = state.obj;
+
+  MeshLod lod;
+  auto&   data = lod.data;
+
+  std::vector<uint32_t> lod_index(obj.vertices.size() / 3, std::numeric_limits<uint32_t>::max());
+  for (auto const& t : state.triangles) {
+    for (auto const v : t) {
+      if (lod_index[v] == std::numeric_limits<uint32_t>::max()) {
+        lod_index[v] = static_cast<uint32_t>(lod.source_vertices.size());
+        lod.source_vertices.emplace_back(v);
+
+        copy_vertex(obj.vertices, 3, v, data.vertices);
+        copy_vertex(obj.colors, 4, v, data.colors);
+        copy_vertex(obj.normals, 3, v, data.normals);
+        copy_vertex(obj.uvs, 2, v, data.uvs);
+        if (!obj.material_ids.empty()) {
+          data.material_ids.emplace_back(obj.material_ids[v]);
+        }
+      }
+      data.indices.emplace_back(lod_index[v]);
+    }
+  }
+  data.num_vertexes = lod.source_vertices.size();
+  return lod;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// MeshSimplifier
+MeshLod
+MeshSimplifier::simplify(ObjData const& obj, size_t const target)
+{
+  SimplifyState state{obj};
+  weld_positions(state);
+  add_triangles(state);
+  compute_quadrics(state);
+
+  while (state.triangles.size() > target) {
+    if (!collapse_pass(state, target)) {
+      break;
+    }
+  }
+  return make_lod(state);
+}
+
+std::vector<MeshLod>
+MeshSimplifier::generate_lods(ObjData const& obj)
+{
+  std::vector<MeshLod> lods;
+
+  auto const num_triangles = obj.indices.size() / 3;
+  if (num_triangles < MIN_TRIANGLES) {
+    return lods;
+  }
+
+  // Each LOD is simplified from the previous one, which is cheaper than starting over from the
+  // original mesh.
+  for (auto const ratio : LOD_RATIOS) {
+    auto const& previous     = lods.empty() ? obj : lods.back().data;
+    auto const  previous_num = previous.indices.size() / 3;
+
+    auto const target = static_cast<size_t>(num_triangles * ratio);
+    auto       lod    = simplify(previous, target);
+    if (lod.num_triangles() > (previous_num * MAX_LOD_REDUCTION)) {
+      break;
+    }
+
+    // Point the LOD's vertices at the original mesh's vertices.
+    if (!lods.empty()) {
+      auto const& previous_sources = lods.back().source_vertices;
+      for (auto& v : lod.source_vertices) {
+        v = previous_sources[v];
+      }
+    }
+    lods.emplace_back(MOVE(lod));
+  }
+  return lods;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// LodSelector
+float
+LodSelector::screen_size(glm::mat4 const& view_mat, glm::mat4 const& proj_mat, Transform const& tr,
+                         AABoundingBox const& bbox)
+{
+  // Like ViewFrustum::bbox_inside(), use a sphere around the entity's translation.
+  auto const& cube   = bbox.cube;
+  auto const& scale  = tr.scale;
+  float const radius = (glm::length(cube.max - cube.min) / 2.0f) *
+                       std::max(scale.x, std::max(scale.y, scale.z));
+
+  // An orthographic projection's size doesn't change with distance.
+  bool const is_perspective = proj_mat[2][3] != 0.0f;
+  if (!is_perspective) {
+    return radius * proj_mat[1][1];
+  }
+
+  // The visible height at distance "d" is (2 * d / proj[1][1]).
+  float const distance = -(view_mat * glm::vec4{tr.translation, 1.0f}).z;
+  if (distance <= radius) {
+    return std::numeric_limits<float>::max();
+  }
+  return (radius * proj_mat[1][1]) / distance;
+}
+
+size_t
+LodSelector::select(float const size, size_t const current_lod, size_t const num_lods)
+{
+  static_assert(SCREEN_SIZES.size() + 1 == MeshSimplifier::MAX_LODS,
+                "Every LOD needs a screen size to switch at.");
+  if (num_lods <= 1) {
+    return 0;
+  }
+  auto const current = std::min(current_lod, num_lods - 1);
+
+  // The LOD the size calls for, ignoring hysteresis.
+  size_t wanted = 0;
+  while ((wanted + 1) < num_lods && size < SCREEN_SIZES[wanted]) {
+    ++wanted;
+  }
+
+  // Only switch as far as the size is past each threshold (by the hysteresis margin).
+  auto lod = current;
+  while (lod < wanted && size < (SCREEN_SIZES[lod] * (1.0f - HYSTERESIS))) {
+    ++lod;
+  }
+  while (lod > wanted && size > (SCREEN_SIZES[lod - 1] * (1.0f + HYSTERESIS))) {
+    --lod;
+  }
+  return lod;
+}
+
+} // namespace boomhs
@@ -0,0 +1,432 @@
+#include <boomhs/mesh_lod.hpp>
+#include <boomhs/mesh_optimizer.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+using namespace boomhs;
+
+namespace
+{
+
+uint32_t constexpr NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+// Simulates a FIFO vertex cache, using the time each vertex entered the cache.
+class CacheSimulator
+{
+  std::vector<uint32_t> entered_;
+  uint32_t              time_ = MeshOptimizer::CACHE_SIZE + 1;
+
+public:
+  explicit CacheSimulator(size_t const num_vertices)
+      : entered_(num_vertices, 0)
+  {
+  }
+
+  // Returns true if the vertex had to be transformed (wasn't in the cache).
+  bool fetch(uint32_t const v)
+  {
+    if ((time_ - entered_[v]) <= MeshOptimizer::CACHE_SIZE) {
+      return false;
+    }
+    entered_[v] = time_++;
+    return true;
+  }
+
+  void flush() { time_ += MeshOptimizer::CACHE_SIZE + 1; }
+};
+
+size_t
+num_vertices(ObjData const& obj)
+{
+  return obj.vertices.size() / 3;
+}
+
+template <typename T>
+void
+gather(std::vector<T>& values, size_t const num_components, std::vector<uint32_t> const& order)
+{
+  if (values.empty()) {
+    return;
+  }
+  std::vector<T> result;
+  result.reserve(order.size() * num_components);
+  for (auto const v : order) {
+    auto const begin = values.cbegin() + (v * num_components);
+    result.insert(result.end(), begin, begin + num_components);
+  }
+  values = MOVE(result);
+}
+
+// Replace the obj's vertices with the vertices in "order" (the indices are left alone).
+void
+gather_vertices(ObjData& obj, std::vector<uint32_t> const& order)
+{
+  gather(obj.vertices, 3, order);
+  gather(obj.colors, 4, order);
+  gather(obj.normals, 3, order);
+  gather(obj.uvs, 2, order);
+  gather(obj.material_ids, 1, order);
+  obj.num_vertexes = order.size();
+}
+
+glm::vec3
+vertex_position(ObjVertices const& positions, uint32_t const v)
+{
+  return glm::vec3{positions[3 * v], positions[3 * v + 1], positions[3 * v + 2]};
+}
+
+// Returns the next vertex to fan around, after the vertices around the last fan were used up.
+//
+// The most recently used vertices (still likely in the cache) are tried first, then the rest of
+// the vertices in order. Returns NO_VERTEX once every triangle was emitted.
+uint32_t
+skip_dead_end(std::vector<uint32_t>& dead_end, std::vector<uint32_t> const& live, size_t& cursor)
+{
+  while (!dead_end.empty()) {
+    auto const v = dead_end.back();
+    dead_end.pop_back();
+    if (live[v] > 0) {
+      return v;
+    }
+  }
+  for (; cursor < live.size(); ++cursor) {
+    if (live[cursor] > 0) {
+      return static_cast<uint32_t>(cursor);
+    }
+  }
+  return NO_VERTEX;
+}
+
+// Split the clusters further, where the ACMR of the triangles (since the last split) is already
+// close to the ACMR of the whole cluster.
+std::vector<uint32_t>
+split_clusters(ObjIndices const& indices, size_t const num_vertices,
+               std::vector<uint32_t> const& clusters)
+{
+  auto const     num_triangles = indices.size() / 3;
+  CacheSimulator cache{num_vertices};
+
+  auto const misses = [&](size_t const t) {
+    size_t count = 0;
+    FOR(i, 3) { count += cache.fetch(indices[3 * t + i]) ? 1 : 0; }
+    return count;
+  };
+
+  std::vector<uint32_t> result;
+  FOR(c, clusters.size())
+  {
+    size_t const begin = clusters[c];
+    size_t const end   = (c + 1) < clusters.size() ? clusters[c + 1] : num_triangles;
+
+    cache.flush();
+    size_t cluster_misses = 0;
+    for (size_t t = begin; t < end; ++t) {
+      cluster_misses += misses(t);
+    }
+    float const threshold =
+        MeshOptimizer::OVERDRAW_THRESHOLD * (static_cast<float>(cluster_misses) / (end - begin));
+
+    cache.flush();
+    result.emplace_back(begin);
+    size_t start = begin, split_misses = 0;
+    for (size_t t = begin; t < end; ++t) {
+      split_misses += misses(t);
+      bool const last = (t + 1) == end;
+      if (!last && (static_cast<float>(split_misses) / (t - start + 1)) <= threshold) {
+        start        = t + 1;
+        split_misses = 0;
+        result.emplace_back(start);
+        cache.flush();
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// MeshOptimizer
+float
+MeshOptimizer::acmr(ObjIndices const& indices, size_t const num_vertices, GLenum const mode)
+{
+  assert(mode == GL_TRIANGLES || mode == GL_TRIANGLE_STRIP);
+  CacheSimulator cache{num_vertices};
+
+  size_t misses = 0, num_triangles = 0;
+  FOR(i, indices.size())
+  {
+    misses += cache.fetch(indices[i]) ? 1 : 0;
+    if (mode == GL_TRIANGLES) {
+      num_triangles += ((i % 3) == 2) ? 1 : 0;
+    }
+    else if (i >= 2) {
+      // Degenerate triangles (joining the strips) are not counted.
+      auto const a = indices[i - 2], b = indices[i - 1], c = indices[i];
+      num_triangles += (a != b && b != c && a != c) ? 1 : 0;
+    }
+  }
+  return num_triangles == 0 ? 0.0f : static_cast<float>(misses) / num_triangles;
+}
+
+size_t
+MeshOptimizer::deduplicate_vertices(ObjData& obj)
+{
+  auto const count = num_vertices(obj);
+
+  auto const append = [](std::vector<float>& key, ObjVertices const& values, size_t const n,
+                         uint32_t const v) {
+    if (!values.empty()) {
+      key.insert(key.end(), values.cbegin() + (n * v), values.cbegin() + (n * v) + n);
+    }
+  };
+
+  std::map<std::vector<float>, uint32_t> unique;
+  std::vector<uint32_t>                  remap(count);
+  std::vector<uint32_t>                  kept;
+  std::vector<float>                     key;
+  FOR(v, count)
+  {
+    key.clear();
+    append(key, obj.vertices, 3, v);
+    append(key, obj.colors, 4, v);
+    append(key, obj.normals, 3, v);
+    append(key, obj.uvs, 2, v);
+    if (!obj.material_ids.empty()) {
+      key.emplace_back(static_cast<float>(obj.material_ids[v]));
+    }
+
+    auto const it = unique.find(key);
+    if (it != unique.end()) {
+      remap[v] = it->second;
+      continue;
+    }
+    remap[v] = static_cast<uint32_t>(kept.size());
+    unique.emplace(key, remap[v]);
+    kept.emplace_back(v);
+  }
+
+  gather_vertices(obj, kept);
+  for (auto& i : obj.indices) {
+    i = remap[i];
+  }
+  return count - kept.size();
+}
+
+ObjIndices
+MeshOptimizer::optimize_vertex_cache(ObjIndices const& indices, size_t const num_vertices,
+                                     std::vector<uint32_t>& clusters)
+{
+  auto const num_triangles = indices.size() / 3;
+
+  // The triangles around each vertex (the triangles around vertex "v" start at offsets[v]).
+  std::vector<uint32_t> offsets(num_vertices + 1, 0);
+  for (auto const i : indices) {
+    ++offsets[i + 1];
+  }
+  FOR(v, num_vertices) { offsets[v + 1] += offsets[v]; }
+
+  std::vector<uint32_t> adjacency(indices.size());
+  {
+    auto next = offsets;
+    FOR(i, indices.size()) { adjacency[next[indices[i]]++] = i / 3; }
+  }
+
+  // The number of triangles around each vertex that have not been emitted.
+  std::vector<uint32_t> live(num_vertices);
+  FOR(v, num_vertices) { live[v] = offsets[v + 1] - offsets[v]; }
+
+  std::vector<uint32_t> entered(num_vertices, 0);
+  std::vector<bool>     emitted(num_triangles, false);
+  std::vector<uint32_t> dead_end, candidates;
+  uint32_t              time   = CACHE_SIZE + 1;
+  size_t                cursor = 0;
+
+  ObjIndices result;
+  result.reserve(num_triangles * 3);
+
+  auto fanning     = skip_dead_end(dead_end, live, cursor);
+  bool new_cluster = true;
+  while (fanning != NO_VERTEX) {
+    if (new_cluster) {
+      clusters.emplace_back(result.size() / 3);
+    }
+
+    // Emit every triangle around the vertex.
+    candidates.clear();
+    for (auto i = offsets[fanning]; i < offsets[fanning + 1]; ++i) {
+      auto const t = adjacency[i];
+      if (emitted[t]) {
+        continue;
+      }
+      FOR(c, 3)
+      {
+        auto const v = indices[3 * t + c];
+        result.emplace_back(v);
+        dead_end.emplace_back(v);
+        candidates.emplace_back(v);
+        --live[v];
+        if ((time - entered[v]) > CACHE_SIZE) {
+          entered[v] = time++;
+        }
+      }
+      emitted[t] = true;
+    }
+
+    // Fan around the candidate that will still be in the cache after it's triangles are emitted,
+    // preferring the one that entered the cache first.
+    auto best          = NO_VERTEX;
+    int  best_priority = -1;
+    for (auto const v : candidates) {
+      if (live[v] == 0) {
+        continue;
+      }
+      int        priority = 0;
+      auto const age      = time - entered[v];
+      if ((age + (2 * live[v])) <= CACHE_SIZE) {
+        priority = static_cast<int>(age);
+      }
+      if (priority > best_priority) {
+        best          = v;
+        best_priority = priority;
+      }
+    }
+
+    new_cluster = best == NO_VERTEX;
+    fanning     = new_cluster ? skip_dead_end(dead_end, live, cursor) : best;
+  }
+  return result;
+}
+
+ObjIndices
+MeshOptimizer::optimize_overdraw(ObjIndices const& indices, ObjVertices const& positions,
+                                 std::vector<uint32_t> const& hard_clusters)
+{
+  auto const num_triangles = indices.size() / 3;
+  auto const clusters      = split_clusters(indices, positions.size() / 3, hard_clusters);
+
+  auto const triangle_normal = [&](size_t const t) {
+    auto const a = vertex_position(positions, indices[3 * t]);
+    auto const b = vertex_position(positions, indices[3 * t + 1]);
+    auto const c = vertex_position(positions, indices[3 * t + 2]);
+    return glm::cross(b - a, c - a);
+  };
+  auto const triangle_center = [&](size_t const t) {
+    auto const a = vertex_position(positions, indices[3 * t]);
+    auto const b = vertex_position(positions, indices[3 * t + 1]);
+    auto const c = vertex_position(positions, indices[3 * t + 2]);
+    return (a + b + c) / 3.0f;
+  };
+
+  // The (area weighted) centers and normals of the clusters, and of the whole mesh.
+  std::vector<glm::vec3> centers(clusters.size()), normals(clusters.size());
+  std::vector<float>     areas(clusters.size(), 0.0f);
+  glm::vec3              mesh_center{0.0f};
+  float                  mesh_area = 0.0f;
+  FOR(c, clusters.size())
+  {
+    size_t const end = (c + 1) < clusters.size() ? clusters[c + 1] : num_triangles;
+    for (size_t t = clusters[c]; t < end; ++t) {
+      auto const  normal = triangle_normal(t);
+      float const area   = glm::length(normal);
+
+      centers[c] += triangle_center(t) * area;
+      normals[c] += normal;
+      areas[c] += area;
+    }
+    mesh_center += centers[c];
+    mesh_area += areas[c];
+  }
+  if (mesh_area > 0.0f) {
+    mesh_center /= mesh_area;
+  }
+
+  // Clusters facing away from the mesh's center are likely to hide the others, draw them first.
+  std::vector<std::pair<float, uint32_t>> order;
+  FOR(c, clusters.size())
+  {
+    float dot = 0.0f;
+    if (areas[c] > 0.0f && glm::length(normals[c]) > 0.0f) {
+      auto const center = centers[c] / areas[c];
+      dot               = glm::dot(center - mesh_center, glm::normalize(normals[c]));
+    }
+    order.emplace_back(-dot, c);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](auto const& a, auto const& b) { return a.first < b.first; });
+
+  ObjIndices result;
+  result.reserve(indices.size());
+  for (auto const& it : order) {
+    auto const   c     = it.second;
+    size_t const begin = clusters[c];
+    size_t const end   = (c + 1) < clusters.size() ? clusters[c + 1] : num_triangles;
+    result.insert(result.end(), indices.cbegin() + (3 * begin), indices.cbegin() + (3 * end));
+  }
+  return result;
+}
+
+std::vector<uint32_t>
+MeshOptimizer::optimize_vertex_fetch(ObjData& obj)
+{
+  std::vector<uint32_t> new_index(num_vertices(obj), NO_VERTEX);
+  std::vector<uint32_t> order;
+  for (auto& i : obj.indices) {
+    if (new_index[i] == NO_VERTEX) {
+      new_index[i] = static_cast<uint32_t>(order.size());
+      order.emplace_back(i);
+    }
+    i = new_index[i];
+  }
+  gather_vertices(obj, order);
+  return order;
+}
+
+MeshOptimizeStats
+MeshOptimizer::optimize(ObjData& obj)
+{
+  MeshOptimizeStats stats;
+  stats.num_vertices_before = num_vertices(obj);
+  stats.acmr_before         = acmr(obj.indices, num_vertices(obj));
+
+  deduplicate_vertices(obj);
+
+  std::vector<uint32_t> clusters;
+  obj.indices = optimize_vertex_cache(obj.indices, num_vertices(obj), clusters);
+  obj.indices = optimize_overdraw(obj.indices, obj.vertices, clusters);
+  optimize_vertex_fetch(obj);
+
+  stats.num_vertices_after = num_vertices(obj);
+  stats.acmr_after         = acmr(obj.indices, num_vertices(obj));
+  return stats;
+}
+
+MeshOptimizeStats
+MeshOptimizer::optimize(MeshLod& lod)
+{
+  auto& obj = lod.data;
+
+  MeshOptimizeStats stats;
+  stats.num_vertices_before = num_vertices(obj);
+  stats.acmr_before         = acmr(obj.indices, num_vertices(obj));
+
+  std::vector<uint32_t> clusters;
+  obj.indices = optimize_vertex_cache(obj.indices, num_vertices(obj), clusters);
+  obj.indices = optimize_overdraw(obj.indices, obj.vertices, clusters);
+
+  auto const order = optimize_vertex_fetch(obj);
+  gather(lod.source_vertices, 1, order);
+
+  stats.num_vertices_after = num_vertices(obj);
+  stats.acmr_after         = acmr(obj.indices, num_vertices(obj));
+  return stats;
+}
+
+} // namespace boomhs
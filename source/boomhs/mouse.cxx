@@ -1,6 +1,5 @@
 #include <boomhs/mouse.hpp>
 #include <common/algorithm.hpp>
-#include <gl_sdl/sdl_window.hpp>
 
 namespace boomhs
 {
@@ -43,10 +42,18 @@ CursorManager::active() const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // MouseState
-glm::ivec2
-MouseState::coords() const
+MouseState::MouseState(glm::ivec2 const& coords, uint32_t const mask)
+    : coords_(coords)
+    , mask_(mask)
 {
-  return gl_sdl::mouse_coords();
+}
+
+MouseState
+MouseState::from_sdl()
+{
+  int        x, y;
+  auto const mask = SDL_GetMouseState(&x, &y);
+  return MouseState{glm::ivec2{x, y}, mask};
 }
 
 } // namespace boomhs
@@ -5,6 +5,9 @@
 #include <boomhs/terrain.hpp>
 
 #include <boomhs/random.hpp>
+#include <common/algorithm.hpp>
+
+#include <cstring>
 
 using namespace boomhs;
 
@@ -87,8 +90,10 @@ NPC::create(EntityRegistry& registry, char const* name, int const level, glm::ve
   transform.translation = pos;
 
   // npc TAG
+  auto const index = name_index(name);
+  assert(index);
   auto& npcdata = registry.assign<NPCData>(eid);
-  npcdata.name  = name;
+  npcdata.name  = NAMES[*index];
 
   auto& hp   = npcdata.health;
   hp.current = 10;
@@ -109,11 +114,23 @@ NPC::create_random(common::Logger& logger, TerrainGrid const& terrain_grid,
     NPC::create(registry, name, level, pos);
   };
   if (rng.gen_bool()) {
-    make_monster("O");
+    make_monster(NAMES[0]);
   }
   else {
-    make_monster("T");
+    make_monster(NAMES[1]);
+  }
+}
+
+std::optional<size_t>
+NPC::name_index(char const* name)
+{
+  FOR(i, NAMES.size())
+  {
+    if (0 == std::strcmp(NAMES[i], name)) {
+      return i;
+    }
   }
+  return std::nullopt;
 }
 
 bool
@@ -2,8 +2,15 @@
 #include <boomhs/obj.hpp>
 
 #include <common/algorithm.hpp>
+#include <common/binary_io.hpp>
+#include <common/phase_timer.hpp>
 
 #include <cassert>
+#include <map>
+#include <sstream>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
 
 using namespace boomhs;
 using namespace opengl;
@@ -11,6 +18,37 @@ using namespace opengl;
 namespace
 {
 
+// Reads the .mtl files an .obj file references into memory before parsing them, so the bytes
+// actually read are recorded into the installed PhaseReport.
+class RecordingMaterialReader : public tinyobj::MaterialReader
+{
+  std::string basedir_;
+
+public:
+  explicit RecordingMaterialReader(char const* basedir)
+      : basedir_(basedir)
+  {
+  }
+
+  bool operator()(std::string const& name, std::vector<tinyobj::material_t>* materials,
+                  std::map<std::string, int>* material_map, std::string* err) override
+  {
+    auto const  path = basedir_ + name;
+    std::string text;
+    if (!common::read_file_text(path, text)) {
+      *err += "Material file '" + path + "' not found.\n";
+      return false;
+    }
+    common::record_bytes_read(text.size());
+
+    std::istringstream stream{MOVE(text)};
+    std::string        warning;
+    tinyobj::LoadMtl(material_map, materials, &stream, &warning);
+    *err += warning;
+    return true;
+  }
+};
+
 LoadStatus
 load_positions(tinyobj::index_t const& index, tinyobj::attrib_t const& attrib,
                std::vector<float>* pvertices)
@@ -203,6 +241,14 @@ load_objfile(common::Logger& logger, char const* objpath, char const* mtlpath)
                     mtlpath == nullptr ? "nullptr" : mtlpath);
   assert(mtlpath);
 
+  // Read the whole file before parsing it, so the bytes actually read are recorded.
+  std::string objtext;
+  if (!common::read_file_text(objpath, objtext)) {
+    LOG_ERROR_SPRINTF("error loading obj, can't read '%s'", objpath);
+    std::abort();
+  }
+  common::record_bytes_read(objtext.size());
+
   tinyobj::attrib_t attrib;
   std::string       err;
 
@@ -210,7 +256,10 @@ load_objfile(common::Logger& logger, char const* objpath, char const* mtlpath)
   auto&   materials = objdata.materials;
   auto&   shapes    = objdata.shapes;
 
-  bool const load_success = tinyobj::LoadObj(&attrib, &shapes, &materials, &err, objpath, mtlpath);
+  std::istringstream      objstream{MOVE(objtext)};
+  RecordingMaterialReader mtl_reader{mtlpath};
+  bool const              load_success =
+      tinyobj::LoadObj(&attrib, &shapes, &materials, &err, &objstream, &mtl_reader);
   if (!load_success) {
     LOG_ERROR_SPRINTF("error loading obj, msg: %s", err);
     std::abort();
@@ -274,6 +323,7 @@ load_objfile(common::Logger& logger, char const* objpath, char const* mtlpath)
       LOAD_ATTR(load_normals(index, attrib, &objdata.normals));
       LOAD_ATTR(load_uvs(index, attrib, &objdata.uvs));
       LOAD_ATTR(load_colors(face_color, &objdata.colors));
+      objdata.material_ids.emplace_back(shape.mesh.material_ids[face]);
 
 #undef LOAD_ATTR
       indices.push_back(indices.size()); // 0, 1, 2, ...
@@ -5,67 +5,89 @@
 #include <extlibs/fmt.hpp>
 #include <iomanip>
 
-using namespace opengl;
-
 namespace boomhs
 {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// ObjQuery
-bool
-operator==(ObjQuery const& a, ObjQuery const& b)
-{
-  // clang-format off
-  return common::and_all(
-      a.name == b.name,
-      a.flags == b.flags);
-  // clang-format on
-}
-
-bool
-operator!=(ObjQuery const& a, ObjQuery const& b)
-{
-  return !(a == b);
-}
-
-std::ostream&
-operator<<(std::ostream& stream, ObjQuery const& query)
+// ObjStore
+void
+ObjStore::add_obj(std::string const& name, ObjData&& o) const
 {
-  stream << "{name: '";
-  stream << std::setw(10) << query.name;
-  stream << "', flags: '";
-  stream << query.flags;
-  stream << "'}";
-  return stream;
+  data_.emplace_back(Entry{name, MOVE(o), {}});
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// ObjStore
 void
-ObjStore::add_obj(std::string const& name, ObjData&& o) const
+ObjStore::add_lods(std::string const& name, std::vector<MeshLod>&& lods) const
 {
-  auto pair = std::make_pair(name, MOVE(o));
-  data_.emplace_back(MOVE(pair));
+  auto const cmp = [&](auto const& entry) { return entry.name == name; };
+  auto const it  = std::find_if(data_.begin(), data_.end(), cmp);
+  assert(it != data_.end());
+  it->lods = MOVE(lods);
 }
 
-#define OBJSTORE_FIND(BEGIN, END)                                                                  \
-  auto const cmp = [&](auto const& pair) { return pair.first == name; };                           \
+#define OBJSTORE_FIND_ENTRY(BEGIN, END)                                                            \
+  auto const cmp = [&](auto const& entry) { return entry.name == name; };                          \
   auto const it  = std::find_if(BEGIN, END, cmp);                                                  \
-  assert(it != END);                                                                               \
-  return it->second;
+  assert(it != END);
 
 ObjData&
 ObjStore::get(common::Logger& logger, std::string const& name)
 {
-  OBJSTORE_FIND(data_.begin(), data_.end());
+  OBJSTORE_FIND_ENTRY(data_.begin(), data_.end());
+  return it->obj;
 }
 
 ObjData const&
 ObjStore::get(common::Logger& logger, std::string const& name) const
 {
-  OBJSTORE_FIND(data_.cbegin(), data_.cend());
+  OBJSTORE_FIND_ENTRY(data_.cbegin(), data_.cend());
+  return it->obj;
 }
 
-#undef OBJSTORE_FIND
+size_t
+ObjStore::num_lods(std::string const& name) const
+{
+  OBJSTORE_FIND_ENTRY(data_.cbegin(), data_.cend());
+  return it->lods.size() + 1;
+}
+
+#define OBJSTORE_GET_LOD                                                                           \
+  OBJSTORE_FIND_ENTRY(data_.begin(), data_.end());                                                 \
+  assert(lod >= 1 && lod <= it->lods.size());                                                      \
+  return it->lods[lod - 1];
+
+MeshLod&
+ObjStore::get_lod(common::Logger& logger, std::string const& name, size_t const lod)
+{
+  OBJSTORE_GET_LOD
+}
+
+MeshLod const&
+ObjStore::get_lod(common::Logger& logger, std::string const& name, size_t const lod) const
+{
+  OBJSTORE_GET_LOD
+}
+
+#undef OBJSTORE_GET_LOD
+#undef OBJSTORE_FIND_ENTRY
+
+size_t
+ObjStore::num_bytes() const
+{
+  auto const obj_bytes = [](ObjData const& obj) {
+    return (sizeof(float) * (obj.vertices.size() + obj.colors.size() + obj.normals.size() +
+                             obj.uvs.size())) +
+           (sizeof(uint32_t) * obj.indices.size());
+  };
+
+  size_t bytes = 0;
+  for (auto const& entry : data_) {
+    bytes += obj_bytes(entry.obj);
+    for (auto const& lod : entry.lods) {
+      bytes += obj_bytes(lod.data);
+    }
+  }
+  return bytes;
+}
 
 } // namespace boomhs
@@ -0,0 +1,401 @@
+#include <boomhs/components.hpp>
+#include <boomhs/math.hpp>
+#include <boomhs/occlusion.hpp>
+#include <boomhs/terrain.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace boomhs;
+
+namespace
+{
+
+auto constexpr WIDTH  = OcclusionBuffer::WIDTH;
+auto constexpr HEIGHT = OcclusionBuffer::HEIGHT;
+
+// Points with a clip space w below this are treated as behind the camera.
+float constexpr MIN_W = 1e-4f;
+
+// The corners of a box, bit 0 of the index selects max.x, bit 1 max.y and bit 2 max.z.
+using BoxCorners = std::array<glm::vec3, 8>;
+
+// The two triangles of each of the box's faces.
+std::array<std::array<uint8_t, 3>, 12> constexpr BOX_TRIANGLES = {{
+    {{0, 1, 3}}, {{0, 3, 2}}, // -z
+    {{4, 5, 7}}, {{4, 7, 6}}, // +z
+    {{0, 2, 6}}, {{0, 6, 4}}, // -x
+    {{1, 3, 7}}, {{1, 7, 5}}, // +x
+    {{0, 1, 5}}, {{0, 5, 4}}, // -y
+    {{2, 3, 7}}, {{2, 7, 6}}  // +y
+}};
+
+// A vertex projected into the depth buffer, x and y in pixels, z the depth in [0, 1].
+struct ScreenVertex
+{
+  float x, y, z;
+};
+
+// An edge function, E(x, y) = c + dx * x + dy * y. Positive on the inner side of the edge.
+struct Edge
+{
+  float dx, dy, c;
+
+  Edge(ScreenVertex const& a, ScreenVertex const& b)
+      : dx(a.y - b.y)
+      , dy(b.x - a.x)
+      , c((a.x * b.y) - (a.y * b.x))
+  {
+  }
+
+  float at(float const x, float const y) const { return c + (dx * x) + (dy * y); }
+};
+
+int
+level_width(size_t const level)
+{
+  return WIDTH >> level;
+}
+
+int
+level_height(size_t const level)
+{
+  return HEIGHT >> level;
+}
+
+// Returns false when the point isn't in front of the near plane.
+bool
+project(glm::mat4 const& mvp, glm::vec3 const& p, ScreenVertex& out)
+{
+  auto const clip = mvp * glm::vec4{p, 1.0f};
+  if (clip.w < MIN_W || clip.z < -clip.w) {
+    return false;
+  }
+  auto const ndc = glm::vec3{clip} / clip.w;
+  out.x          = ((ndc.x * 0.5f) + 0.5f) * WIDTH;
+  out.y          = ((ndc.y * 0.5f) + 0.5f) * HEIGHT;
+  out.z          = (ndc.z * 0.5f) + 0.5f;
+  return true;
+}
+
+BoxCorners
+box_corners(Cube const& cube)
+{
+  BoxCorners corners;
+  FOR(i, corners.size())
+  {
+    corners[i] = glm::vec3{(i & 1) ? cube.max.x : cube.min.x, (i & 2) ? cube.max.y : cube.min.y,
+                           (i & 4) ? cube.max.z : cube.min.z};
+  }
+  return corners;
+}
+
+// The pixels (with their centers) inside [min, max], clamped to the buffer. Clamping before
+// converting to int keeps points projected close to the camera from overflowing.
+int
+first_pixel(float const min, int const size)
+{
+  return static_cast<int>(std::ceil(glm::clamp(min - 0.5f, 0.0f, static_cast<float>(size))));
+}
+
+int
+last_pixel(float const max, int const size)
+{
+  auto const last = static_cast<float>(size - 1);
+  return static_cast<int>(std::floor(glm::clamp(max - 0.5f, -1.0f, last)));
+}
+
+// Write the triangle's depth into the texels it covers completely, keeping the nearest depth.
+//
+// Occluders must never cover more than they do, so texels the triangle only partly covers are left
+// alone, and the depth written is the farthest depth of the triangle's plane over the texel.
+void
+rasterize(std::vector<float>& buffer, ScreenVertex const& a, ScreenVertex b, ScreenVertex c)
+{
+  float area = ((b.x - a.x) * (c.y - a.y)) - ((b.y - a.y) * (c.x - a.x));
+  if (std::abs(area) < std::numeric_limits<float>::epsilon()) {
+    return;
+  }
+  // Occluders are seen from both sides, flip clockwise triangles around.
+  if (area < 0.0f) {
+    std::swap(b, c);
+    area = -area;
+  }
+
+  int const x0 = first_pixel(std::min({a.x, b.x, c.x}), WIDTH);
+  int const x1 = last_pixel(std::max({a.x, b.x, c.x}), WIDTH);
+  int const y0 = first_pixel(std::min({a.y, b.y, c.y}), HEIGHT);
+  int const y1 = last_pixel(std::max({a.y, b.y, c.y}), HEIGHT);
+  if (x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  // Each edge function is the (scaled) barycentric weight of the vertex opposite the edge, so the
+  // depth is a plane over the screen too.
+  Edge const  e0{b, c}, e1{c, a}, e2{a, b};
+  float const inv_area = 1.0f / area;
+  float const zdx      = ((e0.dx * a.z) + (e1.dx * b.z) + (e2.dx * c.z)) * inv_area;
+  float const zdy      = ((e0.dy * a.z) + (e1.dy * b.z) + (e2.dy * c.z)) * inv_area;
+  float const zc       = ((e0.c * a.z) + (e1.c * b.z) + (e2.c * c.z)) * inv_area;
+
+  // The texel is inside the edge when it's corner farthest outside the edge is, the edge function
+  // is that far below it's value at the texel's center. The same goes for the depth.
+  auto const corner = [](float const dx, float const dy) {
+    return (std::abs(dx) + std::abs(dy)) * 0.5f;
+  };
+  float const e0_corner = corner(e0.dx, e0.dy), e1_corner = corner(e1.dx, e1.dy);
+  float const e2_corner = corner(e2.dx, e2.dy), z_corner = corner(zdx, zdy);
+
+  for (int y = y0; y <= y1; ++y) {
+    float const py  = y + 0.5f;
+    float*      row = buffer.data() + (y * WIDTH);
+
+    // No branches within the row, so the compiler can vectorize it.
+    for (int x = x0; x <= x1; ++x) {
+      float const px     = x + 0.5f;
+      bool const  inside = (e0.at(px, py) >= e0_corner) & (e1.at(px, py) >= e1_corner) &
+                          (e2.at(px, py) >= e2_corner);
+      float const z = zc + (zdx * px) + (zdy * py) + z_corner;
+      row[x]        = (inside & (z < row[x])) ? z : row[x];
+    }
+  }
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// OcclusionBuffer
+OcclusionBuffer::OcclusionBuffer()
+    : camera_matrix_(1.0f)
+{
+  FOR(level, NUM_LEVELS)
+  {
+    levels_[level].resize(level_width(level) * level_height(level), 1.0f);
+  }
+  static_assert((HEIGHT >> (NUM_LEVELS - 1)) >= 1, "Too many levels for the buffer's height");
+}
+
+void
+OcclusionBuffer::begin(glm::mat4 const& camera_matrix)
+{
+  camera_matrix_ = camera_matrix;
+  ready_         = false;
+  stats_         = Stats{};
+
+  auto& depths = levels_[0];
+  std::fill(depths.begin(), depths.end(), 1.0f);
+}
+
+void
+OcclusionBuffer::add_triangle(glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c)
+{
+  ScreenVertex sa, sb, sc;
+  if (!project(camera_matrix_, a, sa) || !project(camera_matrix_, b, sb) ||
+      !project(camera_matrix_, c, sc)) {
+    // Leaving out part of an occluder only makes it cover less.
+    return;
+  }
+  rasterize(levels_[0], sa, sb, sc);
+  ++stats_.num_triangles;
+}
+
+void
+OcclusionBuffer::add_box(glm::mat4 const& model, Cube const& cube)
+{
+  auto corners = box_corners(cube);
+  for (auto& corner : corners) {
+    corner = glm::vec3{model * glm::vec4{corner, 1.0f}};
+  }
+  for (auto const& tri : BOX_TRIANGLES) {
+    add_triangle(corners[tri[0]], corners[tri[1]], corners[tri[2]]);
+  }
+}
+
+void
+OcclusionBuffer::add_terrain(TerrainGrid const& tgrid)
+{
+  auto const& dimensions = tgrid.config.dimensions;
+  for (auto const& terrain : tgrid) {
+    auto const& config = terrain.config;
+    auto const& hmap   = terrain.heightmap;
+    auto const  numv   = config.num_vertexes_along_one_side;
+    if (numv < 2) {
+      continue;
+    }
+    auto const cells = std::min(TERRAIN_CELLS, numv - 1);
+
+    // The heightmap vertex each grid line starts at.
+    auto const grid_vertex = [&](size_t const i) { return (i * (numv - 1)) / cells; };
+
+    // The lowest heightmap value within each cell.
+    std::array<uint8_t, TERRAIN_CELLS * TERRAIN_CELLS> cell_min;
+    FOR(cz, cells)
+    {
+      FOR(cx, cells)
+      {
+        uint8_t lowest = std::numeric_limits<uint8_t>::max();
+        for (auto z = grid_vertex(cz); z <= grid_vertex(cz + 1); ++z) {
+          for (auto x = grid_vertex(cx); x <= grid_vertex(cx + 1); ++x) {
+            lowest = std::min(lowest, hmap.data(x, z));
+          }
+        }
+        cell_min[(cz * cells) + cx] = lowest;
+      }
+    }
+
+    // Each grid vertex takes the lowest value of the cells around it, so the cells' triangles
+    // stay below the real terrain.
+    std::array<glm::vec3, (TERRAIN_CELLS + 1) * (TERRAIN_CELLS + 1)> vertices;
+    auto const& pos = terrain.position();
+    auto const  origin = glm::vec2{pos.x * dimensions.x, pos.y * dimensions.y};
+    FOR(vz, cells + 1)
+    {
+      FOR(vx, cells + 1)
+      {
+        // The cells touching the vertex.
+        size_t const cz0 = (vz > 0) ? (vz - 1) : 0, cz1 = std::min<size_t>(vz + 1, cells);
+        size_t const cx0 = (vx > 0) ? (vx - 1) : 0, cx1 = std::min<size_t>(vx + 1, cells);
+
+        uint8_t lowest = std::numeric_limits<uint8_t>::max();
+        for (auto cz = cz0; cz < cz1; ++cz) {
+          for (auto cx = cx0; cx < cx1; ++cx) {
+            lowest = std::min(lowest, cell_min[(cz * cells) + cx]);
+          }
+        }
+        float const height = (lowest / 255.0f) * config.height_multiplier;
+
+        float const x = origin.x + ((grid_vertex(vx) / float(numv - 1)) * dimensions.x);
+        float const z = origin.y + ((grid_vertex(vz) / float(numv - 1)) * dimensions.y);
+        vertices[(vz * (cells + 1)) + vx] = glm::vec3{x, height, z};
+      }
+    }
+
+    FOR(cz, cells)
+    {
+      FOR(cx, cells)
+      {
+        auto const  row = cells + 1;
+        auto const& v00 = vertices[(cz * row) + cx];
+        auto const& v10 = vertices[(cz * row) + cx + 1];
+        auto const& v01 = vertices[((cz + 1) * row) + cx];
+        auto const& v11 = vertices[((cz + 1) * row) + cx + 1];
+        add_triangle(v00, v10, v11);
+        add_triangle(v00, v11, v01);
+      }
+    }
+  }
+}
+
+void
+OcclusionBuffer::add_entities(EntityRegistry& registry)
+{
+  for (auto const eid : registry.view<Occluder, WorldMatrix>()) {
+    if (registry.has<IsRenderable>(eid) && registry.get<IsRenderable>(eid).hidden) {
+      continue;
+    }
+    add_box(registry.get<WorldMatrix>(eid).value, registry.get<Occluder>(eid).box);
+  }
+}
+
+void
+OcclusionBuffer::finish()
+{
+  build_hiz();
+  ready_ = true;
+}
+
+void
+OcclusionBuffer::build_hiz()
+{
+  for (size_t level = 1; level < NUM_LEVELS; ++level) {
+    auto const& below   = levels_[level - 1];
+    auto&       current = levels_[level];
+
+    auto const w = level_width(level), h = level_height(level);
+    auto const below_w = level_width(level - 1);
+    FORI(y, h)
+    {
+      float const* row0 = below.data() + ((2 * y) * below_w);
+      float const* row1 = row0 + below_w;
+      FORI(x, w)
+      {
+        auto const x2        = 2 * x;
+        current[(y * w) + x] = std::max({row0[x2], row0[x2 + 1], row1[x2], row1[x2 + 1]});
+      }
+    }
+  }
+}
+
+void
+OcclusionBuffer::clear()
+{
+  ready_ = false;
+  stats_ = Stats{};
+}
+
+bool
+OcclusionBuffer::visible(glm::mat4 const& camera_matrix, glm::mat4 const& model, Cube const& cube)
+{
+  if (!ready_ || camera_matrix != camera_matrix_) {
+    return true;
+  }
+  ++stats_.num_tested;
+
+  // The box's rectangle on screen, and the depth of it's nearest point.
+  auto const mvp     = camera_matrix * model;
+  float      min_x   = std::numeric_limits<float>::max(), min_y = min_x, nearest = min_x;
+  float      max_x   = std::numeric_limits<float>::lowest(), max_y = max_x;
+  for (auto const& corner : box_corners(cube)) {
+    ScreenVertex sv;
+    if (!project(mvp, corner, sv)) {
+      // The box reaches past the near plane, it can't be hidden behind anything.
+      return true;
+    }
+    min_x   = std::min(min_x, sv.x);
+    max_x   = std::max(max_x, sv.x);
+    min_y   = std::min(min_y, sv.y);
+    max_y   = std::max(max_y, sv.y);
+    nearest = std::min(nearest, sv.z);
+  }
+
+  // Every pixel the rectangle touches, not only the pixels whose centers it covers.
+  int const x0 = static_cast<int>(std::floor(glm::clamp(min_x, 0.0f, float(WIDTH - 1))));
+  int const x1 = static_cast<int>(std::floor(glm::clamp(max_x, 0.0f, float(WIDTH - 1))));
+  int const y0 = static_cast<int>(std::floor(glm::clamp(min_y, 0.0f, float(HEIGHT - 1))));
+  int const y1 = static_cast<int>(std::floor(glm::clamp(max_y, 0.0f, float(HEIGHT - 1))));
+
+  // The level where the rectangle covers at most 2x2 texels.
+  size_t level = 0;
+  while ((level + 1) < NUM_LEVELS &&
+         (((x1 >> level) - (x0 >> level)) > 1 || ((y1 >> level) - (y0 >> level)) > 1)) {
+    ++level;
+  }
+
+  for (int y = (y0 >> level); y <= (y1 >> level); ++y) {
+    for (int x = (x0 >> level); x <= (x1 >> level); ++x) {
+      if (nearest <= depth(level, x, y)) {
+        return true;
+      }
+    }
+  }
+  ++stats_.num_culled;
+  return false;
+}
+
+float
+OcclusionBuffer::depth(size_t const level, int const x, int const y) const
+{
+  assert(level < NUM_LEVELS);
+  assert(x >= 0 && x < level_width(level) && y >= 0 && y < level_height(level));
+  return levels_[level][(y * level_width(level)) + x];
+}
+
+} // namespace boomhs
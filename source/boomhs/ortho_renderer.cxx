@@ -17,6 +17,7 @@
 #include <boomhs/math.hpp>
 #include <boomhs/random.hpp>
 #include <common/log.hpp>
+#include <common/profiler.hpp>
 
 #include <cassert>
 #include <extlibs/imgui.hpp>
@@ -145,6 +146,7 @@ void
 OrthoRenderer::draw_scene(GameState& gs, RenderState& rstate, LevelManager& lm, DrawState& ds,
                           Camera& camera, RNG& rng, StaticRenderers& srs, FrameTime const& ft)
 {
+  PROFILE_ZONE("draw_scene_ortho");
   auto& fs = rstate.fs;
   auto& es = fs.es;
 
@@ -37,6 +37,7 @@
 #include <boomhs/math.hpp>
 #include <boomhs/random.hpp>
 #include <common/log.hpp>
+#include <common/profiler.hpp>
 #include <common/result.hpp>
 
 #include <extlibs/fastnoise.hpp>
@@ -63,11 +64,63 @@ namespace
 namespace boomhs
 {
 
+void
+PerspectiveRenderer::prepare(FrameState const& fs, LevelManager& lm, Camera const& camera)
+{
+  PROFILE_ZONE("prepare_scene");
+  auto& es        = fs.es;
+  auto& zs        = lm.active();
+  auto& gfx_state = zs.gfx_state;
+
+  bool const draw_water             = es.ui_state.debug.buffers.water.draw;
+  bool const graphics_mode_advanced = GameGraphicsMode::Advanced == es.graphics_settings.mode;
+  bool const draw_water_advanced    = draw_water && graphics_mode_advanced;
+
+  {
+    // Rasterize the occluders once, every pass drawn from the camera is tested against them.
+    PROFILE_ZONE("occlusion");
+    auto& occlusion = gfx_state.occlusion;
+    if (es.occlusion_culling) {
+      occlusion.begin(fs.camera_matrix());
+      if (es.draw_terrain) {
+        occlusion.add_terrain(zs.level_data.terrain);
+      }
+      occlusion.add_entities(zs.registry);
+      occlusion.finish();
+    }
+    else {
+      occlusion.clear();
+    }
+  }
+
+  {
+    // Cull the entities once for every camera the frame is drawn from, each pass then draws only
+    // it's visible set.
+    PROFILE_ZONE("visibility");
+    auto& visibility = gfx_state.visibility;
+    visibility.begin();
+
+    visibility.add_pass(VisibilityPass::Camera, fs.view_matrix(), fs.projection_matrix());
+    if (draw_water_advanced) {
+      // The reflection camera follows the player's camera, it's computed now with the rest of the
+      // frame's state.
+      auto const rfs = AdvancedWaterRenderer::reflection_framestate(es, zs, camera);
+      visibility.add_pass(VisibilityPass::Reflection, rfs.view_matrix(), rfs.projection_matrix());
+
+      auto& reflection    = gfx_state.snapshot.reflection;
+      reflection.position = rfs.camera_world_position();
+      reflection.matrices = CameraMatrices{rfs.projection_matrix(), rfs.view_matrix()};
+    }
+    visibility.build(zs.registry, gfx_state.occlusion, es.mesh_lods);
+  }
+}
+
 void
 PerspectiveRenderer::draw_scene(RenderState& rstate, LevelManager& lm, DrawState& ds,
                                 Camera& camera, RNG& rng, StaticRenderers& static_renderers,
                                 FrameTime const& ft)
 {
+  PROFILE_ZONE("draw_scene");
   auto&       es                     = rstate.fs.es;
   auto&       logger                 = es.logger;
   auto const& graphics_settings      = es.graphics_settings;
@@ -79,17 +132,34 @@ PerspectiveRenderer::draw_scene(RenderState& rstate, LevelManager& lm, DrawState
 
   auto& skybox_renderer = static_renderers.skybox;
 
+  // The camera, fog and lighting every program reads, uploaded once for the pass.
+  auto& uniform_blocks = lm.active().gfx_state.uniform_blocks;
+  uniform_blocks.update(rstate.fs);
+
+  // Culled by prepare().
+  rstate.visible = lm.active().gfx_state.visibility.find(VisibilityPass::Camera);
+  ON_SCOPE_EXIT([&]() { rstate.visible = nullptr; });
+
   auto const draw_scene = [&](bool const silhouette_black) {
     auto&      water_renderer = static_renderers.water;
     auto const draw_advanced  = [&](auto& terrain_renderer, auto& entity_renderer) {
-      water_renderer.advanced.render_reflection(es, ds, lm, camera, entity_renderer,
-                                                skybox_renderer, terrain_renderer, rng, ft);
-      water_renderer.advanced.render_refraction(es, ds, lm, camera, entity_renderer,
-                                                skybox_renderer, terrain_renderer, rng, ft);
+      {
+        PROFILE_ZONE("water_reflection");
+        water_renderer.advanced.render_reflection(rstate.fs, ds, lm, entity_renderer,
+                                                  skybox_renderer, terrain_renderer, rng, ft);
+      }
+      {
+        PROFILE_ZONE("water_refraction");
+        water_renderer.advanced.render_refraction(rstate.fs, ds, lm, entity_renderer,
+                                                  skybox_renderer, terrain_renderer, rng, ft);
+      }
     };
     if (draw_water && draw_water_advanced && !silhouette_black) {
       // Render the scene to the refraction and reflection FBOs
       draw_advanced(static_renderers.default_terrain, static_renderers.default_entity);
+
+      // The FBO passes uploaded their own cameras.
+      uniform_blocks.update(rstate.fs);
     }
 
     auto const& zs          = lm.active();
@@ -100,6 +170,7 @@ PerspectiveRenderer::draw_scene(RenderState& rstate, LevelManager& lm, DrawState
     // render scene
     if (es.draw_skybox) {
       if (!silhouette_black) {
+        PROFILE_ZONE("skybox");
         skybox_renderer.render(rstate, ds, ft);
       }
     }
@@ -107,6 +178,7 @@ PerspectiveRenderer::draw_scene(RenderState& rstate, LevelManager& lm, DrawState
     // The water must be drawn BEFORE rendering the scene the last time, otherwise it shows up
     // ontop of the ingame UI nearby target indicators.
     if (draw_water) {
+      PROFILE_ZONE("water");
       water_renderer.render(rstate, ds, lm, camera, ft, silhouette_black);
     }
 
@@ -118,13 +190,17 @@ PerspectiveRenderer::draw_scene(RenderState& rstate, LevelManager& lm, DrawState
   auto const render_scene_with_sunshafts = [&]() {
     // draw scene with black silhouttes into the sunshaft FBO.
     auto& sunshaft_renderer = static_renderers.sunshaft;
-    sunshaft_renderer.with_sunshaft_fbo(logger, [&]() { draw_scene(true); });
+    {
+      PROFILE_ZONE("sunshaft_silhouettes");
+      sunshaft_renderer.with_sunshaft_fbo(logger, [&]() { draw_scene(true); });
+    }
 
     // draw the scene (normal render) to the screen
     draw_scene_normal_render();
 
     // With additive blending enabled, render the FBO ontop of the previously rendered scene to
     // obtain the sunglare effect.
+    PROFILE_ZONE("sunshaft");
     ENABLE_ADDITIVE_BLENDING_UNTIL_SCOPE_EXIT();
     sunshaft_renderer.render(rstate, ds, lm, camera, ft);
   };
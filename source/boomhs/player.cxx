@@ -1,33 +1,29 @@
 #include <boomhs/bounding_object.hpp>
 #include <boomhs/components.hpp>
-#include <boomhs/engine.hpp>
 #include <boomhs/entity.hpp>
 #include <boomhs/frame_time.hpp>
 #include <boomhs/inventory.hpp>
 #include <boomhs/item.hpp>
 #include <boomhs/item_factory.hpp>
-#include <boomhs/leveldata.hpp>
 #include <boomhs/math.hpp>
 #include <boomhs/nearby_targets.hpp>
 #include <boomhs/npc.hpp>
 #include <boomhs/player.hpp>
+#include <boomhs/simulation.hpp>
 #include <boomhs/terrain.hpp>
-#include <boomhs/zone_state.hpp>
 #include <optional>
 
 using namespace boomhs;
 using namespace boomhs::math;
 using namespace boomhs::math::constants;
 using namespace common;
-using namespace opengl;
-using namespace gl_sdl;
 
 namespace
 {
 
 void
-kill_entity(common::Logger& logger, TerrainGrid& terrain, TextureTable& ttable,
-            EntityRegistry& registry, EntityID const entity_eid)
+kill_entity(common::Logger& logger, TerrainGrid& terrain, EntityRegistry& registry,
+            EntityID const entity_eid)
 {
   auto const& bbox = registry.get<AABoundingBox>(entity_eid).cube;
   auto const  hw   = bbox.half_widths();
@@ -44,8 +40,8 @@ kill_entity(common::Logger& logger, TerrainGrid& terrain, TextureTable& ttable,
 }
 
 void
-try_attack_selected_target(common::Logger& logger, TerrainGrid& terrain, TextureTable& ttable,
-                           EntityRegistry& registry, Player& player, EntityID const target_eid)
+try_attack_selected_target(common::Logger& logger, TerrainGrid& terrain, EntityRegistry& registry,
+                           Player& player, EntityID const target_eid)
 {
   auto&      ptransform = player.transform();
   auto const playerpos  = ptransform.translation;
@@ -73,10 +69,9 @@ try_attack_selected_target(common::Logger& logger, TerrainGrid& terrain, Texture
 }
 
 void
-move_worldobject(EngineState& es, WorldObject& wo, glm::vec3 const& move_vec, float const speed,
-                 TerrainGrid const& terrain, FrameTime const& ft)
+move_worldobject(SimulationInput const& input, WorldObject& wo, glm::vec3 const& move_vec,
+                 float const speed, TerrainGrid const& terrain, FrameTime const& ft)
 {
-  auto&      logger  = es.logger;
   auto const max_pos = terrain.max_worldpositions();
   auto const max_x   = max_pos.x;
   auto const max_z   = max_pos.y;
@@ -85,7 +80,7 @@ move_worldobject(EngineState& es, WorldObject& wo, glm::vec3 const& move_vec, fl
   glm::vec3 const newpos = wo.world_position() + delta;
 
   auto const out_of_bounds = terrain.out_of_bounds(newpos.x, newpos.z);
-  if (out_of_bounds && !es.mariolike_edges) {
+  if (out_of_bounds && !input.mariolike_edges) {
     // If the world object *would* be out of bounds, return early (don't move the WO).
     return;
   }
@@ -110,11 +105,10 @@ move_worldobject(EngineState& es, WorldObject& wo, glm::vec3 const& move_vec, fl
 }
 
 void
-update_position(EngineState& es, LevelData& ldata, Player& player, FrameTime const& ft)
+update_position(common::Logger& logger, TerrainGrid& terrain, SimulationInput const& input,
+                Player& player, FrameTime const& ft)
 {
-  auto&       logger   = es.logger;
-  auto&       terrain  = ldata.terrain;
-  auto const& movement = es.movement_state;
+  auto const& movement = input.movement;
 
   // Move the player forward along it's movement direction
   auto move_dir = movement.forward + movement.backward + movement.left + movement.right +
@@ -125,7 +119,7 @@ update_position(EngineState& es, LevelData& ldata, Player& player, FrameTime con
   }
 
   auto& wo = player.world_object();
-  move_worldobject(es, wo, move_dir, player.speed, terrain, ft);
+  move_worldobject(input, wo, move_dir, player.speed, terrain, ft);
 
   // Lookup the player height from the terrain at the player's X, Z world-coordinates.
   auto&       player_pos    = player.transform().translation;
@@ -157,17 +151,19 @@ PlayerHead::update(FrameTime const& ft)
   auto const& head_bbox   = registry_->get<AABoundingBox>(eid_).cube;
 
   auto const& player_tr = registry_->get<Transform>(player_eid);
-  auto&       head_tr   = registry_->get<Transform>(eid_);
+  auto const& head_tr   = registry_->get<Transform>(eid_);
 
   auto const player_half_height = player_bbox.scaled_half_widths(player_tr).y;
   auto const head_half_height   = head_bbox.scaled_half_widths(head_tr).y;
 
-  head_tr.translation = player_tr.translation;
-  head_tr.translation.y += (player_half_height - head_half_height);
+  // Keep the head sitting on top of the player's body, the TransformSystem moves it along with the
+  // player.
+  auto& local       = registry_->get<Parent>(eid_).local;
+  local.translation = glm::vec3{0.0f, player_half_height - head_half_height, 0.0f};
 }
 
 PlayerHead
-PlayerHead::create(common::Logger& logger, EntityRegistry& registry, ShaderPrograms& sps,
+PlayerHead::create(common::Logger& logger, EntityRegistry& registry,
                    WorldOrientation const& world_orientation)
 {
   // construct the head
@@ -175,12 +171,13 @@ PlayerHead::create(common::Logger& logger, EntityRegistry& registry, ShaderProgr
   registry.assign<IsRenderable>(eid);
   registry.assign<Name>(eid, "PlayerHead");
 
-  auto& bbox = AABoundingBox::add_to_entity(logger, sps, eid, registry, -ONE, ONE);
+  AABoundingBox::add_to_entity(eid, registry, -ONE, ONE);
 
-  // The head follows the Player
-  auto const player_eid = find_player_eid(registry);
-  auto&      ft         = registry.assign<FollowTransform>(eid, player_eid);
-  auto&      player     = find_player(registry).world_object();
+  // The head follows the Player, but keeps it's own orientation and scale.
+  auto const player_eid   = find_player_eid(registry);
+  auto&      parent       = registry.assign<Parent>(eid, player_eid);
+  parent.inherit_rotation = false;
+  parent.inherit_scale    = false;
 
   PlayerHead ph{registry, eid, world_orientation};
   auto&      tr = ph.world_object.transform();
@@ -193,12 +190,12 @@ static auto const HOW_OFTEN_GCD_RESETS_MS = TimeConversions::seconds_to_millis(1
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Player
-Player::Player(common::Logger& logger, EntityID const eid, EntityRegistry& r, ShaderPrograms& sps,
+Player::Player(common::Logger& logger, EntityID const eid, EntityRegistry& r,
                WorldOrientation const& world_orientation)
     : eid_(eid)
     , registry_(&r)
     , wo_(eid, r, world_orientation)
-    , head_(PlayerHead::create(logger, *registry_, sps, world_orientation))
+    , head_(PlayerHead::create(logger, *registry_, world_orientation))
 {
 }
 
@@ -214,6 +211,14 @@ Player::pickup_entity(EntityID const eid, EntityRegistry& registry)
 
   registry.get<IsRenderable>(eid).hidden = true;
 
+  // Carried items follow the player around (a torch lights the way from above the player's head).
+  auto& parent            = registry.assign<Parent>(eid, eid_);
+  parent.inherit_rotation = false;
+  parent.inherit_scale    = false;
+  if (registry.has<Torch>(eid)) {
+    parent.local.translation.y = 1.0f;
+  }
+
   // Add ourselves to this list of the item's previous owners.
   item.add_owner(this->name);
 }
@@ -228,6 +233,7 @@ Player::drop_entity(common::Logger& logger, EntityID const eid, EntityRegistry&
   item.is_pickedup = false;
 
   registry.get<IsRenderable>(eid).hidden = false;
+  registry.remove<Parent>(eid);
 
   // Move the dropped item to the player's position
   auto const& player_pos = player.world_object().world_position();
@@ -243,18 +249,15 @@ Player::drop_entity(common::Logger& logger, EntityID const eid, EntityRegistry&
 }
 
 void
-Player::update(EngineState& es, ZoneState& zs, FrameTime const& ft)
+Player::update(common::Logger& logger, SimulationZone& zone, SimulationInput const& input,
+               FrameTime const& ft)
 {
-  auto& logger   = es.logger;
-  auto& registry = zs.registry;
-  auto& ldata    = zs.level_data;
-  auto& terrain  = ldata.terrain;
-  auto& nbt      = ldata.nearby_targets;
-
-  auto& ttable = zs.gfx_state.texture_table;
+  auto& registry = zone.registry;
+  auto& terrain  = zone.terrain;
+  auto& nbt      = zone.nearby_targets;
 
   gcd_.update();
-  update_position(es, ldata, *this, ft);
+  update_position(logger, terrain, input, *this, ft);
   head_.update(ft);
 
   // If no target is selected, no more work to do.
@@ -290,13 +293,13 @@ Player::update(EngineState& es, ZoneState& zs, FrameTime const& ft)
     auto& target_hp = npcdata.health;
 
     bool const already_dead = NPC::is_dead(target_hp);
-    try_attack_selected_target(logger, terrain, ttable, registry, *this, target_eid);
+    try_attack_selected_target(logger, terrain, registry, *this, target_eid);
 
     bool const target_dead_after_attack = NPC::is_dead(target_hp);
     bool const dead_from_attack         = !already_dead && target_dead_after_attack;
 
     if (dead_from_attack) {
-      kill_entity(logger, terrain, ttable, registry, target_eid);
+      kill_entity(logger, terrain, registry, target_eid);
       LOG_ERROR("KILLING TARGET");
     }
     else if (already_dead) {
@@ -0,0 +1,31 @@
+#include <boomhs/billboard.hpp>
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/render_groups.hpp>
+#include <boomhs/transform.hpp>
+
+namespace boomhs
+{
+
+void
+RenderGroups::pack(EntityRegistry& registry)
+{
+  // The ShaderName pool dictates the order, every other pool follows it.
+  registry.sort<ShaderName>(
+      [](ShaderName const& a, ShaderName const& b) { return a.value < b.value; });
+
+  // Components every render pass reads.
+  registry.sort<Transform, ShaderName>();
+  registry.sort<WorldMatrix, ShaderName>();
+  registry.sort<IsRenderable, ShaderName>();
+  registry.sort<AABoundingBox, ShaderName>();
+
+  // Components selecting how an entity is drawn.
+  registry.sort<CubeRenderable, ShaderName>();
+  registry.sort<MeshRenderable, ShaderName>();
+  registry.sort<TextureRenderable, ShaderName>();
+  registry.sort<BillboardRenderable, ShaderName>();
+}
+
+} // namespace boomhs
@@ -0,0 +1,29 @@
+#include <boomhs/frame_time.hpp>
+#include <boomhs/nearby_targets.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/player.hpp>
+#include <boomhs/render_snapshot.hpp>
+
+#include <common/profiler.hpp>
+
+using namespace boomhs;
+
+namespace boomhs
+{
+
+void
+RenderSnapshot::build(EntityRegistry& registry, NearbyTargets const& nbt, FrameTime const& ft)
+{
+  PROFILE_ZONE("render_snapshot");
+  std::apply([&registry](auto&... copies) { (copies.copy(registry), ...); }, components_);
+
+  target_.reset();
+  auto const selected = nbt.selected();
+  if (selected) {
+    auto const  eid    = *selected;
+    auto const& player = find_player(registry);
+    target_ = Target{eid, nbt.calculate_scale(ft), player.level, registry.get<NPCData>(eid).level};
+  }
+}
+
+} // namespace boomhs
@@ -36,6 +36,7 @@
 #include <opengl/texture.hpp>
 
 #include <common/log.hpp>
+#include <common/profiler.hpp>
 #include <common/result.hpp>
 
 #include <extlibs/fastnoise.hpp>
@@ -69,6 +70,7 @@ StaticRenderers::render(LevelManager& lm, RenderState& rstate, Camera& camera, R
   auto& fs = rstate.fs;
   auto& es = fs.es;
   if (es.draw_terrain) {
+    PROFILE_ZONE("terrain");
     auto const draw_basic = [&](auto& terrain_renderer, auto& entity_renderer) {
       auto& zs       = fs.zs;
       auto& ldata    = zs.level_data;
@@ -86,6 +88,7 @@ StaticRenderers::render(LevelManager& lm, RenderState& rstate, Camera& camera, R
   // DRAW ALL ENTITIESImGuiWindowFlags_AlwaysAutoResize
   {
     if (es.draw_3d_entities) {
+      PROFILE_ZONE("entities_3d");
       if (silhouette_black) {
         silhouette_entity.render3d(rstate, rng, ft);
       }
@@ -94,6 +97,7 @@ StaticRenderers::render(LevelManager& lm, RenderState& rstate, Camera& camera, R
       }
     }
     if (es.draw_2d_billboard_entities) {
+      PROFILE_ZONE("entities_billboard");
       if (silhouette_black) {
         silhouette_entity.render2d_billboard(rstate, rng, ft);
       }
@@ -102,6 +106,7 @@ StaticRenderers::render(LevelManager& lm, RenderState& rstate, Camera& camera, R
       }
     }
     if (es.draw_2d_ui_entities) {
+      PROFILE_ZONE("entities_ui");
       if (silhouette_black) {
         silhouette_entity.render2d_ui(rstate, rng, ft);
       }
@@ -114,6 +119,7 @@ StaticRenderers::render(LevelManager& lm, RenderState& rstate, Camera& camera, R
     // do nothing
   }
   else {
+    PROFILE_ZONE("debug");
     debug.render_scene(rstate, lm, camera, rng, ft);
   }
 }
@@ -123,17 +129,17 @@ make_static_renderers(EngineState& es, ZoneState& zs, Viewport const& viewport)
 {
   auto const make_basic_water_renderer = [](common::Logger& logger, ShaderPrograms& sps,
                                             TextureTable& ttable) {
-    auto& diff   = *ttable.find("water-diffuse");
-    auto& normal = *ttable.find("water-normal");
-    auto& sp     = graphics_mode_to_water_shader(logger, GameGraphicsMode::Basic, sps);
+    auto const diff   = ttable.handle("water-diffuse");
+    auto const normal = ttable.handle("water-normal");
+    auto&      sp     = graphics_mode_to_water_shader(logger, GameGraphicsMode::Basic, sps);
     return BasicWaterRenderer{logger, diff, normal, sp};
   };
 
   auto const make_medium_water_renderer = [](common::Logger& logger, ShaderPrograms& sps,
                                              TextureTable& ttable) {
-    auto& diff   = *ttable.find("water-diffuse");
-    auto& normal = *ttable.find("water-normal");
-    auto& sp     = graphics_mode_to_water_shader(logger, GameGraphicsMode::Medium, sps);
+    auto const diff   = ttable.handle("water-diffuse");
+    auto const normal = ttable.handle("water-normal");
+    auto&      sp     = graphics_mode_to_water_shader(logger, GameGraphicsMode::Medium, sps);
     return MediumWaterRenderer{logger, diff, normal, sp};
   };
 
@@ -143,11 +149,11 @@ make_static_renderers(EngineState& es, ZoneState& zs, Viewport const& viewport)
     auto& gfx_state = zs.gfx_state;
     auto& ttable    = gfx_state.texture_table;
     auto& sps       = gfx_state.sps;
-    auto& ti        = *ttable.find("water-diffuse");
-    auto& dudv      = *ttable.find("water-dudv");
-    auto& normal    = *ttable.find("water-normal");
-    auto& sp        = graphics_mode_to_water_shader(logger, GameGraphicsMode::Advanced, sps);
-    return AdvancedWaterRenderer{logger, viewport, sp, ti, dudv, normal};
+    auto const diff   = ttable.handle("water-diffuse");
+    auto const dudv   = ttable.handle("water-dudv");
+    auto const normal = ttable.handle("water-normal");
+    auto&      sp     = graphics_mode_to_water_shader(logger, GameGraphicsMode::Advanced, sps);
+    return AdvancedWaterRenderer{logger, viewport, sp, diff, dudv, normal};
   };
 
   auto const make_black_water_renderer = [](EngineState& es, ZoneState& zs) {
@@ -201,7 +207,8 @@ make_static_renderers(EngineState& es, ZoneState& zs, Viewport const& viewport)
                                         make_medium_water_renderer(logger, sps, ttable),
                                         make_advanced_water_renderer(es, zs),
                                         make_black_water_renderer(es, zs)},
-                         static_shaders::BasicMvWithUniformColor::create(logger)};
+                         static_shaders::BasicMvWithUniformColor::create(logger),
+                         RNG{}};
 }
 
 } // namespace boomhs
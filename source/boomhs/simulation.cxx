@@ -0,0 +1,203 @@
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/frame_time.hpp>
+#include <boomhs/nearby_targets.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/player.hpp>
+#include <boomhs/random.hpp>
+#include <boomhs/simulation.hpp>
+#include <boomhs/terrain.hpp>
+#include <boomhs/transform_system.hpp>
+
+#include <common/frame_arena.hpp>
+#include <common/profiler.hpp>
+#include <extlibs/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace boomhs;
+
+namespace
+{
+
+inline auto
+find_torches(EntityRegistry& registry, common::FrameArena& arena)
+{
+  FrameEntityArray torches{common::FrameAllocator<EntityID>{arena}};
+  auto             view = registry.view<Torch>();
+  torches.reserve(view.size());
+  for (auto const eid : view) {
+    assert(registry.has<Transform>(eid));
+    torches.emplace_back(eid);
+  }
+  return torches;
+}
+
+void
+set_heights_ontop_terrain(common::Logger& logger, TerrainGrid& terrain, EntityRegistry& registry,
+                          EntityID const eid)
+{
+  auto&       transform = registry.get<Transform>(eid);
+  auto const& bbox      = registry.get<AABoundingBox>(eid).cube;
+  auto&       tr        = transform.translation;
+  float const height    = terrain.get_height(logger, tr.x, tr.z);
+
+  // update original transform
+  tr.y = bbox.half_widths().y + height;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+void
+Simulation::update_orbital_bodies(EntityRegistry& registry, FrameTime const& ft)
+{
+  auto constexpr SLOWDOWN_FACTOR = 5.0f;
+  auto const time                = ft.since_start_seconds() / SLOWDOWN_FACTOR;
+
+  for (auto const eid : registry.view<OrbitalBody, Transform>()) {
+    auto& transform = registry.get<Transform>(eid);
+    auto& orbital   = registry.get<OrbitalBody>(eid);
+    auto& pos       = transform.translation;
+
+    float const cos_time = std::cos(time + orbital.offset);
+    float const sin_time = std::sin(time + orbital.offset);
+
+    pos.x = orbital.radius.x * cos_time;
+    pos.y = orbital.radius.y * sin_time;
+    pos.z = orbital.radius.z * sin_time;
+  }
+}
+
+void
+Simulation::update_npc_positions(common::Logger& logger, EntityRegistry& registry,
+                                 TerrainGrid& terrain)
+{
+  auto const update = [&](auto const eid) {
+    auto& npcdata = registry.get<NPCData>(eid);
+    auto& npc_hp  = npcdata.health;
+    if (NPC::is_dead(npc_hp)) {
+      return;
+    }
+    set_heights_ontop_terrain(logger, terrain, registry, eid);
+  };
+  for (auto const eid : registry.view<NPCData, Transform, AABoundingBox>()) {
+    update(eid);
+  }
+}
+
+void
+Simulation::update_nearby_targets(NearbyTargets& nbt, EntityRegistry& registry,
+                                  common::FrameArena& arena)
+{
+  auto const& player = find_player(registry);
+
+  auto const enemies = find_enemies(registry, arena);
+  using pair_t       = std::pair<float, EntityID>;
+  auto pairs         = common::make_framevector<pair_t>(arena);
+  pairs.reserve(enemies.size());
+  for (auto const eid : enemies) {
+    if (registry.get<IsRenderable>(eid).hidden) {
+      continue;
+    }
+    auto const& etransform = registry.get<Transform>(eid);
+    float const distance   = glm::distance(player.transform().translation, etransform.translation);
+    pairs.emplace_back(std::make_pair(distance, eid));
+  }
+
+  auto const sort_fn = [](auto const& a, auto const& b) { return a.first < b.first; };
+  std::sort(pairs.begin(), pairs.end(), sort_fn);
+
+  auto const selected_o = nbt.selected();
+  nbt.clear();
+  for (auto const& it : pairs) {
+    nbt.add_target(it.second);
+  }
+
+  if (selected_o) {
+    nbt.set_selected(*selected_o);
+  }
+}
+
+void
+Simulation::update_torchflicker(EntityRegistry& registry, common::FrameArena& arena, RNG& rng,
+                                FrameTime const& ft)
+{
+  auto const update_torch = [&](auto const eid) {
+    auto& pointlight = registry.get<PointLight>(eid);
+
+    auto const v       = std::sin(ft.since_start_millis() * M_PI);
+    auto&      flicker = registry.get<LightFlicker>(eid);
+    auto&      light   = pointlight.light;
+    light.diffuse      = color::lerp(flicker.colors[0], flicker.colors[1], v);
+    light.specular     = light.diffuse;
+
+    auto const attenuate = [&rng](float& value, float const gen_range, float const base_value) {
+      value += rng.gen_float_range(-gen_range, gen_range);
+
+      auto const clamp = gen_range * 2.0f;
+      value            = glm::clamp(value, base_value - clamp, base_value + clamp);
+    };
+
+    // static float constexpr CONSTANT = 0.1f;
+    // attenuate(attenuation.constant, CONSTANT, torch.default_attenuation.constant);
+
+    // static float constexpr LINEAR = 0.015f;
+    // attenuate(attenuation.linear, LINEAR, torch.default_attenuation.linear);
+
+    // static float constexpr QUADRATIC = LINEAR * LINEAR;
+    // attenuate(attenuation.quadratic, QUADRATIC, torch.default_attenuation.quadratic);
+
+    static float constexpr SPEED_DELTA = 0.24f;
+    attenuate(flicker.current_speed, SPEED_DELTA, flicker.base_speed);
+  };
+  auto const torches = find_torches(registry, arena);
+  for (auto const eid : torches) {
+    update_torch(eid);
+  }
+}
+
+void
+Simulation::update(common::Logger& logger, SimulationZone& zone, SimulationInput const& input,
+                   common::FrameArena& arena, RNG& rng, FrameTime const& ft)
+{
+  auto& registry = zone.registry;
+
+  // Update these as a chunk, so they stay in the correct order.
+  {
+    PROFILE_ZONE("npcs");
+    update_npc_positions(logger, registry, zone.terrain);
+    update_nearby_targets(zone.nearby_targets, registry, arena);
+  }
+  {
+    PROFILE_ZONE("player");
+    find_player(registry).update(logger, zone, input, ft);
+  }
+  {
+    // Bring the player's head and carried items (a torch) along with the player, before the rest
+    // of the frame reads their positions.
+    PROFILE_ZONE("hierarchy");
+    TransformSystem::update_hierarchy(registry);
+  }
+  {
+    PROFILE_ZONE("torchflicker");
+    update_torchflicker(registry, arena, rng, ft);
+  }
+}
+
+void
+Simulation::tick(common::Logger& logger, SimulationZone& zone, SimulationInput const& input,
+                 common::FrameArena& arena, RNG& rng, FrameTime const& ft)
+{
+  if (input.update_orbital_bodies) {
+    update_orbital_bodies(zone.registry, ft);
+  }
+  update(logger, zone, input, arena, rng, ft);
+  TransformSystem::update_world_matrices(zone.registry);
+}
+
+} // namespace boomhs
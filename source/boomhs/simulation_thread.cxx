@@ -0,0 +1,67 @@
+#include <boomhs/simulation_thread.hpp>
+
+#include <common/profiler.hpp>
+
+#include <cassert>
+
+namespace boomhs
+{
+
+SimulationThread::SimulationThread(size_t const arena_capacity)
+    : arena_(arena_capacity)
+{
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+SimulationThread::~SimulationThread()
+{
+  wait();
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  started_.notify_one();
+  thread_.join();
+}
+
+void
+SimulationThread::start(Step&& step)
+{
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    assert(!step_);
+    step_ = MOVE(step);
+  }
+  started_.notify_one();
+}
+
+void
+SimulationThread::wait()
+{
+  PROFILE_ZONE("simulation_wait");
+  std::unique_lock<std::mutex> lock{mutex_};
+  finished_.wait(lock, [this]() { return !step_; });
+}
+
+void
+SimulationThread::run()
+{
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    started_.wait(lock, [this]() { return stop_ || step_; });
+    if (stop_) {
+      return;
+    }
+
+    // The step is only cleared once it has finished, wait() can't return before then.
+    lock.unlock();
+    step_(arena_);
+    arena_.reset();
+    lock.lock();
+
+    step_ = nullptr;
+    finished_.notify_all();
+  }
+}
+
+} // namespace boomhs
@@ -10,15 +10,12 @@
 #include <boomhs/start_area_generator.hpp>
 #include <boomhs/terrain.hpp>
 
-#include <opengl/texture.hpp>
-
 #include <common/os.hpp>
 
 #include <algorithm>
 
 using namespace boomhs;
 using namespace boomhs::math::constants;
-using namespace opengl;
 
 static auto constexpr MIN_MONSTERS_PER_FLOOR = 15;
 static auto constexpr MAX_MONSTERS_PER_FLOOR = 30;
@@ -37,9 +34,9 @@ place_item_on_ground(common::Logger& logger, TerrainGrid& terrain, Transform& tr
 
 void
 place_torch(common::Logger& logger, TerrainGrid& terrain, EntityRegistry& registry,
-            TextureTable& ttable, glm::vec2 const& pos)
+            glm::vec2 const& pos)
 {
-  auto const eid = ItemFactory::create_torch(registry, ttable);
+  auto const eid = ItemFactory::create_torch(registry);
 
   auto& transform = registry.get<Transform>(eid);
   place_item_on_ground(logger, terrain, transform, pos);
@@ -54,13 +51,12 @@ place_monsters(common::Logger& logger, TerrainGrid const& terrain, EntityRegistr
 }
 
 void
-place_player(common::Logger& logger, ShaderPrograms& sps, TerrainGrid const& terrain,
-             MaterialTable const& material_table, EntityRegistry& registry,
+place_player(common::Logger& logger, TerrainGrid const& terrain, MaterialTable const& material_table, EntityRegistry& registry,
              WorldOrientation const& world_orientation)
 {
   auto const eid = registry.create();
 
-  auto& player = registry.assign<Player>(eid, logger, eid, registry, sps, world_orientation);
+  auto& player = registry.assign<Player>(eid, logger, eid, registry, world_orientation);
   player.level = 14;
   player.name  = "BEN";
   player.speed = 460;
@@ -84,15 +80,12 @@ place_player(common::Logger& logger, ShaderPrograms& sps, TerrainGrid const& ter
 }
 
 void
-place_waters(common::Logger& logger, ShaderPrograms& sps, EntityRegistry& registry,
-             TextureTable& ttable, RNG& rng)
+place_waters(common::Logger& logger, EntityRegistry& registry, RNG& rng)
 {
-  auto& water_sp = graphics_mode_to_water_shader(logger, GameGraphicsMode::Basic, sps);
-
   auto const place = [&](glm::vec2 const& pos, unsigned int count) {
     auto const eid = registry.create();
 
-    auto& wi     = WaterFactory::make_default(logger, sps, ttable, eid, registry);
+    auto& wi     = WaterFactory::make_default(logger, eid, registry);
     wi.mix_color = color::random(rng);
 
     auto& tr         = registry.get<Transform>(eid);
@@ -122,7 +115,6 @@ namespace boomhs
 
 LevelGeneratedData
 StartAreaGenerator::gen_level(common::Logger& logger, EntityRegistry& registry, RNG& rng,
-                              ShaderPrograms& sps, TextureTable& ttable,
                               MaterialTable const& material_table, Heightmap const& heightmap,
                               WorldOrientation const& world_orientation)
 {
@@ -130,24 +122,23 @@ StartAreaGenerator::gen_level(common::Logger& logger, EntityRegistry& registry,
 
   LOG_TRACE("Generating Terrain");
   TerrainConfig const tc;
-  auto&               sp = sps.ref_sp(logger, tc.shader_name);
 
   TerrainGridConfig tgc;
   tgc.num_rows = 2;
   tgc.num_cols = 2;
-  auto terrain = terrain::generate_grid(logger, tgc, tc, heightmap, sp);
+  auto terrain = terrain::generate_grid(logger, tgc, tc, heightmap);
 
   LOG_TRACE("Placing Torch");
-  place_torch(logger, terrain, registry, ttable, glm::vec2{2, 2});
+  place_torch(logger, terrain, registry, glm::vec2{2, 2});
 
   LOG_TRACE("Placing Player");
-  place_player(logger, sps, terrain, material_table, registry, world_orientation);
+  place_player(logger, terrain, material_table, registry, world_orientation);
 
   LOG_TRACE("placing monsters ...\n");
   place_monsters(logger, terrain, registry, rng);
 
   LOG_TRACE("placing water ...\n");
-  place_waters(logger, sps, registry, ttable, rng);
+  place_waters(logger, registry, rng);
 
   LOG_TRACE("finished generating starting area!");
   return LevelGeneratedData{MOVE(terrain)};
@@ -4,9 +4,11 @@
 namespace boomhs
 {
 
-GameState::GameState(EngineState& es, LevelManager&& lm, WaterAudioSystem&& was)
+GameState::GameState(EngineState& es, LevelManager&& lm, ZoneStreamer&& streamer,
+                     WaterAudioSystem&& was)
     : es_(es)
     , lm_(MOVE(lm))
+    , streamer_(MOVE(streamer))
     , was_(MOVE(was))
 {
 }
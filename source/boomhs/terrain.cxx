@@ -2,48 +2,23 @@
 #include <boomhs/obj.hpp>
 #include <boomhs/terrain.hpp>
 
-#include <opengl/buffer.hpp>
-#include <opengl/gpu.hpp>
-#include <opengl/shader.hpp>
-
 #include <cassert>
 #include <common/algorithm.hpp>
 #include <common/log.hpp>
 
 #include <sstream>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::terrain
+
 using namespace boomhs;
-using namespace opengl;
 
 namespace
 {
 
-ObjData
-generate_terrain_data(common::Logger& logger, TerrainGridConfig const& tgc, TerrainConfig const& tc,
-                      Heightmap const& heightmap)
-{
-  auto const numv_oneside = tc.num_vertexes_along_one_side;
-  auto const num_vertexes = math::squared(numv_oneside);
-
-  ObjData data;
-  data.num_vertexes = num_vertexes;
-
-  data.vertices = MeshFactory::generate_rectangle_mesh(logger, tgc.dimensions, numv_oneside);
-  heightmap::update_vertices_from_heightmap(logger, tc, heightmap, data.vertices);
-
-  {
-    GenerateNormalData const gnd{tc.invert_normals, heightmap, numv_oneside};
-    data.normals = MeshFactory::generate_normals(logger, gnd);
-  }
-
-  data.uvs     = MeshFactory::generate_uvs(logger, tgc.dimensions, numv_oneside, tc.tile_textures);
-  data.indices = MeshFactory::generate_indices(logger, numv_oneside);
-  return data;
-}
-
 TerrainGrid
 generate_grid_data(common::Logger& logger, TerrainGridConfig const& tgc, TerrainConfig const& tc,
-                   Heightmap const& heightmap, ShaderProgram& sp)
+                   Heightmap const& heightmap)
 {
   LOG_TRACE("Generating Terrain");
   size_t const rows = tgc.num_rows, cols = tgc.num_cols;
@@ -54,7 +29,7 @@ generate_grid_data(common::Logger& logger, TerrainGridConfig const& tgc, Terrain
     FOR(i, cols)
     {
       auto const pos = glm::vec2{i, j};
-      auto       t   = terrain::generate_piece(logger, pos, tgc, tc, heightmap, sp);
+      auto       t   = terrain::generate_piece(logger, pos, tc, heightmap);
       tgrid.add(MOVE(t));
     }
   }
@@ -136,11 +111,8 @@ TerrainConfig::to_string() const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Terrain
-Terrain::Terrain(TerrainConfig const& tc, glm::vec2 const& pos, DrawInfo&& di, ShaderProgram& sp,
-                 Heightmap&& hmap)
+Terrain::Terrain(TerrainConfig const& tc, glm::vec2 const& pos, Heightmap&& hmap)
     : pos_(pos)
-    , di_(MOVE(di))
-    , sp_(&sp)
     , config(tc)
     , heightmap(MOVE(hmap))
 {
@@ -149,9 +121,8 @@ Terrain::Terrain(TerrainConfig const& tc, glm::vec2 const& pos, DrawInfo&& di, S
 std::string
 Terrain::to_string() const
 {
-  return fmt::sprintf("Terrain: {pos: %s, di: %s, sp: %s, terrain config: %s, heightmap: {%s}}",
-                      glm::to_string(pos_), di_.to_string(), sp_->to_string(), config.to_string(),
-                      heightmap.to_string());
+  return fmt::sprintf("Terrain: {pos: %s, terrain config: %s, heightmap: {%s}}",
+                      glm::to_string(pos_), config.to_string(), heightmap.to_string());
 }
 
 std::string&
@@ -170,6 +141,13 @@ Terrain::texture_name(size_t const index) const
   return names.textures[index];
 }
 
+opengl::TextureHandle
+Terrain::texture_handle(size_t const index) const
+{
+  assert(index < texture_handles.size());
+  return texture_handles[index];
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // TerrainArray
 void
@@ -310,34 +288,43 @@ TerrainGrid::to_string() const
 namespace boomhs::terrain
 {
 
+ObjData
+generate_data(common::Logger& logger, TerrainGridConfig const& tgc, Terrain const& terrain)
+{
+  auto const& tc           = terrain.config;
+  auto const& heightmap    = terrain.heightmap;
+  auto const  numv_oneside = tc.num_vertexes_along_one_side;
+  auto const  num_vertexes = math::squared(numv_oneside);
+
+  ObjData data;
+  data.num_vertexes = num_vertexes;
+
+  data.vertices = MeshFactory::generate_rectangle_mesh(logger, tgc.dimensions, numv_oneside);
+  heightmap::update_vertices_from_heightmap(logger, tc, heightmap, data.vertices);
+
+  {
+    GenerateNormalData const gnd{tc.invert_normals, heightmap, numv_oneside};
+    data.normals = MeshFactory::generate_normals(logger, gnd);
+  }
+
+  data.uvs     = MeshFactory::generate_uvs(logger, tgc.dimensions, numv_oneside, tc.tile_textures);
+  data.indices = MeshFactory::generate_indices(logger, numv_oneside);
+  return data;
+}
+
 Terrain
-generate_piece(common::Logger& logger, glm::vec2 const& pos, TerrainGridConfig const& tgc,
-               TerrainConfig const& tc, Heightmap const& heightmap, ShaderProgram& sp)
+generate_piece(common::Logger& logger, glm::vec2 const& pos, TerrainConfig const& tc,
+               Heightmap const& heightmap)
 {
-  auto const data = generate_terrain_data(logger, tgc, tc, heightmap);
-  LOG_TRACE_SPRINTF("Generated terrain piece: %s", data.to_string());
-
-  BufferFlags const flags{true, true, false, true};
-  auto const        buffer = VertexBuffer::create_interleaved(logger, data, flags);
-  auto              di     = gpu::copy_gpu(logger, sp.va(), buffer);
-
-  // These uniforms only need to be set once.
-  sp.while_bound(logger, [&]() {
-    shader::set_uniform(logger, sp, "u_bgsampler",    0);
-    shader::set_uniform(logger, sp, "u_rsampler",     1);
-    shader::set_uniform(logger, sp, "u_gsampler",     2);
-    shader::set_uniform(logger, sp, "u_bsampler",     3);
-    shader::set_uniform(logger, sp, "u_blendsampler", 4);
-  });
-
-  return Terrain{tc, pos, MOVE(di), sp, heightmap.clone()};
+  LOG_TRACE_SPRINTF("Generating terrain piece at: %s", glm::to_string(pos));
+  return Terrain{tc, pos, heightmap.clone()};
 }
 
 TerrainGrid
 generate_grid(common::Logger& logger, TerrainConfig const& tc, Heightmap const& heightmap,
-              ShaderProgram& sp, TerrainGrid const& prevgrid)
+              TerrainGrid const& prevgrid)
 {
-  auto tgrid = generate_grid_data(logger, prevgrid.config, tc, heightmap, sp);
+  auto tgrid = generate_grid_data(logger, prevgrid.config, tc, heightmap);
 
   // If the previous grid has enough rows/columns for how far along we are generating a new grid,
   // then copy the previous terrain's config to the new terrain.
@@ -359,9 +346,9 @@ generate_grid(common::Logger& logger, TerrainConfig const& tc, Heightmap const&
 
 TerrainGrid
 generate_grid(common::Logger& logger, TerrainGridConfig const& tgc, TerrainConfig const& tc,
-              Heightmap const& heightmap, ShaderProgram& sp)
+              Heightmap const& heightmap)
 {
-  return generate_grid_data(logger, tgc, tc, heightmap, sp);
+  return generate_grid_data(logger, tgc, tc, heightmap);
 }
 
 } // namespace boomhs::terrain
@@ -1,6 +1,8 @@
 #include <boomhs/transform.hpp>
 #include <boomhs/math.hpp>
 
+#include <limits>
+
 using namespace boomhs;
 using namespace boomhs::math;
 
@@ -70,4 +72,37 @@ Transform::model_matrix() const
   return compute_modelmatrix(*this);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// WorldMatrix
+WorldMatrix::WorldMatrix()
+    // NaN never compares equal, so a freshly constructed WorldMatrix is always dirty.
+    : translation(std::numeric_limits<float>::quiet_NaN())
+    , scale(constants::ONE)
+{
+}
+
+bool
+WorldMatrix::is_dirty(Transform const& tr) const
+{
+  return (translation != tr.translation) || (rotation != tr.rotation) || (scale != tr.scale);
+}
+
+void
+WorldMatrix::recompute(Transform const& tr)
+{
+  translation = tr.translation;
+  rotation    = tr.rotation;
+  scale       = tr.scale;
+  value       = compute_modelmatrix(tr);
+}
+
+void
+WorldMatrix::assign(Transform const& tr, glm::mat4 const& m)
+{
+  translation = tr.translation;
+  rotation    = tr.rotation;
+  scale       = tr.scale;
+  value       = m;
+}
+
 } // namespace boomhs
@@ -0,0 +1,221 @@
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/math.hpp>
+#include <boomhs/transform.hpp>
+#include <boomhs/transform_system.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+using namespace boomhs;
+
+enum class VisitState : uint8_t
+{
+  Visiting,
+  Done,
+  Broken
+};
+
+// Flatten the hierarchy so parents come before their children, every chain starting at it's root.
+//
+// Entities whose parent chain loops back on itself, or leads to a destroyed entity (or one without
+// a Transform), are left out of the order; their Transform is left as it is.
+void
+build_hierarchy(EntityRegistry& registry, TransformHierarchy& hierarchy)
+{
+  auto& eids         = hierarchy.eids;
+  auto& parent_index = hierarchy.parent_index;
+  eids.clear();
+  parent_index.clear();
+
+  // The index of every entity already in the order.
+  std::unordered_map<EntityID, int> indices;
+  auto const add = [&](EntityID const eid, int const parent) {
+    indices.emplace(eid, static_cast<int>(eids.size()));
+    eids.emplace_back(eid);
+    parent_index.emplace_back(parent);
+  };
+
+  std::unordered_map<EntityID, VisitState> states;
+  std::vector<EntityID>                    chain;
+  for (auto const start : registry.view<Parent, Transform>()) {
+    if (states.count(start)) {
+      continue;
+    }
+
+    // Walk up from the entity until reaching a root (an entity without a Parent), or an entity
+    // already ordered. The chain is then ordered from the root down.
+    chain.clear();
+    bool     broken = false;
+    EntityID top    = start;
+    for (; registry.has<Parent>(top);) {
+      auto const it = states.find(top);
+      if (it != states.cend()) {
+        // Reaching an entity still being visited means the chain is a cycle.
+        broken = VisitState::Done != it->second;
+        break;
+      }
+      states.emplace(top, VisitState::Visiting);
+      chain.emplace_back(top);
+
+      auto const parent = registry.get<Parent>(top).eid;
+      if (!registry.valid(parent) || !registry.has<Transform>(parent)) {
+        broken = true;
+        break;
+      }
+      top = parent;
+    }
+    if (!broken && !indices.count(top)) {
+      add(top, -1);
+    }
+
+    for (auto it = chain.crbegin(); it != chain.crend(); ++it) {
+      states[*it] = broken ? VisitState::Broken : VisitState::Done;
+      if (!broken) {
+        add(*it, indices[registry.get<Parent>(*it).eid]);
+      }
+    }
+  }
+
+  auto const count = eids.size();
+  hierarchy.inherit.resize(count);
+  hierarchy.local.resize(count);
+  hierarchy.world.resize(count);
+  hierarchy.dirty = false;
+}
+
+glm::vec3
+scale_of(glm::mat4 const& m)
+{
+  return glm::vec3{glm::length(glm::vec3{m[0]}), glm::length(glm::vec3{m[1]}),
+                   glm::length(glm::vec3{m[2]})};
+}
+
+glm::mat3
+rotation_of(glm::mat4 const& m, glm::vec3 const& scale)
+{
+  return glm::mat3{glm::vec3{m[0]} / scale.x, glm::vec3{m[1]} / scale.y, glm::vec3{m[2]} / scale.z};
+}
+
+// The child's world matrix, from it's parent's world matrix and it's local matrix.
+//
+// The child's translation is moved by the parent's whole transform, but it's rotation and scale are
+// only combined with the parent's when inherited (the local matrix then holds the child's own).
+glm::mat4
+compose(glm::mat4 const& parent_world, glm::mat4 const& local, uint8_t const inherit)
+{
+  auto const parent_scale = scale_of(parent_world);
+
+  glm::mat3 rotation{1.0f};
+  if (inherit & TransformHierarchy::INHERIT_ROTATION) {
+    rotation = rotation_of(parent_world, parent_scale);
+  }
+  auto const scale =
+      (inherit & TransformHierarchy::INHERIT_SCALE) ? parent_scale : glm::vec3{1.0f};
+
+  glm::mat4 world;
+  FOR(i, 3) { world[i] = glm::vec4{rotation * (glm::vec3{local[i]} * scale[i]), 0.0f}; }
+
+  auto const offset = rotation * (glm::vec3{local[3]} * scale);
+  world[3]          = glm::vec4{glm::vec3{parent_world[3]} + offset, 1.0f};
+  return world;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+void
+TransformSystem::update_hierarchy(EntityRegistry& registry)
+{
+  auto& hierarchy = registry.hierarchy();
+  if (hierarchy.dirty) {
+    build_hierarchy(registry, hierarchy);
+  }
+
+  auto const& eids         = hierarchy.eids;
+  auto const& parent_index = hierarchy.parent_index;
+  auto&       inherit      = hierarchy.inherit;
+  auto&       local        = hierarchy.local;
+  auto&       world        = hierarchy.world;
+  auto const  count        = hierarchy.size();
+
+  // Read the local transforms out of the registry (and the roots' world transforms).
+  FOR(i, count)
+  {
+    auto const eid = eids[i];
+    if (parent_index[i] < 0) {
+      local[i] = registry.get<Transform>(eid).model_matrix();
+      continue;
+    }
+
+    auto const& parent = registry.get<Parent>(eid);
+    if (parent.eid != eids[parent_index[i]]) {
+      // The parent was changed in place, order the hierarchy again before going any further.
+      build_hierarchy(registry, hierarchy);
+      update_hierarchy(registry);
+      return;
+    }
+    inherit[i] = (parent.inherit_rotation ? TransformHierarchy::INHERIT_ROTATION : 0) |
+                 (parent.inherit_scale ? TransformHierarchy::INHERIT_SCALE : 0);
+
+    auto const& tr       = registry.get<Transform>(eid);
+    auto const& rotation = parent.inherit_rotation ? parent.local.rotation : tr.rotation;
+    auto const& scale    = parent.inherit_scale ? parent.local.scale : tr.scale;
+    local[i] = math::compute_modelmatrix(parent.local.translation, rotation, scale);
+  }
+
+  // Single linear pass, parents are always visited before their children so a child's parent
+  // world matrix is final by the time the child reads it.
+  FOR(i, count)
+  {
+    auto const p = parent_index[i];
+    world[i]     = p < 0 ? local[i] : compose(world[p], local[i], inherit[i]);
+  }
+
+  // Write the children's world transforms back, their WorldMatrix is already known.
+  FOR(i, count)
+  {
+    if (parent_index[i] < 0) {
+      continue;
+    }
+    auto const  eid = eids[i];
+    auto const& m   = world[i];
+
+    auto& tr       = registry.get<Transform>(eid);
+    tr.translation = glm::vec3{m[3]};
+    if (inherit[i] != 0) {
+      auto const scale = scale_of(m);
+      if (inherit[i] & TransformHierarchy::INHERIT_SCALE) {
+        tr.scale = scale;
+      }
+      if (inherit[i] & TransformHierarchy::INHERIT_ROTATION) {
+        tr.rotation = glm::quat_cast(rotation_of(m, scale));
+      }
+    }
+    registry.get<WorldMatrix>(eid).assign(tr, m);
+  }
+}
+
+void
+TransformSystem::update_world_matrices(EntityRegistry& registry)
+{
+  // Walk the packed WorldMatrix/Transform pairs once, comparing the cached TRS values against the
+  // current ones. Only entities that actually moved pay for a matrix composition (which is itself
+  // branch-free, see math::compute_modelmatrix).
+  for (auto const eid : registry.view<Transform, WorldMatrix>()) {
+    auto const& tr = registry.get<Transform>(eid);
+    auto&       wm = registry.get<WorldMatrix>(eid);
+    if (wm.is_dirty(tr)) {
+      wm.recompute(tr);
+    }
+  }
+}
+
+} // namespace boomhs
@@ -17,24 +17,17 @@ template <typename FN>
 std::vector<float>
 generate_tree_colors(common::Logger& logger, ObjData const& objdata, FN const& face_to_colormap)
 {
+  // Each vertex gets the color of it's face's material.
   std::vector<float> colors;
-  auto const         update_branchcolors = [&](auto const& shape, int const face) {
-    int const face_materialid = shape.mesh.material_ids[face];
-
+  for (auto const face_materialid : objdata.material_ids) {
     assert(static_cast<size_t>(face_materialid) < face_to_colormap.size());
     auto const& face_color = *face_to_colormap[face_materialid];
 
-    auto const fv = shape.mesh.num_face_vertices[face];
-    FOR(vi, fv)
-    {
-      colors.emplace_back(face_color.r());
-      colors.emplace_back(face_color.g());
-      colors.emplace_back(face_color.b());
-      colors.emplace_back(face_color.a());
-    }
-  };
-
-  objdata.foreach_face(update_branchcolors);
+    colors.emplace_back(face_color.r());
+    colors.emplace_back(face_color.g());
+    colors.emplace_back(face_color.b());
+    colors.emplace_back(face_color.a());
+  }
 
   assert((objdata.colors.size() % 4) == 0);
   assert(objdata.colors.size() == colors.size());
@@ -182,12 +175,33 @@ TreeComponent::leaf_color(size_t const index) const
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Tree
 void
-Tree::update_colors(common::Logger& logger, VertexAttribute const& va, DrawInfo& dinfo,
-                    TreeComponent& tree)
+Tree::update_colors(common::Logger& logger, VertexAttribute const& va, DrawHandleManager& dhm,
+                    ObjStore& obj_store, EntityRegistry& registry, EntityID const eid)
 {
+  auto& tree     = registry.get<TreeComponent>(eid);
   auto& objdata  = tree.obj();
   objdata.colors = generate_tree_colors(logger, tree);
-  gpu::overwrite_vertex_buffer(logger, va, dinfo, objdata);
+
+  // Trees not on the GPU yet get their colors once they are uploaded, see GpuResidency.
+  if (!dhm.has_entity(eid)) {
+    return;
+  }
+  gpu::overwrite_vertex_buffer(logger, va, dhm.lookup_entity(logger, eid), objdata);
+
+  // The LODs' vertices are copies of the mesh's vertices, copy their colors the same way.
+  auto const& mesh_name = registry.get<MeshRenderable>(eid).name;
+  for (size_t lod = 1; lod < dhm.num_lods(eid); ++lod) {
+    auto& mesh_lod = obj_store.get_lod(logger, mesh_name, lod);
+    auto& colors   = mesh_lod.data.colors;
+
+    colors.clear();
+    for (auto const v : mesh_lod.source_vertices) {
+      auto const begin = objdata.colors.cbegin() + (4 * v);
+      colors.insert(colors.end(), begin, begin + 4);
+    }
+    gpu::overwrite_vertex_buffer(logger, va, dhm.lookup_entity_lod(logger, eid, lod),
+                                 mesh_lod.data);
+  }
 }
 
 /*
@@ -9,13 +9,22 @@
 #include <boomhs/tree.hpp>
 #include <boomhs/view_frustum.hpp>
 
+#include <common/profiler.hpp>
+
 #include <extlibs/fmt.hpp>
 #include <extlibs/glm.hpp>
 #include <extlibs/imgui.hpp>
 
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <string_view>
+#include <vector>
+
 using namespace boomhs;
 using namespace opengl;
 using namespace gl_sdl;
+using namespace common;
 
 namespace
 {
@@ -121,8 +130,8 @@ draw_entity_editor(char const* prefix, int const window_flags, EngineState& es,
       auto& sn = registry.get<ShaderName>(eid);
       auto& va = sps.ref_sp(logger, sn.value).va();
 
-      auto& dinfo = draw_handles.lookup_entity(logger, eid);
-      Tree::update_colors(logger, va, dinfo, tc);
+      auto& obj_store = zs.level_data.obj_store;
+      Tree::update_colors(logger, va, draw_handles, obj_store, registry, eid);
     }
 
     if (registry.has<PointLight>(eid) && ImGui::CollapsingHeader("Pointlight")) {
@@ -168,6 +177,183 @@ draw_entity_editor(char const* prefix, int const window_flags, EngineState& es,
   imgui_cxx::with_window(draw, title.c_str(), nullptr, window_flags);
 }
 
+float constexpr PROFILER_WIDTH = 900.0f;
+
+// A color for each zone name, so a zone keeps it's color from frame to frame.
+ImU32
+zone_color(char const* name)
+{
+  auto const  hash = std::hash<std::string_view>{}(name);
+  float const hue  = static_cast<float>(hash % 360) / 360.0f;
+  return ImColor::HSV(hue, 0.55f, 0.80f);
+}
+
+// Draw each zone of the frame as a bar, spanning the time the zone took. Zones nested inside of
+// another zone are drawn below it, each thread gets it's own rows.
+void
+draw_flame_graph(ProfileFrame const& frame)
+{
+  float constexpr ROW_HEIGHT = 18.0f;
+  float constexpr THREAD_GAP = 6.0f;
+
+  // (thread, number of rows), in the order the threads first appear in the frame.
+  std::vector<std::pair<uint32_t, uint32_t>> threads;
+  for (auto const& event : frame.events) {
+    auto const cmp = [&event](auto const& t) { return t.first == event.thread; };
+    auto const it  = std::find_if(threads.begin(), threads.end(), cmp);
+    if (it == threads.end()) {
+      threads.emplace_back(event.thread, event.depth + 1);
+    }
+    else {
+      it->second = std::max(it->second, event.depth + 1);
+    }
+  }
+  auto const row_y = [&threads](uint32_t const thread, uint32_t const depth) {
+    float y = 0.0f;
+    for (auto const& t : threads) {
+      if (t.first == thread) {
+        break;
+      }
+      y += (t.second * ROW_HEIGHT) + THREAD_GAP;
+    }
+    return y + (depth * ROW_HEIGHT);
+  };
+
+  float height = ROW_HEIGHT;
+  for (auto const& t : threads) {
+    height += (t.second * ROW_HEIGHT) + THREAD_GAP;
+  }
+
+  auto const origin = ImGui::GetCursorScreenPos();
+  ImGui::InvisibleButton("##flame graph", ImVec2{PROFILER_WIDTH, height});
+
+  auto*        draw_list = ImGui::GetWindowDrawList();
+  double const px_per_ns = PROFILER_WIDTH / std::max<double>(frame.duration_ns(), 1.0);
+
+  // Zones from other threads may have begun before (or ended after) the frame.
+  auto const to_x = [&](uint64_t const ns) {
+    auto const since_begin = static_cast<int64_t>(ns - frame.begin_ns) * px_per_ns;
+    return origin.x + std::clamp(static_cast<float>(since_begin), 0.0f, PROFILER_WIDTH);
+  };
+
+  ProfileEvent const* hovered = nullptr;
+  for (auto const& event : frame.events) {
+    float const x0 = to_x(event.begin_ns);
+    float const x1 = std::max(to_x(event.end_ns), x0 + 1.0f);
+    float const y0 = origin.y + row_y(event.thread, event.depth);
+
+    ImVec2 const min{x0, y0};
+    ImVec2 const max{x1, y0 + ROW_HEIGHT - 1.0f};
+    draw_list->AddRectFilled(min, max, zone_color(event.name));
+
+    float constexpr MIN_LABEL_WIDTH = 24.0f;
+    if ((x1 - x0) > MIN_LABEL_WIDTH) {
+      draw_list->PushClipRect(min, max, true);
+      draw_list->AddText(ImVec2{x0 + 2.0f, y0 + 2.0f}, IM_COL32_BLACK, event.name);
+      draw_list->PopClipRect();
+    }
+    if (ImGui::IsMouseHoveringRect(min, max)) {
+      hovered = &event;
+    }
+  }
+  if (hovered) {
+    ImGui::SetTooltip("%s (thread %u): %.3fms", hovered->name, hovered->thread,
+                      hovered->duration_ns() / 1000000.0);
+  }
+}
+
+void
+draw_profiler_window(char const* prefix, int const window_flags, EngineState& es)
+{
+  auto& logger = es.logger;
+  auto& buffer = es.ui_state.debug.buffers.profiler;
+
+  auto const draw = [&]() {
+    bool enabled = Profiler::enabled();
+    if (ImGui::Checkbox("Recording", &enabled)) {
+      Profiler::set_enabled(enabled);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace")) {
+      auto r = Profiler::write_chrome_trace(Profiler::TRACE_PATH);
+      if (!r) {
+        LOG_ERROR(r.unwrapErrMove());
+      }
+      else {
+        LOG_INFO_SPRINTF("Profiler trace written to '%s'.", Profiler::TRACE_PATH);
+      }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+      Profiler::clear();
+      buffer.selected_frame.reset();
+    }
+
+    float threshold = Profiler::spike_threshold_ms();
+    if (ImGui::SliderFloat("Spike Threshold (ms)", &threshold, 1.0f, 100.0f)) {
+      Profiler::set_spike_threshold_ms(threshold);
+    }
+    if (ImGui::Checkbox("Show Spikes", &buffer.show_spikes)) {
+      buffer.selected_frame.reset();
+    }
+
+    std::vector<ProfileFrame const*> frames;
+    if (buffer.show_spikes) {
+      for (auto const& frame : Profiler::spikes()) {
+        frames.emplace_back(&frame);
+      }
+      auto const cmp = [](auto const* a, auto const* b) { return a->number < b->number; };
+      std::sort(frames.begin(), frames.end(), cmp);
+    }
+    else {
+      for (auto const& frame : Profiler::history()) {
+        frames.emplace_back(&frame);
+      }
+    }
+    if (frames.empty()) {
+      ImGui::Text("No frames recorded.");
+      return;
+    }
+
+    // The selected frame, or the latest frame if the selected frame is gone.
+    int selected = static_cast<int>(frames.size()) - 1;
+    if (buffer.selected_frame) {
+      auto const number = *buffer.selected_frame;
+      auto const cmp    = [&number](auto const* frame) { return frame->number == number; };
+      auto const it     = std::find_if(frames.cbegin(), frames.cend(), cmp);
+      if (it != frames.cend()) {
+        selected = static_cast<int>(it - frames.cbegin());
+      }
+    }
+
+    std::vector<float> durations;
+    for (auto const* frame : frames) {
+      durations.emplace_back(frame->duration_ms());
+    }
+    auto const num_durations = static_cast<int>(durations.size());
+    ImGui::PlotHistogram("##frame times", durations.data(), num_durations, 0, "Frame Time (ms)",
+                         0.0f, FLT_MAX, ImVec2{PROFILER_WIDTH, 80.0f});
+
+    if (ImGui::SliderInt("Frame", &selected, 0, static_cast<int>(frames.size()) - 1)) {
+      buffer.selected_frame = frames[selected]->number;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Latest")) {
+      buffer.selected_frame.reset();
+      selected = static_cast<int>(frames.size()) - 1;
+    }
+
+    auto const& frame = *frames[selected];
+    ImGui::Text("Frame %lu: %.3fms, %lu zones", frame.number, frame.duration_ms(),
+                frame.events.size());
+    draw_flame_graph(frame);
+  };
+
+  auto const title = std::string{prefix} + ":Profiler Window";
+  auto&      show  = es.ui_state.debug.show_profiler_window;
+  imgui_cxx::with_window(draw, title.c_str(), &show, window_flags | ImGuiWindowFlags_NoCollapse);
+}
+
 } // namespace
 
 namespace boomhs::ui_debug
@@ -190,6 +376,9 @@ draw(char const* prefix, int const window_flags, EngineState& es, LevelManager&
     auto const& proj_mat = fs.projection_matrix();
     draw_entity_editor(prefix, window_flags, es, lm, registry, camera, view_mat, proj_mat);
   }
+  if (uistate.show_profiler_window) {
+    draw_profiler_window(prefix, window_flags, es);
+  }
 }
 
 } // namespace boomhs::ui_debug
@@ -8,6 +8,7 @@
 #include <boomhs/ui_state.hpp>
 #include <boomhs/zone_state.hpp>
 
+#include <opengl/gl_state.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/renderer.hpp>
 
@@ -82,7 +83,7 @@ draw_player_inventory(common::Logger& logger, Player& player, EntityRegistry& re
       auto&       item    = slot.item(registry);
       auto const& tooltip = item.tooltip;
       if (item.has_single_owner()) {
-        ImGui::SetTooltip("%s |Owner: %s", tooltip, item.current_owner().value.c_str());
+        ImGui::SetTooltip("%s |Owner: %s", tooltip.c_str(), item.current_owner().value.c_str());
       }
       else {
         std::stringstream ss;
@@ -99,7 +100,7 @@ draw_player_inventory(common::Logger& logger, Player& player, EntityRegistry& re
           ss << prev_owners[i].value;
         }
         auto const names = ss.str();
-        ImGui::SetTooltip("%s |Owner: %s |Previous Owners: (%s)", tooltip,
+        ImGui::SetTooltip("%s |Owner: %s |Previous Owners: (%s)", tooltip.c_str(),
                           item.current_owner().value.c_str(), names.c_str());
       }
     }
@@ -287,7 +288,7 @@ draw_chatwindow(EngineState& es, Player& player)
 }
 
 void
-draw_debugoverlay_window(EngineState& es, DrawState& ds)
+draw_debugoverlay_window(EngineState& es, ZoneState& zs, DrawState& ds)
 {
   auto const framerate = es.imgui.Framerate;
   auto const ms_frame  = 1000.0f / framerate;
@@ -296,6 +297,18 @@ draw_debugoverlay_window(EngineState& es, DrawState& ds)
     ImGui::Text("Debug Information");
     ImGui::Separator();
     ImGui::Text("#verts: %s", ds.to_string().c_str());
+
+    auto const& glcounters = GLState::counters();
+    auto const  filtered   = glcounters.total_filtered();
+    auto const  total      = filtered + glcounters.total_issued();
+    ImGui::Text("GL state calls filtered: %lu/%lu", filtered, total);
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("%s", glcounters.to_string().c_str());
+    }
+
+    auto const& occlusion = zs.gfx_state.occlusion.stats();
+    ImGui::Text("occluded: %lu/%lu (%lu occluder tris)", occlusion.num_culled,
+                occlusion.num_tested, occlusion.num_triangles);
     ImGui::Text("FPS(avg): %.1f", framerate);
     ImGui::Text("ms/frame: %.3f", ms_frame);
   };
@@ -307,7 +320,7 @@ draw_debugoverlay_window(EngineState& es, DrawState& ds)
   auto const vp                   = Viewport::from_frustum(es.frustum);
   auto const [window_w, window_h] = vp.size();
   ImVec2 const offset{100, 50};
-  auto const   chat_w = 300, chat_h = 100;
+  auto const   chat_w = 300, chat_h = 140;
   auto const   chat_x = window_w - chat_w - offset.x, chat_y = chat_h - offset.y;
   ImVec2 const chat_pos{chat_x, chat_y};
   ImGui::SetNextWindowPos(chat_pos);
@@ -605,7 +618,7 @@ draw(FrameState& fs, Camera& camera, StaticRenderers& srs, DrawState& ds)
 
   auto& player = find_player(registry);
   draw_chatwindow(es, player);
-  draw_debugoverlay_window(es, ds);
+  draw_debugoverlay_window(es, zs, ds);
 
   auto& inventory = player.inventory;
   if (inventory.is_open()) {
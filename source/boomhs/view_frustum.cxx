@@ -8,7 +8,6 @@
 #include <common/type_macros.hpp>
 
 using namespace boomhs;
-using namespace opengl;
 
 // Algorithm(s) adopted/modified from:
 // https://github.com/gametutorials/tutorials/blob/master/OpenGL/Frustum%20Culling/Frustum.cpp
@@ -0,0 +1,186 @@
+#include <boomhs/billboard.hpp>
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/item.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/mesh_lod.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/occlusion.hpp>
+#include <boomhs/player.hpp>
+#include <boomhs/tree.hpp>
+#include <boomhs/view_frustum.hpp>
+#include <boomhs/visibility.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <cstdint>
+
+using namespace boomhs;
+
+namespace
+{
+
+auto constexpr NUM_BUCKETS = static_cast<size_t>(RenderBucket::MAX);
+auto constexpr NUM_PASSES  = static_cast<size_t>(VisibilityPass::MAX);
+
+using BucketMask = uint32_t;
+static_assert(NUM_BUCKETS <= 32, "BucketMask too small");
+
+BucketMask
+bit(RenderBucket const b)
+{
+  return BucketMask{1} << static_cast<size_t>(b);
+}
+
+// The buckets the entity belongs to, matching the views the entity renderers draw.
+BucketMask
+classify(EntityRegistry& registry, EntityID const eid)
+{
+  BucketMask mask     = 0;
+  bool const textured = registry.has<TextureRenderable>(eid);
+  if (textured && registry.has<Torch>(eid)) {
+    mask |= bit(RenderBucket::Torch);
+  }
+  if (textured && registry.has<Book>(eid)) {
+    mask |= bit(RenderBucket::Book);
+  }
+  if (textured && registry.has<Weapon>(eid)) {
+    mask |= bit(RenderBucket::Weapon);
+  }
+  if (registry.has<JunkEntityFromFILE>(eid)) {
+    mask |= bit(RenderBucket::Junk);
+  }
+  if (registry.has<TreeComponent>(eid)) {
+    mask |= bit(RenderBucket::Tree);
+  }
+  if (registry.has<CubeRenderable>(eid) && registry.has<PointLight>(eid)) {
+    mask |= bit(RenderBucket::Pointlight);
+  }
+  if (registry.has<MeshRenderable>(eid) && registry.has<NPCData>(eid)) {
+    mask |= bit(RenderBucket::NPC);
+  }
+  if (registry.has<MeshRenderable>(eid) && registry.has<Player>(eid)) {
+    mask |= bit(RenderBucket::Player);
+  }
+  if (textured && registry.has<BillboardRenderable>(eid) && registry.has<OrbitalBody>(eid)) {
+    mask |= bit(RenderBucket::OrbitalBody);
+  }
+  return mask;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// VisibleSet
+size_t
+VisibleSet::size() const
+{
+  size_t total = 0;
+  for (auto const& bucket : buckets_) {
+    total += bucket.size();
+  }
+  return total;
+}
+
+void
+VisibleSet::clear()
+{
+  for (auto& bucket : buckets_) {
+    bucket.clear();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Visibility
+void
+Visibility::begin()
+{
+  for (auto& p : passes_) {
+    p.active = false;
+    p.visible.clear();
+  }
+}
+
+void
+Visibility::add_pass(VisibilityPass const p, glm::mat4 const& view, glm::mat4 const& proj)
+{
+  auto& pass  = this->pass(p);
+  pass.view   = view;
+  pass.proj   = proj;
+  pass.active = true;
+}
+
+void
+Visibility::build(EntityRegistry& registry, OcclusionBuffer& occlusion, bool const mesh_lods)
+{
+  // The frustum of each pass is extracted once, instead of once per entity drawn.
+  std::array<ViewFrustum, NUM_PASSES> frusta;
+  std::array<glm::mat4, NUM_PASSES>   camera_matrices;
+  FOR(i, NUM_PASSES)
+  {
+    auto const& p = passes_[i];
+    if (p.active) {
+      frusta[i].recalculate(p.view, p.proj);
+      camera_matrices[i] = p.proj * p.view;
+    }
+  }
+
+  for (auto const eid : registry.view<ShaderName, Transform, IsRenderable, AABoundingBox>()) {
+    if (registry.get<IsRenderable>(eid).hidden) {
+      continue;
+    }
+    auto const mask = classify(registry, eid);
+    if (0 == mask) {
+      continue;
+    }
+
+    // Same bounding sphere as ViewFrustum::bbox_inside, centered on the world matrix the entity is
+    // drawn (and occlusion tested) with.
+    auto const&     cube         = registry.get<AABoundingBox>(eid).cube;
+    auto const&     model_matrix = registry.get<WorldMatrix>(eid).value;
+    glm::vec3 const translation  = model_matrix[3];
+    float const     halfsize     = glm::length(cube.max - cube.min) / 2.0f;
+
+    FOR(i, NUM_PASSES)
+    {
+      auto& p = passes_[i];
+      if (!p.active || !frusta[i].cube_in_frustum(translation, halfsize)) {
+        continue;
+      }
+      if (!occlusion.visible(camera_matrices[i], model_matrix, cube)) {
+        continue;
+      }
+      FOR(b, NUM_BUCKETS)
+      {
+        if (mask & (BucketMask{1} << b)) {
+          p.visible.bucket(static_cast<RenderBucket>(b)).emplace_back(eid);
+        }
+      }
+
+      if (i == static_cast<size_t>(VisibilityPass::Camera) && registry.has<MeshLodState>(eid)) {
+        auto& state = registry.get<MeshLodState>(eid);
+        if (mesh_lods) {
+          auto const& tr   = registry.get<Transform>(eid);
+          auto const& bbox = registry.get<AABoundingBox>(eid);
+          auto const  size = LodSelector::screen_size(p.view, p.proj, tr, bbox);
+          state.lod        = LodSelector::select(size, state.lod, state.num_lods);
+        }
+        else {
+          state.lod = 0;
+        }
+      }
+    }
+  }
+}
+
+VisibleSet const*
+Visibility::find(VisibilityPass const p) const
+{
+  auto const& pass = this->pass(p);
+  return pass.active ? &pass.visible : nullptr;
+}
+
+} // namespace boomhs
@@ -1,54 +1,19 @@
 #include <boomhs/bounding_object.hpp>
-#include <boomhs/camera.hpp>
 #include <boomhs/components.hpp>
 #include <boomhs/entity.hpp>
-#include <boomhs/level_manager.hpp>
 #include <boomhs/mesh.hpp>
-#include <boomhs/terrain.hpp>
 #include <boomhs/water.hpp>
 
-#include <opengl/buffer.hpp>
-#include <opengl/gpu.hpp>
-#include <opengl/shader.hpp>
-
-#include <boomhs/random.hpp>
 #include <common/log.hpp>
 
 #include <cassert>
 #include <extlibs/fmt.hpp>
-#include <extlibs/glew.hpp>
 
 using namespace boomhs;
-using namespace opengl;
-using namespace gl_sdl;
 
 namespace boomhs
 {
 
-ShaderProgram&
-graphics_mode_to_water_shader(common::Logger& logger, GameGraphicsMode const dwo,
-                              ShaderPrograms& sps)
-{
-  ShaderProgram* sp = nullptr;
-
-  switch (dwo) {
-  case GameGraphicsMode::Basic:
-    sp = &sps.ref_sp(logger, "water_basic");
-    break;
-  case GameGraphicsMode::Medium:
-    sp = &sps.ref_sp(logger, "water_medium");
-    break;
-  case GameGraphicsMode::Advanced:
-    sp = &sps.ref_sp(logger, "water_advanced");
-    break;
-  default:
-    std::abort();
-  }
-
-  assert(sp);
-  return *sp;
-}
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // WaterFactory
 ObjData
@@ -71,25 +36,11 @@ WaterFactory::generate_water_data(common::Logger& logger, glm::vec2 const& dimen
 }
 
 WaterInfo&
-WaterFactory::make_default(common::Logger& logger, ShaderPrograms& sps, TextureTable& ttable,
-                           EntityID const eid, EntityRegistry& registry)
+WaterFactory::make_default(common::Logger& logger, EntityID const eid, EntityRegistry& registry)
 {
   LOG_TRACE("Generating water");
 
-  auto texture_o = ttable.find("water-diffuse");
-  assert(texture_o);
-  auto& ti = *texture_o;
-
-  ti.while_bound(logger, [&]() {
-    ti.set_fieldi(GL_TEXTURE_WRAP_S, GL_REPEAT);
-    ti.set_fieldi(GL_TEXTURE_WRAP_T, GL_REPEAT);
-    ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    ti.set_fieldi(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  });
-  LOG_TRACE("Finished generating water");
-
   auto& wi        = registry.assign<WaterInfo>(eid);
-  wi.tinfo        = &ti;
   wi.dimensions   = glm::vec2{20};
   wi.num_vertexes = 4;
 
@@ -105,8 +56,9 @@ WaterFactory::make_default(common::Logger& logger, ShaderPrograms& sps, TextureT
 
   auto const min = glm::vec3{0, -WATER_HEIGHT, 0};
   auto const max = glm::vec3{xdim, WATER_HEIGHT, zdim};
-  AABoundingBox::add_to_entity(logger, sps, eid, registry, min, max);
+  AABoundingBox::add_to_entity(eid, registry, min, max);
 
+  LOG_TRACE("Finished generating water");
   return wi;
 }
 
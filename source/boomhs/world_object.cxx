@@ -1,7 +1,4 @@
-#include <boomhs/camera.hpp>
 #include <boomhs/components.hpp>
-#include <boomhs/level_manager.hpp>
-#include <boomhs/terrain.hpp>
 #include <boomhs/world_object.hpp>
 
 #include <boomhs/math.hpp>
@@ -62,7 +59,7 @@ WorldObject::rotate_degrees(float const angle, EulerAxis const axis)
 }
 
 void
-WorldObject::rotate_to_match_camera_rotation(Camera const& camera)
+WorldObject::rotate_to_match_camera_rotation(glm::vec3 const& camera_eye_forward)
 {
   // General procedure:
   //
@@ -75,7 +72,7 @@ WorldObject::rotate_to_match_camera_rotation(Camera const& camera)
   // The result is the object is facing the same direction as the camera on the XZ plane.
   //
   // NOTE: Camera "forward" is actually reverse due to -Z being +Z in eyespace.
-  glm::vec3 camera_wo_fwd = -camera.eye_forward();
+  glm::vec3 camera_wo_fwd = -camera_eye_forward;
   camera_wo_fwd.y         = 0;
   camera_wo_fwd           = glm::normalize(camera_wo_fwd);
 
@@ -0,0 +1,966 @@
+#include <boomhs/zone_snapshot.hpp>
+#include <boomhs/billboard.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/item.hpp>
+#include <boomhs/leveldata.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/material.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/player.hpp>
+
+#include <common/algorithm.hpp>
+#include <common/binary_io.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
+using namespace boomhs;
+
+namespace
+{
+
+std::array<char, 4> constexpr MAGIC = {'B', 'H', 'S', 'Z'};
+uint32_t constexpr VERSION          = 2;
+
+// Identifies the component stored in a column.
+//
+// These values are part of the file format; never change or re-use a value, only append.
+enum class Column : uint32_t
+{
+  Transform = 1,
+  Parent,
+  OrbitalBody,
+  Selectable,
+  IsRenderable,
+  Torch,
+  LightFlicker,
+  CubeRenderable,
+  PointLight,
+  Material,
+  Color,
+  BillboardRenderable,
+  Name,
+  ShaderName,
+  MeshRenderable,
+  NPCData,
+  Item,
+  Player,
+  TextureRenderable,
+  Book,
+  Weapon,
+};
+
+using Buffer = ZoneSnapshot::Buffer;
+using Reader = common::ByteReader;
+using Writer = common::ByteWriter;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// saving
+//
+// Every column starts with it's Column id, the number of components and the size (in bytes) of
+// the rest of the column. The size allows skipping columns a reader doesn't know about.
+size_t
+begin_column(Writer& w, Column const column, size_t const count)
+{
+  w.write(static_cast<uint32_t>(column));
+  w.write(static_cast<uint32_t>(count));
+
+  auto const size_offset = w.size();
+  w.write(uint64_t{0});
+  return size_offset;
+}
+
+void
+end_column(Writer& w, size_t const size_offset)
+{
+  uint64_t const num_bytes = w.size() - size_offset - sizeof(uint64_t);
+  w.patch(size_offset, num_bytes);
+}
+
+void
+write_bool(Writer& w, bool const value)
+{
+  w.write(static_cast<uint8_t>(value));
+}
+
+template <typename T>
+void
+save_pod_column(Writer& w, EntityRegistry const& registry, Column const column)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "POD columns are memcpy'd");
+
+  auto const count       = registry.size<T>();
+  auto const size_offset = begin_column(w, column, count);
+  w.write_bytes(registry.data<T>(), count * sizeof(EntityID));
+  w.write_bytes(registry.raw<T>(), count * sizeof(T));
+  end_column(w, size_offset);
+}
+
+// Columns of components that are written one at a time by "save_fn".
+template <typename T, typename SaveFN>
+void
+save_column(Writer& w, EntityRegistry const& registry, Column const column, SaveFN const& save_fn)
+{
+  auto const  count       = registry.size<T>();
+  auto const* components  = registry.raw<T>();
+  auto const  size_offset = begin_column(w, column, count);
+  w.write_bytes(registry.data<T>(), count * sizeof(EntityID));
+  for (size_t i = 0; i < count; ++i) {
+    save_fn(w, components[i]);
+  }
+  end_column(w, size_offset);
+}
+
+template <typename T>
+void
+save_string_column(Writer& w, EntityRegistry const& registry, Column const column,
+                   std::string T::*const member)
+{
+  auto const save = [&member](Writer& w, T const& component) {
+    w.write_string(component.*member);
+  };
+  save_column<T>(w, registry, column, save);
+}
+
+void
+save_npcdata(Writer& w, NPCData const& npc)
+{
+  // The name points into NPC::NAMES, it's index is stored instead of the pointer.
+  auto const name_index = NPC::name_index(npc.name);
+  assert(name_index);
+  w.write(static_cast<uint32_t>(*name_index));
+  w.write(npc.health);
+  w.write(static_cast<int32_t>(npc.level));
+  w.write(static_cast<uint32_t>(npc.alignment));
+}
+
+void
+save_item(Writer& w, Item const& item)
+{
+  w.write_string(item.name);
+  w.write_string(item.tooltip);
+  w.write_string(item.ui_texture);
+  write_bool(w, item.is_pickedup);
+
+  auto const& owners = item.all_owners();
+  w.write(static_cast<uint32_t>(owners.size()));
+  for (auto const& owner : owners) {
+    w.write_string(owner.value);
+  }
+}
+
+void
+save_player(Writer& w, Player const& player)
+{
+  w.write(player.hp);
+  w.write(static_cast<int32_t>(player.level));
+  w.write_string(player.name);
+  write_bool(w, player.is_attacking);
+  w.write(static_cast<int32_t>(player.damage));
+  w.write(player.speed);
+
+  auto const& inventory = player.inventory;
+  write_bool(w, inventory.is_open());
+  w.write(static_cast<uint32_t>(Inventory::MAX_ITEMS));
+  FOR(i, Inventory::MAX_ITEMS)
+  {
+    auto const& slot = inventory.slot(i);
+    write_bool(w, slot.occupied());
+    w.write(slot.occupied() ? slot.eid() : EntityIDMAX);
+  }
+}
+
+void
+save_leveldata(Writer& w, LevelData const& ldata)
+{
+  w.write(ldata.fog.density);
+  w.write(ldata.fog.gradient);
+  w.write(ldata.fog.color);
+  w.write(ldata.wind.speed);
+  w.write(ldata.global_light.ambient);
+  w.write(ldata.global_light.directional);
+  w.write(ldata.time_offset);
+  w.write(ldata.skybox.transform());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// loading
+//
+// A snapshot is decoded and checked completely before the zone is modified, so loading a corrupt
+// snapshot leaves the zone as it was. Decoding a column stages a function that copies the column
+// into the registry; the staged functions run once every column decoded and passed the checks.
+struct CommitContext
+{
+  EntityRegistry& registry;
+
+  // The entities destroyed after the snapshot was taken are created again, under new id's
+  // (saved id, new id, sorted by the saved id).
+  std::vector<std::pair<EntityID, EntityID>> recreated;
+
+  EntityID remap(EntityID const eid) const
+  {
+    auto const cmp = [](auto const& pair, EntityID const e) { return pair.first < e; };
+    auto const it  = std::lower_bound(recreated.cbegin(), recreated.cend(), eid, cmp);
+    return (it != recreated.cend() && it->first == eid) ? it->second : eid;
+  }
+
+  void remap(std::vector<EntityID>& eids) const
+  {
+    if (recreated.empty()) {
+      return;
+    }
+    for (auto& eid : eids) {
+      eid = remap(eid);
+    }
+  }
+};
+
+using CommitFn = std::function<void(CommitContext&)>;
+
+// The LevelData values held by a snapshot.
+struct SavedLevelData
+{
+  float            fog_density, fog_gradient;
+  ColorRGBA        fog_color;
+  float            wind_speed;
+  ColorRGB         ambient;
+  DirectionalLight directional;
+  float            time_offset;
+  Transform        skybox;
+};
+
+// The Player's values held by a snapshot.
+struct SavedPlayer
+{
+  EntityID     eid;
+  HealthPoints hp;
+  int32_t      level;
+  std::string  name;
+  bool         is_attacking;
+  int32_t      damage;
+  float        speed;
+
+  bool                                 inventory_open;
+  std::vector<std::optional<EntityID>> inventory;
+};
+
+struct LoadContext
+{
+  common::Logger&       logger;
+  EntityRegistry const& registry;
+
+  SavedLevelData        leveldata;
+  std::optional<SavedPlayer> player;
+
+  // The entities alive when the snapshot was taken (sorted).
+  std::vector<EntityID> saved_entities;
+
+  std::vector<CommitFn> columns;
+
+  // What the snapshot says about the items, to check it agrees with itself before committing:
+  // the items (and whether they were picked up), the entities with a Parent and the hidden ones.
+  std::vector<std::pair<EntityID, bool>> items;
+  std::vector<EntityID>                  parented, hidden;
+
+  LoadContext(common::Logger& l, EntityRegistry const& r)
+      : logger(l)
+      , registry(r)
+  {
+  }
+
+  bool was_saved(EntityID const eid) const
+  {
+    return std::binary_search(saved_entities.cbegin(), saved_entities.cend(), eid);
+  }
+};
+
+// Read the entity array of a column.
+//
+// The count is read from the file, it's checked against the bytes left before allocating anything.
+bool
+read_column_entities(Reader& r, uint32_t const count, std::vector<EntityID>& eids)
+{
+  if ((r.remaining() / sizeof(EntityID)) < count) {
+    return false;
+  }
+  eids.resize(count);
+  return r.read_bytes(eids.data(), count * sizeof(EntityID));
+}
+
+// Read the entity array of a column, every entity must have been alive when the snapshot was taken
+// and own at most one of the column's components.
+bool
+stage_column_entities(Reader& r, LoadContext& ctx, uint32_t const count,
+                      std::vector<EntityID>& eids)
+{
+  if (!read_column_entities(r, count, eids)) {
+    return false;
+  }
+  auto const not_saved = [&ctx](EntityID const eid) { return !ctx.was_saved(eid); };
+  if (std::any_of(eids.cbegin(), eids.cend(), not_saved)) {
+    return false;
+  }
+  auto sorted = eids;
+  std::sort(sorted.begin(), sorted.end());
+  return sorted.cend() == std::adjacent_find(sorted.cbegin(), sorted.cend());
+}
+
+// POD columns are memcpy'd straight into the components, so the bools and enums inside them are
+// checked to hold a value their type can represent first.
+bool
+is_bool(uint8_t const* value, size_t const offset)
+{
+  return value[offset] <= 1;
+}
+
+template <typename T>
+bool
+is_valid(uint8_t const*)
+{
+  return true;
+}
+
+template <>
+bool
+is_valid<Parent>(uint8_t const* value)
+{
+  return is_bool(value, offsetof(Parent, inherit_rotation)) &&
+         is_bool(value, offsetof(Parent, inherit_scale));
+}
+
+template <>
+bool
+is_valid<Selectable>(uint8_t const* value)
+{
+  return is_bool(value, offsetof(Selectable, selected));
+}
+
+template <>
+bool
+is_valid<IsRenderable>(uint8_t const* value)
+{
+  return is_bool(value, offsetof(IsRenderable, hidden));
+}
+
+template <>
+bool
+is_valid<BillboardRenderable>(uint8_t const* value)
+{
+  std::underlying_type_t<BillboardType> type;
+  std::memcpy(&type, value + offsetof(BillboardRenderable, value), sizeof(type));
+  return type >= 0 && type <= static_cast<decltype(type)>(BillboardType::INVALID);
+}
+
+// Remove "T" from the entities that don't have one in the snapshot.
+//
+// Called once the zone holds exactly the snapshot's entities, see ZoneSnapshot::load().
+template <typename T>
+void
+remove_unsaved_components(EntityRegistry& registry, std::vector<EntityID> eids)
+{
+  std::sort(eids.begin(), eids.end());
+
+  std::vector<EntityID> remove;
+  auto const*           pool = registry.data<T>();
+  for (size_t i = 0; i < registry.size<T>(); ++i) {
+    auto const eid = pool[i];
+    if (!std::binary_search(eids.cbegin(), eids.cend(), eid)) {
+      remove.emplace_back(eid);
+    }
+  }
+  for (auto const eid : remove) {
+    registry.remove<T>(eid);
+  }
+}
+
+template <typename T>
+void
+commit_pod_column(CommitContext& cc, std::vector<EntityID>& eids, uint8_t const* values)
+{
+  auto&        registry    = cc.registry;
+  size_t const count       = eids.size();
+  size_t const value_bytes = count * sizeof(T);
+  cc.remap(eids);
+
+  // Fast path, the pool holds the same entities in the same order as when the snapshot was taken
+  // (ie: reloading a save while still in the zone). Copy the whole column over the pool.
+  if (count > 0 && registry.size<T>() == count &&
+      0 == std::memcmp(registry.data<T>(), eids.data(), count * sizeof(EntityID))) {
+    std::memcpy(registry.raw<T>(), values, value_bytes);
+  }
+  else {
+    remove_unsaved_components<T>(registry, eids);
+    for (size_t i = 0; i < count; ++i) {
+      auto const  eid = eids[i];
+      auto const* src = values + (i * sizeof(T));
+      if (registry.has<T>(eid)) {
+        std::memcpy(&registry.get<T>(eid), src, sizeof(T));
+      }
+      else {
+        // Not every component is default constructible, copy the bytes into suitable storage.
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+        std::memcpy(&storage, src, sizeof(T));
+        registry.assign<T>(eid, *reinterpret_cast<T const*>(&storage));
+      }
+    }
+  }
+
+  if constexpr (std::is_same<T, Parent>::value) {
+    if (!cc.recreated.empty()) {
+      for (auto const eid : eids) {
+        auto& parent = registry.get<Parent>(eid);
+        parent.eid   = cc.remap(parent.eid);
+      }
+    }
+  }
+}
+
+template <typename T>
+bool
+stage_pod_column(Reader& r, LoadContext& ctx, uint32_t const count)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "POD columns are memcpy'd");
+  std::vector<EntityID> eids;
+  if (!stage_column_entities(r, ctx, count, eids)) {
+    return false;
+  }
+
+  // The values are copied straight out of the snapshot's buffer when the column is committed.
+  size_t const value_bytes = count * sizeof(T);
+  auto const*  values      = r.position();
+  if (!r.skip(value_bytes)) {
+    return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    auto const* value = values + (i * sizeof(T));
+    if (!is_valid<T>(value)) {
+      return false;
+    }
+    if constexpr (std::is_same<T, Parent>::value) {
+      EntityID parent_eid;
+      std::memcpy(&parent_eid, value + offsetof(Parent, eid), sizeof(parent_eid));
+      if (!ctx.was_saved(parent_eid)) {
+        return false;
+      }
+      ctx.parented.emplace_back(eids[i]);
+    }
+    else if constexpr (std::is_same<T, IsRenderable>::value) {
+      if (1 == value[offsetof(IsRenderable, hidden)]) {
+        ctx.hidden.emplace_back(eids[i]);
+      }
+    }
+  }
+
+  auto commit = [eids = MOVE(eids), values](CommitContext& cc) mutable {
+    commit_pod_column<T>(cc, eids, values);
+  };
+  ctx.columns.emplace_back(MOVE(commit));
+  return true;
+}
+
+// Replace the components "T" with the decoded values.
+template <typename T>
+void
+commit_column(CommitContext& cc, std::vector<EntityID>& eids, std::vector<T>& values)
+{
+  auto& registry = cc.registry;
+  cc.remap(eids);
+  remove_unsaved_components<T>(registry, eids);
+
+  for (size_t i = 0; i < eids.size(); ++i) {
+    auto const eid = eids[i];
+    if (registry.has<T>(eid)) {
+      registry.get<T>(eid) = MOVE(values[i]);
+    }
+    else {
+      registry.assign<T>(eid, MOVE(values[i]));
+    }
+  }
+}
+
+// Stage a column of components that are read one at a time by "read_fn", "inspect_fn" is shown
+// every component read.
+template <typename T, typename ReadFN, typename InspectFN>
+bool
+stage_column(Reader& r, LoadContext& ctx, uint32_t const count, ReadFN const& read_fn,
+             InspectFN const& inspect_fn)
+{
+  std::vector<EntityID> eids;
+  if (!stage_column_entities(r, ctx, count, eids)) {
+    return false;
+  }
+
+  std::vector<T> values;
+  values.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    std::optional<T> value = read_fn(r);
+    if (!value) {
+      return false;
+    }
+    inspect_fn(eids[i], *value);
+    values.emplace_back(MOVE(*value));
+  }
+
+  auto commit = [eids = MOVE(eids), values = MOVE(values)](CommitContext& cc) mutable {
+    commit_column<T>(cc, eids, values);
+  };
+  ctx.columns.emplace_back(MOVE(commit));
+  return true;
+}
+
+template <typename T, typename ReadFN>
+bool
+stage_column(Reader& r, LoadContext& ctx, uint32_t const count, ReadFN const& read_fn)
+{
+  auto const ignore = [](EntityID, T const&) {};
+  return stage_column<T>(r, ctx, count, read_fn, ignore);
+}
+
+// Components holding a single string, the handle of a TextureRenderable's texture is looked up again
+// (see LevelLoader::resolve_textures()).
+template <typename T>
+bool
+stage_string_column(Reader& r, LoadContext& ctx, uint32_t const count)
+{
+  auto const read = [](Reader& r) -> std::optional<T> {
+    std::string value;
+    if (!r.read_string(value)) {
+      return std::nullopt;
+    }
+    return T{MOVE(value)};
+  };
+  return stage_column<T>(r, ctx, count, read);
+}
+
+std::optional<NPCData>
+read_npcdata(Reader& r)
+{
+  uint32_t name_index = 0, alignment = 0;
+  int32_t  level      = 0;
+
+  NPCData npc;
+  if (!r.read(name_index) || !r.read(npc.health) || !r.read(level) || !r.read(alignment)) {
+    return std::nullopt;
+  }
+  if (name_index >= NPC::NAMES.size() ||
+      alignment > static_cast<uint32_t>(Alignment::NOT_SET)) {
+    return std::nullopt;
+  }
+  npc.name      = NPC::NAMES[name_index];
+  npc.level     = level;
+  npc.alignment = static_cast<Alignment>(alignment);
+  return npc;
+}
+
+bool
+stage_item_column(Reader& r, LoadContext& ctx, uint32_t const count)
+{
+  auto const read = [](Reader& r) -> std::optional<Item> {
+    Item     item;
+    uint32_t num_owners = 0;
+    if (!r.read_string(item.name) || !r.read_string(item.tooltip) ||
+        !r.read_string(item.ui_texture) || !r.read_bool(item.is_pickedup) ||
+        !r.read_count(num_owners, sizeof(uint32_t))) {
+      return std::nullopt;
+    }
+
+    std::string owner;
+    for (uint32_t i = 0; i < num_owners; ++i) {
+      if (!r.read_string(owner)) {
+        return std::nullopt;
+      }
+      item.add_owner(owner);
+    }
+    return item;
+  };
+
+  auto const inspect = [&ctx](EntityID const eid, Item const& item) {
+    ctx.items.emplace_back(eid, item.is_pickedup);
+  };
+  return stage_column<Item>(r, ctx, count, read, inspect);
+}
+
+bool
+stage_player_column(Reader& r, LoadContext& ctx, uint32_t const count)
+{
+  std::vector<EntityID> eids;
+  if (!stage_column_entities(r, ctx, count, eids)) {
+    return false;
+  }
+  if (count > 1 || (count == 1 && ctx.player)) {
+    return false;
+  }
+
+  for (auto const eid : eids) {
+    // The player isn't plain data (it refers to the world's orientation, ...) so it can't be
+    // created again, it's values are restored onto the zone's player.
+    auto&       logger   = ctx.logger;
+    auto const& registry = ctx.registry;
+    if (!registry.valid(eid) || !registry.has<Player>(eid)) {
+      LOG_ERROR("Zone snapshot's player no longer exists.");
+      return false;
+    }
+
+    SavedPlayer player;
+    player.eid         = eid;
+    uint32_t num_slots = 0;
+    if (!r.read(player.hp) || !r.read(player.level) || !r.read_string(player.name) ||
+        !r.read_bool(player.is_attacking) || !r.read(player.damage) || !r.read(player.speed) ||
+        !r.read_bool(player.inventory_open) || !r.read(num_slots) ||
+        num_slots != Inventory::MAX_ITEMS) {
+      return false;
+    }
+    FOR(i, num_slots)
+    {
+      bool     occupied = false;
+      EntityID item_eid = EntityIDMAX;
+      if (!r.read_bool(occupied) || !r.read(item_eid)) {
+        return false;
+      }
+      if (occupied && !ctx.was_saved(item_eid)) {
+        return false;
+      }
+      player.inventory.emplace_back(occupied ? std::make_optional(item_eid) : std::nullopt);
+    }
+    ctx.player = MOVE(player);
+  }
+  return true;
+}
+
+void
+commit_player(CommitContext& cc, SavedPlayer const& saved)
+{
+  auto& player        = cc.registry.get<Player>(saved.eid);
+  player.hp           = saved.hp;
+  player.level        = saved.level;
+  player.name         = saved.name;
+  player.is_attacking = saved.is_attacking;
+  player.damage       = saved.damage;
+  player.speed        = saved.speed;
+
+  auto& inventory = player.inventory;
+  if (inventory.is_open() != saved.inventory_open) {
+    inventory.toggle_open();
+  }
+  FOR(i, saved.inventory.size())
+  {
+    auto const& item_eid = saved.inventory[i];
+    if (item_eid) {
+      inventory.set_item(i, cc.remap(*item_eid));
+    }
+    else {
+      inventory.remove_item(i);
+    }
+  }
+}
+
+// The snapshot holds the items, their Parent and IsRenderable components and the inventory in
+// separate columns. Picking up an item changes all of them (see Player::pickup_entity()), check
+// they agree.
+bool
+is_consistent(LoadContext& ctx)
+{
+  std::sort(ctx.parented.begin(), ctx.parented.end());
+  std::sort(ctx.hidden.begin(), ctx.hidden.end());
+
+  std::vector<EntityID> inventory, items;
+  if (ctx.player) {
+    for (auto const& item_eid : ctx.player->inventory) {
+      if (item_eid) {
+        inventory.emplace_back(*item_eid);
+      }
+    }
+  }
+  std::sort(inventory.begin(), inventory.end());
+
+  auto const contains = [](auto const& eids, EntityID const eid) {
+    return std::binary_search(eids.cbegin(), eids.cend(), eid);
+  };
+  for (auto const& [eid, is_pickedup] : ctx.items) {
+    if (is_pickedup != contains(inventory, eid)) {
+      return false;
+    }
+    if (is_pickedup && (!contains(ctx.parented, eid) || !contains(ctx.hidden, eid))) {
+      return false;
+    }
+    items.emplace_back(eid);
+  }
+
+  // Every inventory slot holds an item.
+  std::sort(items.begin(), items.end());
+  auto const is_item = [&](EntityID const eid) { return contains(items, eid); };
+  return std::all_of(inventory.cbegin(), inventory.cend(), is_item);
+}
+
+bool
+stage_column(Reader& r, LoadContext& ctx, uint32_t const column, uint32_t const count)
+{
+  switch (static_cast<Column>(column)) {
+  case Column::Transform:
+    return stage_pod_column<Transform>(r, ctx, count);
+  case Column::Parent:
+    return stage_pod_column<Parent>(r, ctx, count);
+  case Column::OrbitalBody:
+    return stage_pod_column<OrbitalBody>(r, ctx, count);
+  case Column::Selectable:
+    return stage_pod_column<Selectable>(r, ctx, count);
+  case Column::IsRenderable:
+    return stage_pod_column<IsRenderable>(r, ctx, count);
+  case Column::Torch:
+    return stage_pod_column<Torch>(r, ctx, count);
+  case Column::LightFlicker:
+    return stage_pod_column<LightFlicker>(r, ctx, count);
+  case Column::CubeRenderable:
+    return stage_pod_column<CubeRenderable>(r, ctx, count);
+  case Column::PointLight:
+    return stage_pod_column<PointLight>(r, ctx, count);
+  case Column::Material:
+    return stage_pod_column<Material>(r, ctx, count);
+  case Column::Color:
+    return stage_pod_column<Color>(r, ctx, count);
+  case Column::BillboardRenderable:
+    return stage_pod_column<BillboardRenderable>(r, ctx, count);
+  case Column::Name:
+    return stage_string_column<Name>(r, ctx, count);
+  case Column::ShaderName:
+    return stage_string_column<ShaderName>(r, ctx, count);
+  case Column::MeshRenderable:
+    return stage_string_column<MeshRenderable>(r, ctx, count);
+  case Column::NPCData:
+    return stage_column<NPCData>(r, ctx, count, read_npcdata);
+  case Column::Item:
+    return stage_item_column(r, ctx, count);
+  case Column::Player:
+    return stage_player_column(r, ctx, count);
+  case Column::TextureRenderable:
+    return stage_string_column<TextureRenderable>(r, ctx, count);
+  case Column::Book:
+    return stage_pod_column<Book>(r, ctx, count);
+  case Column::Weapon:
+    return stage_pod_column<Weapon>(r, ctx, count);
+  }
+
+  // Written by a newer version of the game, skip it.
+  auto& logger = ctx.logger;
+  LOG_WARN_SPRINTF("Skipping unknown zone snapshot column %u.", column);
+  return true;
+}
+
+bool
+read_leveldata(Reader& r, SavedLevelData& saved)
+{
+  return r.read(saved.fog_density) && r.read(saved.fog_gradient) && r.read(saved.fog_color) &&
+         r.read(saved.wind_speed) && r.read(saved.ambient) && r.read(saved.directional) &&
+         r.read(saved.time_offset) && r.read(saved.skybox);
+}
+
+void
+commit_leveldata(SavedLevelData const& saved, LevelData& ldata)
+{
+  ldata.fog.density              = saved.fog_density;
+  ldata.fog.gradient             = saved.fog_gradient;
+  ldata.fog.color                = saved.fog_color;
+  ldata.wind.speed               = saved.wind_speed;
+  ldata.global_light.ambient     = saved.ambient;
+  ldata.global_light.directional = saved.directional;
+  ldata.time_offset              = saved.time_offset;
+  ldata.skybox.transform()       = saved.skybox;
+}
+
+// Make the zone hold exactly the entities alive when the snapshot was taken: destroy the ones
+// created after it was taken, create the ones destroyed after it was taken again.
+void
+commit_entities(LoadContext const& ctx, CommitContext& cc, EntityArray& recreated)
+{
+  auto& registry = cc.registry;
+
+  std::vector<EntityID> unsaved;
+  registry.each([&](auto const eid) {
+    if (!ctx.was_saved(eid)) {
+      unsaved.emplace_back(eid);
+    }
+  });
+  for (auto const eid : unsaved) {
+    registry.destroy(eid);
+  }
+
+  for (auto const eid : ctx.saved_entities) {
+    if (!registry.valid(eid)) {
+      auto const new_eid = registry.create();
+      cc.recreated.emplace_back(eid, new_eid);
+      recreated.emplace_back(new_eid);
+    }
+  }
+}
+
+// Walk the sections of a snapshot (starting after the version), checking every section is
+// complete.
+bool
+validate_layout(Reader r)
+{
+  uint64_t leveldata_bytes = 0;
+  if (!r.read(leveldata_bytes) || !r.skip(leveldata_bytes)) {
+    return false;
+  }
+
+  uint32_t num_entities = 0;
+  if (!r.read(num_entities) || (r.remaining() / sizeof(EntityID)) < num_entities ||
+      !r.skip(num_entities * sizeof(EntityID))) {
+    return false;
+  }
+
+  uint32_t num_columns = 0;
+  if (!r.read(num_columns)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    uint32_t column = 0, count = 0;
+    uint64_t num_bytes = 0;
+    if (!r.read(column) || !r.read(count) || !r.read(num_bytes) || !r.skip(num_bytes)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ZoneSnapshot
+ZoneSnapshot::Buffer
+ZoneSnapshot::save(LevelData const& ldata, EntityRegistry const& registry)
+{
+  Buffer buffer;
+  Writer w{buffer};
+  w.write(MAGIC);
+  w.write(VERSION);
+  {
+    auto const size_offset = w.size();
+    w.write(uint64_t{0});
+    save_leveldata(w, ldata);
+    w.patch(size_offset, static_cast<uint64_t>(w.size() - size_offset - sizeof(uint64_t)));
+  }
+
+  std::vector<EntityID> entities;
+  registry.each([&entities](auto const eid) { entities.emplace_back(eid); });
+  w.write(static_cast<uint32_t>(entities.size()));
+  w.write_bytes(entities.data(), entities.size() * sizeof(EntityID));
+
+  uint32_t constexpr NUM_COLUMNS = static_cast<uint32_t>(Column::Weapon);
+  w.write(NUM_COLUMNS);
+  save_pod_column<Transform>(w, registry, Column::Transform);
+  save_pod_column<Parent>(w, registry, Column::Parent);
+  save_pod_column<OrbitalBody>(w, registry, Column::OrbitalBody);
+  save_pod_column<Selectable>(w, registry, Column::Selectable);
+  save_pod_column<IsRenderable>(w, registry, Column::IsRenderable);
+  save_pod_column<Torch>(w, registry, Column::Torch);
+  save_pod_column<LightFlicker>(w, registry, Column::LightFlicker);
+  save_pod_column<CubeRenderable>(w, registry, Column::CubeRenderable);
+  save_pod_column<PointLight>(w, registry, Column::PointLight);
+  save_pod_column<Material>(w, registry, Column::Material);
+  save_pod_column<Color>(w, registry, Column::Color);
+  save_pod_column<BillboardRenderable>(w, registry, Column::BillboardRenderable);
+  save_string_column<Name>(w, registry, Column::Name, &Name::value);
+  save_string_column<ShaderName>(w, registry, Column::ShaderName, &ShaderName::value);
+  save_string_column<MeshRenderable>(w, registry, Column::MeshRenderable, &MeshRenderable::name);
+  save_column<NPCData>(w, registry, Column::NPCData, save_npcdata);
+  save_column<Item>(w, registry, Column::Item, save_item);
+  save_column<Player>(w, registry, Column::Player, save_player);
+  save_string_column<TextureRenderable>(w, registry, Column::TextureRenderable,
+                                        &TextureRenderable::texture);
+  save_pod_column<Book>(w, registry, Column::Book);
+  save_pod_column<Weapon>(w, registry, Column::Weapon);
+  return buffer;
+}
+
+Result<EntityArray, std::string>
+ZoneSnapshot::load(common::Logger& logger, LevelData& ldata, EntityRegistry& registry,
+                   Buffer const& buffer)
+{
+  Reader r{buffer};
+
+  std::array<char, 4> magic;
+  uint32_t            version = 0;
+  if (!r.read(magic) || magic != MAGIC) {
+    return ErrCString("Not a zone snapshot.");
+  }
+  if (!r.read(version) || version != VERSION) {
+    return Err(fmt::sprintf("Zone snapshot has version %u, expected %u.", version, VERSION));
+  }
+  if (!validate_layout(r)) {
+    return ErrCString("Zone snapshot is truncated.");
+  }
+
+  // Decode and check the whole snapshot before modifying the zone.
+  LoadContext ctx{logger, registry};
+
+  uint64_t leveldata_bytes = 0;
+  r.read(leveldata_bytes);
+  Reader leveldata{r};
+  r.skip(leveldata_bytes);
+  if (!read_leveldata(leveldata, ctx.leveldata)) {
+    return ErrCString("Zone snapshot level data is truncated.");
+  }
+
+  uint32_t num_entities = 0;
+  r.read(num_entities);
+  read_column_entities(r, num_entities, ctx.saved_entities);
+  std::sort(ctx.saved_entities.begin(), ctx.saved_entities.end());
+
+  uint32_t num_columns = 0;
+  r.read(num_columns);
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    uint32_t column = 0, count = 0;
+    uint64_t num_bytes = 0;
+    r.read(column);
+    r.read(count);
+    r.read(num_bytes);
+
+    Reader column_reader{r};
+    r.skip(num_bytes);
+    if (!stage_column(column_reader, ctx, column, count)) {
+      return Err(fmt::sprintf("Zone snapshot column %u is corrupt.", column));
+    }
+  }
+  if (!is_consistent(ctx)) {
+    return ErrCString("Zone snapshot's items disagree with the player's inventory.");
+  }
+
+  // Everything decoded, commit the snapshot to the zone.
+  EntityArray   recreated;
+  CommitContext cc{registry, {}};
+  commit_leveldata(ctx.leveldata, ldata);
+  commit_entities(ctx, cc, recreated);
+  for (auto& commit : ctx.columns) {
+    commit(cc);
+  }
+  if (ctx.player) {
+    commit_player(cc, *ctx.player);
+  }
+
+  // The selected target may be gone, the targets are found again next frame.
+  ldata.nearby_targets.clear();
+
+  if (!recreated.empty()) {
+    LOG_INFO_SPRINTF("Zone snapshot: created %lu entities destroyed after it was taken.",
+                     recreated.size());
+  }
+  return OK_MOVE(recreated);
+}
+
+} // namespace boomhs
@@ -0,0 +1,64 @@
+#include <boomhs/zone_snapshot.hpp>
+#include <boomhs/boomhs.hpp>
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/level_loader.hpp>
+#include <boomhs/zone_state.hpp>
+
+#include <common/binary_io.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
+using namespace boomhs;
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ZoneSnapshot
+ZoneSnapshot::Buffer
+ZoneSnapshot::save(ZoneState& zs)
+{
+  return save(zs.level_data, zs.registry);
+}
+
+Result<common::none_t, std::string>
+ZoneSnapshot::load(common::Logger& logger, ZoneState& zs, Buffer const& buffer)
+{
+  auto&      registry  = zs.registry;
+  auto const recreated = TRY_MOVEOUT(load(logger, zs.level_data, registry, buffer));
+
+  // The snapshot only holds plain data, give the entities it created again what the renderer needs
+  // to draw them (the same way the zone's entities got them when it was uploaded).
+  auto& gfx_state = zs.gfx_state;
+  LevelLoader::resolve_textures(logger, gfx_state.texture_table, registry);
+  for (auto const eid : recreated) {
+    copy_entity_gpu(logger, gfx_state.sps, gfx_state.texture_table, registry,
+                    gfx_state.draw_handles, eid);
+  }
+  AABoundingBox::add_to_all_entities(logger, zs.level_data.obj_store, registry);
+  return OK_NONE;
+}
+
+Result<common::none_t, std::string>
+ZoneSnapshot::save_to_file(ZoneState& zs, std::string const& path)
+{
+  if (!common::write_file_bytes(path, save(zs))) {
+    return Err(fmt::sprintf("Could not write zone snapshot to '%s'.", path));
+  }
+  return OK_NONE;
+}
+
+Result<common::none_t, std::string>
+ZoneSnapshot::load_from_file(common::Logger& logger, ZoneState& zs, std::string const& path)
+{
+  Buffer buffer;
+  if (!common::read_file_bytes(path, buffer)) {
+    return Err(fmt::sprintf("Could not open '%s' for reading.", path));
+  }
+  return load(logger, zs, buffer);
+}
+
+} // namespace boomhs
@@ -0,0 +1,293 @@
+#include <boomhs/boomhs.hpp>
+#include <boomhs/engine.hpp>
+#include <boomhs/level_manager.hpp>
+#include <boomhs/random.hpp>
+#include <boomhs/zone_streamer.hpp>
+
+#include <opengl/texture.hpp>
+
+#include <common/phase_timer.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
+using namespace boomhs;
+using namespace opengl;
+
+namespace
+{
+
+bool
+level_exists(int const floor_number)
+{
+  std::ifstream const file{"levels/" + floornumber_to_levelfilename(floor_number)};
+  return file.good();
+}
+
+// Estimate the memory used by the zone, the mesh data (kept on the CPU and copied to the GPU) and
+// the textures.
+size_t
+estimate_num_bytes(ZoneState const& zs)
+{
+  size_t bytes = zs.level_data.obj_store.num_bytes();
+  for (auto const& it : zs.gfx_state.texture_table) {
+    auto const&  ti       = *it.second;
+    size_t const faces    = (ti.target == GL_TEXTURE_CUBE_MAP) ? 6 : 1;
+    size_t const channels = (ti.format == GL_RGB) ? 3 : 4;
+    bytes += faces * channels * ti.width * ti.height;
+  }
+  return bytes;
+}
+
+} // namespace
+
+namespace boomhs
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ZoneStreamer
+ZoneStreamer::ZoneStreamer(WorldOrientation const& wo, uint64_t const seed,
+                           size_t const memory_budget)
+    : wo_(wo)
+    , seed_(seed)
+    , memory_budget_(memory_budget)
+{
+}
+
+ZoneStreamer::PendingIterator
+ZoneStreamer::find_pending(int const floor)
+{
+  auto const cmp = [&floor](auto const& pz) { return pz.floor == floor; };
+  return std::find_if(pending_.begin(), pending_.end(), cmp);
+}
+
+bool
+ZoneStreamer::is_pending(int const floor) const
+{
+  auto const cmp = [&floor](auto const& pz) { return pz.floor == floor; };
+  return std::any_of(pending_.cbegin(), pending_.cend(), cmp);
+}
+
+bool
+ZoneStreamer::is_unavailable(int const floor) const
+{
+  return std::find(unavailable_.cbegin(), unavailable_.cend(), floor) != unavailable_.cend();
+}
+
+void
+ZoneStreamer::start_reading(common::Logger& logger, int const floor, std::launch const policy)
+{
+  PendingZone pz;
+  pz.floor = floor;
+  pz.read  = std::async(policy, [&logger, floor]() {
+    // The logger's queue takes messages from any thread, the loading thread logs through it too.
+    return LevelLoader::read_level(logger, floornumber_to_levelfilename(floor));
+  });
+  pending_.emplace_back(MOVE(pz));
+}
+
+size_t
+ZoneStreamer::memory_used() const
+{
+  size_t bytes = 0;
+  for (auto const& lz : loaded_) {
+    bytes += lz.num_bytes;
+  }
+  return bytes;
+}
+
+bool
+ZoneStreamer::is_ready(LevelManager const& lm, int const floor) const
+{
+  return lm.is_loaded(floor) && !is_pending(floor);
+}
+
+void
+ZoneStreamer::preload(EngineState& es, LevelManager const& lm, int const floor)
+{
+  auto& logger = es.logger;
+
+  bool const in_range = floor >= 0 && floor < lm.num_levels();
+  if (!in_range || lm.is_loaded(floor) || is_pending(floor) || is_unavailable(floor)) {
+    return;
+  }
+  if (!level_exists(floor)) {
+    LOG_DEBUG_SPRINTF("Floor %i has no level, not preloading it.", floor);
+    unavailable_.emplace_back(floor);
+    return;
+  }
+  LOG_INFO_SPRINTF("Preloading floor %i ...", floor);
+  start_reading(logger, floor, std::launch::async);
+}
+
+void
+ZoneStreamer::preload_neighbours(EngineState& es, LevelManager const& lm)
+{
+  auto const active = lm.active_zone();
+  preload(es, lm, active - 1);
+  preload(es, lm, active + 1);
+}
+
+Result<bool, std::string>
+ZoneStreamer::step(EngineState& es, Engine& engine, LevelManager& lm, PendingZone& pz)
+{
+  auto&      logger   = es.logger;
+  auto const floor    = pz.floor;
+  auto&      registry = engine.registries[floor];
+
+  switch (pz.step) {
+  case LoadStep::INSTANTIATE: {
+    // Blocks if the background thread hasn't finished reading the level.
+    auto source = TRY_MOVEOUT(pz.read.get());
+    pz.assets.emplace(
+        TRY_MOVEOUT(LevelLoader::instantiate_level(logger, registry, MOVE(source))));
+    pz.step = LoadStep::GENERATE;
+    return Ok(false);
+  }
+  case LoadStep::GENERATE: {
+    RNG  rng{seed_ + floor};
+    auto zs = TRY_MOVEOUT(create_zone(es, registry, MOVE(*pz.assets), floor, wo_, rng));
+    pz.assets.reset();
+
+    lm.add_zone(floor, MOVE(zs));
+    pz.step = LoadStep::UPLOAD;
+    return Ok(false);
+  }
+  case LoadStep::UPLOAD:
+    return upload_zone_gpu(es, lm.zone(floor), pz.upload, UPLOADS_PER_STEP);
+  }
+
+  std::abort();
+}
+
+Result<bool, std::string>
+ZoneStreamer::advance(EngineState& es, Engine& engine, LevelManager& lm, PendingIterator const it)
+{
+  auto&      logger = es.logger;
+  auto const floor  = it->floor;
+
+  auto result = step(es, engine, lm, *it);
+  if (!result) {
+    // Throw away whatever part of the zone was already created.
+    pending_.erase(it);
+    engine.registries[floor].clear();
+    if (lm.is_loaded(floor)) {
+      lm.remove_zone(floor);
+    }
+    unavailable_.emplace_back(floor);
+    return Err(fmt::sprintf("Error loading floor %i: %s", floor, result.unwrapErrMove()));
+  }
+
+  bool const finished = result.expect_moveout("step result");
+  if (finished) {
+    pending_.erase(it);
+
+    auto const num_bytes = estimate_num_bytes(lm.zone(floor));
+    loaded_.emplace_back(LoadedZone{floor, num_bytes});
+    LOG_INFO_SPRINTF("Loaded floor %i (%lu bytes).", floor, num_bytes);
+  }
+  return Ok(finished);
+}
+
+void
+ZoneStreamer::update(EngineState& es, Engine& engine, LevelManager& lm)
+{
+  auto& logger = es.logger;
+
+  // Work on the first zone that doesn't have to wait on it's background thread.
+  auto const has_work = [](PendingZone const& pz) {
+    return pz.step != LoadStep::INSTANTIATE ||
+           pz.read.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+  };
+  auto const it = std::find_if(pending_.begin(), pending_.end(), has_work);
+  if (it == pending_.end()) {
+    return;
+  }
+
+  auto result = advance(es, engine, lm, it);
+  if (!result) {
+    LOG_ERROR(result.unwrapErrMove());
+  }
+  else if (result.expect_moveout("advance result")) {
+    evict(es, engine, lm);
+  }
+}
+
+Result<common::none_t, std::string>
+ZoneStreamer::load_now(EngineState& es, Engine& engine, LevelManager& lm, int const floor)
+{
+  if (floor < 0 || floor >= lm.num_levels()) {
+    return Err(fmt::sprintf("Floor %i doesn't exist.", floor));
+  }
+  if (is_ready(lm, floor)) {
+    return OK_NONE;
+  }
+  if (!is_pending(floor)) {
+    if (!level_exists(floor)) {
+      return Err(fmt::sprintf("Floor %i has no level.", floor));
+    }
+    // Nothing else is happening while the floor loads, so read it on this thread.
+    start_reading(es.logger, floor, std::launch::deferred);
+  }
+
+  PHASE_TIMER("load_zone:" + std::to_string(floor));
+  auto const it       = find_pending(floor);
+  bool       finished = false;
+  while (!finished) {
+    finished = TRY_MOVEOUT(advance(es, engine, lm, it));
+  }
+  return OK_NONE;
+}
+
+Result<common::none_t, std::string>
+ZoneStreamer::make_active(EngineState& es, Engine& engine, LevelManager& lm, int const floor)
+{
+  TRY_MOVEOUT(load_now(es, engine, lm, floor));
+  lm.make_active(floor);
+  touch(floor);
+
+  preload_neighbours(es, lm);
+  evict(es, engine, lm);
+  return OK_NONE;
+}
+
+void
+ZoneStreamer::touch(int const floor)
+{
+  auto const cmp = [&floor](auto const& lz) { return lz.floor == floor; };
+  auto const it  = std::find_if(loaded_.begin(), loaded_.end(), cmp);
+  assert(it != loaded_.end());
+
+  // Move the zone to the back, the most recently used position.
+  std::rotate(it, it + 1, loaded_.end());
+}
+
+void
+ZoneStreamer::evict(EngineState& es, Engine& engine, LevelManager& lm)
+{
+  auto& logger = es.logger;
+
+  auto it = loaded_.begin();
+  while (memory_used() > memory_budget_ && it != loaded_.end()) {
+    auto const floor = it->floor;
+    if (floor == lm.active_zone()) {
+      ++it;
+      continue;
+    }
+    LOG_INFO_SPRINTF("Unloading floor %i (%lu bytes), zones are over the memory budget.", floor,
+                     it->num_bytes);
+
+    // Destroy the entities first, their components refer to the zone's resources.
+    engine.registries[floor].clear();
+    lm.remove_zone(floor);
+    it = loaded_.erase(it);
+  }
+}
+
+} // namespace boomhs
@@ -0,0 +1,206 @@
+#include <common/log.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+
+using namespace common::impl;
+
+namespace
+{
+
+auto
+to_spdlog_level(LogLevel const level)
+{
+  switch (level) {
+  case LogLevel::trace:
+    return spdlog::level::trace;
+  case LogLevel::debug:
+    return spdlog::level::debug;
+  case LogLevel::info:
+    return spdlog::level::info;
+  case LogLevel::warn:
+    return spdlog::level::warn;
+  case LogLevel::error:
+    return spdlog::level::err;
+  default:
+    break;
+  }
+  std::abort();
+}
+
+} // namespace
+
+namespace common::impl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// LogQueue
+LogQueue::LogQueue(size_t const capacity)
+    : cells_(std::make_unique<Cell[]>(capacity))
+    , mask_(capacity - 1)
+{
+  assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+  for (size_t i = 0; i < capacity; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  enqueue_pos_.store(0, std::memory_order_relaxed);
+  dequeue_pos_.store(0, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// AsyncLogger
+AsyncLogger::AsyncLogger(LoggerPointer&& logger, OverflowPolicy const overflow,
+                         size_t const queue_size)
+    : logger_(MOVE(logger))
+    , queue_(queue_size)
+    , overflow_(overflow)
+{
+  for (auto& level : levels_) {
+    level.store(logger_->level(), std::memory_order_relaxed);
+  }
+
+  thread_ = std::thread{[this]() { run(); }};
+}
+
+AsyncLogger::~AsyncLogger()
+{
+  push_control(LogRecord::Kind::stop);
+  thread_.join();
+}
+
+void
+AsyncLogger::push_control(LogRecord::Kind const kind)
+{
+  // Control records are never discarded.
+  auto const fill = [&kind](LogRecord& record) { record.set_control(kind); };
+  while (!queue_.try_push(fill)) {
+    std::this_thread::yield();
+  }
+  wake();
+}
+
+void
+AsyncLogger::wake()
+{
+  // Pairs with the fence in sleep(), either the logging thread sees the record or this sees it
+  // sleeping.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    sleeping_.store(false, std::memory_order_relaxed);
+    wakeup_.notify_one();
+  }
+}
+
+void
+AsyncLogger::sleep()
+{
+  std::unique_lock<std::mutex> lock{mutex_};
+  sleeping_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!queue_.empty()) {
+    sleeping_.store(false, std::memory_order_relaxed);
+    return;
+  }
+  wakeup_.wait(lock, [this]() { return !sleeping_.load(std::memory_order_relaxed); });
+}
+
+bool
+AsyncLogger::write(LogRecord& record)
+{
+  switch (record.kind) {
+  case LogRecord::Kind::message:
+    // A bad format string must not take down the logging thread (and every message after it).
+    try {
+      logger_->log(to_spdlog_level(record.level), record.take_message());
+    }
+    catch (std::exception const& e) {
+      logger_->error("Error formatting log message: '{}'", e.what());
+    }
+    return true;
+  case LogRecord::Kind::flush: {
+    logger_->flush();
+    std::lock_guard<std::mutex> lock{mutex_};
+    flushes_done_.fetch_add(1, std::memory_order_release);
+    flushed_.notify_all();
+  }
+    return true;
+  case LogRecord::Kind::stop:
+    logger_->flush();
+    return false;
+  default:
+    break;
+  }
+  std::abort();
+}
+
+void
+AsyncLogger::run()
+{
+  // Spin (yielding) briefly when the queue empties, then sleep until a record is pushed.
+  int constexpr SPINS_BEFORE_SLEEPING = 64;
+
+  bool running = true;
+  int  idle    = 0;
+  while (running) {
+    bool const popped = queue_.try_pop([&](LogRecord& record) { running = write(record); });
+    if (popped) {
+      idle = 0;
+      continue;
+    }
+
+    auto const num_discarded = num_discarded_.exchange(0, std::memory_order_relaxed);
+    if (num_discarded > 0) {
+      logger_->warn("{} log messages were discarded, the log queue was full.", num_discarded);
+    }
+
+    if (++idle < SPINS_BEFORE_SLEEPING) {
+      std::this_thread::yield();
+    }
+    else {
+      sleep();
+      idle = 0;
+    }
+  }
+}
+
+void
+AsyncLogger::update_logger_level()
+{
+  // The categories filter the messages before they're queued, the spdlog logger only needs to let
+  // through the most verbose category's messages.
+  int level = spdlog::level::off;
+  for (auto const& category_level : levels_) {
+    level = std::min(level, category_level.load(std::memory_order_relaxed));
+  }
+  logger_->set_level(static_cast<spdlog::level::level_enum>(level));
+}
+
+void
+AsyncLogger::set_level(spdlog::level::level_enum const level)
+{
+  for (auto& category_level : levels_) {
+    category_level.store(level, std::memory_order_relaxed);
+  }
+  update_logger_level();
+}
+
+void
+AsyncLogger::set_level(LogCategory const category, spdlog::level::level_enum const level)
+{
+  levels_[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+  update_logger_level();
+}
+
+void
+AsyncLogger::flush()
+{
+  auto const ticket = flush_requests_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  push_control(LogRecord::Kind::flush);
+
+  std::unique_lock<std::mutex> lock{mutex_};
+  flushed_.wait(lock, [&]() { return flushes_done_.load(std::memory_order_acquire) >= ticket; });
+}
+
+} // namespace common::impl
@@ -0,0 +1,64 @@
+#include <common/frame_arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace
+{
+
+size_t
+align_up(size_t const value, size_t const alignment)
+{
+  assert((alignment & (alignment - 1)) == 0);
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+namespace common
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// FrameArena
+FrameArena::FrameArena(size_t const capacity)
+    : buffer_(std::make_unique<std::byte[]>(capacity))
+    , capacity_(capacity)
+{
+}
+
+void*
+FrameArena::allocate(size_t const bytes, size_t const alignment)
+{
+  auto const base  = reinterpret_cast<uintptr_t>(buffer_.get());
+  auto const start = align_up(base + offset_, alignment) - base;
+  if (start + bytes <= capacity_) {
+    offset_ = start + bytes;
+    return buffer_.get() + start;
+  }
+
+  // The buffer is full, fall back to the heap for the rest of this frame.
+  auto const size = bytes + alignment;
+  overflow_.emplace_back(std::make_unique<std::byte[]>(size));
+  overflow_bytes_ += size;
+
+  auto const overflow_base = reinterpret_cast<uintptr_t>(overflow_.back().get());
+  return reinterpret_cast<void*>(align_up(overflow_base, alignment));
+}
+
+void
+FrameArena::reset()
+{
+  if (!overflow_.empty()) {
+    // Grow the buffer so a frame making the same allocations fits without falling back to the
+    // heap.
+    capacity_ = std::max(capacity_ * 2, offset_ + overflow_bytes_);
+    buffer_   = std::make_unique<std::byte[]>(capacity_);
+
+    overflow_.clear();
+    overflow_bytes_ = 0;
+  }
+  offset_ = 0;
+}
+
+} // namespace common
@@ -20,17 +20,6 @@ threadunsafe_sink(char const* file_path)
   return std::make_unique<SinkType>(file_path);
 }
 
-auto
-threadsafe_sink(char const* file_path)
-{
-  // use multi-threaded spdlog sink
-  using SinkType = spdlog::sinks::simple_file_sink_mt;
-  return std::make_unique<SinkType>(file_path);
-
-  // using SinkType = spdlog::sinks::daily_file_sink_st;
-  // return std::make_unique<SinkType>(file_path, 23, 50);
-}
-
 auto
 threadsafe_stderr_sink()
 {
@@ -42,7 +31,8 @@ LogFlusher
 make_logflusher(char const* file_path, spdlog::level::level_enum const level)
 {
   try {
-    auto file_sink   = threadsafe_sink(file_path);
+    // Only the AsyncLogger's thread writes to the sinks.
+    auto file_sink   = threadunsafe_sink(file_path);
     auto stderr_sink = threadsafe_stderr_sink();
     stderr_sink->set_level(spdlog::level::err);
 
@@ -50,7 +40,9 @@ make_logflusher(char const* file_path, spdlog::level::level_enum const level)
     auto       logger = std::make_unique<spdlog::logger>(file_path, sinks.cbegin(), sinks.cend());
     logger->set_level(level);
 
-    auto adapter = impl::LogAdapter{MOVE(logger)};
+    // Under heavy logging (ie: trace logging in hot loops) drop trace and debug messages instead of
+    // stalling the game.
+    auto adapter = impl::LogAdapter{MOVE(logger), impl::OverflowPolicy::discard_verbose};
     return LogFlusher{MOVE(adapter)};
   }
   catch (spdlog::spdlog_ex const& ex) {
@@ -87,7 +79,7 @@ LogFactory::make_stderr()
     auto       logger = std::make_unique<spdlog::logger>("", sinks.cbegin(), sinks.cend());
     logger->set_level(level);
 
-    auto adapter = impl::LogAdapter{MOVE(logger)};
+    auto adapter = impl::LogAdapter{MOVE(logger), impl::OverflowPolicy::block};
     return Logger{LogFlusher{MOVE(adapter)}};
   }
   catch (spdlog::spdlog_ex const& ex) {
@@ -0,0 +1,217 @@
+#include <common/phase_timer.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+
+using namespace common;
+
+namespace
+{
+
+thread_local PhaseReport* INSTALLED_REPORT = nullptr;
+
+// CPU time used by the calling thread.
+double
+thread_cpu_ms()
+{
+  timespec ts;
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
+
+double
+millis_since(std::chrono::steady_clock::time_point const start)
+{
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  return Milliseconds{std::chrono::steady_clock::now() - start}.count();
+}
+
+std::string
+escape_json(std::string const& str)
+{
+  std::string result;
+  for (char const c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result;
+}
+
+struct BaselinePhase
+{
+  std::string name;
+  double      wall_ms;
+};
+
+// Read the name and wall time of each phase out of a report written by PhaseReport::to_json().
+//
+// This isn't a general JSON parser, it relies on the layout to_json() writes.
+Result<std::vector<BaselinePhase>, std::string>
+read_baseline(std::string const& json)
+{
+  std::string const NAME_KEY = "\"name\": \"";
+  std::string const WALL_KEY = "\"wall_ms\": ";
+
+  std::vector<BaselinePhase> phases;
+  size_t                     pos = 0;
+  while ((pos = json.find(NAME_KEY, pos)) != std::string::npos) {
+    BaselinePhase phase;
+    for (pos += NAME_KEY.size(); pos < json.size() && json[pos] != '"'; ++pos) {
+      if (json[pos] == '\\') {
+        ++pos;
+      }
+      phase.name += json[pos];
+    }
+
+    auto const wall_pos = json.find(WALL_KEY, pos);
+    if (wall_pos == std::string::npos) {
+      return Err(fmt::sprintf("Baseline phase '%s' has no wall time.", phase.name));
+    }
+    phase.wall_ms = std::strtod(json.c_str() + wall_pos + WALL_KEY.size(), nullptr);
+    phases.emplace_back(MOVE(phase));
+    pos = wall_pos;
+  }
+  return OK_MOVE(phases);
+}
+
+} // namespace
+
+namespace common
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// PhaseReport
+PhaseReport::PhaseReport()
+    : start_(std::chrono::steady_clock::now())
+{
+}
+
+double
+PhaseReport::total_ms() const
+{
+  return millis_since(start_);
+}
+
+size_t
+PhaseReport::begin_phase(std::string&& name)
+{
+  PhaseTiming phase;
+  phase.name  = MOVE(name);
+  phase.depth = static_cast<int>(open_.size());
+
+  auto const index = phases_.size();
+  phases_.emplace_back(MOVE(phase));
+  open_.emplace_back(index);
+  return index;
+}
+
+void
+PhaseReport::end_phase(size_t const index, double const wall_ms, double const cpu_ms)
+{
+  // Phases are scoped, so they always end in the reverse order they began.
+  assert(!open_.empty() && open_.back() == index);
+  open_.pop_back();
+
+  auto& phase   = phases_[index];
+  phase.wall_ms = wall_ms;
+  phase.cpu_ms  = cpu_ms;
+}
+
+void
+PhaseReport::add_bytes_read(uint64_t const num_bytes)
+{
+  for (auto const index : open_) {
+    phases_[index].bytes_read += num_bytes;
+  }
+}
+
+std::string
+PhaseReport::to_json() const
+{
+  std::stringstream ss;
+  ss << "{\n";
+  ss << fmt::sprintf("  \"total_ms\": %.3f,\n", total_ms());
+  ss << "  \"phases\": [\n";
+  for (size_t i = 0; i < phases_.size(); ++i) {
+    auto const& p = phases_[i];
+    ss << fmt::sprintf("    {\"name\": \"%s\", \"depth\": %i, \"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+                       "\"bytes_read\": %lu}",
+                       escape_json(p.name), p.depth, p.wall_ms, p.cpu_ms, p.bytes_read);
+    ss << ((i + 1) < phases_.size() ? ",\n" : "\n");
+  }
+  ss << "  ]\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+Result<std::vector<std::string>, std::string>
+PhaseReport::compare_to_baseline(std::string const& baseline_json, double const tolerance) const
+{
+  // Differences smaller than this are noise, even when they are a large fraction of the phase.
+  double constexpr MIN_DIFFERENCE_MS = 1.0;
+
+  auto const baseline = TRY_MOVEOUT(read_baseline(baseline_json));
+
+  std::vector<std::string> regressions;
+  for (auto const& phase : phases_) {
+    auto const cmp = [&phase](auto const& bp) { return bp.name == phase.name; };
+    auto const it  = std::find_if(baseline.cbegin(), baseline.cend(), cmp);
+    if (it == baseline.cend()) {
+      continue;
+    }
+
+    auto const difference = phase.wall_ms - it->wall_ms;
+    if (difference > MIN_DIFFERENCE_MS && phase.wall_ms > it->wall_ms * (1.0 + tolerance)) {
+      regressions.emplace_back(fmt::sprintf("'%s' took %.3fms, baseline %.3fms (+%.1f%%)",
+                                            phase.name, phase.wall_ms, it->wall_ms,
+                                            100.0 * difference / std::max(it->wall_ms, 0.001)));
+    }
+  }
+  return OK_MOVE(regressions);
+}
+
+PhaseReport*
+PhaseReport::installed()
+{
+  return INSTALLED_REPORT;
+}
+
+void
+PhaseReport::install(PhaseReport* report)
+{
+  INSTALLED_REPORT = report;
+}
+
+void
+record_bytes_read(uint64_t const num_bytes)
+{
+  if (INSTALLED_REPORT) {
+    INSTALLED_REPORT->add_bytes_read(num_bytes);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ScopedPhase
+void
+ScopedPhase::begin(std::string&& name)
+{
+  index_        = report_->begin_phase(MOVE(name));
+  wall_start_   = std::chrono::steady_clock::now();
+  cpu_start_ms_ = thread_cpu_ms();
+}
+
+ScopedPhase::~ScopedPhase()
+{
+  if (report_) {
+    report_->end_phase(index_, millis_since(wall_start_), thread_cpu_ms() - cpu_start_ms_);
+  }
+}
+
+} // namespace common
@@ -0,0 +1,272 @@
+#include <common/profiler.hpp>
+#include <extlibs/fmt.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+using namespace common;
+
+namespace
+{
+
+// Events are dropped once a buffer holds this many, in case frames stop being ended.
+size_t constexpr MAX_BUFFERED_EVENTS = 1 << 16;
+
+struct ThreadBuffer
+{
+  std::vector<ProfileEvent> events;
+  uint32_t                  depth           = 0;
+  uint32_t                  thread          = 0;
+  bool                      is_frame_thread = false;
+};
+
+std::atomic<uint32_t> NEXT_THREAD{0};
+
+ThreadBuffer&
+thread_buffer()
+{
+  thread_local ThreadBuffer buffer{{}, 0, NEXT_THREAD.fetch_add(1), false};
+  return buffer;
+}
+
+std::atomic<bool>   ENABLED{true};
+std::atomic<double> SPIKE_THRESHOLD_MS{Profiler::DEFAULT_SPIKE_THRESHOLD_MS};
+
+// Events handed over by threads other than the frame thread.
+std::mutex                PENDING_MUTEX;
+std::vector<ProfileEvent> PENDING;
+
+// Only touched by the frame thread.
+ProfileFrame              CURRENT;
+bool                      FRAME_OPEN = false;
+std::deque<ProfileFrame>  HISTORY;
+std::vector<ProfileFrame> SPIKES;
+
+void
+append_event(std::vector<ProfileEvent>& events, ProfileEvent const& event)
+{
+  if (events.size() < MAX_BUFFERED_EVENTS) {
+    events.emplace_back(event);
+  }
+}
+
+void
+keep_if_spike(ProfileFrame const& frame)
+{
+  if (frame.duration_ms() < SPIKE_THRESHOLD_MS.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (SPIKES.size() < Profiler::MAX_SPIKES) {
+    SPIKES.emplace_back(frame);
+    return;
+  }
+
+  // Replace the fastest spike, if this frame is slower.
+  auto const cmp = [](auto const& a, auto const& b) { return a.duration_ns() < b.duration_ns(); };
+  auto const it  = std::min_element(SPIKES.begin(), SPIKES.end(), cmp);
+  if (it->duration_ns() < frame.duration_ns()) {
+    *it = frame;
+  }
+}
+
+void
+write_trace_events(std::stringstream& ss, ProfileFrame const& frame, bool& first)
+{
+  auto const write_event = [&](char const* name, uint32_t const thread, uint64_t const begin_ns,
+                               uint64_t const duration_ns) {
+    ss << (first ? "\n" : ",\n");
+    first = false;
+
+    // The trace format's timestamps are in microseconds.
+    ss << fmt::sprintf("  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, "
+                       "\"ts\": %.3f, \"dur\": %.3f}",
+                       name, thread, begin_ns / 1000.0, duration_ns / 1000.0);
+  };
+
+  auto const frame_thread = thread_buffer().thread;
+  write_event("frame", frame_thread, frame.begin_ns, frame.duration_ns());
+  for (auto const& event : frame.events) {
+    write_event(event.name, event.thread, event.begin_ns, event.duration_ns());
+  }
+}
+
+} // namespace
+
+namespace common
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Profiler
+bool
+Profiler::enabled()
+{
+  return ENABLED.load(std::memory_order_relaxed);
+}
+
+void
+Profiler::set_enabled(bool const enabled)
+{
+  ENABLED.store(enabled, std::memory_order_relaxed);
+}
+
+double
+Profiler::spike_threshold_ms()
+{
+  return SPIKE_THRESHOLD_MS.load(std::memory_order_relaxed);
+}
+
+void
+Profiler::set_spike_threshold_ms(double const ms)
+{
+  SPIKE_THRESHOLD_MS.store(ms, std::memory_order_relaxed);
+}
+
+void
+Profiler::begin_frame()
+{
+  auto& buffer           = thread_buffer();
+  buffer.is_frame_thread = true;
+
+  CURRENT.events.clear();
+  CURRENT.begin_ns = now_ns();
+  FRAME_OPEN       = true;
+}
+
+void
+Profiler::end_frame()
+{
+  if (!FRAME_OPEN) {
+    return;
+  }
+  FRAME_OPEN     = false;
+  CURRENT.end_ns = now_ns();
+
+  auto& events = thread_buffer().events;
+  CURRENT.events.swap(events);
+  events.clear();
+  {
+    std::lock_guard<std::mutex> lock{PENDING_MUTEX};
+    CURRENT.events.insert(CURRENT.events.end(), PENDING.cbegin(), PENDING.cend());
+    PENDING.clear();
+  }
+
+  // Zones are recorded when they end, the flame view wants them in the order they began.
+  auto const cmp = [](auto const& a, auto const& b) { return a.begin_ns < b.begin_ns; };
+  std::sort(CURRENT.events.begin(), CURRENT.events.end(), cmp);
+
+  if (!enabled()) {
+    return;
+  }
+  keep_if_spike(CURRENT);
+
+  auto const number = CURRENT.number;
+  if (HISTORY.size() == HISTORY_SIZE) {
+    // Reuse the oldest frame's event buffer, instead of allocating a new one each frame.
+    auto oldest = MOVE(HISTORY.front());
+    HISTORY.pop_front();
+    HISTORY.emplace_back(MOVE(CURRENT));
+    CURRENT = MOVE(oldest);
+  }
+  else {
+    HISTORY.emplace_back(MOVE(CURRENT));
+  }
+  CURRENT.number = number + 1;
+}
+
+std::deque<ProfileFrame> const&
+Profiler::history()
+{
+  return HISTORY;
+}
+
+std::vector<ProfileFrame> const&
+Profiler::spikes()
+{
+  return SPIKES;
+}
+
+void
+Profiler::clear()
+{
+  HISTORY.clear();
+  SPIKES.clear();
+}
+
+std::string
+Profiler::to_chrome_trace()
+{
+  // A spike may still be in the history, write each frame once (in order).
+  std::map<uint64_t, ProfileFrame const*> frames;
+  for (auto const& frame : SPIKES) {
+    frames[frame.number] = &frame;
+  }
+  for (auto const& frame : HISTORY) {
+    frames[frame.number] = &frame;
+  }
+
+  std::stringstream ss;
+  ss << "{\"traceEvents\": [";
+  bool first = true;
+  for (auto const& it : frames) {
+    write_trace_events(ss, *it.second, first);
+  }
+  ss << "\n]}\n";
+  return ss.str();
+}
+
+Result<none_t, std::string>
+Profiler::write_chrome_trace(char const* path)
+{
+  std::ofstream file{path};
+  if (!file) {
+    return Err(fmt::sprintf("Error opening '%s' to write the profiler trace.", path));
+  }
+  file << to_chrome_trace();
+  return OK_NONE;
+}
+
+uint64_t
+Profiler::now_ns()
+{
+  using namespace std::chrono;
+  auto const since_epoch = steady_clock::now().time_since_epoch();
+  return duration_cast<nanoseconds>(since_epoch).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ProfileZone
+ProfileZone::ProfileZone(char const* name)
+    : name_(name)
+    , active_(Profiler::enabled())
+{
+  if (active_) {
+    ++thread_buffer().depth;
+    begin_ns_ = Profiler::now_ns();
+  }
+}
+
+ProfileZone::~ProfileZone()
+{
+  if (!active_) {
+    return;
+  }
+  auto const end_ns = Profiler::now_ns();
+  auto&      buffer = thread_buffer();
+  --buffer.depth;
+
+  append_event(buffer.events, ProfileEvent{name_, begin_ns_, end_ns, buffer.thread, buffer.depth});
+  if (!buffer.is_frame_thread && buffer.depth == 0) {
+    std::lock_guard<std::mutex> lock{PENDING_MUTEX};
+    for (auto const& event : buffer.events) {
+      append_event(PENDING, event);
+    }
+    buffer.events.clear();
+  }
+}
+
+} // namespace common
@@ -1,5 +1,6 @@
 #include <common/timer.hpp>
-#include <extlibs/sdl.hpp>
+
+#include <chrono>
 
 namespace common
 {
@@ -22,7 +23,7 @@ TimeConversions::seconds_to_ticks(ticks_t const ticks, freq_t const freq)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Timer
 Timer::Timer()
-    : frequency_(SDL_GetPerformanceFrequency())
+    : frequency_(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num)
     , start_(now())
     , last_(start_)
 {
@@ -31,7 +32,8 @@ Timer::Timer()
 ticks_t
 Timer::now() const
 {
-  return SDL_GetPerformanceCounter();
+  // The steady clock doesn't need SDL, so the simulation can use timers without a window.
+  return std::chrono::steady_clock::now().time_since_epoch().count();
 }
 
 ticks_t
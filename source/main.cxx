@@ -3,6 +3,7 @@
 #include <boomhs/controller.hpp>
 #include <boomhs/entity.hpp>
 #include <boomhs/frame_time.hpp>
+#include <boomhs/input_recording.hpp>
 #include <boomhs/io_behavior.hpp>
 #include <boomhs/io_sdl.hpp>
 #include <boomhs/main_menu.hpp>
@@ -12,6 +13,9 @@
 
 #include <common/timer.hpp>
 #include <common/log.hpp>
+#include <common/os.hpp>
+#include <common/phase_timer.hpp>
+#include <common/profiler.hpp>
 #include <common/time.hpp>
 
 #include <gl_sdl/common.hpp>
@@ -20,6 +24,10 @@
 #include <extlibs/imgui.hpp>
 #include <extlibs/openal.hpp>
 
+#include <fstream>
+#include <optional>
+#include <string>
+
 using namespace boomhs;
 using namespace boomhs::math;
 using namespace common;
@@ -28,16 +36,76 @@ using namespace gl_sdl;
 namespace
 {
 
+// Where the game's input comes from.
+//
+// Normally input is read live from SDL, and optionally recorded. When replaying, input is read from
+// a recording instead.
+struct InputSession
+{
+  std::optional<InputRecorder> recorder;
+  std::optional<InputReplayer> replayer;
+};
+
+struct CommandLineArgs
+{
+  std::string record_path;
+  std::string replay_path;
+};
+
+// Events that reference memory outside of the SDL_Event structure can't be recorded.
+bool
+is_recordable(SDL_Event const& event)
+{
+  return event.type != SDL_DROPFILE && event.type != SDL_DROPTEXT && event.type != SDL_SYSWMEVENT;
+}
+
+// Read everything the next frame needs from outside the game into "frame".
+//
+// Returns false once a replayed session has no frames left.
+bool
+read_input_frame(InputSession& session, Timer const& timer, InputFrame& frame, bool& quit)
+{
+  SDL_Event event;
+  if (session.replayer) {
+    // Keep the window responsive while replaying, but the live input itself is ignored (besides
+    // the user closing the window).
+    while (0 != SDL_PollEvent(&event)) {
+      quit |= event.type == SDL_QUIT;
+    }
+    return session.replayer->read_frame(frame);
+  }
+
+  frame.clear();
+  frame.delta       = timer.delta_ticks_since_last_update();
+  frame.since_start = timer.since_start();
+  while (0 != SDL_PollEvent(&event)) {
+    if (is_recordable(event)) {
+      frame.events.emplace_back(event);
+    }
+  }
+
+  // SDL updates the keyboard and mouse state while polling, so read them after.
+  frame.keyboard = KeyboardState::from_sdl();
+  frame.mouse    = MouseState::from_sdl();
+
+  if (session.recorder) {
+    session.recorder->write_frame(frame);
+  }
+  return true;
+}
+
 void
-loop_events(GameState& state, Camera& camera, bool const show_mainmenu, bool& quit,
-            FrameTime const& ft)
+loop_events(GameState& state, Camera& camera, InputFrame& frame, bool const show_mainmenu,
+            bool& quit, FrameTime const& ft)
 {
   auto const& fn = show_mainmenu
     ? &main_menu::process_event
     : &IO_SDL::process_event;
 
-  SDL_Event event;
-  while ((!quit) && (0 != SDL_PollEvent(&event))) {
+  for (auto& event : frame.events) {
+    if (quit) {
+      break;
+    }
     ImGui_ImplSdlGL3_ProcessEvent(&event);
     fn(SDLEventProcessArgs{state, event, camera, ft});
     quit |= event.type == SDL_QUIT;
@@ -45,37 +113,64 @@ loop_events(GameState& state, Camera& camera, bool const show_mainmenu, bool& qu
 }
 
 void
-loop(Engine& engine, GameState& gs, RNG& rng, Camera& camera, FrameTime const& ft)
+loop(Engine& engine, GameState& gs, RNG& rng, Camera& camera, InputFrame& frame,
+     FrameTime const& ft)
 {
   auto& es     = gs.engine_state();
   auto& logger = es.logger;
 
   auto& window = engine.window;
+  common::Profiler::begin_frame();
 
   // Reset Imgui for next game frame.
   ImGui_ImplSdlGL3_NewFrame(window.raw());
 
-  loop_events(gs, camera, es.main_menu.show, es.quit, ft);
+  // The game reads the keyboard and mouse from these, never from SDL directly.
+  auto& ds         = es.device_states;
+  ds.keyboard      = frame.keyboard;
+  ds.mouse.current = frame.mouse;
+
+  {
+    PROFILE_ZONE("events");
+    loop_events(gs, camera, frame, es.main_menu.show, es.quit, ft);
+  }
   boomhs::game_loop(engine, gs, rng, camera, ft);
 
-  // Render Imgui UI
-  ImGui::Render();
-  ImGui_ImplSdlGL3_RenderDrawData(ImGui::GetDrawData());
+  {
+    // Render Imgui UI
+    PROFILE_ZONE("imgui_render");
+    ImGui::Render();
+    ImGui_ImplSdlGL3_RenderDrawData(ImGui::GetDrawData());
+  }
 
-  // Update window with OpenGL rendering
-  SDL_GL_SwapWindow(window.raw());
+  {
+    // Update window with OpenGL rendering
+    PROFILE_ZONE("swap_window");
+    SDL_GL_SwapWindow(window.raw());
+  }
+
+  // Everything allocated from the frame arena this frame is garbage now.
+  es.frame_arena.reset();
+  common::Profiler::end_frame();
 }
 
 void
-timed_game_loop(Engine& engine, GameState& gs, Camera& camera, RNG& rng)
+timed_game_loop(Engine& engine, GameState& gs, Camera& camera, RNG& rng, InputSession& session)
 {
   Timer timer;
   FrameCounter fcounter;
+  InputFrame   frame;
+
+  auto& es     = gs.engine_state();
+  auto& logger = es.logger;
 
-  auto& es = gs.engine_state();
+  auto const frequency = session.replayer ? session.replayer->frequency() : timer.frequency();
   while (!es.quit) {
-    auto const ft = FrameTime::from_timer(timer);
-    loop(engine, gs, rng, camera, ft);
+    if (!read_input_frame(session, timer, frame, es.quit)) {
+      break;
+    }
+    FrameTime const ft{frame.delta, frame.since_start, frequency};
+    loop(engine, gs, rng, camera, frame, ft);
 
     if ((fcounter.frames_counted % 60 == 0)) {
       es.time.add_hours(1);
@@ -83,10 +178,49 @@ timed_game_loop(Engine& engine, GameState& gs, Camera& camera, RNG& rng)
     timer.update();
     fcounter.update();
   }
+
+  if (session.replayer) {
+    auto const frames = fcounter.frames_counted;
+    auto const millis = TimeConversions::ticks_to_millis(timer.since_start(), timer.frequency());
+    LOG_INFO_SPRINTF("Replayed %li frames in %.2fms (%.3fms per frame).", frames, millis,
+                     frames > 0 ? (millis / frames) : 0.0);
+  }
+}
+
+// Where the startup report is written to, and the baseline it is compared to. To update the
+// baseline, copy a report over it.
+char constexpr STARTUP_REPORT_PATH[]   = "build-system/bin/logs/startup-report.json";
+char constexpr STARTUP_BASELINE_PATH[] = "startup-baseline.json";
+
+// How much slower (as a fraction) a phase may get before it's reported as a regression.
+double constexpr STARTUP_REGRESSION_TOLERANCE = 0.2;
+
+void
+write_startup_report(common::Logger& logger, common::PhaseReport const& report)
+{
+  std::ofstream{STARTUP_REPORT_PATH} << report.to_json();
+  LOG_INFO_SPRINTF("Startup took %.3fms, report written to '%s'.", report.total_ms(),
+                   STARTUP_REPORT_PATH);
+
+  auto baseline = common::read_file(STARTUP_BASELINE_PATH);
+  if (!baseline) {
+    LOG_INFO_SPRINTF("No startup baseline at '%s' to compare to.", STARTUP_BASELINE_PATH);
+    return;
+  }
+  auto const baseline_json = baseline.expect_moveout("startup baseline");
+  auto       regressions = report.compare_to_baseline(baseline_json, STARTUP_REGRESSION_TOLERANCE);
+  if (!regressions) {
+    LOG_ERROR_SPRINTF("Error reading startup baseline: %s", regressions.unwrapErrMove());
+    return;
+  }
+  for (auto const& regression : regressions.expect_moveout("startup regressions")) {
+    LOG_WARN_SPRINTF("Startup regression: %s", regression);
+  }
 }
 
 Result<common::none_t, std::string>
-start(common::Logger& logger, Engine& engine)
+start(common::Logger& logger, Engine& engine, CommandLineArgs const& args,
+      common::PhaseReport& startup_report)
 {
   // Initialize GUI library
   auto* imgui_context = ImGui::CreateContext();
@@ -100,7 +234,10 @@ start(common::Logger& logger, Engine& engine)
   auto& registries = engine.registries;
 
   // Initialize opengl
-  OR::init(logger);
+  {
+    PHASE_TIMER("init_opengl");
+    OR::init(logger);
+  }
 
   // Initialize openAL
   ALCdevice* al_device = alcOpenDevice(nullptr);
@@ -146,12 +283,49 @@ start(common::Logger& logger, Engine& engine)
                                                   wo_2dorthographic);
   camera.ortho.flip_rightv = true;
 
-  RNG rng;
-  auto gs = TRY_MOVEOUT(boomhs::create_gamestate(engine, es, wo_3dperspective, camera, rng));
-  boomhs::init_gamestate_inplace(gs, camera);
+  InputSession session;
+  if (!args.replay_path.empty()) {
+    session.replayer = TRY_MOVEOUT(InputReplayer::open(args.replay_path));
+    LOG_INFO_SPRINTF("Replaying input from '%s'.", args.replay_path);
+  }
+  // A replayed session must generate the same random numbers as the recorded session did.
+  RNG rng = session.replayer ? RNG{session.replayer->seed()} : RNG{};
+  if (!args.record_path.empty() && !session.replayer) {
+    session.recorder = TRY_MOVEOUT(
+        InputRecorder::create(args.record_path, rng.seed(), SDL_GetPerformanceFrequency()));
+    LOG_INFO_SPRINTF("Recording input to '%s'.", args.record_path);
+  }
+
+  auto gs_result = [&]() {
+    PHASE_TIMER("create_gamestate");
+    return boomhs::create_gamestate(engine, es, wo_3dperspective, camera, rng);
+  }();
+  auto gs = TRY_MOVEOUT(MOVE(gs_result));
+  {
+    PHASE_TIMER("init_gamestate");
+    boomhs::init_gamestate_inplace(gs, camera);
+  }
+
+  // Loading has finished, only the startup is recorded.
+  write_startup_report(logger, startup_report);
+  common::PhaseReport::install(nullptr);
 
   // Start game in a timed loop
-  timed_game_loop(engine, gs, camera, rng);
+  timed_game_loop(engine, gs, camera, rng, session);
+
+  // Keep the slow frames of the session around, so they can be looked at after the game exits.
+  auto const& spikes = common::Profiler::spikes();
+  if (!spikes.empty()) {
+    auto const path = common::Profiler::TRACE_PATH;
+    auto       r    = common::Profiler::write_chrome_trace(path);
+    if (!r) {
+      LOG_ERROR(r.unwrapErrMove());
+    }
+    else {
+      LOG_INFO_SPRINTF("%lu frames were slower than %.1fms, profiler trace written to '%s'.",
+                       spikes.size(), common::Profiler::spike_threshold_ms(), path);
+    }
+  }
 
   // Game has finished
   LOG_TRACE("game loop finished.");
@@ -178,14 +352,43 @@ main(int argc, char* argv[])
     return EXIT_FAILURE;
   };
 
-  LOG_DEBUG("Initializing OpenGL context and SDL window.");
-  auto gl_sdl = TRY_OR(GlSdl::make_default(logger, TITLE, FULLSCREEN, 1024, 768), on_error);
+  // usage: boomhs [--record <file>] [--replay <file>]
+  CommandLineArgs args;
+  for (int i = 1; i < argc; i += 2) {
+    std::string const flag      = argv[i];
+    bool const        has_value = (i + 1) < argc;
+    if (has_value && flag == "--record") {
+      args.record_path = argv[i + 1];
+    }
+    else if (has_value && flag == "--replay") {
+      args.replay_path = argv[i + 1];
+    }
+    else {
+      LOG_ERROR_SPRINTF("Unknown or incomplete command line argument '%s'.", flag);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Time each phase of starting the game.
+  common::PhaseReport startup_report;
+  common::PhaseReport::install(&startup_report);
 
-  auto controller = TRY_OR(SDLControllers::find_attached_controllers(logger), on_error);
+  LOG_DEBUG("Initializing OpenGL context and SDL window.");
+  auto gl_sdl_result = [&]() {
+    PHASE_TIMER("create_window");
+    return GlSdl::make_default(logger, TITLE, FULLSCREEN, 1024, 768);
+  }();
+  auto gl_sdl = TRY_OR(MOVE(gl_sdl_result), on_error);
+
+  auto controller_result = [&]() {
+    PHASE_TIMER("find_controllers");
+    return SDLControllers::find_attached_controllers(logger);
+  }();
+  auto   controller = TRY_OR(MOVE(controller_result), on_error);
   Engine engine{MOVE(gl_sdl.window), MOVE(controller)};
 
   LOG_DEBUG("Starting game loop");
-  TRY_OR(start(logger, engine), on_error);
+  TRY_OR(start(logger, engine, args, startup_report), on_error);
 
   LOG_DEBUG("Game loop finished successfully! Ending program now.");
   return EXIT_SUCCESS;
@@ -126,6 +126,21 @@ VertexBuffer::create_interleaved(common::Logger& logger, ObjData const& data,
   return buffer;
 }
 
+VertexBuffer
+VertexBuffer::create_interleaved(common::Logger& logger, ObjData const& data,
+                                 VertexAttribute const& va)
+{
+  auto buffer = create_interleaved(logger, data, BufferFlags::from_va(va));
+  if (va.is_quantized()) {
+    buffer.packed = va.pack(buffer.vertices);
+
+    // The floats were only needed to build the packed vertices.
+    buffer.vertices.clear();
+    buffer.vertices.shrink_to_fit();
+  }
+  return buffer;
+}
+
 VertexBuffer
 VertexBuffer::copy() const
 {
@@ -135,6 +150,7 @@ VertexBuffer::copy() const
 void
 VertexBuffer::set_colors(Color const& color)
 {
+  assert(!is_packed());
   size_t i = 0;
   while (i < vertices.size()) {
     assert(flags.vertices);
@@ -164,7 +180,8 @@ VertexBuffer::set_colors(Color const& color)
 std::string
 VertexBuffer::to_string() const
 {
-  return fmt::sprintf("{vertices size: %u, indices size: %u}", vertices.size(), indices.size());
+  return fmt::sprintf("{vertices size: %u, packed size: %u, indices size: %u}", vertices.size(),
+                      packed.size(), indices.size());
 }
 
 } // namespace opengl
@@ -9,12 +9,16 @@
 #include <boomhs/level_manager.hpp>
 #include <boomhs/math.hpp>
 #include <boomhs/player.hpp>
+#include <boomhs/render_snapshot.hpp>
 #include <boomhs/vertex_factory.hpp>
 
 #include <boomhs/random.hpp>
 
 #include <extlibs/glm.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::render
+
 using namespace boomhs;
 using namespace boomhs::math;
 using namespace opengl;
@@ -82,27 +86,35 @@ draw_axis(RenderState& rstate, glm::vec3 const& pos)
 void
 conditionally_draw_player_vectors(RenderState& rstate, Player const& player)
 {
-  auto& fstate   = rstate.fs;
-  auto& es       = fstate.es;
-  auto& zs       = fstate.zs;
-  auto& registry = zs.registry;
+  auto& fstate = rstate.fs;
+  auto& es     = fstate.es;
+  auto& zs     = fstate.zs;
 
   auto& logger = es.logger;
 
-  auto const draw_local_axis = [&rstate](auto const& wo) {
-    glm::vec3 const pos = wo.world_position();
-    // local-space
+  // The player's Transforms are read from the snapshot, the simulation may be moving the player.
+  auto const& snapshot  = zs.gfx_state.snapshot;
+  auto const  transform = [&snapshot](WorldObject const& wo) -> Transform const& {
+    return snapshot.get<Transform>(wo.eid());
+  };
+
+  auto const draw_local_axis = [&](WorldObject const& wo) {
+    auto const&     tr  = transform(wo);
+    glm::vec3 const pos = tr.translation;
+
+    // local-space (the same vectors as WorldObject::eye_forward(), eye_up() and eye_right())
     //
     // eye-forward
-    auto const fwd = wo.eye_forward();
+    auto const& orientation = wo.world_orientation();
+    auto const  fwd         = orientation.forward * tr.rotation;
     render::draw_arrow(rstate, pos, pos + (2.0f * fwd), LOC4::PURPLE);
 
     // eye-up
-    auto const up = wo.eye_up();
+    auto const up = orientation.up * tr.rotation;
     render::draw_arrow(rstate, pos, pos + up, LOC4::YELLOW);
 
     // eye-right
-    auto const right = wo.eye_right();
+    auto const right = glm::normalize(glm::cross(fwd, up));
     render::draw_arrow(rstate, pos, pos + right, LOC4::ORANGE);
   };
 
@@ -111,8 +123,8 @@ conditionally_draw_player_vectors(RenderState& rstate, Player const& player)
     draw_local_axis(player.head_world_object());
   }
   if (es.show_player_worldspace_vectors) {
-    draw_axis(rstate, player.world_position());
-    draw_axis(rstate, player.head_world_object().transform().translation);
+    draw_axis(rstate, transform(player.world_object()).translation);
+    draw_axis(rstate, transform(player.head_world_object()).translation);
   }
 }
 
@@ -171,7 +183,7 @@ namespace opengl
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // DebugRenderer
 void
-DebugRenderer::render_scene(RenderState& rstate, LevelManager& lm, Camera& camera, RNG& rng,
+DebugRenderer::render_scene(RenderState& rstate, LevelManager& lm, Camera&, RNG& rng,
                             FrameTime const& ft)
 {
   auto& fstate = rstate.fs;
@@ -192,7 +204,7 @@ DebugRenderer::render_scene(RenderState& rstate, LevelManager& lm, Camera& camer
   }
 
   Transform camera_transform;
-  camera_transform.translation = camera.position();
+  camera_transform.translation = fstate.camera_world_position();
   auto const model             = camera_transform.model_matrix();
 
   if (es.draw_view_frustum) {
@@ -1,18 +1,53 @@
 #include <opengl/buffer.hpp>
 #include <opengl/draw_info.hpp>
+#include <opengl/geometry_pool.hpp>
 #include <opengl/gpu.hpp>
+#include <opengl/gpu_memory.hpp>
 #include <opengl/shader.hpp>
 
 #include <boomhs/bounding_object.hpp>
 #include <boomhs/components.hpp>
 #include <boomhs/obj_store.hpp>
+#include <boomhs/terrain.hpp>
 #include <boomhs/vertex_factory.hpp>
 
 #include <common/algorithm.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace boomhs;
+using namespace opengl;
+
+namespace
+{
+
+DrawInfo
+copy_terrain_gpu(common::Logger& logger, ShaderPrograms& sps, TerrainGrid const& terrain_grid,
+                 size_t const index)
+{
+  auto const& terrain = terrain_grid[index];
+  auto&       sp      = sps.ref_sp(logger, terrain.config.shader_name);
+
+  auto const data = terrain::generate_data(logger, terrain_grid.config, terrain);
+  LOG_TRACE_SPRINTF("Generated terrain piece: %s", data.to_string());
+
+  auto const buffer = VertexBuffer::create_interleaved(logger, data, sp.va());
+  auto       dinfo  = gpu::copy_gpu(logger, sp.va(), buffer);
+
+  // These uniforms only need to be set once.
+  sp.while_bound(logger, [&]() {
+    shader::set_uniform(logger, sp, "u_bgsampler",    0);
+    shader::set_uniform(logger, sp, "u_rsampler",     1);
+    shader::set_uniform(logger, sp, "u_gsampler",     2);
+    shader::set_uniform(logger, sp, "u_bsampler",     3);
+    shader::set_uniform(logger, sp, "u_blendsampler", 4);
+  });
+  return dinfo;
+}
+
+} // namespace
+
 namespace opengl
 {
 
@@ -67,19 +102,42 @@ operator<<(std::ostream& stream, BufferHandles const& buffers)
   return stream;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// DrawBuffers
+DrawBuffers::DrawBuffers(size_t const vb, GLuint const ni)
+    : vertex_bytes(vb)
+    , num_indices(ni)
+{
+}
+
+DrawBuffers::~DrawBuffers()
+{
+  if (arena) {
+    arena->free(*this);
+  }
+  if (handles) {
+    GpuMemory::freed(GpuMemory::BUFFERS, num_bytes());
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // DrawInfo
-DrawInfo::DrawInfo(size_t const num_vertexes, GLuint const num_indices)
-    : num_vertexes_(num_vertexes)
-    , num_indices_(num_indices)
+DrawInfo::DrawInfo(size_t const vertex_bytes, GLuint const num_indices)
+    : buffers_(std::make_shared<DrawBuffers>(vertex_bytes, num_indices))
+{
+  buffers_->handles.emplace(BufferHandles{});
+  buffers_->vao.emplace();
+  GpuMemory::allocated(GpuMemory::BUFFERS, buffers_->num_bytes());
+}
+
+DrawInfo::DrawInfo(std::shared_ptr<DrawBuffers>&& buffers)
+    : buffers_(MOVE(buffers))
 {
+  assert(buffers_);
 }
 
 DrawInfo::DrawInfo(DrawInfo&& other)
-    : num_vertexes_(other.num_vertexes_)
-    , num_indices_(other.num_indices_)
-    , handles_(MOVE(other.handles_))
-    , vao_(MOVE(other.vao_))
+    : buffers_(MOVE(other.buffers_))
 {
   assert(this != &other);
 }
@@ -89,16 +147,41 @@ DrawInfo::operator=(DrawInfo&& other)
 {
   assert(this != &other);
 
-  num_vertexes_       = other.num_vertexes_;
-  num_indices_        = other.num_indices_;
-  other.num_vertexes_ = 0;
-  other.num_indices_  = 0;
-
-  handles_ = MOVE(other.handles_);
-  vao_     = MOVE(other.vao_);
+  buffers_ = MOVE(other.buffers_);
   return *this;
 }
 
+GLuint
+DrawInfo::vbo() const
+{
+  return is_pooled() ? buffers_->arena->vbo() : buffers_->handles->vbo();
+}
+
+GLuint
+DrawInfo::ebo() const
+{
+  return is_pooled() ? buffers_->arena->ebo() : buffers_->handles->ebo();
+}
+
+VAO&
+DrawInfo::vao()
+{
+  return is_pooled() ? buffers_->arena->vao() : *buffers_->vao;
+}
+
+VAO const&
+DrawInfo::vao() const
+{
+  return is_pooled() ? buffers_->arena->vao() : *buffers_->vao;
+}
+
+DrawInfo
+DrawInfo::share() const
+{
+  auto buffers = buffers_;
+  return DrawInfo{MOVE(buffers)};
+}
+
 void
 DrawInfo::bind_impl(common::Logger& logger)
 {
@@ -119,7 +202,9 @@ DrawInfo::to_string() const
   std::string result;
   result += fmt::format("NumIndices: {} ", dinfo.num_indices());
   result += "VAO: " + dinfo.vao().to_string() + " ";
-  result += "BufferHandles: {" + dinfo.handles_.to_string() + "} ";
+  result += fmt::format("BufferHandles: {{vbo: {}, ebo: {}}} ", dinfo.vbo(), dinfo.ebo());
+  result += fmt::format("BaseVertex: {} FirstIndex: {} ", dinfo.base_vertex(), dinfo.first_index());
+  result += fmt::format("Shared: {} ", dinfo.is_shared());
   // auto const num_indices = dinfo.num_indices();
 
   // TODO: maybe need to bind the element buffer before calling glMapBuffer?
@@ -183,6 +268,24 @@ EntityDrawHandleMap::add(EntityID const eid, opengl::DrawInfo&& di)
   return pos;
 }
 
+void
+EntityDrawHandleMap::remove(EntityID const eid)
+{
+  auto const dih = find(eid);
+  assert(dih);
+
+  // Move the last DrawInfo into the removed one's slot, handles to the last DrawInfo are
+  // invalidated.
+  auto const index = dih->value;
+  auto const last  = drawinfos_.size() - 1;
+  if (index != last) {
+    drawinfos_[index] = MOVE(drawinfos_[last]);
+    entities_[index]  = entities_[last];
+  }
+  drawinfos_.pop_back();
+  entities_.pop_back();
+}
+
 bool
 EntityDrawHandleMap::has(DrawInfoHandle const dih) const
 {
@@ -226,6 +329,23 @@ DrawHandleManager::add_entity(EntityID const eid, DrawInfo&& dinfo)
   return entities_.add(eid, MOVE(dinfo));
 }
 
+bool
+DrawHandleManager::has_entity(EntityID const eid) const
+{
+  return entities().find(eid) != std::nullopt;
+}
+
+void
+DrawHandleManager::remove_entity(EntityID const eid)
+{
+  entities().remove(eid);
+  for (auto& lod : lods_) {
+    if (lod.find(eid)) {
+      lod.remove(eid);
+    }
+  }
+}
+
 EntityDrawHandleMap&
 DrawHandleManager::entities()
 {
@@ -264,9 +384,75 @@ DrawHandleManager::lookup_entity(common::Logger& logger, EntityID const eid) con
 
 #undef LOOKUP_MANAGER_IMPL
 
+DrawInfo&
+DrawHandleManager::lookup_entity_lod(common::Logger& logger, EntityID const eid, size_t const lod)
+{
+  if (lod == 0) {
+    return lookup_entity(logger, eid);
+  }
+  assert(lod <= lods_.size());
+  auto& map = lods_[lod - 1];
+  auto  p   = map.find(eid);
+  assert(p);
+  return map.get(*p);
+}
+
+size_t
+DrawHandleManager::num_lods(EntityID const eid) const
+{
+  // LODs are uploaded in order, the first missing LOD ends the chain.
+  size_t count = 1;
+  while (count <= lods_.size() && lods_[count - 1].find(eid)) {
+    ++count;
+  }
+  return count;
+}
+
+size_t
+DrawHandleManager::num_bytes(common::Logger& logger, EntityID const eid) const
+{
+  auto const drawinfo_bytes = [](DrawInfo const& dinfo) -> size_t {
+    return dinfo.is_shared() ? 0 : dinfo.num_bytes();
+  };
+
+  size_t bytes = drawinfo_bytes(lookup_entity(logger, eid));
+  for (auto const& lod : lods_) {
+    auto const p = lod.find(eid);
+    if (p) {
+      bytes += drawinfo_bytes(lod.get(*p));
+    }
+  }
+  return bytes;
+}
+
+size_t
+DrawHandleManager::share_bytes(common::Logger& logger, EntityID const eid) const
+{
+  auto const drawinfo_bytes = [](DrawInfo const& dinfo) -> size_t {
+    return dinfo.num_bytes() / dinfo.num_sharers();
+  };
+
+  size_t bytes = drawinfo_bytes(lookup_entity(logger, eid));
+  for (auto const& lod : lods_) {
+    auto const p = lod.find(eid);
+    if (p) {
+      bytes += drawinfo_bytes(lod.get(*p));
+    }
+  }
+  return bytes;
+}
+
 void
 DrawHandleManager::add_mesh(common::Logger& logger, ShaderPrograms& sps, ObjStore& obj_store,
                             EntityID const eid, EntityRegistry& registry)
+{
+  upload_mesh(logger, sps, obj_store, eid, registry);
+  AABoundingBox::add_mesh_to_entity(logger, obj_store, eid, registry);
+}
+
+DrawInfo&
+DrawHandleManager::upload_mesh(common::Logger& logger, ShaderPrograms& sps, ObjStore& obj_store,
+                               EntityID const eid, EntityRegistry& registry)
 {
   auto& sn = registry.get<ShaderName>(eid);
   auto& va = sps.ref_sp(logger, sn.value).va();
@@ -274,13 +460,24 @@ DrawHandleManager::add_mesh(common::Logger& logger, ShaderPrograms& sps, ObjStor
   auto const& mesh_name = registry.get<MeshRenderable>(eid).name;
   auto const& obj       = obj_store.get(logger, mesh_name);
 
-  auto       handle     = OG::copy_gpu(logger, va, obj);
+  auto constexpr POOLED  = OG::BufferStorage::POOLED;
+  auto       handle     = OG::copy_gpu(logger, va, obj, POOLED);
   auto const draw_index = add_entity(eid, MOVE(handle));
 
-  auto const  posbuffer = obj.positions();
-  auto const& min       = posbuffer.min();
-  auto const& max       = posbuffer.max();
-  AABoundingBox::add_to_entity(logger, sps, eid, registry, min, max);
+  auto const num_lods = std::min(obj_store.num_lods(mesh_name), lods_.size() + 1);
+  for (size_t lod = 1; lod < num_lods; ++lod) {
+    auto const& lod_obj = obj_store.get_lod(logger, mesh_name, lod).data;
+    lods_[lod - 1].add(eid, OG::copy_gpu(logger, va, lod_obj, POOLED));
+  }
+
+  // Visibility keeps the entity's current LOD here, switching as it's screen size changes.
+  if (num_lods > 1) {
+    if (!registry.has<MeshLodState>(eid)) {
+      registry.assign<MeshLodState>(eid);
+    }
+    registry.get<MeshLodState>(eid).num_lods = num_lods;
+  }
+  return entities().get(draw_index);
 }
 
 void
@@ -292,10 +489,51 @@ DrawHandleManager::add_cube(common::Logger& logger, ShaderPrograms& sps, EntityI
   auto&       va = sps.ref_sp(logger, sn.value).va();
 
   auto const vertices   = VertexFactory::build_cube(cr.min, cr.max);
-  auto       handle     = OG::copy_cube_gpu(logger, vertices, va);
-  auto const draw_index = add_entity(eid, MOVE(handle));
+  auto       handle     = OG::copy_cube_gpu(logger, vertices, va, OG::BufferStorage::POOLED);
+  add_entity(eid, MOVE(handle));
+}
+
+void
+DrawHandleManager::upload_terrain(common::Logger& logger, ShaderPrograms& sps,
+                                  TerrainGrid const& terrain_grid)
+{
+  terrain_.clear();
+  terrain_.reserve(terrain_grid.size());
+  FOR(i, terrain_grid.size()) { add_terrain_piece(logger, sps, terrain_grid, i); }
+}
+
+void
+DrawHandleManager::add_terrain_piece(common::Logger& logger, ShaderPrograms& sps,
+                                     TerrainGrid const& terrain_grid, size_t const index)
+{
+  assert(index == terrain_.size());
+  terrain_.emplace_back(copy_terrain_gpu(logger, sps, terrain_grid, index));
+}
+
+void
+DrawHandleManager::upload_terrain_piece(common::Logger& logger, ShaderPrograms& sps,
+                                        TerrainGrid const& terrain_grid, size_t const index)
+{
+  assert(index < terrain_.size());
+  terrain_[index] = copy_terrain_gpu(logger, sps, terrain_grid, index);
+}
+
+DrawInfo&
+DrawHandleManager::lookup_terrain(size_t const index)
+{
+  assert(index < terrain_.size());
+  return terrain_[index];
+}
 
-  AABoundingBox::add_to_entity(logger, sps, eid, registry, cr.min, cr.max);
+DrawInfo&
+DrawHandleManager::boundingbox(common::Logger& logger, ShaderPrograms& sps)
+{
+  if (!boundingbox_) {
+    auto&      va = sps.sp_wireframe(logger).va();
+    auto const cv = VertexFactory::build_cube(math::constants::ZERO, math::constants::ONE);
+    boundingbox_  = OG::copy_cube_wireframe_gpu(logger, cv, va, OG::BufferStorage::POOLED);
+  }
+  return *boundingbox_;
 }
 
 } // namespace opengl
@@ -9,16 +9,28 @@
 #include <boomhs/material.hpp>
 #include <boomhs/npc.hpp>
 #include <boomhs/player.hpp>
+#include <boomhs/render_snapshot.hpp>
 #include <boomhs/tree.hpp>
 #include <boomhs/view_frustum.hpp>
+#include <boomhs/visibility.hpp>
 #include <boomhs/zone_state.hpp>
 
+#include <algorithm>
+
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::render
+
 using namespace boomhs;
 using namespace opengl;
 
 namespace
 {
 
+Uniform<glm::mat4> const U_MV{"u_mv"};
+Uniform<ColorRGBA> const U_WIRECOLOR{"u_wirecolor"};
+Uniform<ColorRGB> const  U_COLOR{"u_color"};
+Uniform<float> const     U_GLOW{"u_glow"};
+
 // clang-format off
 #define RENDER_3D_ENTITIES(                                                                        \
     DRAW_COMMON_________FN,                                                                        \
@@ -67,39 +79,139 @@ draw_entity_common_without_binding_sp(RenderState& rstate, GLenum const dm, Shad
   auto&      logger       = es.logger;
   auto&      zs           = fstate.zs;
   auto&      registry     = zs.registry;
-  auto const model_matrix = transform.model_matrix();
+  auto const& snapshot    = zs.gfx_state.snapshot;
+
+  // The cached world matrix was computed from the entity's Transform. Callers may pass a copy of
+  // the Transform with a displaced translation (ie: torch flicker), the displacement is applied on
+  // top of the world matrix.
+  auto const& world_matrix = snapshot.get<WorldMatrix>(eid).value;
+  auto const  displacement = transform.translation - snapshot.get<Transform>(eid).translation;
+  auto const  model_matrix = glm::translate(glm::mat4{1.0f}, displacement) * world_matrix;
 
   bool const is_lightsource = registry.has<PointLight>(eid);
   bool const receives_light = registry.has<Material>(eid);
 
   BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
   if (is_lightsource) {
-    LOG_WARN("LIGHTSOURCE");
+    LOG_TRACE("LIGHTSOURCE");
     render::draw_3dlightsource(rstate, dm, model_matrix, sp, dinfo, eid, registry);
   }
   else if (receives_light) {
-    LOG_WARN("RECEVIES LIGHT");
+    LOG_TRACE("RECEVIES LIGHT");
     auto const& tr = transform.translation;
     draw_shape_with_light(rstate, dm, eid, registry, sp, dinfo, tr, model_matrix);
     return;
   }
   else {
-    LOG_WARN("WITHOUT LIGHT");
+    LOG_TRACE("WITHOUT LIGHT");
     render::draw(logger, rstate.ds, dm, sp, dinfo);
   }
 }
 
+// Find the entity's DrawInfo, for the LOD picked this frame (see Visibility::build).
+//
+// Returns nullptr when the entity's mesh isn't on the GPU yet, requesting that it be uploaded.
+DrawInfo*
+find_drawinfo(common::Logger& logger, ZoneState& zs, EntityID const eid)
+{
+  auto& gfx_state = zs.gfx_state;
+  auto& registry  = zs.registry;
+  if (registry.has<StreamedMesh>(eid) && !gfx_state.residency.request(eid)) {
+    return nullptr;
+  }
+
+  auto& draw_handles = gfx_state.draw_handles;
+  if (!registry.has<MeshLodState>(eid)) {
+    return &draw_handles.lookup_entity(logger, eid);
+  }
+  auto const lod = std::min(registry.get<MeshLodState>(eid).lod, draw_handles.num_lods(eid) - 1);
+  return &draw_handles.lookup_entity_lod(logger, eid, lod);
+}
+
+// The model matrix scaling the DrawHandleManager's unit wireframe cube onto the bounding box.
+glm::mat4
+boundingbox_model_matrix(glm::mat4 const& world_matrix, AABoundingBox const& bbox)
+{
+  auto const& cube = bbox.cube;
+  auto const  tm   = glm::translate(glm::mat4{1.0f}, cube.min);
+  return world_matrix * glm::scale(tm, cube.max - cube.min);
+}
+
+// Draw the entity's bounding box in place of a mesh that is still being copied to the GPU.
+void
+draw_placeholder(RenderState& rstate, EntityID const eid, AABoundingBox& bbox)
+{
+  auto& fstate = rstate.fs;
+  auto& es     = fstate.es;
+  auto& logger = es.logger;
+  auto& zs     = fstate.zs;
+
+  auto& gfx_state    = zs.gfx_state;
+  auto& sp           = gfx_state.sps.sp_wireframe(logger);
+  auto const& matrix = gfx_state.snapshot.get<WorldMatrix>(eid).value;
+  BIND_UNTIL_END_OF_SCOPE(logger, sp);
+  shader::set_uniform(logger, sp, U_WIRECOLOR, LOC4::GRAY);
+
+  auto const model_matrix = boundingbox_model_matrix(matrix, bbox);
+  auto&      dinfo        = gfx_state.draw_handles.boundingbox(logger, gfx_state.sps);
+
+  BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
+  render::set_mvpmatrix(logger, fstate.camera_matrix(), model_matrix, sp);
+  render::draw(logger, rstate.ds, GL_LINES, sp, dinfo);
+}
+
+// The entity's component "C". The components the simulation writes are read from the frame's
+// RenderSnapshot, the simulation may be writing the registry's.
+template <typename C>
+decltype(auto)
+component(RenderState& rstate, EntityID const eid)
+{
+  auto& zs = rstate.fs.zs;
+  if constexpr (IsSnapshotComponent<C>::value) {
+    return zs.gfx_state.snapshot.get<C>(eid);
+  }
+  else {
+    return zs.registry.get<C>(eid);
+  }
+}
+
+// Invoke "fn" with every entity (and it's components "C") of the registry's view.
+template <typename... C, typename FN>
+void
+each_in_view(RenderState& rstate, FN const& fn)
+{
+  for (auto const eid : rstate.fs.zs.registry.view<C...>()) {
+    fn(eid, component<C>(rstate, eid)...);
+  }
+}
+
+// Invoke "fn" with every entity (and it's components "C") in the bucket of the pass' visible set.
+// Passes without a visible set walk the registry's view instead.
+template <typename... C, typename FN>
+void
+each_entity(RenderState& rstate, RenderBucket const bucket, FN const& fn)
+{
+  if (!rstate.visible) {
+    each_in_view<C...>(rstate, fn);
+    return;
+  }
+  for (auto const eid : rstate.visible->bucket(bucket)) {
+    fn(eid, component<C>(rstate, eid)...);
+  }
+}
+
 // This function performs more work than just drawing the shapes directly.
 //
-// 1. It checks if the entity is visible, returning early if it is.
-// 2. It looks up the DrawInfo in the "Entity handlemap" passed in.
+// 1. It checks if the entity is visible (inside the view frustum and not occluded), returning early
+//    if it isn't. Entities from the pass' visible set were already culled.
+// 2. It looks up the DrawInfo of the entity's LOD, drawing a placeholder if it isn't on the GPU
+//    yet.
 // 3. It binds the provided shader program
 // 4. Draws the entity.
 template <typename... Args>
 void
 draw_entity(RenderState& rstate, GLenum const dm, ShaderProgram& sp, EntityID const eid,
-            DrawInfo& dinfo, Transform& transform, IsRenderable& is_r, AABoundingBox& bbox,
-            Args&&... args)
+            Transform const& transform, IsRenderable& is_r, AABoundingBox& bbox, Args&&... args)
 {
   // If entity is not visible, just return.
   if (is_r.hidden) {
@@ -111,20 +223,35 @@ draw_entity(RenderState& rstate, GLenum const dm, ShaderProgram& sp, EntityID co
   auto& logger = es.logger;
   auto& zs     = fstate.zs;
 
-  glm::mat4 const& view_mat = fstate.view_matrix();
-  glm::mat4 const& proj_mat = fstate.projection_matrix();
-  if (!ViewFrustum::bbox_inside(view_mat, proj_mat, transform, bbox)) {
+  if (!rstate.visible) {
+    glm::mat4 const& view_mat = fstate.view_matrix();
+    glm::mat4 const& proj_mat = fstate.projection_matrix();
+    if (!ViewFrustum::bbox_inside(view_mat, proj_mat, transform, bbox)) {
+      return;
+    }
+
+    // Or hidden behind the terrain (or another occluder).
+    auto&       occlusion    = zs.gfx_state.occlusion;
+    auto const& model_matrix = zs.gfx_state.snapshot.get<WorldMatrix>(eid).value;
+    if (!occlusion.visible(fstate.camera_matrix(), model_matrix, bbox.cube)) {
+      return;
+    }
+  }
+
+  auto* dinfo = find_drawinfo(logger, zs, eid);
+  if (!dinfo) {
+    draw_placeholder(rstate, eid, bbox);
     return;
   }
 
   sp.while_bound(logger, [&]() {
-    draw_entity_common_without_binding_sp(rstate, dm, sp, dinfo, eid, transform);
+    draw_entity_common_without_binding_sp(rstate, dm, sp, *dinfo, eid, transform);
   });
 }
 
 void
-draw_orbital_body(RenderState& rstate, ShaderProgram& sp, EntityID const eid, Transform& transform,
-                  IsRenderable& is_r, AABoundingBox& bbox, BillboardRenderable& bboard,
+draw_orbital_body(RenderState& rstate, ShaderProgram& sp, EntityID const eid,
+                  Transform const& transform, IsRenderable& is_r, AABoundingBox& bbox, BillboardRenderable& bboard,
                   OrbitalBody&, TextureRenderable& trenderable)
 {
   auto& fstate = rstate.fs;
@@ -137,21 +264,17 @@ draw_orbital_body(RenderState& rstate, ShaderProgram& sp, EntityID const eid, Tr
   auto const proj_matrix = fstate.projection_matrix();
   auto const mvp_matrix  = proj_matrix * view_model;
   sp.while_bound(logger, [&]() {
-      shader::set_uniform(logger, sp, "u_mv", mvp_matrix);
+      shader::set_uniform(logger, sp, U_MV, mvp_matrix);
     // render::set_modelmatrix(logger, mvp_matrix, sp);
   });
 
-  auto* ti = trenderable.texture_info;
-  assert(ti);
+  auto& gfx_state = fstate.zs.gfx_state;
+  auto& ti        = gfx_state.residency.texture(logger, gfx_state.texture_table, trenderable.handle);
 
   ENABLE_ALPHA_BLENDING_UNTIL_SCOPE_EXIT();
 
-  auto& zs           = fstate.zs;
-  auto& draw_handles = zs.gfx_state.draw_handles;
-  auto& dinfo        = draw_handles.lookup_entity(logger, eid);
-
-  BIND_UNTIL_END_OF_SCOPE(logger, *ti);
-  draw_entity(rstate, GL_TRIANGLES, sp, eid, dinfo, transform, is_r, bbox);
+  BIND_UNTIL_END_OF_SCOPE(logger, ti);
+  draw_entity(rstate, GL_TRIANGLES, sp, eid, transform, is_r, bbox);
 }
 
 template <typename DrawCommonFN, typename DrawTorchFN, typename DrawDefaultEntityFN,
@@ -168,39 +291,39 @@ render_common_3d_entities(RenderState& rstate, RNG& rng, FrameTime const& ft,
 
   LOG_TRACE("================ BEGIN RENDERING COMMON 3D ENTITIES ================");
 
-  auto& zs       = fstate.zs;
-  auto& registry = zs.registry;
-
-  // define rendering order here
+  // define rendering order here (the same order as RenderBucket)
 
   LOG_TRACE("Rendering Torch");
-  registry.view<Common..., TextureRenderable, Torch>().each(draw_torch_fn);
+  each_entity<Common..., TextureRenderable, Torch>(rstate, RenderBucket::Torch, draw_torch_fn);
 
   LOG_TRACE("Rendering Book");
-  registry.view<Common..., TextureRenderable, Book>().each(draw_default_entity_fn);
+  each_entity<Common..., TextureRenderable, Book>(rstate, RenderBucket::Book,
+                                                  draw_default_entity_fn);
 
   LOG_TRACE("Rendering Weapon");
-  registry.view<Common..., TextureRenderable, Weapon>().each(draw_default_entity_fn);
+  each_entity<Common..., TextureRenderable, Weapon>(rstate, RenderBucket::Weapon,
+                                                    draw_default_entity_fn);
 
   LOG_TRACE("Rendering Junk");
-  registry.view<Common..., JunkEntityFromFILE>().each(draw_default_entity_fn);
+  each_entity<Common..., JunkEntityFromFILE>(rstate, RenderBucket::Junk, draw_default_entity_fn);
 
   LOG_TRACE("Rendering Trees");
-  registry.view<Common..., TreeComponent>().each(draw_common_fn);
+  each_entity<Common..., TreeComponent>(rstate, RenderBucket::Tree, draw_common_fn);
 
   // CUBES
   LOG_TRACE("Rendering Pointlights");
-  registry.view<Common..., CubeRenderable, PointLight>().each(draw_pointlight_fn);
+  each_entity<Common..., CubeRenderable, PointLight>(rstate, RenderBucket::Pointlight,
+                                                     draw_pointlight_fn);
 
   LOG_TRACE("Rendering NPCs");
-  registry.view<Common..., MeshRenderable, NPCData>().each(
-      [&](auto&&... args) { draw_common_fn(FORWARD(args)); });
+  each_entity<Common..., MeshRenderable, NPCData>(
+      rstate, RenderBucket::NPC, [&](auto&&... args) { draw_common_fn(FORWARD(args)); });
 
   // Only render the player if the camera isn't in FPS mode.
   if (CameraMode::FPS != fstate.camera_mode()) {
     LOG_TRACE("Rendering Player");
-    registry.view<Common..., MeshRenderable, Player>().each(
-        [&](auto&&... args) { draw_common_fn(FORWARD(args)); });
+    each_entity<Common..., MeshRenderable, Player>(
+        rstate, RenderBucket::Player, [&](auto&&... args) { draw_common_fn(FORWARD(args)); });
   }
   LOG_TRACE("================ END RENDERING COMMON 3D ENTITIES ================");
 }
@@ -221,8 +344,7 @@ EntityRenderer::render2d_billboard(RenderState& rstate, RNG& rng, FrameTime cons
   auto& zs           = fstate.zs;
   auto& draw_handles = zs.gfx_state.draw_handles;
 
-  auto& registry = zs.registry;
-  auto& sps      = zs.gfx_state.sps;
+  auto& sps = zs.gfx_state.sps;
 
 #define COMMON ShaderName, Transform, IsRenderable, AABoundingBox
 #define COMMON_ARGS auto const eid, auto &sn, auto &transform, auto &is_r, auto &bbox
@@ -233,8 +355,8 @@ EntityRenderer::render2d_billboard(RenderState& rstate, RNG& rng, FrameTime cons
   };
 
   LOG_TRACE("BEGIN Rendering 2d billboard entities with Default Entity Renderer");
-  registry.view<COMMON, BillboardRenderable, OrbitalBody, TextureRenderable>().each(
-      draw_orbital_fn);
+  each_entity<COMMON, BillboardRenderable, OrbitalBody, TextureRenderable>(
+      rstate, RenderBucket::OrbitalBody, draw_orbital_fn);
 
   LOG_TRACE("BEGIN drawing target reticle with Default Entity Renderer");
   render::draw_targetreticle(rstate, ft);
@@ -249,20 +371,21 @@ EntityRenderer::render2d_ui(RenderState& rstate, RNG& rng, FrameTime const& ft)
 void
 EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
 {
-  auto&       fstate       = rstate.fs;
-  auto const& es           = fstate.es;
-  auto&       logger       = es.logger;
-  auto&       zs           = fstate.zs;
-  auto&       draw_handles = zs.gfx_state.draw_handles;
+  auto&       fstate = rstate.fs;
+  auto const& es     = fstate.es;
+  auto&       logger = es.logger;
+  auto&       zs     = fstate.zs;
 
-  auto& registry = zs.registry;
-  auto& sps      = zs.gfx_state.sps;
+  auto& registry     = zs.registry;
+  auto& sps          = zs.gfx_state.sps;
+  auto& draw_handles = zs.gfx_state.draw_handles;
+  auto& residency    = zs.gfx_state.residency;
+  auto& ttable       = zs.gfx_state.texture_table;
 
   auto const draw_common_fn = [&](COMMON_ARGS, auto&&... args) {
     auto& sp = sps.ref_sp(logger, sn.value);
     assert(!sp.is_2d);
-    auto& dinfo = draw_handles.lookup_entity(logger, eid);
-    draw_entity(rstate, GL_TRIANGLES, sp, eid, dinfo, transform, is_r, bbox, FORWARD(args));
+    draw_entity(rstate, GL_TRIANGLES, sp, eid, transform, is_r, bbox, FORWARD(args));
   };
 
   auto const draw_default_entity_fn = [&](COMMON_ARGS, auto&&...) {
@@ -272,14 +395,12 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
       assert(!registry.has<Color>(eid));
 
       auto& tr = registry.get<TextureRenderable>(eid);
-      auto* ti = tr.texture_info;
-      assert(ti);
-      ti->while_bound(logger, [&]() { draw_common_fn(eid, sn, transform, is_r, bbox, tr); });
+      auto& ti = residency.texture(logger, ttable, tr.handle);
+      ti.while_bound(logger, [&]() { draw_common_fn(eid, sn, transform, is_r, bbox, tr); });
     }
     else {
       // assert(registry.has<Color>(eid));
-      auto& dinfo = draw_handles.lookup_entity(logger, eid);
-      draw_entity(rstate, GL_TRIANGLES, sp, eid, dinfo, transform, is_r, bbox);
+      draw_entity(rstate, GL_TRIANGLES, sp, eid, transform, is_r, bbox);
     }
   };
   auto const draw_torch_fn = [&](COMMON_ARGS, TextureRenderable& trenderable, Torch& torch) {
@@ -292,7 +413,7 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
       static constexpr double SPEED = 0.135;
       auto const              a     = std::sin(ft.since_start_millis() * M_PI * SPEED);
       float const             glow  = glm::lerp(MIN, MAX, std::abs(a));
-      sp.while_bound(logger, [&]() { shader::set_uniform(logger, sp, "u_glow", glow); });
+      sp.while_bound(logger, [&]() { shader::set_uniform(logger, sp, U_GLOW, glow); });
     }
 
     // randomize the position slightly
@@ -303,13 +424,12 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
     copy_transform.translation.y += rng.gen_float_range(-DISPLACEMENT_MAX, DISPLACEMENT_MAX);
     copy_transform.translation.z += rng.gen_float_range(-DISPLACEMENT_MAX, DISPLACEMENT_MAX);
 
-    auto* ti = trenderable.texture_info;
-    assert(ti);
-    ti->while_bound(logger, [&]() { draw_common_fn(eid, sn, copy_transform, is_r, bbox, torch); });
+    auto& ti = residency.texture(logger, ttable, trenderable.handle);
+    ti.while_bound(logger, [&]() { draw_common_fn(eid, sn, copy_transform, is_r, bbox, torch); });
   };
 
   auto const draw_boundingboxes = [&](std::pair<Color, Color> const& colors, EntityID const eid,
-                                      Transform& transform, AABoundingBox& bbox, Selectable& sel,
+                                      Transform const&, AABoundingBox& bbox, Selectable& sel,
                                       auto&&...) {
     if (!es.draw_bounding_boxes) {
       return;
@@ -317,15 +437,15 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
     Color const wire_color = sel.selected ? colors.first : colors.second;
 
     auto& sp = sps.sp_wireframe(logger);
-    auto  tr = transform;
 
     BIND_UNTIL_END_OF_SCOPE(logger, sp);
-    shader::set_uniform(logger, sp, "u_wirecolor", wire_color);
+    shader::set_uniform(logger, sp, U_WIRECOLOR, wire_color);
 
     // We needed to bind the shader program to set the uniforms above, no reason to pay to bind
     // it again.
-    auto const model_matrix = tr.model_matrix();
-    auto&      dinfo        = bbox.draw_info;
+    auto const& world_matrix = zs.gfx_state.snapshot.get<WorldMatrix>(eid).value;
+    auto const  model_matrix = boundingbox_model_matrix(world_matrix, bbox);
+    auto&       dinfo        = draw_handles.boundingbox(logger, sps);
 
     BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
     auto const camera_matrix = fstate.camera_matrix();
@@ -341,11 +461,12 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
   LOG_TRACE("END Rendering 3d entities with Default Entity Renderer");
 
 #define COMMON_BBOX Transform, AABoundingBox, Selectable
-  registry.view<COMMON_BBOX>().each(
-      [&](auto&&... args) { draw_boundingboxes(PAIR(LOC4::GREEN, LOC4::RED), FORWARD(args)); });
+  each_in_view<COMMON_BBOX>(
+      rstate, [&](auto&&... args) { draw_boundingboxes(PAIR(LOC4::GREEN, LOC4::RED), FORWARD(args)); });
 
-  registry.view<COMMON_BBOX, WaterInfo>().each(
-      [&](auto&&... args) { draw_boundingboxes(PAIR(LOC4::BLUE, LOC4::ORANGE), FORWARD(args)); });
+  each_in_view<COMMON_BBOX, WaterInfo>(rstate, [&](auto&&... args) {
+    draw_boundingboxes(PAIR(LOC4::BLUE, LOC4::ORANGE), FORWARD(args));
+  });
 #undef COMMON_BBOX
 }
 
@@ -354,11 +475,10 @@ EntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime const& ft)
 void
 SilhouetteEntityRenderer::render2d_billboard(RenderState& rstate, RNG& rng, FrameTime const& ft)
 {
-  auto&       fstate   = rstate.fs;
-  auto const& es       = fstate.es;
-  auto&       logger   = es.logger;
-  auto&       zs       = fstate.zs;
-  auto&       registry = zs.registry;
+  auto&       fstate = rstate.fs;
+  auto const& es     = fstate.es;
+  auto&       logger = es.logger;
+  auto&       zs     = fstate.zs;
 
   auto& gfx_state = zs.gfx_state;
   auto& sps       = gfx_state.sps;
@@ -366,14 +486,14 @@ SilhouetteEntityRenderer::render2d_billboard(RenderState& rstate, RNG& rng, Fram
   auto const draw_orbital_fn = [&](COMMON_ARGS, auto&&... args) {
     auto& sp = sps.sp_silhoutte_2d(logger);
 
-    sp.while_bound(logger, [&]() { shader::set_uniform(logger, sp, "u_color", LOC3::WHITE); });
+    sp.while_bound(logger, [&]() { shader::set_uniform(logger, sp, U_COLOR, LOC3::WHITE); });
 
     draw_orbital_body(rstate, sp, eid, transform, is_r, bbox, FORWARD(args));
   };
 
   LOG_TRACE("BEGIN Rendering Billboard entities with SilhouetteEntityRenderer");
-  registry.view<COMMON, BillboardRenderable, OrbitalBody, TextureRenderable>().each(
-      draw_orbital_fn);
+  each_entity<COMMON, BillboardRenderable, OrbitalBody, TextureRenderable>(
+      rstate, RenderBucket::OrbitalBody, draw_orbital_fn);
   LOG_TRACE("END Rendering Billboard entities with SilhouetteEntityRenderer");
 
   auto const draw_pointlight_fn = [&](COMMON_ARGS, auto&&... args) {};
@@ -392,22 +512,25 @@ SilhouetteEntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime cons
   auto&       logger = es.logger;
   auto&       zs     = fstate.zs;
 
-  auto& gfx_state    = zs.gfx_state;
-  auto& sps          = gfx_state.sps;
-  auto& draw_handles = gfx_state.draw_handles;
+  auto& gfx_state = zs.gfx_state;
+  auto& sps       = gfx_state.sps;
 
   auto const draw_common_fn = [&](COMMON_ARGS, auto&&... args) {
     auto& sp = sps.sp_silhoutte_3d(logger);
     if (!sp.is_2d) {
-      auto& dinfo = draw_handles.lookup_entity(logger, eid);
+      // Meshes still being copied to the GPU have no silhouette.
+      auto* dinfo = find_drawinfo(logger, zs, eid);
+      if (!dinfo) {
+        return;
+      }
 
       BIND_UNTIL_END_OF_SCOPE(logger, sp);
-      BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
+      BIND_UNTIL_END_OF_SCOPE(logger, *dinfo);
 
-      auto const camera_matrix = fstate.camera_matrix();
-      auto const model_matrix  = transform.model_matrix();
+      auto const  camera_matrix = fstate.camera_matrix();
+      auto const& model_matrix  = gfx_state.snapshot.get<WorldMatrix>(eid).value;
       render::set_mvpmatrix(logger, camera_matrix, model_matrix, sp);
-      render::draw(logger, rstate.ds, GL_TRIANGLES, sp, dinfo);
+      render::draw(logger, rstate.ds, GL_TRIANGLES, sp, *dinfo);
     }
   };
 
@@ -415,8 +538,7 @@ SilhouetteEntityRenderer::render3d(RenderState& rstate, RNG& rng, FrameTime cons
     auto& sp = sps.ref_sp(logger, sn.value);
 
     if (!sp.is_2d) {
-      auto& dinfo = draw_handles.lookup_entity(logger, eid);
-      draw_entity(rstate, GL_TRIANGLES, sp, eid, dinfo, transform, is_r, bbox, FORWARD(args));
+      draw_entity(rstate, GL_TRIANGLES, sp, eid, transform, is_r, bbox, FORWARD(args));
     }
   };
 
@@ -1,4 +1,5 @@
 #include <opengl/framebuffer.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/renderer.hpp>
 
 using namespace boomhs;
@@ -16,8 +17,8 @@ make_fb_ti(common::Logger& logger, int const width, int const height, GLenum con
   ti.target = GL_TEXTURE_2D;
   ti.gen_texture(logger, 1);
 
-  glActiveTexture(tu);
-  ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+  GLState::active_texture(tu);
+  ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
 
   ti.while_bound(logger, [&]() {
     ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -40,18 +41,19 @@ FBInfo::FBInfo() { glGenFramebuffers(1, &id); }
 void
 FBInfo::bind_impl(common::Logger& logger)
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, id);
+  GLState::bind_framebuffer(id);
 }
 
 void
 FBInfo::unbind_impl(common::Logger& logger)
 {
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  GLState::bind_framebuffer(0);
 }
 
 void
 FBInfo::destroy_impl()
 {
+  GLState::delete_framebuffer(id);
   glDeleteFramebuffers(1, &id);
 }
 
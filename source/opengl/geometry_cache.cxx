@@ -0,0 +1,142 @@
+#include <opengl/geometry_cache.hpp>
+#include <opengl/vertex_attribute.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace
+{
+
+uint64_t constexpr FNV_OFFSET_BASIS = 14695981039346656037ull;
+uint64_t constexpr FNV_PRIME        = 1099511628211ull;
+
+// FNV-1a, continuing from "hash".
+uint64_t
+hash_bytes(uint64_t hash, void const* data, size_t const num_bytes)
+{
+  auto const* bytes = static_cast<uint8_t const*>(data);
+  for (size_t i = 0; i < num_bytes; ++i) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+struct KeyHash
+{
+  size_t operator()(opengl::GeometryCache::Key const& key) const
+  {
+    return static_cast<size_t>(key.hash);
+  }
+};
+
+template <typename T>
+void
+append_value(std::vector<uint8_t>& bytes, T const& value)
+{
+  auto const* begin = reinterpret_cast<uint8_t const*>(&value);
+  bytes.insert(bytes.end(), begin, begin + sizeof(T));
+}
+
+// Expired entries (the buffers were freed) are removed once the cache grows past this many entries,
+// the limit then doubles the number of entries left.
+size_t constexpr MIN_PURGE_SIZE = 64;
+
+using WeakBuffers = std::weak_ptr<opengl::DrawBuffers>;
+std::unordered_map<opengl::GeometryCache::Key, WeakBuffers, KeyHash> ENTRIES;
+
+size_t PURGE_SIZE = MIN_PURGE_SIZE;
+size_t HITS       = 0;
+size_t MISSES     = 0;
+
+void
+purge_expired()
+{
+  for (auto it = ENTRIES.begin(); it != ENTRIES.end();) {
+    it = it->second.expired() ? ENTRIES.erase(it) : std::next(it);
+  }
+  PURGE_SIZE = std::max(MIN_PURGE_SIZE, ENTRIES.size() * 2);
+}
+
+} // namespace
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GeometryCache
+bool
+GeometryCache::Key::operator==(Key const& other) const
+{
+  return hash == other.hash && vertex_bytes == other.vertex_bytes &&
+         num_indices == other.num_indices && layout == other.layout;
+}
+
+GeometryCache::Key
+GeometryCache::make_key(VertexAttribute const& va, void const* vertices, size_t const vertices_size,
+                        GLuint const* indices, size_t const num_indices)
+{
+  Key key;
+  key.vertex_bytes = vertices_size;
+  key.num_indices  = num_indices;
+
+  // The fields are copied one at a time, the structs may contain padding.
+  append_value(key.layout, va.stride());
+  for (auto const& api : va) {
+    append_value(key.layout, api.index);
+    append_value(key.layout, api.datatype);
+    append_value(key.layout, api.component_count);
+    append_value(key.layout, api.normalized);
+  }
+
+  key.hash = hash_bytes(FNV_OFFSET_BASIS, vertices, vertices_size);
+  key.hash = hash_bytes(key.hash, indices, num_indices * sizeof(GLuint));
+  return key;
+}
+
+std::shared_ptr<DrawBuffers>
+GeometryCache::find(Key const& key, Matches const& matches)
+{
+  auto const it      = ENTRIES.find(key);
+  auto       buffers = it == ENTRIES.end() ? nullptr : it->second.lock();
+  if (!buffers || !matches(*buffers)) {
+    ++MISSES;
+    return nullptr;
+  }
+  ++HITS;
+  return buffers;
+}
+
+void
+GeometryCache::insert(Key&& key, DrawInfo const& dinfo)
+{
+  if (ENTRIES.size() >= PURGE_SIZE) {
+    purge_expired();
+  }
+  ENTRIES[MOVE(key)] = dinfo.buffers_;
+}
+
+size_t
+GeometryCache::num_hits()
+{
+  return HITS;
+}
+
+size_t
+GeometryCache::num_misses()
+{
+  return MISSES;
+}
+
+size_t
+GeometryCache::num_entries()
+{
+  size_t count = 0;
+  for (auto const& it : ENTRIES) {
+    count += it.second.expired() ? 0 : 1;
+  }
+  return count;
+}
+
+} // namespace opengl
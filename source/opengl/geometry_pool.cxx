@@ -0,0 +1,353 @@
+#include <opengl/geometry_pool.hpp>
+#include <opengl/gpu_memory.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+
+bool
+same_layout(opengl::VertexAttribute const& a, opengl::VertexAttribute const& b)
+{
+  auto const same_api = [](auto const& x, auto const& y) {
+    return x.index == y.index && x.datatype == y.datatype &&
+           x.component_count == y.component_count && x.normalized == y.normalized;
+  };
+  return a.stride() == b.stride() && std::equal(a.begin(), a.end(), b.begin(), same_api);
+}
+
+// Arenas hold a weak reference, the geometry in an arena keeps it alive.
+std::vector<std::weak_ptr<opengl::GeometryArena>> ARENAS;
+
+} // namespace
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// RangeAllocator
+RangeAllocator::RangeAllocator(size_t const capacity)
+    : capacity_(capacity)
+    , num_free_(capacity)
+{
+  if (capacity > 0) {
+    free_.emplace(0, capacity);
+  }
+}
+
+std::optional<size_t>
+RangeAllocator::allocate(size_t const count)
+{
+  auto const fits = [&count](auto const& range) { return range.second >= count; };
+  auto const it   = std::find_if(free_.begin(), free_.end(), fits);
+  if (it == free_.end()) {
+    return std::nullopt;
+  }
+
+  auto const offset    = it->first;
+  auto const remaining = it->second - count;
+  free_.erase(it);
+  if (remaining > 0) {
+    free_.emplace(offset + count, remaining);
+  }
+  num_free_ -= count;
+  return offset;
+}
+
+void
+RangeAllocator::free(size_t offset, size_t count)
+{
+  assert(offset + count <= capacity_);
+  num_free_ += count;
+
+  // Merge with the free range after.
+  auto next = free_.lower_bound(offset);
+  if (next != free_.end() && next->first == offset + count) {
+    count += next->second;
+    next = free_.erase(next);
+  }
+
+  // Merge with the free range before.
+  if (next != free_.begin()) {
+    auto const prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      prev->second += count;
+      return;
+    }
+  }
+  free_.emplace(offset, count);
+}
+
+void
+RangeAllocator::compact(size_t const count)
+{
+  assert(count <= capacity_);
+  free_.clear();
+  if (count < capacity_) {
+    free_.emplace(count, capacity_ - count);
+  }
+  num_free_ = capacity_ - count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GeometryArena
+GeometryArena::GeometryArena(common::Logger& logger, VertexAttribute const& va,
+                             size_t const num_vertices, size_t const num_indices,
+                             size_t const max_vertices, size_t const max_indices)
+    : va_(va.clone())
+    , vertices_(num_vertices)
+    , indices_(num_indices)
+    , min_vertices_(num_vertices)
+    , min_indices_(num_indices)
+    , max_vertices_(std::max(num_vertices, max_vertices))
+    , max_indices_(std::max(num_indices, max_indices))
+{
+  create_buffers(logger);
+  GpuMemory::allocated(GpuMemory::ARENAS, num_bytes());
+}
+
+GeometryArena::~GeometryArena() { GpuMemory::freed(GpuMemory::ARENAS, num_bytes()); }
+
+size_t
+GeometryArena::num_bytes() const
+{
+  return (vertices_.capacity() * va_.stride()) + (indices_.capacity() * sizeof(GLuint));
+}
+
+void
+GeometryArena::create_buffers(common::Logger& logger)
+{
+  auto const vertex_bytes = vertices_.capacity() * va_.stride();
+  auto const index_bytes  = indices_.capacity() * sizeof(GLuint);
+
+  vao_.while_bound(logger, [&]() {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo());
+    va_.upload_vertex_format_to_glbound_vao(logger);
+
+    glBufferData(GL_ARRAY_BUFFER, vertex_bytes, nullptr, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_bytes, nullptr, GL_STATIC_DRAW);
+  });
+}
+
+bool
+GeometryArena::allocate(common::Logger& logger, DrawBuffers& buffers)
+{
+  assert(!buffers.arena);
+  auto const num_vertices = buffers.vertex_bytes / va_.stride();
+  auto const num_indices  = buffers.num_indices;
+  if (num_vertices > vertices_.num_free() || num_indices > indices_.num_free()) {
+    auto const needed_vertices = vertices_.num_used() + num_vertices;
+    auto const needed_indices  = indices_.num_used() + num_indices;
+    if (needed_vertices > max_vertices_ || needed_indices > max_indices_) {
+      return false;
+    }
+
+    // Double the buffers that are too small (up to their maximum size), or more if the geometry
+    // needs it. The ranges are compacted along the way.
+    auto const grow = [](size_t const capacity, size_t const needed, size_t const max) {
+      return needed <= capacity ? capacity : std::min(std::max(capacity * 2, needed), max);
+    };
+    relocate(logger, grow(vertices_.capacity(), needed_vertices, max_vertices_),
+             grow(indices_.capacity(), needed_indices, max_indices_));
+  }
+
+  auto vertex_offset = vertices_.allocate(num_vertices);
+  auto index_offset  = indices_.allocate(num_indices);
+  if (!vertex_offset || !index_offset) {
+    // There is enough room, just not in one piece.
+    if (vertex_offset) {
+      vertices_.free(*vertex_offset, num_vertices);
+    }
+    if (index_offset) {
+      indices_.free(*index_offset, num_indices);
+    }
+    compact(logger);
+    vertex_offset = vertices_.allocate(num_vertices);
+    index_offset  = indices_.allocate(num_indices);
+    assert(vertex_offset && index_offset);
+  }
+
+  buffers.base_vertex = static_cast<GLint>(*vertex_offset);
+  buffers.first_index = static_cast<GLuint>(*index_offset);
+  buffers.arena       = shared_from_this();
+  allocations_.emplace_back(&buffers);
+  return true;
+}
+
+void
+GeometryArena::free(DrawBuffers& buffers)
+{
+  assert(buffers.arena.get() == this);
+  vertices_.free(buffers.base_vertex, buffers.vertex_bytes / va_.stride());
+  indices_.free(buffers.first_index, buffers.num_indices);
+
+  auto const it = std::find(allocations_.begin(), allocations_.end(), &buffers);
+  assert(it != allocations_.end());
+  allocations_.erase(it);
+}
+
+void
+GeometryArena::upload(DrawBuffers const& buffers, void const* vertices, GLuint const* indices)
+{
+  assert(buffers.arena.get() == this);
+
+  // The copy targets don't change the bound vertex array's element buffer.
+  glBindBuffer(GL_COPY_WRITE_BUFFER, vbo());
+  glBufferSubData(GL_COPY_WRITE_BUFFER, buffers.base_vertex * va_.stride(), buffers.vertex_bytes,
+                  vertices);
+
+  auto const index_bytes = buffers.num_indices * sizeof(GLuint);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, ebo());
+  glBufferSubData(GL_COPY_WRITE_BUFFER, buffers.first_index * sizeof(GLuint), index_bytes, indices);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void
+GeometryArena::compact(common::Logger& logger)
+{
+  relocate(logger, vertices_.capacity(), indices_.capacity());
+}
+
+bool
+GeometryArena::shrink(common::Logger& logger)
+{
+  auto const shrunk = [](RangeAllocator const& range, size_t const min) {
+    auto capacity = range.capacity();
+    while ((capacity / 2) >= min && (range.num_used() * 4) <= capacity) {
+      capacity /= 2;
+    }
+    return capacity;
+  };
+  auto const num_vertices = shrunk(vertices_, min_vertices_);
+  auto const num_indices  = shrunk(indices_, min_indices_);
+  if (num_vertices == vertices_.capacity() && num_indices == indices_.capacity()) {
+    return false;
+  }
+  relocate(logger, num_vertices, num_indices);
+  return true;
+}
+
+void
+GeometryArena::relocate(common::Logger& logger, size_t const num_vertices,
+                        size_t const num_indices)
+{
+  LOG_DEBUG_SPRINTF("Relocating geometry arena (%lu allocations, %lu free vertex ranges) into "
+                    "%lu vertices, %lu indices",
+                    allocations_.size(), vertices_.num_free_ranges(), num_vertices, num_indices);
+  assert(num_vertices >= vertices_.num_used() && num_indices >= indices_.num_used());
+
+  // Buffers can't be copied within themselves where the ranges overlap, copy every range into new
+  // buffers instead.
+  GpuMemory::freed(GpuMemory::ARENAS, num_bytes());
+  BufferHandles old_handles = MOVE(handles_);
+  handles_                  = BufferHandles{};
+  vertices_                 = RangeAllocator{num_vertices};
+  indices_                  = RangeAllocator{num_indices};
+  create_buffers(logger);
+  GpuMemory::allocated(GpuMemory::ARENAS, num_bytes());
+
+  auto const by_offset = [](auto const* a, auto const* b) {
+    return a->base_vertex < b->base_vertex;
+  };
+  std::sort(allocations_.begin(), allocations_.end(), by_offset);
+
+  auto const copy_range = [](GLuint const from, GLuint const to, size_t const src, size_t const dst,
+                             size_t const num_bytes) {
+    glBindBuffer(GL_COPY_READ_BUFFER, from);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, to);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, src, dst, num_bytes);
+  };
+
+  size_t vertices_used = 0, indices_used = 0;
+  auto const stride = va_.stride();
+  for (auto* buffers : allocations_) {
+    copy_range(old_handles.vbo(), vbo(), buffers->base_vertex * stride, vertices_used * stride,
+               buffers->vertex_bytes);
+    copy_range(old_handles.ebo(), ebo(), buffers->first_index * sizeof(GLuint),
+               indices_used * sizeof(GLuint), buffers->num_indices * sizeof(GLuint));
+
+    buffers->base_vertex = static_cast<GLint>(vertices_used);
+    buffers->first_index = static_cast<GLuint>(indices_used);
+    vertices_used += buffers->vertex_bytes / stride;
+    indices_used += buffers->num_indices;
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  vertices_.compact(vertices_used);
+  indices_.compact(indices_used);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GeometryPool
+bool
+GeometryPool::supported()
+{
+  return GLEW_VERSION_3_2 || GLEW_ARB_draw_elements_base_vertex;
+}
+
+std::optional<DrawInfo>
+GeometryPool::copy(common::Logger& logger, VertexAttribute const& va, void const* vertices,
+                   size_t const vertex_bytes, GLuint const* indices, size_t const num_indices)
+{
+  if (!supported()) {
+    return std::nullopt;
+  }
+  auto const stride = static_cast<size_t>(va.stride());
+  assert(stride > 0 && (vertex_bytes % stride) == 0);
+
+  auto const is_expired = [](auto const& arena) { return arena.expired(); };
+  ARENAS.erase(std::remove_if(ARENAS.begin(), ARENAS.end(), is_expired), ARENAS.end());
+
+  auto buffers = std::make_shared<DrawBuffers>(vertex_bytes, static_cast<GLuint>(num_indices));
+  auto const allocate = [&](GeometryArena& arena) {
+    return same_layout(arena.va(), va) && arena.allocate(logger, *buffers);
+  };
+
+  // Keep the arenas (and the geometry in them) alive until the geometry has one.
+  std::vector<std::shared_ptr<GeometryArena>> arenas;
+  std::transform(ARENAS.cbegin(), ARENAS.cend(), std::back_inserter(arenas),
+                 [](auto const& arena) { return arena.lock(); });
+
+  auto const it = std::find_if(arenas.begin(), arenas.end(), [&](auto& a) { return allocate(*a); });
+  if (it == arenas.end()) {
+    // Geometry larger than an arena's maximum size gets an arena of it's own.
+    auto const num_vertices   = vertex_bytes / stride;
+    auto const arena_vertices = std::max(ARENA_MIN_VERTEX_BYTES / stride, num_vertices);
+    auto const arena_indices  = std::max(ARENA_MIN_INDICES, num_indices);
+    auto const max_vertices   = ARENA_MAX_VERTEX_BYTES / stride;
+    LOG_DEBUG_SPRINTF("Creating geometry arena (%lu vertices, %lu indices, stride %lu)",
+                      arena_vertices, arena_indices, stride);
+
+    auto arena = std::make_shared<GeometryArena>(logger, va, arena_vertices, arena_indices,
+                                                 max_vertices, ARENA_MAX_INDICES);
+    arena->allocate(logger, *buffers);
+    assert(buffers->arena);
+    ARENAS.emplace_back(arena);
+  }
+
+  buffers->arena->upload(*buffers, vertices, indices);
+  return DrawInfo{MOVE(buffers)};
+}
+
+void
+GeometryPool::trim(common::Logger& logger)
+{
+  for (auto const& weak : ARENAS) {
+    auto arena = weak.lock();
+    if (arena) {
+      arena->shrink(logger);
+    }
+  }
+}
+
+size_t
+GeometryPool::num_arenas()
+{
+  auto const is_alive = [](auto const& arena) { return !arena.expired(); };
+  return std::count_if(ARENAS.cbegin(), ARENAS.cend(), is_alive);
+}
+
+} // namespace opengl
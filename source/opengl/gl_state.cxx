@@ -0,0 +1,462 @@
+#include <opengl/gl_state.hpp>
+
+#include <common/algorithm.hpp>
+#include <common/type_macros.hpp>
+
+#include <extlibs/fmt.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+
+using namespace opengl;
+
+namespace
+{
+
+// The bindings are unknown before the first sync, and after the bound object was deleted (so the
+// next bind always goes through).
+GLuint constexpr UNKNOWN_ID = std::numeric_limits<GLuint>::max();
+GLenum constexpr UNKNOWN    = std::numeric_limits<GLenum>::max();
+
+enum class Capability
+{
+  Blend = 0,
+  CullFace,
+  DepthTest,
+  ScissorTest,
+
+  MAX,
+  UNTRACKED = MAX
+};
+
+Capability
+to_capability(GLenum const cap)
+{
+  switch (cap) {
+  case GL_BLEND:
+    return Capability::Blend;
+  case GL_CULL_FACE:
+    return Capability::CullFace;
+  case GL_DEPTH_TEST:
+    return Capability::DepthTest;
+  case GL_SCISSOR_TEST:
+    return Capability::ScissorTest;
+  default:
+    break;
+  }
+  return Capability::UNTRACKED;
+}
+
+struct Rect
+{
+  GLint   x = 0, y = 0;
+  GLsizei w = -1, h = -1;
+
+  bool operator==(Rect const& o) const { return x == o.x && y == o.y && w == o.w && h == o.h; }
+};
+
+struct TextureUnit
+{
+  GLuint texture_2d = UNKNOWN_ID;
+  GLuint cubemap    = UNKNOWN_ID;
+};
+
+struct Shadow
+{
+  GLuint program      = UNKNOWN_ID;
+  GLuint vertex_array = UNKNOWN_ID;
+  GLuint framebuffer  = UNKNOWN_ID;
+
+  GLenum                                              active_texture = UNKNOWN;
+  std::array<TextureUnit, GLState::MAX_TEXTURE_UNITS> texture_units;
+
+  // -1 unknown, 0 disabled, 1 enabled
+  std::array<int, static_cast<size_t>(Capability::MAX)> capabilities = {{-1, -1, -1, -1}};
+
+  BlendFunc blend_func = {UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN};
+  GLenum    cull_face  = UNKNOWN;
+  GLenum    front_face = UNKNOWN;
+
+  Rect viewport, scissor;
+
+  GLStateCounters counters;
+};
+
+Shadow SHADOW;
+
+// Count the call, returns whether it has to reach GL.
+bool
+changed(GLStateCall const call, bool const changes_state)
+{
+  auto const index = static_cast<size_t>(call);
+  auto&      c     = SHADOW.counters;
+  ++(changes_state ? c.issued : c.filtered)[index];
+  return changes_state;
+}
+
+template <typename T>
+bool
+update(GLStateCall const call, T& shadowed, T const& value)
+{
+  if (!changed(call, !(shadowed == value))) {
+    return false;
+  }
+  shadowed = value;
+  return true;
+}
+
+GLint
+get_integer(GLenum const name)
+{
+  GLint value;
+  glGetIntegerv(name, &value);
+  return value;
+}
+
+// The texture unit the active texture refers to, nullptr for units that aren't tracked.
+TextureUnit*
+active_unit()
+{
+  if (UNKNOWN == SHADOW.active_texture) {
+    return nullptr;
+  }
+  auto const unit = SHADOW.active_texture - GL_TEXTURE0;
+  return unit < GLState::MAX_TEXTURE_UNITS ? &SHADOW.texture_units[unit] : nullptr;
+}
+
+GLuint*
+bound_texture(TextureUnit& tu, GLenum const target)
+{
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return &tu.texture_2d;
+  case GL_TEXTURE_CUBE_MAP:
+    return &tu.cubemap;
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+void
+forget(GLuint& bound, GLuint const deleted)
+{
+  if (bound == deleted) {
+    bound = UNKNOWN_ID;
+  }
+}
+
+} // namespace
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GLStateCounters
+uint64_t
+GLStateCounters::total_issued() const
+{
+  uint64_t total = 0;
+  for (auto const n : issued) {
+    total += n;
+  }
+  return total;
+}
+
+uint64_t
+GLStateCounters::total_filtered() const
+{
+  uint64_t total = 0;
+  for (auto const n : filtered) {
+    total += n;
+  }
+  return total;
+}
+
+std::string
+GLStateCounters::to_string() const
+{
+  std::string result;
+  FOR(i, NUM_CALLS)
+  {
+    auto const call = static_cast<GLStateCall>(i);
+    result += fmt::sprintf("%s: %lu/%lu\n", name(call), filtered[i], filtered[i] + issued[i]);
+  }
+  return result;
+}
+
+char const*
+GLStateCounters::name(GLStateCall const call)
+{
+  switch (call) {
+  case GLStateCall::Program:
+    return "Program";
+  case GLStateCall::VertexArray:
+    return "VertexArray";
+  case GLStateCall::ActiveTexture:
+    return "ActiveTexture";
+  case GLStateCall::Texture:
+    return "Texture";
+  case GLStateCall::Framebuffer:
+    return "Framebuffer";
+  case GLStateCall::Capability:
+    return "Capability";
+  case GLStateCall::BlendFunc:
+    return "BlendFunc";
+  case GLStateCall::CullFace:
+    return "CullFace";
+  case GLStateCall::FrontFace:
+    return "FrontFace";
+  case GLStateCall::Viewport:
+    return "Viewport";
+  case GLStateCall::Scissor:
+    return "Scissor";
+  case GLStateCall::MAX:
+    break;
+  }
+  std::abort();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GLState
+void
+GLState::sync()
+{
+  auto& s = SHADOW;
+
+  s.program      = get_integer(GL_CURRENT_PROGRAM);
+  s.vertex_array = get_integer(GL_VERTEX_ARRAY_BINDING);
+  s.framebuffer  = get_integer(GL_FRAMEBUFFER_BINDING);
+
+  // Reading every unit's bindings means switching to it, so the units are forgotten instead.
+  s.active_texture = get_integer(GL_ACTIVE_TEXTURE);
+  for (auto& tu : s.texture_units) {
+    tu = TextureUnit{};
+  }
+
+  FOR(i, s.capabilities.size())
+  {
+    GLenum constexpr CAPS[] = {GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST};
+    s.capabilities[i]       = glIsEnabled(CAPS[i]) ? 1 : 0;
+  }
+
+  auto& bf        = s.blend_func;
+  bf.source_rgb   = get_integer(GL_BLEND_SRC_RGB);
+  bf.dest_rgb     = get_integer(GL_BLEND_DST_RGB);
+  bf.source_alpha = get_integer(GL_BLEND_SRC_ALPHA);
+  bf.dest_alpha   = get_integer(GL_BLEND_DST_ALPHA);
+
+  s.cull_face  = get_integer(GL_CULL_FACE_MODE);
+  s.front_face = get_integer(GL_FRONT_FACE);
+
+  GLint rect[4];
+  glGetIntegerv(GL_VIEWPORT, rect);
+  s.viewport = Rect{rect[0], rect[1], rect[2], rect[3]};
+  glGetIntegerv(GL_SCISSOR_BOX, rect);
+  s.scissor = Rect{rect[0], rect[1], rect[2], rect[3]};
+}
+
+void
+GLState::use_program(GLuint const program)
+{
+  if (update(GLStateCall::Program, SHADOW.program, program)) {
+    glUseProgram(program);
+  }
+}
+
+void
+GLState::bind_vertex_array(GLuint const vao)
+{
+  if (update(GLStateCall::VertexArray, SHADOW.vertex_array, vao)) {
+    glBindVertexArray(vao);
+  }
+}
+
+void
+GLState::bind_framebuffer(GLuint const fbo)
+{
+  if (update(GLStateCall::Framebuffer, SHADOW.framebuffer, fbo)) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  }
+}
+
+void
+GLState::active_texture(GLenum const unit)
+{
+  if (update(GLStateCall::ActiveTexture, SHADOW.active_texture, unit)) {
+    glActiveTexture(unit);
+  }
+}
+
+void
+GLState::bind_texture(GLenum const target, GLuint const texture)
+{
+  auto* tu    = active_unit();
+  auto* bound = tu ? bound_texture(*tu, target) : nullptr;
+  if (!bound) {
+    changed(GLStateCall::Texture, true);
+    glBindTexture(target, texture);
+  }
+  else if (update(GLStateCall::Texture, *bound, texture)) {
+    glBindTexture(target, texture);
+  }
+}
+
+void
+GLState::enable(GLenum const cap)
+{
+  set_enabled(cap, true);
+}
+
+void
+GLState::disable(GLenum const cap)
+{
+  set_enabled(cap, false);
+}
+
+void
+GLState::set_enabled(GLenum const cap, bool const enabled)
+{
+  auto const capability = to_capability(cap);
+  bool const issue      = Capability::UNTRACKED == capability
+                         ? changed(GLStateCall::Capability, true)
+                         : update(GLStateCall::Capability,
+                                  SHADOW.capabilities[static_cast<size_t>(capability)],
+                                  enabled ? 1 : 0);
+  if (!issue) {
+    return;
+  }
+  if (enabled) {
+    glEnable(cap);
+  }
+  else {
+    glDisable(cap);
+  }
+}
+
+bool
+GLState::is_enabled(GLenum const cap)
+{
+  auto const capability = to_capability(cap);
+  if (Capability::UNTRACKED == capability) {
+    return glIsEnabled(cap);
+  }
+  auto const enabled = SHADOW.capabilities[static_cast<size_t>(capability)];
+  assert(-1 != enabled);
+  return 1 == enabled;
+}
+
+void
+GLState::blend_func(GLenum const source, GLenum const dest)
+{
+  blend_func_separate(BlendFunc{source, dest, source, dest});
+}
+
+void
+GLState::blend_func_separate(BlendFunc const& bf)
+{
+  auto& shadowed = SHADOW.blend_func;
+  bool const same = shadowed.source_rgb == bf.source_rgb && shadowed.dest_rgb == bf.dest_rgb &&
+                    shadowed.source_alpha == bf.source_alpha &&
+                    shadowed.dest_alpha == bf.dest_alpha;
+  if (changed(GLStateCall::BlendFunc, !same)) {
+    shadowed = bf;
+    glBlendFuncSeparate(bf.source_rgb, bf.dest_rgb, bf.source_alpha, bf.dest_alpha);
+  }
+}
+
+BlendFunc const&
+GLState::blend_func()
+{
+  assert(UNKNOWN != SHADOW.blend_func.source_rgb);
+  return SHADOW.blend_func;
+}
+
+void
+GLState::cull_face(GLenum const mode)
+{
+  if (update(GLStateCall::CullFace, SHADOW.cull_face, mode)) {
+    glCullFace(mode);
+  }
+}
+
+GLenum
+GLState::cull_face()
+{
+  assert(UNKNOWN != SHADOW.cull_face);
+  return SHADOW.cull_face;
+}
+
+void
+GLState::front_face(GLenum const winding)
+{
+  if (update(GLStateCall::FrontFace, SHADOW.front_face, winding)) {
+    glFrontFace(winding);
+  }
+}
+
+GLenum
+GLState::front_face()
+{
+  assert(UNKNOWN != SHADOW.front_face);
+  return SHADOW.front_face;
+}
+
+void
+GLState::viewport(GLint const x, GLint const y, GLsizei const w, GLsizei const h)
+{
+  if (update(GLStateCall::Viewport, SHADOW.viewport, Rect{x, y, w, h})) {
+    glViewport(x, y, w, h);
+  }
+}
+
+void
+GLState::scissor(GLint const x, GLint const y, GLsizei const w, GLsizei const h)
+{
+  if (update(GLStateCall::Scissor, SHADOW.scissor, Rect{x, y, w, h})) {
+    glScissor(x, y, w, h);
+  }
+}
+
+void
+GLState::delete_program(GLuint const program)
+{
+  // The program stays in use until another is, but it's id may be reused after that.
+  forget(SHADOW.program, program);
+}
+
+void
+GLState::delete_vertex_array(GLuint const vao)
+{
+  forget(SHADOW.vertex_array, vao);
+}
+
+void
+GLState::delete_texture(GLuint const texture)
+{
+  for (auto& tu : SHADOW.texture_units) {
+    forget(tu.texture_2d, texture);
+    forget(tu.cubemap, texture);
+  }
+}
+
+void
+GLState::delete_framebuffer(GLuint const fbo)
+{
+  forget(SHADOW.framebuffer, fbo);
+}
+
+GLStateCounters const&
+GLState::counters()
+{
+  return SHADOW.counters;
+}
+
+void
+GLState::reset_counters()
+{
+  SHADOW.counters = GLStateCounters{};
+}
+
+} // namespace opengl
@@ -1,4 +1,7 @@
+#include <opengl/buffer.hpp>
 #include <opengl/draw_info.hpp>
+#include <opengl/geometry_cache.hpp>
+#include <opengl/geometry_pool.hpp>
 #include <opengl/global.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/shader.hpp>
@@ -16,7 +19,10 @@
 #include <common/algorithm.hpp>
 #include <common/type_macros.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <optional>
 #include <extlibs/fmt.hpp>
 #include <extlibs/glew.hpp>
 
@@ -28,11 +34,71 @@ using namespace glm;
 namespace
 {
 
-template <typename VERTICES, typename INDICES>
-void
-copy_synchronous(common::Logger& logger, VertexAttribute const& va, DrawInfo& dinfo,
-                 VERTICES const& vertices, INDICES const& indices)
+// Whether the buffers hold the vertices and indices.
+//
+// The GeometryCache keeps no copy of the geometry, so the buffers it found (the key's hash may
+// collide) are read back from the GPU and compared against the caller's geometry. Only done when
+// the cache finds buffers, which is when the upload is avoided.
+bool
+buffers_hold(VertexAttribute const& va, DrawBuffers const& buffers, void const* vertices_data,
+             size_t const vertices_size, GLuint const* indices, size_t const num_indices)
+{
+  auto const& arena = buffers.arena;
+  GLuint const vbo  = arena ? arena->vbo() : buffers.handles->vbo();
+  GLuint const ebo  = arena ? arena->ebo() : buffers.handles->ebo();
+
+  auto const           indices_size = num_indices * sizeof(GLuint);
+  std::vector<uint8_t> bytes(std::max(vertices_size, indices_size));
+
+  glBindBuffer(GL_COPY_READ_BUFFER, vbo);
+  glGetBufferSubData(GL_COPY_READ_BUFFER, buffers.base_vertex * va.stride(), vertices_size,
+                     bytes.data());
+  bool const same_vertices = 0 == std::memcmp(bytes.data(), vertices_data, vertices_size);
+
+  bool same_indices = false;
+  if (same_vertices) {
+    glBindBuffer(GL_COPY_READ_BUFFER, ebo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, buffers.first_index * sizeof(GLuint), indices_size,
+                       bytes.data());
+    same_indices = 0 == std::memcmp(bytes.data(), indices, indices_size);
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  return same_vertices && same_indices;
+}
+
+template <typename INDICES>
+DrawInfo
+copy_synchronous(common::Logger& logger, VertexAttribute const& va, void const* vertices_data,
+                 size_t const vertices_size, INDICES const& indices, BufferStorage const storage)
 {
+  auto const num_indices = static_cast<GLuint>(indices.size());
+
+  // Share the buffers of identical geometry already on the GPU, instead of uploading it again.
+  std::optional<GeometryCache::Key> key;
+  if (BufferStorage::OWN != storage) {
+    key = GeometryCache::make_key(va, vertices_data, vertices_size, indices.data(), indices.size());
+    auto const holds = [&](DrawBuffers const& buffers) {
+      return buffers_hold(va, buffers, vertices_data, vertices_size, indices.data(),
+                          indices.size());
+    };
+    auto cached = GeometryCache::find(*key, holds);
+    if (cached) {
+      LOG_TRACE("Geometry already on the gpu, sharing it's buffers");
+      return GeometryCache::share(MOVE(cached));
+    }
+  }
+
+  if (BufferStorage::POOLED == storage) {
+    auto pooled = GeometryPool::copy(logger, va, vertices_data, vertices_size, indices.data(),
+                                     indices.size());
+    if (pooled) {
+      GeometryCache::insert(MOVE(*key), *pooled);
+      return MOVE(*pooled);
+    }
+  }
+
+  DrawInfo dinfo{vertices_size, num_indices};
+
   auto const bind_and_copy = [&]() {
     glBindBuffer(GL_ARRAY_BUFFER, dinfo.vbo());
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, dinfo.ebo());
@@ -40,9 +106,7 @@ copy_synchronous(common::Logger& logger, VertexAttribute const& va, DrawInfo& di
     va.upload_vertex_format_to_glbound_vao(logger);
 
     // copy the vertices
-    LOG_DEBUG_SPRINTF("inserting '%i' vertices into GL_BUFFER_ARRAY\n", vertices.size());
-    auto const  vertices_size = vertices.size() * sizeof(GLfloat);
-    auto const& vertices_data = vertices.data();
+    LOG_DEBUG_SPRINTF("inserting '%i' vertex bytes into GL_BUFFER_ARRAY\n", vertices_size);
     glBufferData(GL_ARRAY_BUFFER, vertices_size, vertices_data, GL_STATIC_DRAW);
 
     // copy the vertice rendering order
@@ -56,28 +120,33 @@ copy_synchronous(common::Logger& logger, VertexAttribute const& va, DrawInfo& di
   auto& vao = dinfo.vao();
   vao.while_bound(logger, bind_and_copy);
   LOG_TRACE("cpu -> gpu copy complete");
+
+  if (key) {
+    GeometryCache::insert(MOVE(*key), dinfo);
+  }
+  return dinfo;
 }
 
+// Copy interleaved float vertices to the GPU, packing them first if the layout is quantized.
 template <typename V, typename I>
 DrawInfo
 copy_gpu_impl(common::Logger& logger, VertexAttribute const& va, V const& vertices,
-              I const& indices)
-{
-  auto const num_indices = static_cast<GLuint>(indices.size());
-  DrawInfo   dinfo{vertices.size(), num_indices};
-  copy_synchronous(logger, va, dinfo, vertices, indices);
-  return dinfo;
+              I const& indices, BufferStorage const storage = BufferStorage::OWN)
+{
+  if (va.is_quantized()) {
+    auto const packed = va.pack(vertices);
+    return copy_synchronous(logger, va, packed.data(), packed.size(), indices, storage);
+  }
+  auto const vertices_size = vertices.size() * sizeof(GLfloat);
+  return copy_synchronous(logger, va, vertices.data(), vertices_size, indices, storage);
 }
 
 template <typename V, typename I>
 DrawInfo
 make_drawinfo(common::Logger& logger, VertexAttribute const& va, V const& vertex_data,
-              I const& indices)
+              I const& indices, BufferStorage const storage = BufferStorage::OWN)
 {
-  auto const num_indices = static_cast<GLuint>(indices.size());
-  DrawInfo   dinfo{vertex_data.size(), num_indices};
-  copy_synchronous(logger, va, dinfo, vertex_data, indices);
-  return dinfo;
+  return copy_gpu_impl(logger, va, vertex_data, indices, storage);
 }
 
 } // namespace
@@ -105,32 +174,38 @@ copy(common::Logger& logger, VertexAttribute const& va,
 }
 
 DrawInfo
-copy_cube_gpu(common::Logger& logger, CubeVertices const& cv, VertexAttribute const& va)
+copy_cube_gpu(common::Logger& logger, CubeVertices const& cv, VertexAttribute const& va,
+              BufferStorage const storage)
 {
-  return make_drawinfo(logger, va, cv, VertexFactory::CUBE_INDICES);
+  return make_drawinfo(logger, va, cv, VertexFactory::CUBE_INDICES, storage);
 }
 
 DrawInfo
-copy_cube_wireframe_gpu(common::Logger& logger, CubeVertices const& cv, VertexAttribute const& va)
+copy_cube_wireframe_gpu(common::Logger& logger, CubeVertices const& cv, VertexAttribute const& va,
+                        BufferStorage const storage)
 {
-  return make_drawinfo(logger, va, cv, VertexFactory::CUBE_WIREFRAME_INDICES);
+  return make_drawinfo(logger, va, cv, VertexFactory::CUBE_WIREFRAME_INDICES, storage);
 }
 
 DrawInfo
-copy_gpu(common::Logger& logger, VertexAttribute const& va, ObjData const& data)
+copy_gpu(common::Logger& logger, VertexAttribute const& va, ObjData const& data,
+         BufferStorage const storage)
 {
-  auto const qa          = BufferFlags::from_va(va);
-  auto       interleaved = VertexBuffer::create_interleaved(logger, data, qa);
-
-  return copy_gpu_impl(logger, va, interleaved.vertices, interleaved.indices);
+  auto const interleaved = VertexBuffer::create_interleaved(logger, data, va);
+  return copy_gpu(logger, va, interleaved, storage);
 }
 
 DrawInfo
-copy_gpu(common::Logger& logger, VertexAttribute const& va, VertexBuffer const& object)
+copy_gpu(common::Logger& logger, VertexAttribute const& va, VertexBuffer const& object,
+         BufferStorage const storage)
 {
-  auto const& v = object.vertices;
   auto const& i = object.indices;
-  return copy_gpu_impl(logger, va, v, i);
+  if (object.is_packed()) {
+    auto const& p = object.packed;
+    return copy_synchronous(logger, va, p.data(), p.size(), i, storage);
+  }
+  auto const& v = object.vertices;
+  return copy_gpu_impl(logger, va, v, i, storage);
 }
 
 DrawInfo
@@ -150,34 +225,20 @@ copy_rectangle(common::Logger& logger, VertexAttribute const& va, RectLineBuffer
 
 DrawInfo
 copy_rectangle(common::Logger& logger, VertexAttribute const& va,
-               RectangleUvVertices const& vertices)
+               RectangleUvVertices const& vertices, BufferStorage const storage)
 {
   auto const& i = VertexFactory::RECTANGLE_DEFAULT_INDICES;
-
-  DrawInfo dinfo{vertices.size(), i.size()};
-  copy_synchronous(logger, va, dinfo, vertices, i);
-  return dinfo;
+  return copy_gpu_impl(logger, va, vertices, i, storage);
 }
 
 void
 overwrite_vertex_buffer(common::Logger& logger, VertexAttribute const& va, DrawInfo& dinfo,
                         ObjData const& objdata)
 {
-  auto const upload = [&]() {
-    glBindBuffer(GL_ARRAY_BUFFER, dinfo.vbo());
-    va.upload_vertex_format_to_glbound_vao(logger);
-
-    auto const qa          = BufferFlags::from_va(va);
-    auto       interleaved = VertexBuffer::create_interleaved(logger, objdata, qa);
-
-    auto const& vertices      = interleaved.vertices;
-    auto const  vertices_size = vertices.size() * sizeof(GLfloat);
-    auto const& vertices_data = vertices.data();
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices_size, vertices_data);
-  };
-
-  auto& vao = dinfo.vao();
-  vao.while_bound(logger, upload);
+  // The buffers may be shared with other DrawInfos (see GeometryCache), so they aren't written to.
+  // The new vertices are copied as new geometry, the old buffers are freed if no longer used.
+  auto const storage = dinfo.is_pooled() ? BufferStorage::POOLED : BufferStorage::SHARED;
+  dinfo              = copy_gpu(logger, va, objdata, storage);
 }
 
 } // namespace opengl::gpu
@@ -0,0 +1,43 @@
+#include <opengl/gpu_memory.hpp>
+
+#include <cassert>
+#include <numeric>
+
+namespace
+{
+
+std::array<size_t, opengl::GpuMemory::MAX> BYTES{};
+
+} // namespace
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuMemory
+void
+GpuMemory::allocated(Kind const kind, size_t const num_bytes)
+{
+  BYTES[kind] += num_bytes;
+}
+
+void
+GpuMemory::freed(Kind const kind, size_t const num_bytes)
+{
+  assert(BYTES[kind] >= num_bytes);
+  BYTES[kind] -= num_bytes;
+}
+
+size_t
+GpuMemory::bytes(Kind const kind)
+{
+  return BYTES[kind];
+}
+
+size_t
+GpuMemory::total()
+{
+  return std::accumulate(BYTES.cbegin(), BYTES.cend(), size_t{0});
+}
+
+} // namespace opengl
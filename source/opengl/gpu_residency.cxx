@@ -0,0 +1,223 @@
+#include <opengl/draw_info.hpp>
+#include <opengl/geometry_pool.hpp>
+#include <opengl/gpu_memory.hpp>
+#include <opengl/gpu_residency.hpp>
+#include <opengl/shader.hpp>
+
+#include <boomhs/components.hpp>
+#include <boomhs/transform.hpp>
+#include <boomhs/tree.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <algorithm>
+
+using namespace boomhs;
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GpuResidency
+GpuResidency::GpuResidency(size_t const vram_budget, size_t const uploads_per_frame)
+    : vram_budget_(vram_budget)
+    , uploads_per_frame_(uploads_per_frame)
+{
+}
+
+void
+GpuResidency::enqueue(EntityID const eid)
+{
+  auto& entry     = entries_[eid];
+  entry.last_used = frame_;
+  upload_queue_.emplace_back(eid);
+}
+
+bool
+GpuResidency::request(EntityID const eid)
+{
+  auto const it = entries_.find(eid);
+  if (it == entries_.end()) {
+    enqueue(eid);
+    return false;
+  }
+
+  auto& entry     = it->second;
+  entry.last_used = frame_;
+  return entry.resident;
+}
+
+void
+GpuResidency::predict(EntityRegistry& registry, glm::vec3 const& position, float const distance)
+{
+  for (auto const eid : registry.view<StreamedMesh, Transform>()) {
+    if (entries_.count(eid) > 0) {
+      continue;
+    }
+    auto const& tr = registry.get<Transform>(eid).translation;
+    if (glm::distance(tr, position) <= distance) {
+      enqueue(eid);
+    }
+  }
+}
+
+TextureInfo&
+GpuResidency::texture(common::Logger& logger, TextureTable& ttable, TextureHandle const handle)
+{
+  if (!ttable.is_streamed(handle)) {
+    return ttable.get(handle);
+  }
+
+  auto const it = texture_entries_.find(handle.value);
+  if (it == texture_entries_.end()) {
+    texture_entries_[handle.value].last_used = frame_;
+    texture_queue_.emplace_back(handle);
+  }
+  else {
+    auto& entry     = it->second;
+    entry.last_used = frame_;
+    if (entry.resident) {
+      return ttable.get(handle);
+    }
+  }
+
+  if (!placeholder_) {
+    placeholder_.emplace(texture::upload_placeholder_texture(logger).expect_moveout("placeholder"));
+  }
+  return **placeholder_;
+}
+
+void
+GpuResidency::forget(EntityID const eid, DrawHandleManager& dhm)
+{
+  entries_.erase(eid);
+  upload_queue_.erase(std::remove(upload_queue_.begin(), upload_queue_.end(), eid),
+                      upload_queue_.end());
+  if (dhm.has_entity(eid)) {
+    dhm.remove_entity(eid);
+  }
+}
+
+void
+GpuResidency::update(common::Logger& logger, ShaderPrograms& sps, ObjStore& obj_store,
+                     EntityRegistry& registry, TextureTable& ttable, DrawHandleManager& dhm)
+{
+  for (auto const eid : registry.take_destroyed()) {
+    forget(eid, dhm);
+  }
+
+  size_t const num_uploads = std::min(uploads_per_frame_, upload_queue_.size());
+  FOR(i, num_uploads)
+  {
+    auto const eid = upload_queue_[i];
+    if (!registry.has<StreamedMesh>(eid)) {
+      entries_.erase(eid);
+      continue;
+    }
+    dhm.upload_mesh(logger, sps, obj_store, eid, registry);
+    entries_[eid].resident = true;
+
+    // The tree's colors are written into it's vertex buffers.
+    if (registry.has<TreeComponent>(eid)) {
+      auto& va = sps.ref_sp(logger, registry.get<ShaderName>(eid).value).va();
+      Tree::update_colors(logger, va, dhm, obj_store, registry, eid);
+    }
+  }
+  upload_queue_.erase(upload_queue_.begin(), upload_queue_.begin() + num_uploads);
+
+  upload_textures(logger, ttable);
+  evict(logger, ttable, dhm);
+  ++frame_;
+}
+
+void
+GpuResidency::upload_textures(common::Logger& logger, TextureTable& ttable)
+{
+  size_t const num_uploads = std::min(DEFAULT_TEXTURE_UPLOADS_PER_FRAME, texture_queue_.size());
+  FOR(i, num_uploads)
+  {
+    auto const handle = texture_queue_[i];
+
+    // A texture failing to upload keeps it's entry, so it isn't queued (and fails) every frame.
+    auto result = ttable.upload(logger, handle);
+    if (result.isErr()) {
+      LOG_ERROR_SPRINTF("Error uploading streamed texture: %s", result.unwrapErrMove());
+      continue;
+    }
+    texture_entries_[handle.value].resident = true;
+  }
+  texture_queue_.erase(texture_queue_.begin(), texture_queue_.begin() + num_uploads);
+}
+
+void
+GpuResidency::evict(common::Logger& logger, TextureTable& ttable, DrawHandleManager& dhm)
+{
+  // Meshes and textures used this frame are being drawn, the rest are candidates (least recently
+  // used first).
+  struct Candidate
+  {
+    uint64_t last_used;
+    bool     is_texture;
+    uint32_t id;
+
+    bool operator<(Candidate const& other) const { return last_used < other.last_used; }
+  };
+  std::vector<Candidate> candidates;
+  bytes_used_ = 0;
+  for (auto const& it : entries_) {
+    auto const& entry = it.second;
+    if (!entry.resident) {
+      continue;
+    }
+    bytes_used_ += dhm.share_bytes(logger, it.first);
+    if (entry.last_used < frame_) {
+      candidates.emplace_back(Candidate{entry.last_used, false, it.first});
+    }
+  }
+  for (auto const& it : texture_entries_) {
+    auto const& entry = it.second;
+    if (!entry.resident) {
+      continue;
+    }
+    bytes_used_ += ttable.get(TextureHandle{it.first}).num_bytes;
+    if (entry.last_used < frame_) {
+      candidates.emplace_back(Candidate{entry.last_used, true, it.first});
+    }
+  }
+  if (bytes_used_ <= vram_budget_) {
+    over_budget_ = false;
+    return;
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // Pooled geometry only frees a range of it's arena, give the arenas' free space back once done.
+  for (auto const& candidate : candidates) {
+    if (bytes_used_ <= vram_budget_) {
+      break;
+    }
+    if (candidate.is_texture) {
+      TextureHandle const handle{candidate.id};
+      bytes_used_ -= ttable.get(handle).num_bytes;
+
+      ttable.evict(handle);
+      texture_entries_.erase(candidate.id);
+      continue;
+    }
+    auto const eid = candidate.id;
+    bytes_used_ -= dhm.share_bytes(logger, eid);
+
+    dhm.remove_entity(eid);
+    entries_.erase(eid);
+  }
+  GeometryPool::trim(logger);
+
+  bool const over_budget = bytes_used_ > vram_budget_;
+  if (over_budget && !over_budget_) {
+    LOG_WARN_SPRINTF("The meshes and textures in use (%lu bytes) exceed the VRAM budget (%lu bytes), %lu bytes "
+                     "of GPU memory are allocated in total.",
+                     bytes_used_, vram_budget_, GpuMemory::total());
+  }
+  over_budget_ = over_budget;
+}
+
+} // namespace opengl
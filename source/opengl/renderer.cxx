@@ -17,6 +17,7 @@
 
 #include <boomhs/shape.hpp>
 #include <opengl/draw_info.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/global.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/light_renderer.hpp>
@@ -30,6 +31,9 @@
 #include <boomhs/random.hpp>
 #include <common/log.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::render
+
 using namespace boomhs;
 using namespace boomhs::math::constants;
 using namespace opengl;
@@ -38,27 +42,23 @@ using namespace gl_sdl;
 namespace
 {
 
+// Uniforms set for every entity drawn. The camera and fog are uniform blocks, set once per pass.
+Uniform<glm::mat4> const U_MODELMATRIX{"u_modelmatrix"};
+Uniform<glm::mat4> const U_MV{"u_mv"};
+Uniform<bool> const      U_DRAWNORMALS{"u_drawnormals"};
+Uniform<ColorRGB> const  U_LIGHTCOLOR{"u_lightcolor"};
+
 void
 enable_depth_tests()
 {
-  glEnable(GL_DEPTH_TEST);
+  GLState::enable(GL_DEPTH_TEST);
 }
 
 void
 disable_depth_tests()
 {
-  glDisable(GL_CULL_FACE);
-  glDisable(GL_DEPTH_TEST);
-}
-
-void
-set_fog(common::Logger& logger, Fog const& fog, glm::mat4 const& view_matrix, ShaderProgram& sp)
-{
-  shader::set_uniform(logger, sp, "u_viewmatrix", view_matrix);
-
-  shader::set_uniform(logger, sp, "u_fog.density", fog.density);
-  shader::set_uniform(logger, sp, "u_fog.gradient", fog.gradient);
-  shader::set_uniform(logger, sp, "u_fog.color", fog.color);
+  GLState::disable(GL_CULL_FACE);
+  GLState::disable(GL_DEPTH_TEST);
 }
 
 void
@@ -106,30 +106,31 @@ DrawState::to_string() const
 namespace opengl::render
 {
 
+// The states are read from GLState's shadow, not GL (a glGet* stalls until the driver catches up).
 CWState
 read_cwstate()
 {
   CWState cwstate;
-  glGetIntegerv(GL_FRONT_FACE, &cwstate.winding.state);
+  cwstate.winding.state = GLState::front_face();
 
-  auto& culling = cwstate.culling;
-  glGetBooleanv(GL_CULL_FACE, &culling.enabled);
-  glGetIntegerv(GL_CULL_FACE_MODE, &culling.mode);
+  auto& culling   = cwstate.culling;
+  culling.enabled = GLState::is_enabled(GL_CULL_FACE);
+  culling.mode    = GLState::cull_face();
   return cwstate;
 }
 
 void
 set_cwstate(CWState const& cw_state)
 {
-  glFrontFace(cw_state.winding.state);
+  GLState::front_face(cw_state.winding.state);
 
   auto& culling = cw_state.culling;
   if (culling.enabled) {
-    glEnable(GL_CULL_FACE);
-    glCullFace(culling.mode);
+    GLState::enable(GL_CULL_FACE);
+    GLState::cull_face(culling.mode);
   }
   else {
-    glDisable(GL_CULL_FACE);
+    GLState::disable(GL_CULL_FACE);
   }
 }
 
@@ -137,13 +138,14 @@ BlendState
 read_blendstate()
 {
   BlendState bstate;
-  bstate.enabled = glIsEnabled(GL_BLEND);
+  bstate.enabled = GLState::is_enabled(GL_BLEND);
 
-  glGetIntegerv(GL_BLEND_SRC_ALPHA, &bstate.source_alpha);
-  glGetIntegerv(GL_BLEND_DST_ALPHA, &bstate.dest_alpha);
+  auto const& bf      = GLState::blend_func();
+  bstate.source_alpha = bf.source_alpha;
+  bstate.dest_alpha   = bf.dest_alpha;
 
-  glGetIntegerv(GL_BLEND_SRC_RGB, &bstate.source_rgb);
-  glGetIntegerv(GL_BLEND_DST_RGB, &bstate.dest_rgb);
+  bstate.source_rgb = bf.source_rgb;
+  bstate.dest_rgb   = bf.dest_rgb;
 
   return bstate;
 }
@@ -151,29 +153,29 @@ read_blendstate()
 void
 set_blendstate(BlendState const& state)
 {
-  glBlendFuncSeparate(state.source_rgb, state.dest_rgb, state.source_alpha, state.dest_alpha);
-
-  if (state.enabled) {
-    glEnable(GL_BLEND);
-  }
-  else {
-    glDisable(GL_BLEND);
-  }
+  GLState::blend_func_separate(BlendFunc{static_cast<GLenum>(state.source_rgb),
+                                         static_cast<GLenum>(state.dest_rgb),
+                                         static_cast<GLenum>(state.source_alpha),
+                                         static_cast<GLenum>(state.dest_alpha)});
+  GLState::set_enabled(GL_BLEND, state.enabled);
 }
 
 void
 init(common::Logger& logger)
 {
+  // Read the context's defaults once, every state change after this goes through GLState.
+  GLState::sync();
+
   // Initialize opengl
-  glDisable(GL_BLEND);
-  glDisable(GL_CULL_FACE);
+  GLState::disable(GL_BLEND);
+  GLState::disable(GL_CULL_FACE);
 
-  glEnable(GL_SCISSOR_TEST);
+  GLState::enable(GL_SCISSOR_TEST);
 
   enable_depth_tests();
 
-  glEnable(GL_DEBUG_OUTPUT);
-  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  GLState::enable(GL_DEBUG_OUTPUT);
+  GLState::enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
   // The logger is thread safe
   glDebugMessageCallback((GLDEBUGPROC)gl_log_callback, (void*)(&logger));
@@ -223,14 +225,14 @@ draw_3dlightsource(RenderState& rstate, GLenum const dm, glm::mat4 const& model_
   auto& zs     = fstate.zs;
 
   auto& logger     = es.logger;
-  auto& pointlight = registry.get<PointLight>(eid);
+  auto& pointlight = zs.gfx_state.snapshot.get<PointLight>(eid);
 
   bool const has_texture = registry.has<TextureRenderable>(eid);
   if (!has_texture) {
     // ASSUMPTION: If the light source has a texture, then DO NOT set u_lightcolor.
     // Instead, assume the image should be rendered unaffected by the lightsource itself.
     auto const diffuse = pointlight.light.diffuse;
-    shader::set_uniform(logger, sp, "u_lightcolor", diffuse);
+    shader::set_uniform(logger, sp, U_LIGHTCOLOR, diffuse);
   }
 
   if (!sp.is_2d) {
@@ -256,16 +258,8 @@ draw_3dshape(RenderState& rstate, GLenum const dm, glm::mat4 const& model_matrix
   auto const camera_matrix = fstate.camera_matrix();
   set_mvpmatrix(logger, camera_matrix, model_matrix, sp);
 
-  {
-    auto const& zs          = fstate.zs;
-    auto const& ldata       = zs.level_data;
-    auto const& fog         = ldata.fog;
-    auto const  view_matrix = fstate.view_matrix();
-    set_fog(logger, fog, view_matrix, sp);
-  }
-
   // misc
-  shader::set_uniform(logger, sp, "u_drawnormals", es.draw_normals);
+  shader::set_uniform(logger, sp, U_DRAWNORMALS, es.draw_normals);
   draw(logger, rstate.ds, dm, sp, dinfo);
 }
 
@@ -295,8 +289,7 @@ draw_3dlit_shape(RenderState& rstate, GLenum const dm, glm::vec3 const& position
   auto& zs     = fstate.zs;
 
   if (!es.draw_normals) {
-    LightRenderer::set_light_uniforms(rstate, registry, sp, material, position, model_matrix,
-                                      set_normalmatrix);
+    LightRenderer::set_light_uniforms(rstate, sp, material, model_matrix, set_normalmatrix);
   }
 
   draw_3dshape(rstate, dm, model_matrix, sp, dinfo);
@@ -318,21 +311,32 @@ draw(common::Logger& logger, DrawState& ds, GLenum const dm, ShaderProgram& sp,
 
   FOR_DEBUG_ONLY([&]() { assert(sp.is_bound()); });
   FOR_DEBUG_ONLY([&]() { assert(dinfo.is_bound()); });
-  draw_elements(logger, draw_mode, sp, num_indices, ds);
+  draw_elements(logger, draw_mode, sp, num_indices, ds, dinfo.first_index(), dinfo.base_vertex());
 }
 
 void
 draw_elements(common::Logger& logger, GLenum const draw_mode, ShaderProgram& sp,
-              GLuint const num_indices, DrawState& ds)
+              GLuint const num_indices, DrawState& ds, GLuint const first_index,
+              GLint const base_vertex)
 {
-  auto constexpr INDICES_PTR = nullptr;
+  // The offset (in bytes) into the bound element buffer.
+  auto const* indices_ptr = reinterpret_cast<void const*>(first_index * sizeof(GLuint));
 
-  if (sp.instance_count) {
+  // Only pooled geometry has a base vertex, the pool isn't used without glDrawElementsBaseVertex.
+  if (sp.instance_count && base_vertex != 0) {
+    auto const prim_count = *sp.instance_count;
+    glDrawElementsInstancedBaseVertex(draw_mode, num_indices, GL_UNSIGNED_INT, indices_ptr,
+                                      prim_count, base_vertex);
+  }
+  else if (sp.instance_count) {
     auto const prim_count = *sp.instance_count;
-    glDrawElementsInstanced(draw_mode, num_indices, GL_UNSIGNED_INT, INDICES_PTR, prim_count);
+    glDrawElementsInstanced(draw_mode, num_indices, GL_UNSIGNED_INT, indices_ptr, prim_count);
+  }
+  else if (base_vertex != 0) {
+    glDrawElementsBaseVertex(draw_mode, num_indices, GL_UNSIGNED_INT, indices_ptr, base_vertex);
   }
   else {
-    glDrawElements(draw_mode, num_indices, GL_UNSIGNED_INT, INDICES_PTR);
+    glDrawElements(draw_mode, num_indices, GL_UNSIGNED_INT, indices_ptr);
   }
 
   ds.num_vertices += num_indices;
@@ -424,7 +428,7 @@ draw_fbo_testwindow(RenderState& rstate, glm::vec2 const& pos, glm::vec2 const&
   BIND_UNTIL_END_OF_SCOPE(logger, sp);
   shader::set_uniform(logger, sp, "u_mv", proj_matrix);
 
-  glActiveTexture(GL_TEXTURE0);
+  GLState::active_texture(GL_TEXTURE0);
   BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
   draw_2d(rstate, GL_TRIANGLES, sp, ti, dinfo);
 }
@@ -435,25 +439,21 @@ draw_targetreticle(RenderState& rstate, FrameTime const& ft)
   auto&       fstate   = rstate.fs;
   auto&       es       = fstate.es;
   auto&       zs       = fstate.zs;
-  auto&       registry = zs.registry;
-  auto const& ldata    = zs.level_data;
+  auto const& snapshot = zs.gfx_state.snapshot;
 
-  auto const& nearby_targets = ldata.nearby_targets;
-  auto const  selected       = nearby_targets.selected();
-  if (!selected) {
+  auto const& target = snapshot.target();
+  if (!target) {
     return;
   }
 
   auto& logger = fstate.es.logger;
   auto& ttable = zs.gfx_state.texture_table;
 
-  auto const npc_selected_eid = *selected;
-  assert(registry.has<Transform>(npc_selected_eid));
-  auto& npc_transform = registry.get<Transform>(npc_selected_eid);
+  auto const& npc_transform = snapshot.get<Transform>(target->eid);
 
   Transform transform;
   transform.translation = npc_transform.translation;
-  auto const scale      = nearby_targets.calculate_scale(ft);
+  auto const scale      = target->scale;
   transform.scale       = glm::vec3{scale};
 
   auto const proj_matrix = fstate.projection_matrix();
@@ -493,9 +493,8 @@ draw_targetreticle(RenderState& rstate, FrameTime const& ft)
     auto const mvp_matrix = proj_matrix * (view_model * rmatrix);
     shader::set_uniform(logger, sp, "u_mv", mvp_matrix);
 
-    auto const& player       = find_player(registry);
-    auto const  target_level = registry.get<NPCData>(npc_selected_eid).level;
-    auto const  blendc = NearbyTargets::color_from_level_difference(player.level, target_level);
+    auto const blendc =
+        NearbyTargets::color_from_level_difference(target->player_level, target->target_level);
     shader::set_uniform(logger, sp, "u_blendcolor", blendc);
 
     draw_billboard(rstate, transform, sp, "TargetReticle");
@@ -556,7 +555,7 @@ draw_grid_lines(RenderState& rstate)
 void
 set_modelmatrix(common::Logger& logger, glm::mat4 const& model_matrix, ShaderProgram& sp)
 {
-  shader::set_uniform(logger, sp, "u_modelmatrix", model_matrix);
+  shader::set_uniform(logger, sp, U_MODELMATRIX, model_matrix);
 }
 
 void
@@ -564,7 +563,7 @@ set_mvpmatrix(common::Logger& logger, glm::mat4 const& camera_matrix, glm::mat4
               ShaderProgram& sp)
 {
   auto const mvp_matrix = camera_matrix * model_matrix;
-  shader::set_uniform(logger, sp, "u_mv", mvp_matrix);
+  shader::set_uniform(logger, sp, U_MV, mvp_matrix);
 }
 
 namespace detail
@@ -600,13 +599,13 @@ gl_fn_using_viewport(Viewport const& vp, int const screen_height, void (*fn)(int
 void
 set_viewport(Viewport const& vp, int const screen_height)
 {
-  detail::gl_fn_using_viewport(vp, screen_height, glViewport);
+  detail::gl_fn_using_viewport(vp, screen_height, GLState::viewport);
 }
 
 void
 set_scissor(Viewport const& vp, int const screen_height)
 {
-  detail::gl_fn_using_viewport(vp, screen_height, glScissor);
+  detail::gl_fn_using_viewport(vp, screen_height, GLState::scissor);
 }
 
 void
@@ -1,19 +1,26 @@
 #include <extlibs/glew.hpp>
 #include <gl_sdl/gl_sdl_log.hpp>
 #include <opengl/debug.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/global.hpp>
 #include <opengl/shader.hpp>
+#include <opengl/uniform_buffer.hpp>
 #include <opengl/vertex_attribute.hpp>
 
 #include <boomhs/math.hpp>
 #include <common/algorithm.hpp>
 #include <common/os.hpp>
+#include <common/phase_timer.hpp>
 #include <common/result.hpp>
 #include <common/type_macros.hpp>
 
 #include <cstring>
+#include <deque>
 #include <extlibs/fmt.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
 namespace
 {
 
@@ -77,6 +84,9 @@ link_program(common::Logger& logger, GLuint const program_id)
                                   program_log, shader_log);
     return Err(fmt);
   }
+
+  // The shared uniform blocks (camera, fog, lighting) are bound once, here.
+  UniformBlocks::bind_program(program_id);
   return OK_NONE;
 }
 
@@ -253,11 +263,111 @@ active_uniforms_string(GLuint const program)
   return result;
 }
 
+// Interned uniform names, the id of a name is it's index. A deque never moves it's elements, the
+// name pointers handed out stay valid.
+struct InternedNames
+{
+  std::deque<std::string>                 names;
+  std::unordered_map<std::string, size_t> ids;
+};
+
+InternedNames&
+interned_names()
+{
+  // Uniform handles are created during static initialization, the table must exist before them.
+  static InternedNames table;
+  return table;
+}
+
 } // namespace
 
 namespace opengl
 {
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// UniformNames
+size_t
+UniformNames::intern(char const* name)
+{
+  auto& table = interned_names();
+
+  auto const it = table.ids.find(name);
+  if (it != table.ids.end()) {
+    return it->second;
+  }
+  auto const id = table.names.size();
+  table.names.emplace_back(name);
+  table.ids.emplace(name, id);
+  return id;
+}
+
+char const*
+UniformNames::name(size_t const id)
+{
+  auto const& names = interned_names().names;
+  assert(id < names.size());
+  return names[id].c_str();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// UniformTable
+UniformTable::UniformTable(GLuint const program)
+{
+  GLint buffer_size{0};
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &buffer_size);
+
+  GLint count{0};
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+
+  GLsizei length{0};
+  GLint   size{0};
+  GLenum  type{0};
+
+  std::vector<GLchar> buffer(std::max(buffer_size, 1), '\0');
+  FORI(i, count)
+  {
+    auto const buffer_length = static_cast<GLsizei>(buffer.size());
+    glGetActiveUniform(program, static_cast<GLuint>(i), buffer_length, &length, &size, &type,
+                       buffer.data());
+    std::string const name{buffer.data(), static_cast<size_t>(length)};
+
+    // Arrays are (usually) reported by their first element, "u_array[0]".
+    bool const is_element = name.size() > 3 && 0 == name.compare(name.size() - 3, 3, "[0]");
+    if (size > 1 || is_element) {
+      auto const base = is_element ? name.substr(0, name.size() - 3) : name;
+      FORI(element, size)
+      {
+        auto const element_name = fmt::sprintf("%s[%i]", base, element);
+        locations_[element_name] = glGetUniformLocation(program, element_name.c_str());
+      }
+      locations_[base] = locations_[base + "[0]"];
+    }
+    else {
+      locations_[name] = glGetUniformLocation(program, name.c_str());
+    }
+  }
+}
+
+GLint
+UniformTable::find(GLchar const* name) const
+{
+  auto const it = locations_.find(name);
+  return it == locations_.end() ? -1 : it->second;
+}
+
+GLint
+UniformTable::find(size_t const id)
+{
+  if (id >= by_id_.size()) {
+    by_id_.resize(id + 1, UNRESOLVED);
+  }
+  auto& loc = by_id_[id];
+  if (UNRESOLVED == loc) {
+    loc = find(UniformNames::name(id));
+  }
+  return loc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // program_factory
 Result<GLuint, std::string>
@@ -303,6 +413,7 @@ program_factory::from_files(common::Logger& logger, VertexShaderFilename const&
   auto attribute_variable_info =
       TRY_MOVEOUT(from_vertex_shader(vertex_shader_path, vertex_shader_source));
   auto const fragment_shader_source = TRY_MOVEOUT(common::read_file(fragment_shader_path));
+  common::record_bytes_read(vertex_shader_source.size() + fragment_shader_source.size());
 
   LOG_TRACE_SPRINTF("Compiling shaders vert: %s, frag: %s", v.filename(), f.filename());
   return from_sources(logger, vertex_shader_source.c_str(), fragment_shader_source.c_str());
@@ -341,6 +452,7 @@ ProgramHandle::~ProgramHandle()
   DEBUG_ASSERT_NOT_BOUND(*this);
 
   if (program_ != INVALID_PROGRAM_ID) {
+    GLState::delete_program(program_);
     glDeleteProgram(program_);
     program_ = INVALID_PROGRAM_ID;
   }
@@ -351,7 +463,7 @@ ProgramHandle::~ProgramHandle()
 void
 ShaderProgram::bind_impl(common::Logger& logger)
 {
-  glUseProgram(program_.handle());
+  GLState::use_program(program_.handle());
   LOG_ANY_GL_ERRORS(logger, "Shader use/enable");
 }
 
@@ -359,7 +471,7 @@ void
 ShaderProgram::unbind_impl(common::Logger& logger)
 {
 #ifdef DEBUG_BUILD
-  glUseProgram(0);
+  GLState::use_program(0);
 #endif
 }
 
@@ -367,11 +479,18 @@ GLint
 ShaderProgram::get_uniform_location(common::Logger& logger, GLchar const* name)
 {
   DEBUG_ASSERT_BOUND(*this);
-  LOG_DEBUG_SPRINTF("getting uniform '%s' location.", name);
-  GLint const loc = glGetUniformLocation(program_.handle(), name);
-  LOG_DEBUG_SPRINTF("uniform '%s' found at '%d'.", name, loc);
+  GLint const loc = uniforms_.find(name);
+  LOG_TRACE_SPRINTF("uniform '%s' found at '%d'.", name, loc);
 
-  LOG_ANY_GL_ERRORS(logger, "get_uniform_location");
+  assert(-1 != loc);
+  return loc;
+}
+
+GLint
+ShaderProgram::get_uniform_location(common::Logger& logger, size_t const id)
+{
+  DEBUG_ASSERT_BOUND(*this);
+  GLint const loc = uniforms_.find(id);
   assert(-1 != loc);
   return loc;
 }
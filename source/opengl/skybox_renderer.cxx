@@ -1,5 +1,6 @@
 #include <opengl/skybox_renderer.hpp>
 
+#include <opengl/gl_state.hpp>
 #include <opengl/renderer.hpp>
 #include <opengl/shader.hpp>
 #include <opengl/texture.hpp>
@@ -30,8 +31,8 @@ SkyboxRenderer::SkyboxRenderer(common::Logger& logger, DrawInfo&& dinfo, Texture
   });
 
   auto const set_fields = [&](auto& ti, GLenum const tunit) {
-    glActiveTexture(tunit);
-    ON_SCOPE_EXIT([&]() { glActiveTexture(tunit); });
+    GLState::active_texture(tunit);
+    ON_SCOPE_EXIT([&]() { GLState::active_texture(tunit); });
     ti.while_bound(logger, [&]() {
       ti.set_fieldi(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
       ti.set_fieldi(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -55,14 +56,13 @@ SkyboxRenderer::render(RenderState& rstate, DrawState& ds, FrameTime const& ft)
   }
 
   auto const& ldata = zs.level_data;
-  auto const& fog   = ldata.fog;
 
-  glActiveTexture(GL_TEXTURE0);
-  ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+  GLState::active_texture(GL_TEXTURE0);
+  ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
 
   BIND_UNTIL_END_OF_SCOPE(logger, *day_);
 
-  glActiveTexture(GL_TEXTURE1);
+  GLState::active_texture(GL_TEXTURE1);
   BIND_UNTIL_END_OF_SCOPE(logger, *night_);
 
   // Converting the "current hour" to a value in [0.0, 1.0]
@@ -96,7 +96,6 @@ SkyboxRenderer::render(RenderState& rstate, DrawState& ds, FrameTime const& ft)
       auto const mvp_matrix   = math::compute_mvp_matrix(model_matrix, view_matrix, proj_matrix);
       shader::set_uniform(logger, *sp_, "u_mv", mvp_matrix);
     }
-    shader::set_uniform(logger, *sp_, "u_fog.color", fog.color);
 
     auto const blend = calculate_blend();
     shader::set_uniform(logger, *sp_, "u_blend_factor", blend);
@@ -1,3 +1,4 @@
+#include <opengl/gl_state.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/renderbuffer.hpp>
 #include <opengl/renderer.hpp>
@@ -20,7 +21,7 @@ namespace
 void
 setup(common::Logger& logger, TextureInfo& ti, GLint const v)
 {
-  glActiveTexture(v);
+  GLState::active_texture(v);
   ti.while_bound(logger, [&]() {
     ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     ti.set_fieldi(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -50,7 +51,7 @@ SunshaftRenderer::SunshaftRenderer(common::Logger& logger, Viewport const& view_
   buffers_.rbo = fbo->attach_render_buffer(logger, w, h);
 
   {
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+    ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
     setup(logger, texture_info(), GL_TEXTURE0);
   }
 
@@ -67,11 +68,6 @@ SunshaftRenderer::render(RenderState& rstate, DrawState& ds, LevelManager& lm, C
   auto& es     = fstate.es;
   auto& logger = es.logger;
 
-  auto const& zs                = fstate.zs;
-  auto const& ldata             = zs.level_data;
-  auto const& global_light      = ldata.global_light;
-  auto const& directional_light = global_light.directional;
-
   auto&      ti   = texture_info();
   auto const v    = VertexFactory::build_default();
   auto const uv   = UvFactory::build_rectangle(ti.uv_max);
@@ -88,12 +84,12 @@ SunshaftRenderer::render(RenderState& rstate, DrawState& ds, LevelManager& lm, C
 
   auto const model_matrix = transform.model_matrix();
   sp_->while_bound(logger, [&]() {
+    // The sun's screen position is read from the LightingBlock uniform block.
     render::set_modelmatrix(logger, model_matrix, *sp_);
-    shader::set_uniform(logger, *sp_, "u_dirlight.screenspace_pos", directional_light.screenspace_pos);
 
-    glActiveTexture(GL_TEXTURE0);
+    GLState::active_texture(GL_TEXTURE0);
     dinfo.while_bound(logger, [&]() { render::draw_2d(rstate, GL_TRIANGLES, *sp_, ti, dinfo); });
-    // glActiveTexture(GL_TEXTURE0);
+    // GLState::active_texture(GL_TEXTURE0);
   });
 }
 
@@ -1,4 +1,5 @@
 #include <opengl/buffer.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/renderer.hpp>
 #include <opengl/shader.hpp>
@@ -15,6 +16,9 @@
 
 #include <cassert>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::render
+
 using namespace boomhs;
 using namespace opengl;
 using namespace gl_sdl;
@@ -31,10 +35,9 @@ render_terrain(RenderState& rstate, EntityRegistry& registry, FrameTime const& f
   auto& es     = fstate.es;
   auto& logger = es.logger;
 
-  auto& zs        = fstate.zs;
-  auto& gfx_state = zs.gfx_state;
-  auto& sps       = gfx_state.sps;
-  auto& ttable    = gfx_state.texture_table;
+  auto& zs           = fstate.zs;
+  auto& gfx_state    = zs.gfx_state;
+  auto& draw_handles = gfx_state.draw_handles;
 
   auto& ldata        = zs.level_data;
   auto& terrain_grid = ldata.terrain;
@@ -44,15 +47,15 @@ render_terrain(RenderState& rstate, EntityRegistry& registry, FrameTime const& f
 
   auto const& dimensions = terrain_grid.config.dimensions;
 
-  auto const draw_piece = [&](auto& terrain) {
+  auto const draw_piece = [&](auto& terrain, DrawInfo& dinfo) {
     auto const& config = terrain.config;
-    glFrontFace(terrain_grid.winding);
+    GLState::front_face(terrain_grid.winding);
     if (terrain_grid.culling_enabled) {
-      glEnable(GL_CULL_FACE);
-      glCullFace(terrain_grid.culling_mode);
+      GLState::enable(GL_CULL_FACE);
+      GLState::cull_face(terrain_grid.culling_mode);
     }
     else {
-      glDisable(GL_CULL_FACE);
+      GLState::disable(GL_CULL_FACE);
     }
 
     Transform tr;
@@ -68,13 +71,11 @@ render_terrain(RenderState& rstate, EntityRegistry& registry, FrameTime const& f
       tr.translation.z         = terrain_pos.y * dimensions.y;
     }
 
-    fn(terrain, tr);
+    fn(terrain, tr, dinfo);
   };
 
   LOG_TRACE("-------------------- Draw Terrain BEGIN ----------------------");
-  for (auto& t : terrain_grid) {
-    draw_piece(t);
-  }
+  FOR(i, terrain_grid.size()) { draw_piece(terrain_grid[i], draw_handles.lookup_terrain(i)); }
   LOG_TRACE("-------------------- Draw Terrain END  ----------------------");
 }
 
@@ -96,6 +97,8 @@ DefaultTerrainRenderer::render(RenderState& rstate, MaterialTable const& mat_tab
 
   auto& zs           = fstate.zs;
   auto& ldata        = zs.level_data;
+  auto& sps          = zs.gfx_state.sps;
+  auto& residency    = zs.gfx_state.residency;
   auto& ttable       = zs.gfx_state.texture_table;
   auto& terrain_grid = ldata.terrain;
 
@@ -103,15 +106,13 @@ DefaultTerrainRenderer::render(RenderState& rstate, MaterialTable const& mat_tab
 
   auto const& dimensions = terrain_grid.config.dimensions;
 
-  auto const fn = [&](auto& terrain, auto const& tr) {
-    auto& sp = terrain.shader();
+  auto const fn = [&](auto& terrain, auto const& tr, DrawInfo& dinfo) {
+    auto const& config = terrain.config;
+    auto&       sp     = sps.ref_sp(logger, config.shader_name);
     sp.while_bound(logger, [&]() {
-      auto const& config = terrain.config;
       shader::set_uniform(logger, sp, "u_uvmodifier", config.uv_modifier);
       shader::set_uniform(logger, sp, "u_clipPlane", cull_plane);
 
-      auto& dinfo = terrain.draw_info();
-
       auto const draw_fn = [&]() {
         dinfo.while_bound(logger, [&]() {
           bool constexpr SET_NORMALMATRIX = true;
@@ -120,7 +121,7 @@ DefaultTerrainRenderer::render(RenderState& rstate, MaterialTable const& mat_tab
                                    dinfo, mat, registry, SET_NORMALMATRIX);
         });
       };
-      this->while_bound(draw_fn, logger, terrain, ttable);
+      this->while_bound(draw_fn, logger, terrain, residency, ttable);
     });
   };
 
@@ -129,32 +130,28 @@ DefaultTerrainRenderer::render(RenderState& rstate, MaterialTable const& mat_tab
 
 void
 DefaultTerrainRenderer::bind_impl(common::Logger& logger, Terrain const& terrain,
-                                  opengl::TextureTable& ttable)
+                                  GpuResidency& residency, TextureTable& ttable)
 {
   auto const bind = [&](size_t const tunit) {
-    glActiveTexture(GL_TEXTURE0 + tunit);
-    auto& tinfo = *ttable.find(terrain.texture_name(tunit));
+    GLState::active_texture(GL_TEXTURE0 + tunit);
+    auto& tinfo = residency.texture(logger, ttable, terrain.texture_handle(tunit));
     bind::global_bind(logger, tinfo);
   };
 
-  auto const& config         = terrain.config;
-  auto const& bound_textures = config.texture_names;
-  FOR(i, bound_textures.textures.size()) { bind(i); }
+  FOR(i, terrain.texture_handles.size()) { bind(i); }
 }
 
 void
 DefaultTerrainRenderer::unbind_impl(common::Logger& logger, Terrain const& terrain,
-                                    opengl::TextureTable& ttable)
+                                    GpuResidency& residency, TextureTable& ttable)
 {
   auto const unbind = [&](size_t const tunit) {
-    auto& tinfo = *ttable.find(terrain.texture_name(tunit));
+    auto& tinfo = residency.texture(logger, ttable, terrain.texture_handle(tunit));
     bind::global_unbind(logger, tinfo);
   };
 
-  auto const& config         = terrain.config;
-  auto const& bound_textures = config.texture_names;
-  FOR(i, bound_textures.textures.size()) { unbind(i); }
-  glActiveTexture(GL_TEXTURE0);
+  FOR(i, terrain.texture_handles.size()) { unbind(i); }
+  GLState::active_texture(GL_TEXTURE0);
 }
 
 std::string
@@ -179,10 +176,7 @@ SilhouetteTerrainRenderer::render(RenderState&    rstate, MaterialTable const&,
   auto& es     = fstate.es;
   auto& logger = es.logger;
 
-  auto const fn = [&](auto& terrain, auto const& tr) {
-    auto const& config = terrain.config;
-
-    auto& dinfo = terrain.draw_info();
+  auto const fn = [&](auto& terrain, auto const& tr, DrawInfo& dinfo) {
     sp_->while_bound(logger, [&]() {
       dinfo.while_bound(logger, [&]() {
         auto const model_matrix = tr.model_matrix();
@@ -1,8 +1,12 @@
 #include <gl_sdl/gl_sdl_log.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/global.hpp>
+#include <opengl/gpu_memory.hpp>
 #include <opengl/texture.hpp>
 
 #include <common/algorithm.hpp>
+#include <common/binary_io.hpp>
+#include <common/phase_timer.hpp>
 #include <common/tuple.hpp>
 
 #include <extlibs/fmt.hpp>
@@ -10,11 +14,15 @@
 #include <extlibs/soil.hpp>
 
 #include <algorithm>
+#include <array>
 #include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::loader
+
 using namespace opengl;
 
 namespace
@@ -44,6 +52,18 @@ upload_image_gpu(common::Logger& logger, std::string const& path, GLenum const t
   return OK_MOVE(image_data);
 }
 
+// A TextureInfo holding the texture's parameters, without any GPU memory.
+TextureInfo
+texture_parameters(TextureInfo const& ti)
+{
+  TextureInfo params;
+  params.target = ti.target;
+  params.format = ti.format;
+  params.wrap   = ti.wrap;
+  params.uv_max = ti.uv_max;
+  return params;
+}
+
 } // namespace
 
 namespace opengl
@@ -75,14 +95,28 @@ TextureInfo::unbind_impl(common::Logger& logger)
   // This is an expected no-op operation.
   //
   // Make sure this isn't masking any problems, try commenting out and see if rendering changes.
-  glActiveTexture(GL_TEXTURE0);
+  GLState::active_texture(GL_TEXTURE0);
 
   global::texture_unbind(*this);
 }
 
+void
+TextureInfo::count_gpu_memory(size_t const num_images)
+{
+  assert(0 == num_bytes);
+  size_t const bytes_per_pixel = format == GL_RGBA ? 4 : 3;
+
+  // The mipmaps add a third to the size of each image.
+  size_t const image_bytes = width * height * bytes_per_pixel;
+  num_bytes                = num_images * (image_bytes + (image_bytes / 3));
+  GpuMemory::allocated(GpuMemory::TEXTURES, num_bytes);
+}
+
 void
 TextureInfo::destroy_impl()
 {
+  GpuMemory::freed(GpuMemory::TEXTURES, num_bytes);
+  GLState::delete_texture(id);
   glDeleteTextures(TextureInfo::NUM_BUFFERS, &id);
 }
 
@@ -114,10 +148,12 @@ TextureInfo::to_string() const
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // TextureTable
 void
-TextureTable::add_texture(TextureFilenames&& tf, Texture&& ta)
+TextureTable::add_texture(TextureFilenames&& tf, Texture&& ta, bool const streamed)
 {
+  assert(streamed || 0 != ta->id);
   auto pair = std::make_pair(MOVE(tf), MOVE(ta));
-  data_.emplace(MOVE(pair));
+  handles_.emplace_back(data_.emplace(MOVE(pair)).first);
+  streamed_.emplace_back(streamed);
 }
 
 std::string
@@ -185,6 +221,72 @@ TextureTable::find(std::string const& name) const
 
 #undef FIND_TF
 
+TextureHandle
+TextureTable::handle(std::string const& name) const
+{
+  auto const cmp = [&name](auto const& it) { return it->first.name == name; };
+  auto const it  = std::find_if(handles_.cbegin(), handles_.cend(), cmp);
+
+  TextureHandle handle;
+  if (it != handles_.cend()) {
+    handle.value = static_cast<TextureHandle::value_type>(it - handles_.cbegin());
+  }
+  return handle;
+}
+
+TextureInfo&
+TextureTable::get(TextureHandle const handle)
+{
+  assert(handle.value < handles_.size());
+  return handles_[handle.value]->second.resource();
+}
+
+TextureInfo const&
+TextureTable::get(TextureHandle const handle) const
+{
+  assert(handle.value < handles_.size());
+  return handles_[handle.value]->second.resource();
+}
+
+bool
+TextureTable::is_streamed(TextureHandle const handle) const
+{
+  assert(handle.value < streamed_.size());
+  return streamed_[handle.value];
+}
+
+bool
+TextureTable::is_resident(TextureHandle const handle) const
+{
+  return 0 != get(handle).id;
+}
+
+Result<common::none_t, std::string>
+TextureTable::upload(common::Logger& logger, TextureHandle const handle)
+{
+  assert(is_streamed(handle) && !is_resident(handle));
+  auto const& filenames = handles_[handle.value]->first.filenames;
+  auto&       texture   = handles_[handle.value]->second;
+
+  auto ti = texture_parameters(*texture);
+  texture = TRY_MOVEOUT(GL_TEXTURE_CUBE_MAP == ti.target
+                            ? texture::upload_3dcube_texture(logger, filenames, MOVE(ti))
+                            : texture::upload_2d_texture(logger, filenames[0], MOVE(ti)));
+  return OK_NONE;
+}
+
+void
+TextureTable::evict(TextureHandle const handle)
+{
+  assert(is_streamed(handle) && is_resident(handle));
+  auto& texture = handles_[handle.value]->second;
+
+  // Assigning a Texture doesn't destroy the one it replaces.
+  auto params = texture_parameters(*texture);
+  texture->destroy_impl();
+  texture = Texture{MOVE(params)};
+}
+
 } // namespace opengl
 
 namespace opengl::texture
@@ -195,38 +297,27 @@ load_image(common::Logger& logger, char const* path, GLenum const format)
 {
   int w = 0, h = 0;
 
-  int const      soil_format = format == GL_RGBA ? SOIL_LOAD_RGBA : SOIL_LOAD_RGB;
-  unsigned char* pimage      = SOIL_load_image(path, &w, &h, 0, soil_format);
+  // Read the whole file before decoding it, so the bytes actually read are recorded.
+  common::ByteBuffer buffer;
+  if (!common::read_file_bytes(path, buffer)) {
+    return Err(fmt::sprintf("image at path '%s' failed to load, reason 'can't read file'", path));
+  }
+  common::record_bytes_read(buffer.size());
+
+  int const soil_format = format == GL_RGBA ? SOIL_LOAD_RGBA : SOIL_LOAD_RGB;
+  int const num_bytes   = static_cast<int>(buffer.size());
+
+  auto* pimage = SOIL_load_image_from_memory(buffer.data(), num_bytes, &w, &h, 0, soil_format);
   if (nullptr == pimage) {
     auto const fmt =
         fmt::sprintf("image at path '%s' failed to load, reason '%s'", path, SOIL_last_result());
     return Err(fmt);
   }
+
   ImageDataPointer image_data{pimage, &SOIL_free_image_data};
   return Ok(ImageData{w, h, MOVE(image_data)});
 }
 
-GLint
-wrap_mode_from_string(char const* name)
-{
-  auto const cmp = [&name](char const* str) {
-    auto const len = std::strlen(str);
-    return std::strncmp(name, str, len) == 0;
-  };
-  if (cmp("clamp")) {
-    return GL_CLAMP_TO_EDGE;
-  }
-  else if (cmp("repeat")) {
-    return GL_REPEAT;
-  }
-  else if (cmp("mirror_repeat")) {
-    return GL_MIRRORED_REPEAT;
-  }
-
-  // Invalid
-  std::abort();
-}
-
 TextureResult
 upload_2d_texture(common::Logger& logger, std::string const& filename, TextureInfo&& ti)
 {
@@ -261,6 +352,7 @@ upload_2d_texture(common::Logger& logger, std::string const& filename, TextureIn
     LOG_ANY_GL_ERRORS(logger, "glGenerateMipmap");
   }
 
+  ti.count_gpu_memory(1);
   return Ok(Texture{MOVE(ti)});
 }
 
@@ -308,6 +400,30 @@ upload_3dcube_texture(common::Logger& logger, std::vector<std::string> const& pa
   };
   ti.while_bound(logger, fn);
 
+  ti.count_gpu_memory(6);
+  return Ok(Texture{MOVE(ti)});
+}
+
+TextureResult
+upload_placeholder_texture(common::Logger& logger)
+{
+  std::array<GLubyte, 4> constexpr GREY = {128, 128, 128, 255};
+
+  TextureInfo ti;
+  ti.format = GL_RGBA;
+  ti.uv_max = 1.0f;
+  ti.gen_texture(logger, 1);
+  {
+    BIND_UNTIL_END_OF_SCOPE(logger, ti);
+    glTexImage2D(ti.target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, GREY.data());
+
+    // There are no mipmaps.
+    ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    ti.set_fieldi(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  }
+  ti.width  = 1;
+  ti.height = 1;
+  ti.count_gpu_memory(1);
   return Ok(Texture{MOVE(ti)});
 }
 
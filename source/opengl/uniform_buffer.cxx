@@ -0,0 +1,174 @@
+#include <opengl/uniform_buffer.hpp>
+
+#include <boomhs/engine.hpp>
+#include <boomhs/fog.hpp>
+#include <boomhs/frame.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/transform.hpp>
+#include <boomhs/zone_state.hpp>
+
+#include <common/algorithm.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace boomhs;
+using namespace opengl;
+
+namespace
+{
+
+std140::CameraBlock
+make_camera_block(FrameState const& fs)
+{
+  auto const& view = fs.view_matrix();
+
+  std140::CameraBlock block;
+  block.view           = view;
+  block.invview        = glm::mat4{glm::inverse(glm::mat3{view})};
+  block.world_position = glm::vec4{fs.camera_world_position(), 1.0f};
+  return block;
+}
+
+std140::FogBlock
+make_fog_block(Fog const& fog)
+{
+  std140::FogBlock block;
+  block.density  = fog.density;
+  block.gradient = fog.gradient;
+  block.color    = fog.color.vec4();
+  return block;
+}
+
+auto
+make_attenuation(Attenuation const& attenuation)
+{
+  std140::Attenuation block;
+  block.constant  = attenuation.constant;
+  block.linear    = attenuation.linear;
+  block.quadratic = attenuation.quadratic;
+  return block;
+}
+
+std140::LightingBlock
+make_lighting_block(FrameState const& fs)
+{
+  auto&       es       = fs.es;
+  auto&       zs       = fs.zs;
+  auto&       registry = zs.registry;
+  auto const& snapshot = zs.gfx_state.snapshot;
+
+  auto const& global_light = zs.level_data.global_light;
+  auto const& directional  = global_light.directional;
+
+  std140::LightingBlock block;
+  block.ambient = glm::vec4{global_light.ambient.vec3(), 1.0f};
+
+  auto& dirlight           = block.dirlight;
+  dirlight.direction       = glm::vec4{directional.direction, 0.0f};
+  dirlight.diffuse         = glm::vec4{directional.light.diffuse.vec3(), 1.0f};
+  dirlight.specular        = glm::vec4{directional.light.specular.vec3(), 1.0f};
+  dirlight.screenspace_pos = directional.screenspace_pos;
+
+  // The shaders always add up MAX_POINTLIGHTS pointlights, the pointlights that aren't used are
+  // left zero'd (as the individual uniforms were).
+  auto const eids = find_pointlights(registry, es.frame_arena);
+  auto const num  = std::min(eids.size(), std140::LightingBlock::MAX_POINTLIGHTS);
+  FOR(i, num)
+  {
+    auto const& transform  = snapshot.get<Transform>(eids[i]);
+    auto const& pointlight = snapshot.get<PointLight>(eids[i]);
+
+    auto& pl       = block.pointlights[i];
+    pl.position    = glm::vec4{transform.translation, 1.0f};
+    pl.diffuse     = glm::vec4{pointlight.light.diffuse.vec3(), 1.0f};
+    pl.specular    = glm::vec4{pointlight.light.specular.vec3(), 1.0f};
+    pl.attenuation = make_attenuation(pointlight.attenuation);
+  }
+
+  block.reflectivity = 1.0f;
+  return block;
+}
+
+} // namespace
+
+namespace opengl
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// UniformBuffer
+UniformBuffer::UniformBuffer(GLuint const binding, size_t const size)
+    : binding_(binding)
+    , contents_(size, 0)
+{
+  glGenBuffers(1, &id_);
+  glBindBuffer(GL_UNIFORM_BUFFER, id_);
+  glBufferData(GL_UNIFORM_BUFFER, contents_.size(), contents_.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+  glDeleteBuffers(1, &id_);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other)
+    : id_(other.id_)
+    , binding_(other.binding_)
+    , contents_(MOVE(other.contents_))
+{
+  other.id_ = 0;
+}
+
+void
+UniformBuffer::update(void const* data)
+{
+  auto const num_bytes = contents_.size();
+  if (0 != std::memcmp(contents_.data(), data, num_bytes)) {
+    std::memcpy(contents_.data(), data, num_bytes);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, id_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, num_bytes, contents_.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  }
+
+  // Another zone's blocks may have been bound to the binding point since.
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding_, id_);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// UniformBlocks
+UniformBlocks::UniformBlocks()
+    : camera_(CAMERA_BINDING, sizeof(std140::CameraBlock))
+    , fog_(FOG_BINDING, sizeof(std140::FogBlock))
+    , lighting_(LIGHTING_BINDING, sizeof(std140::LightingBlock))
+{
+}
+
+void
+UniformBlocks::update(FrameState const& fs)
+{
+  camera_.update(make_camera_block(fs));
+
+  auto const& ldata = fs.zs.level_data;
+  fog_.update(make_fog_block(ldata.fog));
+  lighting_.update(make_lighting_block(fs));
+}
+
+void
+UniformBlocks::bind_program(GLuint const program)
+{
+  static_assert(CAMERA_BINDING == 0 && FOG_BINDING == 1 && LIGHTING_BINDING == 2,
+                "BLOCK_NAMES are indexed by binding point");
+  FOR(binding, BLOCK_NAMES.size())
+  {
+    // Programs only have the blocks they use, the rest were optimized out.
+    GLuint const index = glGetUniformBlockIndex(program, BLOCK_NAMES[binding]);
+    if (GL_INVALID_INDEX != index) {
+      glUniformBlockBinding(program, index, static_cast<GLuint>(binding));
+    }
+  }
+}
+
+} // namespace opengl
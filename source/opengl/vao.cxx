@@ -1,5 +1,73 @@
+#include <common/algorithm.hpp>
 #include <extlibs/fmt.hpp>
 #include <opengl/vao.hpp>
+#include <opengl/vertex_attribute.hpp>
+
+using namespace opengl;
+
+namespace
+{
+
+void
+ensure_backend_has_enough_vertex_attributes(common::Logger& logger, GLint const num_apis)
+{
+  auto max_attribs = 0;
+  glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &max_attribs);
+
+  LOG_DEBUG_FMT("Max number of vertex attributes, found {}", max_attribs);
+
+  if (max_attribs <= num_apis) {
+    LOG_ERROR_SPRINTF("Error requested '%d' vertex attributes from opengl, only '%d' available",
+                      num_apis, max_attribs);
+    std::abort();
+  }
+}
+
+void
+configure_and_enable_attrib_pointer(common::Logger& logger, AttributePointerInfo const& info,
+                                    GLsizei const stride_size_in_bytes, size_t& offset)
+{
+  ensure_backend_has_enough_vertex_attributes(logger, info.component_count);
+
+  // enable vertex attibute arrays
+  glEnableVertexAttribArray(info.index);
+
+  auto const normalize_the_data = info.normalized ? GL_TRUE : GL_FALSE;
+
+  // clang-format off
+  auto const offset_size_in_bytes = offset;
+  auto const offset_ptr = reinterpret_cast<GLvoid*>(offset_size_in_bytes);
+
+  glVertexAttribPointer(
+      info.index,                // global index id
+      info.gl_component_count(), // number of components per attribute
+      info.datatype,             // data-type of the components
+      normalize_the_data,        // whether integer data is mapped to [0, 1] or [-1, 1]
+      stride_size_in_bytes,      // byte-offset between consecutive vertex attributes
+      offset_ptr);               // offset from beginning of buffer
+  // clang-format on
+  offset += info.size_in_bytes();
+
+  auto const make_decimals = [](auto const a0, auto const a1, auto const a2, auto const a3,
+                                auto const a4) {
+    return fmt::sprintf("%-15d %-15d %-15d %-15d %-15d", a0, a1, a2, a3, a4);
+  };
+
+  auto const make_strings = [](auto const a0, auto const a1, auto const a2, auto const a3,
+                               auto const a4) {
+    return fmt::sprintf("%-15s %-15s %-15s %-15s %-15s", a0, a1, a2, a3, a4);
+  };
+
+  auto const s = make_decimals(info.index, info.gl_component_count(), normalize_the_data,
+                               stride_size_in_bytes, offset_size_in_bytes);
+  auto const z =
+      make_strings("attribute_index", "component_count", "normalize_data", "stride", "offset");
+
+  LOG_DEBUG(z);
+  LOG_DEBUG(s);
+}
+
+} // namespace
 
 namespace opengl
 {
@@ -27,4 +95,21 @@ operator<<(std::ostream& stream, VAO const& vao)
   return stream;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// VertexAttribute
+void
+VertexAttribute::upload_vertex_format_to_glbound_vao(common::Logger& logger) const
+{
+  size_t offset = 0;
+  FOR(i, this->num_apis_)
+  {
+    auto const& api = this->apis_[i];
+    assert(api.datatype != AttributePointerInfo::INVALID_TYPE);
+    assert(api.typezilla != AttributeType::OTHER);
+    assert(api.component_count > 0);
+
+    configure_and_enable_attrib_pointer(logger, api, this->stride_, offset);
+  }
+}
+
 } // namespace opengl
@@ -3,101 +3,104 @@
 #include <extlibs/fmt.hpp>
 #include <opengl/vertex_attribute.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace
 {
 
 using namespace opengl;
 
-class UploadFormatState
+// Convert a float to an IEEE 754 half-precision float, rounding to the nearest half.
+uint16_t
+float_to_half(float const value)
 {
-  static constexpr auto INVALID_TYPE = 0;
-
-  GLsizei const stride_;
-  GLsizei       components_skipped_ = 0;
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
 
-public:
-  GLint component_type_ = INVALID_TYPE;
+  uint32_t const sign     = (bits >> 16) & 0x8000;
+  int32_t const  exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+  uint32_t       mantissa = bits & 0x007FFFFF;
 
-  explicit UploadFormatState(GLsizei const stride)
-      : stride_(stride)
-  {
+  if (((bits >> 23) & 0xFF) == 0xFF) {
+    // infinity or NaN
+    return sign | 0x7C00 | (mantissa ? 0x0200 : 0);
   }
-
-  auto stride_size() const
-  {
-    assert(INVALID_TYPE != this->component_type_);
-    return this->stride_ * sizeof(this->component_type_);
+  if (exponent >= 0x1F) {
+    // too large, becomes infinity
+    return sign | 0x7C00;
   }
-
-  auto offset_size() const
-  {
-    assert(INVALID_TYPE != this->component_type_);
-    return this->components_skipped_ * sizeof(this->component_type_);
+  if (exponent <= 0) {
+    // too small for a normal half, becomes a subnormal half (or zero)
+    if (exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x00800000;
+    auto const shift = static_cast<uint32_t>(14 - exponent);
+    auto const half  = mantissa >> shift;
+    auto const round = (mantissa >> (shift - 1)) & 1;
+    return sign | (half + round);
   }
 
-  void increase_offset(GLsizei const amount) { this->components_skipped_ += amount; }
-  void set_type(GLint const type) { this->component_type_ = type; }
-};
+  // Rounding may carry into the exponent, which is still the correctly rounded result.
+  auto const half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+  return half + ((mantissa >> 12) & 1);
+}
 
-void
-ensure_backend_has_enough_vertex_attributes(common::Logger& logger, GLint const num_apis)
+// Pack three signed normalized floats (and a two bit w) the way GL_INT_2_10_10_10_REV is read.
+uint32_t
+pack_int_2_10_10_10_rev(float const* values, bool const normalized)
 {
-  auto max_attribs = 0;
-  glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &max_attribs);
-
-  LOG_DEBUG_FMT("Max number of vertex attributes, found {}", max_attribs);
+  auto const pack = [&normalized](float const v, float const max, int const bits) {
+    auto const scaled  = normalized ? (std::clamp(v, -1.0f, 1.0f) * max) : v;
+    auto const integer = static_cast<int32_t>(std::lround(std::clamp(scaled, -max - 1, max)));
+    return static_cast<uint32_t>(integer) & ((1u << bits) - 1);
+  };
+  return pack(values[0], 511.0f, 10) | (pack(values[1], 511.0f, 10) << 10) |
+         (pack(values[2], 511.0f, 10) << 20);
+}
 
-  if (max_attribs <= num_apis) {
-    LOG_ERROR_SPRINTF("Error requested '%d' vertex attributes from opengl, only '%d' available",
-                      num_apis, max_attribs);
-    std::abort();
-  }
+uint8_t
+pack_unsigned_byte(float const v, bool const normalized)
+{
+  auto const scaled = normalized ? (std::clamp(v, 0.0f, 1.0f) * 255.0f) : v;
+  return static_cast<uint8_t>(std::lround(std::clamp(scaled, 0.0f, 255.0f)));
 }
 
+// Write the attribute's "component_count" floats to "dest", quantized to the attribute's datatype.
 void
-configure_and_enable_attrib_pointer(common::Logger& logger, AttributePointerInfo const& info,
-                                    UploadFormatState& ufs)
-{
-  ensure_backend_has_enough_vertex_attributes(logger, info.component_count);
-
-  // enable vertex attibute arrays
-  glEnableVertexAttribArray(info.index);
-
-  static auto constexpr DONT_NORMALIZE_THE_DATA = GL_FALSE;
-
-  // clang-format off
-  ufs.set_type(info.datatype);
-  auto const stride_size_in_bytes = ufs.stride_size();
-  auto const offset_size_in_bytes = ufs.offset_size();
-  auto const offset_ptr = reinterpret_cast<GLvoid*>(offset_size_in_bytes);
-
-  glVertexAttribPointer(
-      info.index,              // global index id
-      info.component_count,    // number of components per attribute
-      info.datatype,           // data-type of the components
-      DONT_NORMALIZE_THE_DATA, // don't normalize our data
-      stride_size_in_bytes,    // byte-offset between consecutive vertex attributes
-      offset_ptr);             // offset from beginning of buffer
-  // clang-format on
-  ufs.increase_offset(info.component_count);
-
-  auto const make_decimals = [](auto const a0, auto const a1, auto const a2, auto const a3,
-                                auto const a4) {
-    return fmt::sprintf("%-15d %-15d %-15d %-15d %-15d", a0, a1, a2, a3, a4);
-  };
-
-  auto const make_strings = [](auto const a0, auto const a1, auto const a2, auto const a3,
-                               auto const a4) {
-    return fmt::sprintf("%-15s %-15s %-15s %-15s %-15s", a0, a1, a2, a3, a4);
-  };
-
-  auto const s = make_decimals(info.index, info.component_count, DONT_NORMALIZE_THE_DATA,
-                               stride_size_in_bytes, offset_size_in_bytes);
-  auto const z =
-      make_strings("attribute_index", "component_count", "normalize_data", "stride", "offset");
-
-  LOG_DEBUG(z);
-  LOG_DEBUG(s);
+pack_attribute(AttributePointerInfo const& api, float const* src, uint8_t* dest)
+{
+  auto const num = static_cast<size_t>(api.component_count);
+  switch (api.datatype) {
+  case GL_FLOAT:
+    std::memcpy(dest, src, num * sizeof(float));
+    break;
+  case GL_HALF_FLOAT:
+    FOR(i, num)
+    {
+      auto const half = float_to_half(src[i]);
+      std::memcpy(dest + (i * sizeof(half)), &half, sizeof(half));
+    }
+    break;
+  case GL_UNSIGNED_BYTE:
+    FOR(i, num)
+    {
+      dest[i] = pack_unsigned_byte(src[i], api.normalized);
+    }
+    break;
+  case GL_INT_2_10_10_10_REV: {
+    // Normals have three components, the fourth (w) is left zero.
+    float xyz[3] = {0.0f, 0.0f, 0.0f};
+    std::copy(src, src + std::min<size_t>(num, 3), xyz);
+    auto const packed = pack_int_2_10_10_10_rev(xyz, api.normalized);
+    std::memcpy(dest, &packed, sizeof(packed));
+    break;
+  }
+  default:
+    std::abort();
+  }
 }
 
 bool
@@ -135,15 +138,63 @@ attribute_type_from_string(char const* str)
   std::abort();
 }
 
+GLint
+datatype_from_string(char const* str)
+{
+  if (common::cstrcmp(str, "float")) {
+    return GL_FLOAT;
+  }
+  if (common::cstrcmp(str, "half_float")) {
+    return GL_HALF_FLOAT;
+  }
+  if (common::cstrcmp(str, "unsigned_byte")) {
+    return GL_UNSIGNED_BYTE;
+  }
+  if (common::cstrcmp(str, "int_2_10_10_10_rev")) {
+    return GL_INT_2_10_10_10_REV;
+  }
+  return AttributePointerInfo::INVALID_TYPE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // AttributePointerInfo
 AttributePointerInfo::AttributePointerInfo(GLuint const i, GLint const t, AttributeType const at,
-                                           GLsizei const cc)
+                                           GLsizei const cc, bool const n)
     : index(i)
     , datatype(t)
     , typezilla(at)
     , component_count(cc)
+    , normalized(n)
+{
+}
+
+GLint
+AttributePointerInfo::gl_component_count() const
 {
+  return (datatype == GL_INT_2_10_10_10_REV) ? 4 : component_count;
+}
+
+GLsizei
+AttributePointerInfo::size_in_bytes() const
+{
+  GLsizei bytes = 0;
+  switch (datatype) {
+  case GL_FLOAT:
+    bytes = component_count * sizeof(GLfloat);
+    break;
+  case GL_HALF_FLOAT:
+    bytes = component_count * sizeof(GLhalf);
+    break;
+  case GL_UNSIGNED_BYTE:
+    bytes = component_count * sizeof(GLubyte);
+    break;
+  case GL_INT_2_10_10_10_REV:
+    bytes = sizeof(GLuint);
+    break;
+  default:
+    std::abort();
+  }
+  return (bytes + 3) & ~3;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -156,19 +207,50 @@ VertexAttribute::VertexAttribute(size_t const n_apis, GLsizei const stride_p,
 {
 }
 
-void
-VertexAttribute::upload_vertex_format_to_glbound_vao(common::Logger& logger) const
+GLsizei
+VertexAttribute::float_stride() const
 {
-  UploadFormatState ufs{this->stride_};
+  GLsizei stride = 0;
   FOR(i, this->num_apis_)
   {
-    auto const& api = this->apis_[i];
-    assert(api.datatype != AttributePointerInfo::INVALID_TYPE);
-    assert(api.typezilla != AttributeType::OTHER);
-    assert(api.component_count > 0);
+    stride += this->apis_[i].component_count;
+  }
+  return stride;
+}
 
-    configure_and_enable_attrib_pointer(logger, api, ufs);
+bool
+VertexAttribute::is_quantized() const
+{
+  FOR(i, this->num_apis_)
+  {
+    if (this->apis_[i].datatype != GL_FLOAT) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<uint8_t>
+VertexAttribute::pack(float const* floats, size_t const num_floats) const
+{
+  auto const float_stride = static_cast<size_t>(this->float_stride());
+  assert(float_stride > 0 && (num_floats % float_stride) == 0);
+
+  auto const           num_vertices = num_floats / float_stride;
+  std::vector<uint8_t> packed(num_vertices * this->stride_, 0);
+
+  uint8_t* dest = packed.data();
+  FOR(v, num_vertices)
+  {
+    FOR(i, this->num_apis_)
+    {
+      auto const& api = this->apis_[i];
+      pack_attribute(api, floats, dest);
+      floats += api.component_count;
+      dest += api.size_in_bytes();
+    }
   }
+  return packed;
 }
 
 bool
@@ -198,8 +280,8 @@ VertexAttribute::has_uvs() const
 std::string
 AttributePointerInfo::to_string() const
 {
-  return fmt::format("(API) -- '{}' datatype: {}' component_count: '{}'", this->index,
-                     this->datatype, this->component_count);
+  return fmt::format("(API) -- '{}' datatype: {}' component_count: '{}' normalized: '{}'",
+                     this->index, this->datatype, this->component_count, this->normalized);
 }
 
 std::ostream&
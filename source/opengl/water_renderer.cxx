@@ -1,4 +1,5 @@
 #include <opengl/buffer.hpp>
+#include <opengl/gl_state.hpp>
 #include <opengl/gpu.hpp>
 #include <opengl/renderer.hpp>
 #include <opengl/shader.hpp>
@@ -22,6 +23,9 @@
 #include <extlibs/fmt.hpp>
 #include <extlibs/glew.hpp>
 
+#undef  LOG_CATEGORY
+#define LOG_CATEGORY ::common::LogCategory::render
+
 using namespace boomhs;
 using namespace opengl;
 using namespace gl_sdl;
@@ -31,14 +35,27 @@ using namespace gl_sdl;
 namespace
 {
 
+void
+set_linear_filters(TextureInfo& ti)
+{
+  ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  ti.set_fieldi(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
 void
 setup(common::Logger& logger, TextureInfo& ti, GLint const v)
 {
-  glActiveTexture(v);
-  ti.while_bound(logger, [&]() {
-    ti.set_fieldi(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    ti.set_fieldi(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  });
+  GLState::active_texture(v);
+  ti.while_bound(logger, [&]() { set_linear_filters(ti); });
+}
+
+// The water's textures may be streamed, so they are resolved every time they are drawn (and their
+// filters set once bound, a texture uploaded again has the default filters).
+TextureInfo&
+water_texture(common::Logger& logger, ZoneState& zs, TextureHandle const handle)
+{
+  auto& gfx_state = zs.gfx_state;
+  return gfx_state.residency.texture(logger, gfx_state.texture_table, handle);
 }
 
 template <typename FN>
@@ -60,7 +77,7 @@ render_water_common(ShaderProgram& sp, RenderState& rstate, DrawState& ds, Level
     if (registry.get<IsRenderable>(eid).hidden) {
       return;
     }
-    auto const& tr   = registry.get<Transform>(eid);
+    auto const& tr   = zs.gfx_state.snapshot.get<Transform>(eid);
     auto const& bbox = registry.get<AABoundingBox>(eid);
 
     glm::mat4 const& view_mat = fstate.view_matrix();
@@ -91,7 +108,8 @@ render_water_common(ShaderProgram& sp, RenderState& rstate, DrawState& ds, Level
     shader::set_uniform(logger, sp, "u_water.weight_mix_effect", wbuffer.weight_mix_effect);
 
     BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
-    fn(winfo, tr);
+    auto const& model_matrix = gfx_state.snapshot.get<WorldMatrix>(eid).value;
+    fn(winfo, tr, model_matrix);
   };
 
   LOG_TRACE("Rendering water");
@@ -108,18 +126,38 @@ render_water_common(ShaderProgram& sp, RenderState& rstate, DrawState& ds, Level
 namespace opengl
 {
 
+ShaderProgram&
+graphics_mode_to_water_shader(common::Logger& logger, GameGraphicsMode const dwo,
+                              ShaderPrograms& sps)
+{
+  ShaderProgram* sp = nullptr;
+
+  switch (dwo) {
+  case GameGraphicsMode::Basic:
+    sp = &sps.ref_sp(logger, "water_basic");
+    break;
+  case GameGraphicsMode::Medium:
+    sp = &sps.ref_sp(logger, "water_medium");
+    break;
+  case GameGraphicsMode::Advanced:
+    sp = &sps.ref_sp(logger, "water_advanced");
+    break;
+  default:
+    std::abort();
+  }
+
+  assert(sp);
+  return *sp;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // BasicWaterRenderer
-BasicWaterRenderer::BasicWaterRenderer(common::Logger& logger, TextureInfo& diff, TextureInfo& norm,
-                                       ShaderProgram& sp)
+BasicWaterRenderer::BasicWaterRenderer(common::Logger& logger, TextureHandle const diff,
+                                       TextureHandle const norm, ShaderProgram& sp)
     : sp_(&sp)
-    , diffuse_(&diff)
-    , normal_(&norm)
+    , diffuse_(diff)
+    , normal_(norm)
 {
-  ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
-  setup(logger, *diffuse_, GL_TEXTURE0);
-  setup(logger, *normal_, GL_TEXTURE1);
-
   // connect texture units to shader program
   sp_->while_bound(logger, [&]() {
       shader::set_uniform(logger, *sp_, "u_diffuse_sampler", 0);
@@ -135,24 +173,29 @@ BasicWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelManage
   auto& es     = fstate.es;
   auto& logger = es.logger;
 
-  auto const fn = [&](WaterInfo& winfo, Transform const& transform) {
+  auto const fn = [&](WaterInfo& winfo, Transform const& transform,
+                      glm::mat4 const& model_matrix) {
     shader::set_uniform(logger, *sp_, "u_water.mix_color", winfo.mix_color);
     shader::set_uniform(logger, *sp_, "u_water.mix_intensity", winfo.mix_intensity);
 
-    glActiveTexture(GL_TEXTURE0);
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+    auto& zs = lm.active();
+
+    GLState::active_texture(GL_TEXTURE0);
+    ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
 
-    BIND_UNTIL_END_OF_SCOPE(logger, *diffuse_);
+    auto& diffuse = water_texture(logger, zs, diffuse_);
+    BIND_UNTIL_END_OF_SCOPE(logger, diffuse);
+    set_linear_filters(diffuse);
 
-    glActiveTexture(GL_TEXTURE1);
-    BIND_UNTIL_END_OF_SCOPE(logger, *normal_);
+    GLState::active_texture(GL_TEXTURE1);
+    auto& normal = water_texture(logger, zs, normal_);
+    BIND_UNTIL_END_OF_SCOPE(logger, normal);
+    set_linear_filters(normal);
 
-    auto& zs           = lm.active();
     auto& gfx_state    = zs.gfx_state;
     auto& draw_handles = gfx_state.draw_handles;
     auto& dinfo        = draw_handles.lookup_entity(logger, winfo.eid);
 
-    auto const model_matrix = transform.model_matrix();
     render::draw_3dshape(rstate, GL_TRIANGLE_STRIP, model_matrix, *sp_, dinfo);
   };
 
@@ -161,18 +204,12 @@ BasicWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelManage
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // MediumWaterRenderer
-MediumWaterRenderer::MediumWaterRenderer(common::Logger& logger, TextureInfo& diff,
-                                         TextureInfo& norm, ShaderProgram& sp)
+MediumWaterRenderer::MediumWaterRenderer(common::Logger& logger, TextureHandle const diff,
+                                         TextureHandle const norm, ShaderProgram& sp)
     : sp_(&sp)
-    , diffuse_(&diff)
-    , normal_(&norm)
+    , diffuse_(diff)
+    , normal_(norm)
 {
-  {
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
-    setup(logger, *diffuse_, GL_TEXTURE0);
-    setup(logger, *normal_, GL_TEXTURE1);
-  }
-
   // connect texture units to shader program
   sp_->while_bound(logger, [&]() {
       shader::set_uniform(logger, *sp_, "u_diffuse_sampler", 0);
@@ -193,24 +230,28 @@ MediumWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelManag
 
   Material const water_material{};
 
-  auto const fn = [&](WaterInfo& winfo, Transform const& transform) {
+  auto const fn = [&](WaterInfo& winfo, Transform const& transform,
+                      glm::mat4 const& model_matrix) {
     shader::set_uniform(logger, *sp_, "u_water.mix_color", winfo.mix_color);
     shader::set_uniform(logger, *sp_, "u_water.mix_intensity", winfo.mix_intensity);
 
-    glActiveTexture(GL_TEXTURE0);
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+    GLState::active_texture(GL_TEXTURE0);
+    ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
 
-    BIND_UNTIL_END_OF_SCOPE(logger, *diffuse_);
+    auto& diffuse = water_texture(logger, zs, diffuse_);
+    BIND_UNTIL_END_OF_SCOPE(logger, diffuse);
+    set_linear_filters(diffuse);
 
-    glActiveTexture(GL_TEXTURE1);
-    BIND_UNTIL_END_OF_SCOPE(logger, *normal_);
+    GLState::active_texture(GL_TEXTURE1);
+    auto& normal = water_texture(logger, zs, normal_);
+    BIND_UNTIL_END_OF_SCOPE(logger, normal);
+    set_linear_filters(normal);
 
     auto& gfx_state    = zs.gfx_state;
     auto& draw_handles = gfx_state.draw_handles;
     auto& dinfo        = draw_handles.lookup_entity(logger, winfo.eid);
 
     bool constexpr SET_NORMALMATRIX = false;
-    auto const model_matrix         = transform.model_matrix();
     render::draw_3dlit_shape(rstate, GL_TRIANGLE_STRIP, transform.translation, model_matrix, *sp_,
                              dinfo, water_material, registry, SET_NORMALMATRIX);
   };
@@ -236,12 +277,12 @@ RefractionBuffers::RefractionBuffers(common::Logger& logger)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // AdvancedWaterRenderer
 AdvancedWaterRenderer::AdvancedWaterRenderer(common::Logger& logger, Viewport const& view_port,
-                                             ShaderProgram& sp, TextureInfo& diffuse,
-                                             TextureInfo& dudv, TextureInfo& normal)
+                                             ShaderProgram& sp, TextureHandle const diffuse,
+                                             TextureHandle const dudv, TextureHandle const normal)
     : sp_(&sp)
-    , diffuse_(&diffuse)
-    , dudv_(&dudv)
-    , normal_(&normal)
+    , diffuse_(diffuse)
+    , dudv_(dudv)
+    , normal_(normal)
     , reflection_(logger)
     , refraction_(logger)
 {
@@ -264,12 +305,9 @@ AdvancedWaterRenderer::AdvancedWaterRenderer(common::Logger& logger, Viewport co
   }
 
   {
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
-    setup(logger, *diffuse_, GL_TEXTURE0);
+    ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
     setup(logger, reflection_.tbo, GL_TEXTURE1);
     setup(logger, refraction_.tbo, GL_TEXTURE2);
-    setup(logger, *dudv_, GL_TEXTURE3);
-    setup(logger, *normal_, GL_TEXTURE4);
     setup(logger, refraction_.dbo, GL_TEXTURE5);
   }
 
@@ -284,6 +322,22 @@ AdvancedWaterRenderer::AdvancedWaterRenderer(common::Logger& logger, Viewport co
   });
 }
 
+FrameState
+AdvancedWaterRenderer::reflection_framestate(EngineState& es, ZoneState& zs, Camera const& camera)
+{
+  // Compute the camera position beneath the water for capturing the reflective image the camera
+  // will see.
+  //
+  // By inverting the camera's Y position before computing the view matrices, we can render the
+  // world as if the camera was beneath the water's surface. This is how computing the reflection
+  // texture works.
+  glm::vec3 camera_pos = camera.position();
+  camera_pos.y         = -camera_pos.y;
+
+  return FrameState::from_camera_withposition(es, zs, camera, camera.view_settings_ref(),
+                                              es.frustum, camera_pos);
+}
+
 void
 AdvancedWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelManager& lm,
                                     FrameTime const& ft)
@@ -298,7 +352,8 @@ AdvancedWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelMan
   Material const water_material{};
 
   auto&      wbuffer = es.ui_state.debug.buffers.water;
-  auto const fn      = [&](WaterInfo& winfo, Transform const& transform) {
+  auto const fn      = [&](WaterInfo& winfo, Transform const& transform,
+                           glm::mat4 const& model_matrix) {
     auto& gfx_state    = zs.gfx_state;
     auto& draw_handles = gfx_state.draw_handles;
     auto& dinfo        = draw_handles.lookup_entity(logger, winfo.eid);
@@ -316,37 +371,41 @@ AdvancedWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelMan
       shader::set_uniform(logger, *sp_, "u_far", fr.far);
     }
 
-    shader::set_uniform(logger, *sp_, "u_camera_position", fs.camera_world_position());
     shader::set_uniform(logger, *sp_, "u_wave_offset", winfo.wave_offset);
     shader::set_uniform(logger, *sp_, "u_wavestrength", winfo.wave_strength);
 
     shader::set_uniform(logger, *sp_, "u_water.mix_color", winfo.mix_color);
     shader::set_uniform(logger, *sp_, "u_water.mix_intensity", winfo.mix_intensity);
 
-    glActiveTexture(GL_TEXTURE0);
-    ON_SCOPE_EXIT([]() { glActiveTexture(GL_TEXTURE0); });
+    GLState::active_texture(GL_TEXTURE0);
+    ON_SCOPE_EXIT([]() { GLState::active_texture(GL_TEXTURE0); });
 
-    BIND_UNTIL_END_OF_SCOPE(logger, *diffuse_);
+    auto& diffuse = water_texture(logger, zs, diffuse_);
+    BIND_UNTIL_END_OF_SCOPE(logger, diffuse);
+    set_linear_filters(diffuse);
 
-    glActiveTexture(GL_TEXTURE1);
+    GLState::active_texture(GL_TEXTURE1);
     BIND_UNTIL_END_OF_SCOPE(logger, reflection_.tbo);
     BIND_UNTIL_END_OF_SCOPE(logger, reflection_.rbo.resource());
 
-    glActiveTexture(GL_TEXTURE2);
+    GLState::active_texture(GL_TEXTURE2);
     BIND_UNTIL_END_OF_SCOPE(logger, refraction_.tbo);
 
-    glActiveTexture(GL_TEXTURE3);
-    BIND_UNTIL_END_OF_SCOPE(logger, *dudv_);
+    GLState::active_texture(GL_TEXTURE3);
+    auto& dudv = water_texture(logger, zs, dudv_);
+    BIND_UNTIL_END_OF_SCOPE(logger, dudv);
+    set_linear_filters(dudv);
 
-    glActiveTexture(GL_TEXTURE4);
-    BIND_UNTIL_END_OF_SCOPE(logger, *normal_);
+    GLState::active_texture(GL_TEXTURE4);
+    auto& normal = water_texture(logger, zs, normal_);
+    BIND_UNTIL_END_OF_SCOPE(logger, normal);
+    set_linear_filters(normal);
 
-    glActiveTexture(GL_TEXTURE5);
+    GLState::active_texture(GL_TEXTURE5);
     BIND_UNTIL_END_OF_SCOPE(logger, refraction_.dbo);
 
     ENABLE_ALPHA_BLENDING_UNTIL_SCOPE_EXIT();
     bool constexpr SET_NORMALMATRIX = false;
-    auto const model_matrix         = transform.model_matrix();
     render::draw_3dlit_shape(rstate, GL_TRIANGLE_STRIP, transform.translation, model_matrix, *sp_,
                              dinfo, water_material, registry, SET_NORMALMATRIX);
   };
@@ -377,7 +436,7 @@ SilhouetteWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelM
     if (registry.get<IsRenderable>(eid).hidden) {
       return;
     }
-    auto const& tr   = registry.get<Transform>(eid);
+    auto const& tr   = zs.gfx_state.snapshot.get<Transform>(eid);
     auto const& bbox = registry.get<AABoundingBox>(eid);
 
     glm::mat4 const& view_mat = fstate.view_matrix();
@@ -390,7 +449,7 @@ SilhouetteWaterRenderer::render_water(RenderState& rstate, DrawState& ds, LevelM
     auto& draw_handles = gfx_state.draw_handles;
     auto& dinfo        = draw_handles.lookup_entity(logger, winfo.eid);
 
-    auto const model_matrix = tr.model_matrix();
+    auto const& model_matrix = gfx_state.snapshot.get<WorldMatrix>(eid).value;
     BIND_UNTIL_END_OF_SCOPE(logger, *sp_);
     BIND_UNTIL_END_OF_SCOPE(logger, dinfo);
     render::draw_3dblack_water(rstate, GL_TRIANGLE_STRIP, model_matrix, *sp_, dinfo);
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+
+namespace common::test
+{
+
+// Set once any check fails, the test's exit status.
+inline bool FAILED = false;
+
+// Report a failed condition, the test keeps running so every failure is reported.
+inline void
+check(bool const condition, char const* what)
+{
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    FAILED = true;
+  }
+}
+
+inline int
+exit_status()
+{
+  return FAILED ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace common::test
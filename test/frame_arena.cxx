@@ -0,0 +1,88 @@
+#include <common/frame_arena.hpp>
+
+#include "check.hpp"
+
+#include <cstdint>
+
+using namespace common;
+using common::test::check;
+
+// Allocates from a FrameArena across a few frames, including frames that don't fit in the arena's
+// buffer.
+namespace
+{
+
+bool
+is_aligned(void const* p, size_t const alignment)
+{
+  return 0 == (reinterpret_cast<uintptr_t>(p) % alignment);
+}
+
+void
+test_allocate()
+{
+  FrameArena arena{1024};
+
+  auto* a = arena.allocate(1, 1);
+  auto* b = arena.allocate(8, 8);
+  auto* c = arena.allocate(16, 16);
+  check(is_aligned(b, 8) && is_aligned(c, 16), "allocations aligned");
+  check(a != b && b != c, "allocations distinct");
+  check(arena.bytes_used() >= 25 && arena.bytes_used() <= arena.capacity(), "bytes counted");
+
+  arena.reset();
+  check(0 == arena.bytes_used(), "reset frees everything");
+  check(1024 == arena.capacity(), "arena doesn't grow when the frame fit");
+  check(a == arena.allocate(1, 1), "memory reused after reset");
+}
+
+void
+test_overflow()
+{
+  FrameArena arena{64};
+
+  // Fills the buffer, the rest of the frame is allocated from the heap.
+  auto* inside   = arena.allocate(48, 16);
+  auto* overflow = arena.allocate(256, 16);
+  check(nullptr != inside && nullptr != overflow, "allocations past the capacity succeed");
+  check(is_aligned(overflow, 16), "heap allocations aligned");
+  check(arena.bytes_used() > arena.capacity(), "heap allocations counted");
+
+  // The next frame making the same allocations fits in the buffer.
+  arena.reset();
+  check(arena.capacity() >= 48 + 256, "arena grows to fit the frame");
+  check(0 == arena.bytes_used(), "reset frees the heap allocations");
+
+  auto const capacity = arena.capacity();
+  arena.allocate(48, 16);
+  arena.allocate(256, 16);
+  check(arena.bytes_used() <= arena.capacity(), "grown arena fits the frame");
+  arena.reset();
+  check(capacity == arena.capacity(), "arena stops growing once the frame fits");
+}
+
+void
+test_framevector()
+{
+  FrameArena arena{4096};
+  {
+    auto values = make_framevector<int>(arena);
+    for (int i = 0; i < 100; ++i) {
+      values.emplace_back(i);
+    }
+    check(100 == values.size() && 99 == values.back(), "FrameVector holds it's values");
+    check(arena.bytes_used() >= 100 * sizeof(int), "FrameVector allocates from the arena");
+  }
+  arena.reset();
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_allocate();
+  test_overflow();
+  test_framevector();
+  return common::test::exit_status();
+}
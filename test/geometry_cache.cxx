@@ -0,0 +1,77 @@
+#include <opengl/geometry_cache.hpp>
+#include <opengl/vertex_attribute.hpp>
+
+#include "check.hpp"
+
+#include <array>
+
+using namespace opengl;
+using common::test::check;
+
+// Checks geometry is only found in the GeometryCache by identical layouts, vertices and indices.
+//
+// Finding geometry never touches the GPU, so this runs headless (no OpenGL context is needed).
+namespace
+{
+
+using Vertices = std::array<float, 9>;
+using Indices  = std::array<GLuint, 3>;
+
+auto
+make_key(VertexAttribute const& va, Vertices const& vertices, Indices const& indices)
+{
+  return GeometryCache::make_key(va, vertices.data(), sizeof(vertices), indices.data(),
+                                 indices.size());
+}
+
+void
+test_keys()
+{
+  auto const position = AttributePointerInfo{0, GL_FLOAT, AttributeType::POSITION, 3};
+  auto const va       = make_vertex_attribute(position);
+
+  // The same vertex bytes, read as normalized bytes instead of floats.
+  auto const normal    = AttributePointerInfo{0, GL_UNSIGNED_BYTE, AttributeType::NORMAL, 3, true};
+  auto const va_normal = make_vertex_attribute(normal);
+
+  Vertices const triangle = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+  Indices const  indices  = {0, 1, 2};
+  auto const     key      = make_key(va, triangle, indices);
+
+  check(key == make_key(va, triangle, indices), "identical geometry has identical keys");
+
+  Vertices moved = triangle;
+  moved[3]       = 2;
+  check(key != make_key(va, moved, indices), "different vertices have different keys");
+
+  Indices const flipped = {0, 2, 1};
+  check(key != make_key(va, triangle, flipped), "different indices have different keys");
+  check(key != make_key(va_normal, triangle, indices), "different layouts have different keys");
+}
+
+void
+test_find()
+{
+  auto const position = AttributePointerInfo{0, GL_FLOAT, AttributeType::POSITION, 3};
+  auto const va       = make_vertex_attribute(position);
+
+  Vertices const triangle = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+  Indices const  indices  = {0, 1, 2};
+
+  auto const misses = GeometryCache::num_misses();
+  auto const matches = [](DrawBuffers const&) { return true; };
+  check(!GeometryCache::find(make_key(va, triangle, indices), matches),
+        "uncached geometry not found");
+  check(misses + 1 == GeometryCache::num_misses(), "miss counted");
+  check(0 == GeometryCache::num_entries(), "cache starts empty");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_keys();
+  test_find();
+  return common::test::exit_status();
+}
@@ -0,0 +1,176 @@
+#include <boomhs/level_compiler.hpp>
+
+#include <common/binary_io.hpp>
+
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace boomhs;
+using common::test::check;
+
+// Serializes a CompiledLevel into the compiled level format and reads it back, including compiled
+// levels that are truncated or hold corrupt counts, bools and indices.
+namespace
+{
+
+// The layout and shader have empty strings, so their fields are at fixed offsets:
+//
+// magic (0), version (4), 1 layout (8), layout name (12), 0 apis (16), 1 shader (20),
+// shader name (24), vertex (28), fragment (32), vertex_layout (36), is_2d (40).
+size_t constexpr NUM_LAYOUTS_OFFSET = 8;
+size_t constexpr IS_2D_OFFSET       = 40;
+
+auto
+make_level()
+{
+  CompiledLevel level;
+  level.vertex_layouts.emplace_back();
+
+  CompiledShader shader;
+  shader.vertex_layout  = 0;
+  shader.is_2d          = true;
+  shader.instance_count = 4;
+  level.shaders.emplace_back(MOVE(shader));
+
+  // A mesh of 8 vertices, and a single triangle LOD copied from 3 of them.
+  CompiledMesh mesh{"tree", "tree.obj", {}, {}};
+  mesh.obj.num_vertexes = 8;
+  mesh.obj.vertices.resize(8 * 3, 0.0f);
+  mesh.obj.vertices[3] = 2.0f;
+  mesh.obj.indices     = {0, 1, 2, 4, 7, 5};
+
+  MeshLod lod;
+  lod.data.num_vertexes = 3;
+  lod.data.vertices     = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+  lod.data.indices      = {0, 1, 2};
+  lod.source_vertices   = {0, 4, 7};
+  mesh.lods.emplace_back(MOVE(lod));
+  level.meshes.emplace_back(MOVE(mesh));
+  level.fog_density = 0.5f;
+
+  CompiledTexture heightmap;
+  heightmap.name = "Area0-HM";
+  heightmap.filenames.emplace_back("Area0-HM.png");
+  level.textures.emplace_back(MOVE(heightmap));
+  level.heightmap = 0;
+
+  CompiledEntity entity;
+  entity.name         = "e";
+  entity.shader       = 0;
+  entity.geometry     = CompiledGeometry::MESH;
+  entity.mesh         = 0;
+  entity.position     = glm::vec3{1, 2, 3};
+  entity.has_occluder = true;
+  entity.occluder_max = glm::vec3{1};
+  level.entities.emplace_back(MOVE(entity));
+  return level;
+}
+
+void
+test_roundtrip()
+{
+  auto level_in = make_level();
+  level_in.textures[0].streamed = true;
+
+  auto const buffer = LevelCompiler::serialize(level_in);
+  auto       result = LevelCompiler::deserialize(buffer);
+  check(result.isOk(), "compiled level loads");
+  if (!result.isOk()) {
+    return;
+  }
+
+  auto const level = result.unwrap_moveout();
+  check(1 == level.vertex_layouts.size(), "vertex layouts read");
+  check(1 == level.shaders.size() && level.shaders[0].is_2d, "shaders read");
+  check(4 == level.shaders[0].instance_count, "shader instance count read");
+  check(1 == level.meshes.size() && "tree.obj" == level.meshes[0].path, "meshes read");
+
+  auto const& obj = level.meshes[0].obj;
+  check(8 == obj.num_vertexes && 24 == obj.vertices.size() && 2.0f == obj.vertices[3],
+        "mesh vertices read");
+  check(6 == obj.indices.size() && 7 == obj.indices[4], "mesh indices read");
+
+  auto const& lods = level.meshes[0].lods;
+  check(1 == lods.size() && 3 == lods[0].data.num_vertexes, "mesh lods read");
+  check(9 == lods[0].data.vertices.size() && 1.0f == lods[0].data.vertices[3],
+        "lod vertices read");
+  check(3 == lods[0].data.indices.size() && 2 == lods[0].data.indices[2], "lod indices read");
+  check(3 == lods[0].source_vertices.size() && 7 == lods[0].source_vertices[2],
+        "lod source vertices read");
+
+  check(0.5f == level.fog_density, "fog read");
+  check(0 == level.heightmap && "Area0-HM" == level.textures[0].name, "heightmap read");
+  check(level.textures[0].streamed, "texture streamed flag read");
+  check(1 == level.entities.size(), "entities read");
+
+  auto const& e = level.entities[0];
+  check("e" == e.name && CompiledGeometry::MESH == e.geometry && 0 == e.mesh, "entity read");
+  check(glm::vec3{1, 2, 3} == e.position, "entity position read");
+  check(e.has_occluder && glm::vec3{1} == e.occluder_max, "entity occluder read");
+}
+
+void
+test_corrupt()
+{
+  auto const buffer = LevelCompiler::serialize(make_level());
+
+  auto truncated = buffer;
+  truncated.pop_back();
+  check(LevelCompiler::deserialize(truncated).isErr(), "truncated level rejected");
+
+  auto bad_magic = buffer;
+  bad_magic[0]   = 'X';
+  check(LevelCompiler::deserialize(bad_magic).isErr(), "bad magic rejected");
+
+  auto           huge_count = buffer;
+  uint32_t const count      = UINT32_MAX;
+  std::memcpy(huge_count.data() + NUM_LAYOUTS_OFFSET, &count, sizeof(count));
+  check(LevelCompiler::deserialize(huge_count).isErr(),
+        "table count larger than the level rejected");
+
+  auto bad_bool          = buffer;
+  bad_bool[IS_2D_OFFSET] = 2;
+  check(LevelCompiler::deserialize(bad_bool).isErr(), "bool other than 0 or 1 rejected");
+
+  auto level               = make_level();
+  level.entities[0].shader = 1;
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "index past the end of it's table rejected");
+
+  level                                = make_level();
+  level.meshes[0].lods[0].data.indices = {0, 1, 3};
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "lod index past the lod's vertices rejected");
+
+  level                                   = make_level();
+  level.meshes[0].lods[0].source_vertices = {0};
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "lod without a source vertex for each vertex rejected");
+
+  level                                   = make_level();
+  level.meshes[0].lods[0].source_vertices = {0, 4, 8};
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "lod source vertex past the mesh's vertices rejected");
+
+  level                      = make_level();
+  level.meshes[0].obj.colors = {1.0f};
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "mesh without a color for each vertex rejected");
+
+  level           = make_level();
+  level.heightmap = 1;
+  check(LevelCompiler::deserialize(LevelCompiler::serialize(level)).isErr(),
+        "heightmap past the end of the textures rejected");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_roundtrip();
+  test_corrupt();
+  return common::test::exit_status();
+}
@@ -0,0 +1,140 @@
+#include <common/log.hpp>
+#include <spdlog/sinks/ostream_sink.h>
+
+#include "check.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace common::impl;
+using common::test::check;
+
+// Pushes and pops log records through a LogQueue, from several producer and consumer threads at
+// once, and checks the AsyncLogger writes errors before returning.
+namespace
+{
+
+void
+test_fifo()
+{
+  LogQueue queue{4};
+  check(queue.empty(), "queue starts empty");
+
+  for (int i = 0; i < 4; ++i) {
+    bool const pushed = queue.try_push([&i](auto& record) {
+      record.set_message(LogLevel::info, FormatPolicy::format, "{}", i);
+    });
+    check(pushed, "push into a queue with room");
+  }
+  check(!queue.try_push([](auto&) {}), "push into a full queue fails");
+
+  for (int i = 0; i < 4; ++i) {
+    std::string message;
+    queue.try_pop([&message](auto& record) { message = record.take_message(); });
+    check(std::to_string(i) == message, "records popped in the order they were pushed");
+  }
+  check(queue.empty() && !queue.try_pop([](auto&) {}), "pop from an empty queue fails");
+}
+
+// Character arrays are copied when the message is logged, not when it's formatted.
+void
+test_copies_strings()
+{
+  LogQueue queue{2};
+  char     name[] = "before";
+  queue.try_push([&name](auto& record) {
+    record.set_message(LogLevel::info, FormatPolicy::sprintf, "name: %s", name);
+  });
+  std::strcpy(name, "after!");
+
+  std::string message;
+  queue.try_pop([&message](auto& record) { message = record.take_message(); });
+  check("name: before" == message, "character array copied when logged");
+}
+
+void
+test_threads()
+{
+  int constexpr NUM_PRODUCERS = 4;
+  int constexpr NUM_CONSUMERS = 2;
+  int constexpr NUM_MESSAGES  = 20000;
+
+  LogQueue                      queue{64};
+  std::vector<std::atomic<int>> received(NUM_PRODUCERS * NUM_MESSAGES);
+  std::atomic<int>              num_popped{0};
+  std::vector<std::thread>      threads;
+
+  for (int p = 0; p < NUM_PRODUCERS; ++p) {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < NUM_MESSAGES; ++i) {
+        int const id = (p * NUM_MESSAGES) + i;
+        while (!queue.try_push([id](auto& record) {
+          record.set_message(LogLevel::info, FormatPolicy::format, "{}", id);
+        })) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < NUM_CONSUMERS; ++c) {
+    threads.emplace_back([&]() {
+      while (num_popped.load() < (NUM_PRODUCERS * NUM_MESSAGES)) {
+        bool const popped = queue.try_pop([&received](auto& record) {
+          ++received[std::stoi(record.take_message())];
+        });
+        if (popped) {
+          ++num_popped;
+        }
+        else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  bool all_once = true;
+  for (auto const& count : received) {
+    all_once &= (1 == count.load());
+  }
+  check(all_once, "every record popped exactly once");
+  check(queue.empty(), "queue drained");
+}
+
+// The message of an error is in the sink when the call returns (the caller may std::abort() next),
+// even if the queue is full and the logger discards messages.
+void
+test_error_written_before_returning()
+{
+  std::ostringstream stream;
+  auto               sink   = std::make_shared<spdlog::sinks::ostream_sink_st>(stream);
+  auto               logger = std::make_unique<spdlog::logger>("", sink);
+  logger->set_level(spdlog::level::trace);
+
+  AsyncLogger async{std::move(logger), OverflowPolicy::discard, 2};
+  for (int i = 0; i < 1000; ++i) {
+    async.log(LogLevel::info, FormatPolicy::format, "info {}", i);
+  }
+  async.log(LogLevel::error, FormatPolicy::format, "fatal {}", 42);
+
+  // The flush the error waited for orders the sink's writes before this read.
+  check(std::string::npos != stream.str().find("fatal 42"), "error written when log() returns");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_fifo();
+  test_copies_strings();
+  test_threads();
+  test_error_written_before_returning();
+  return common::test::exit_status();
+}
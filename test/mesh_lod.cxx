@@ -0,0 +1,88 @@
+#include <boomhs/mesh_lod.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include "check.hpp"
+#include "sphere.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace boomhs;
+using test::make_sphere;
+using common::test::check;
+
+// Generates the LOD chain of a sphere, and picks LODs for a few screen sizes.
+//
+// Neither touches the GPU, so this runs headless.
+namespace
+{
+
+void
+test_generate_lods()
+{
+  auto const sphere        = make_sphere(64, 32);
+  auto const num_triangles = sphere.indices.size() / 3;
+  auto const lods          = MeshSimplifier::generate_lods(sphere);
+  check(MeshSimplifier::LOD_RATIOS.size() == lods.size(), "every LOD generated");
+
+  size_t previous = num_triangles;
+  for (auto const& lod : lods) {
+    check(lod.num_triangles() < previous, "each LOD has fewer triangles than the last");
+    previous = lod.num_triangles();
+
+    // Every vertex of the LOD is a copy of the vertex it's source vertex points at.
+    bool sources_match = lod.source_vertices.size() == lod.data.num_vertexes;
+    for (size_t v = 0; sources_match && v < lod.source_vertices.size(); ++v) {
+      auto const source = lod.source_vertices[v];
+      for (size_t k = 0; k < 3; ++k) {
+        sources_match &= lod.data.vertices[(3 * v) + k] == sphere.vertices[(3 * source) + k];
+      }
+    }
+    check(sources_match, "LOD vertices copied from their source vertices");
+
+    // The simplified sphere keeps it's shape, the centers of it's triangles stay near the surface.
+    float max_error = 0.0f;
+    for (size_t i = 0; i < lod.data.indices.size(); i += 3) {
+      glm::vec3 center{0.0f};
+      for (size_t k = 0; k < 3; ++k) {
+        auto const* p = &lod.data.vertices[3 * lod.data.indices[i + k]];
+        center += glm::vec3{p[0], p[1], p[2]} / 3.0f;
+      }
+      max_error = std::max(max_error, 1.0f - glm::length(center));
+    }
+    check(max_error < 0.1f, "LOD keeps the shape of the sphere");
+  }
+  if (!lods.empty()) {
+    auto const target = MeshSimplifier::LOD_RATIOS.back() * num_triangles;
+    check(lods.back().num_triangles() <= (target * 1.1f), "last LOD reaches it's target");
+  }
+
+  check(MeshSimplifier::generate_lods(make_sphere(4, 4)).empty(), "small meshes not simplified");
+}
+
+void
+test_select()
+{
+  auto constexpr NUM_LODS = MeshSimplifier::MAX_LODS;
+
+  // Within the hysteresis of the first threshold (0.25) the current LOD is kept.
+  check(0 == LodSelector::select(0.24f, 0, NUM_LODS), "LOD 0 kept just below the threshold");
+  check(1 == LodSelector::select(0.20f, 0, NUM_LODS), "LOD 1 picked well below the threshold");
+  check(1 == LodSelector::select(0.27f, 1, NUM_LODS), "LOD 1 kept just above the threshold");
+  check(0 == LodSelector::select(0.50f, 1, NUM_LODS), "LOD 0 picked well above the threshold");
+
+  check(3 == LodSelector::select(0.01f, 0, NUM_LODS), "smallest LOD picked for tiny entities");
+  check(1 == LodSelector::select(0.01f, 0, 2), "LOD limited to the LODs the mesh has");
+  check(0 == LodSelector::select(0.01f, 0, 1), "meshes without LODs always use LOD 0");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_generate_lods();
+  test_select();
+  return common::test::exit_status();
+}
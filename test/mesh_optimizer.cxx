@@ -0,0 +1,88 @@
+#include <boomhs/mesh_lod.hpp>
+#include <boomhs/mesh_optimizer.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include "check.hpp"
+#include "sphere.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+
+using namespace boomhs;
+using test::make_sphere;
+using common::test::check;
+
+// Optimizes a sphere (and it's LODs) for the vertex cache, checking the cache misses go down while
+// the triangles drawn stay the same.
+namespace
+{
+
+// The mesh's triangles, by the positions of their corners. Each triangle starts at it's smallest
+// corner so reordering the triangles' vertices (but not flipping them) compares equal.
+using Triangle = std::array<std::array<float, 3>, 3>;
+
+std::multiset<Triangle>
+triangles(ObjData const& data)
+{
+  std::multiset<Triangle> result;
+  for (size_t i = 0; i < data.indices.size(); i += 3) {
+    Triangle t;
+    for (size_t k = 0; k < 3; ++k) {
+      auto const* p = &data.vertices[3 * data.indices[i + k]];
+      t[k]          = {{p[0], p[1], p[2]}};
+    }
+    std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+    result.emplace(t);
+  }
+  return result;
+}
+
+void
+test_acmr()
+{
+  // Every vertex of a lone triangle misses the cache, the second triangle of a quad only misses
+  // it's last vertex.
+  check(3.0f == MeshOptimizer::acmr(ObjIndices{0, 1, 2}, 3), "ACMR of a triangle");
+  check(2.0f == MeshOptimizer::acmr(ObjIndices{0, 1, 2, 2, 1, 3}, 4), "ACMR of a quad");
+}
+
+void
+test_optimize()
+{
+  auto       sphere = make_sphere(64, 32);
+  auto const before = triangles(sphere);
+
+  auto const stats = MeshOptimizer::optimize(sphere);
+  check(stats.acmr_after < stats.acmr_before, "optimizing reduces the ACMR");
+  check(stats.num_vertices_after < stats.num_vertices_before, "identical vertices merged");
+  check(stats.num_vertices_after == sphere.num_vertexes, "vertex count updated");
+  check(before == triangles(sphere), "optimizing keeps the triangles");
+
+  for (auto& lod : MeshSimplifier::generate_lods(sphere)) {
+    auto const lod_before = triangles(lod.data);
+    MeshOptimizer::optimize(lod);
+    check(lod_before == triangles(lod.data), "optimizing a LOD keeps it's triangles");
+
+    bool sources_match = true;
+    for (size_t v = 0; v < lod.source_vertices.size(); ++v) {
+      auto const source = lod.source_vertices[v];
+      for (size_t k = 0; k < 3; ++k) {
+        sources_match &= lod.data.vertices[(3 * v) + k] == sphere.vertices[(3 * source) + k];
+      }
+    }
+    check(sources_match, "optimizing a LOD keeps it's source vertices");
+  }
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_acmr();
+  test_optimize();
+  return common::test::exit_status();
+}
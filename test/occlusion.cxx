@@ -0,0 +1,77 @@
+#include <boomhs/math.hpp>
+#include <boomhs/occlusion.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include "check.hpp"
+
+#include <cmath>
+
+using namespace boomhs;
+using common::test::check;
+
+// Rasterizes occluders into an OcclusionBuffer on the CPU and checks which boxes the buffer culls.
+//
+// No window or OpenGL context is needed, so this runs headless (ie: from ctest).
+namespace
+{
+
+auto
+translate(glm::vec3 const& pos)
+{
+  return glm::translate(glm::mat4{1}, pos);
+}
+
+// A wall 10 units in front of the camera, hiding the boxes directly behind it.
+void
+test_wall()
+{
+  auto const proj   = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 200.0f);
+  auto const view   = glm::lookAt(glm::vec3{0, 1, 0}, glm::vec3{0, 1, -1}, glm::vec3{0, 1, 0});
+  auto const camera = proj * view;
+
+  OcclusionBuffer ob;
+  ob.begin(camera);
+  ob.add_box(translate(glm::vec3{0, 0, -10}), Cube{glm::vec3{-5, 0, -0.5f}, glm::vec3{5, 3, 0.5f}});
+  ob.finish();
+
+  Cube const unit{glm::vec3{-0.5f}, glm::vec3{0.5f}};
+  check(!ob.visible(camera, translate(glm::vec3{0, 1, -30}), unit), "box behind the wall culled");
+  check(ob.visible(camera, translate(glm::vec3{0, 1, -5}), unit), "box before the wall visible");
+  check(ob.visible(camera, translate(glm::vec3{0, 10, -30}), unit), "box above the wall visible");
+  check(ob.visible(camera, translate(glm::vec3{25, 1, -30}), unit), "box beside the wall visible");
+
+  // The buffer was built from another camera, so it can't cull anything for this one.
+  check(ob.visible(glm::mat4{1}, translate(glm::vec3{0, 1, -30}), unit),
+        "box seen by another camera visible");
+}
+
+// With an identity camera, world space is NDC. The triangle covers the lower left half of the
+// buffer, it's depth increasing from 0.25 at the left edge to 0.75 at the right edge.
+void
+test_conservative()
+{
+  OcclusionBuffer ob;
+  ob.begin(glm::mat4{1});
+  ob.add_triangle(glm::vec3{-1, -1, -0.5f}, glm::vec3{1, -1, 0.5f}, glm::vec3{-1, 1, -0.5f});
+  ob.finish();
+
+  // The hypotenuse crosses this texel, it's center is inside the triangle but it's upper right
+  // corner is not.
+  check(1.0f == ob.depth(0, 128, 63), "texel partially covered by the triangle left empty");
+
+  // A covered texel holds the farthest depth over the texel (at it's right edge), not the depth at
+  // it's center.
+  float const farthest = 0.25f + (11.0f / 512.0f);
+  check(std::abs(ob.depth(0, 10, 10) - farthest) < 1e-4f, "texel holds the farthest depth");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  test_wall();
+  test_conservative();
+  return common::test::exit_status();
+}
@@ -0,0 +1,133 @@
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/frame_time.hpp>
+#include <boomhs/lighting.hpp>
+#include <boomhs/nearby_targets.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/player.hpp>
+#include <boomhs/render_snapshot.hpp>
+#include <boomhs/simulation_thread.hpp>
+
+#include <common/frame_arena.hpp>
+#include <common/log.hpp>
+
+#include "check.hpp"
+
+#include <atomic>
+
+using namespace boomhs;
+using common::test::check;
+
+// Copies a registry into a RenderSnapshot and checks the snapshot stays the same while the registry
+// is written (as the simulation does while the frame is drawn), and runs steps on a
+// SimulationThread.
+namespace
+{
+
+void
+test_copy()
+{
+  EntityRegistry registry;
+  NearbyTargets  nbt;
+  FrameTime const ft{1, 1000, 1000};
+
+  auto const light = registry.create();
+  registry.assign<Transform>(light).translation    = glm::vec3{1, 2, 3};
+  registry.assign<PointLight>(light).light.diffuse = LOC3::RED;
+
+  auto const placed = registry.create();
+  registry.assign<Transform>(placed).translation = glm::vec3{4, 5, 6};
+  registry.get<WorldMatrix>(placed).value[3]     = glm::vec4{4, 5, 6, 1};
+
+  RenderSnapshot snapshot;
+  snapshot.build(registry, nbt, ft);
+  check(!snapshot.target(), "no target without a selected target");
+
+  // Write the registry after the snapshot was built.
+  registry.get<Transform>(light).translation    = glm::vec3{0};
+  registry.get<PointLight>(light).light.diffuse = LOC3::BLUE;
+  registry.destroy(placed);
+  auto const reused = registry.create();
+  registry.assign<Transform>(reused).translation = glm::vec3{7, 8, 9};
+
+  check(glm::vec3{1, 2, 3} == snapshot.get<Transform>(light).translation,
+        "transform unchanged by the registry");
+  check(LOC3::RED.vec3() == snapshot.get<PointLight>(light).light.diffuse.vec3(),
+        "pointlight unchanged by the registry");
+  check(glm::vec3{4, 5, 6} == snapshot.get<Transform>(placed).translation,
+        "destroyed entity's transform still in the snapshot");
+  check(glm::vec4{4, 5, 6, 1} == snapshot.get<WorldMatrix>(placed).value[3],
+        "destroyed entity's world matrix still in the snapshot");
+  check(!snapshot.has<PointLight>(placed), "entity without the component");
+  check(!snapshot.has<Transform>(reused), "entity created after the snapshot");
+
+  // Building the snapshot again copies the registry as it is now.
+  snapshot.build(registry, nbt, ft);
+  check(glm::vec3{0} == snapshot.get<Transform>(light).translation, "rebuilt transform");
+  check(!snapshot.has<Transform>(placed), "destroyed entity dropped");
+  check(!snapshot.has<WorldMatrix>(placed), "destroyed entity's world matrix dropped");
+  check(glm::vec3{7, 8, 9} == snapshot.get<Transform>(reused).translation,
+        "created entity copied");
+}
+
+void
+test_target(common::Logger& logger)
+{
+  EntityRegistry registry;
+  NearbyTargets  nbt;
+  FrameTime const ft{1, 1000, 1000};
+
+  WorldOrientation const orientation{glm::vec3{0, 0, -1}, glm::vec3{0, 1, 0}};
+  auto const             player_eid = registry.create();
+  auto& player = registry.assign<Player>(player_eid, logger, player_eid, registry, orientation);
+  player.level = 3;
+
+  NPC::create(registry, NPC::NAMES[0], 5, glm::vec3{0});
+  for (auto const eid : registry.view<NPCData>()) {
+    nbt.add_target(eid);
+    nbt.set_selected(eid);
+  }
+
+  RenderSnapshot snapshot;
+  snapshot.build(registry, nbt, ft);
+
+  auto const& target = snapshot.target();
+  check(target.has_value(), "selected target copied");
+  if (target) {
+    check(nbt.selected() == target->eid, "target's entity");
+    check(3 == target->player_level && 5 == target->target_level, "target's levels");
+  }
+}
+
+void
+test_thread()
+{
+  SimulationThread thread{1024};
+
+  // Waiting without a step returns immediately.
+  thread.wait();
+
+  std::atomic<int> steps{0};
+  for (int i = 0; i < 100; ++i) {
+    thread.start([&steps](common::FrameArena& arena) {
+      // Steps allocate from the thread's arena.
+      auto* const value = static_cast<int*>(arena.allocate(sizeof(int), alignof(int)));
+      *value            = 1;
+      steps.fetch_add(*value, std::memory_order_relaxed);
+    });
+    thread.wait();
+    check(i + 1 == steps.load(std::memory_order_relaxed), "step finished before wait() returns");
+  }
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  auto logger = common::LogFactory::make_stderr();
+  test_copy();
+  test_target(logger);
+  test_thread();
+  return common::test::exit_status();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <boomhs/math_constants.hpp>
+#include <boomhs/obj.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include <cmath>
+
+namespace boomhs::test
+{
+
+// A unit sphere with a vertex per face corner, like the meshes load_objfile() returns.
+inline ObjData
+make_sphere(int const slices, int const stacks)
+{
+  using math::constants::PI;
+  auto const point = [&](int const i, int const j) {
+    float const theta = (PI * j) / stacks;
+    float const phi   = (2.0f * PI * (i % slices)) / slices;
+    return glm::vec3{std::sin(theta) * std::cos(phi), std::cos(theta),
+                     std::sin(theta) * std::sin(phi)};
+  };
+
+  ObjData data;
+  auto const add = [&data](glm::vec3 const& p) {
+    data.vertices.insert(data.vertices.end(), {p.x, p.y, p.z});
+    data.normals.insert(data.normals.end(), {p.x, p.y, p.z});
+    data.colors.insert(data.colors.end(), {1.0f, 0.0f, 0.0f, 1.0f});
+    data.uvs.insert(data.uvs.end(), {0.0f, 0.0f});
+    data.material_ids.emplace_back(0);
+    data.indices.emplace_back(data.indices.size());
+  };
+  for (int i = 0; i < slices; ++i) {
+    for (int j = 0; j < stacks; ++j) {
+      auto const a = point(i, j), b = point(i + 1, j), c = point(i + 1, j + 1), d = point(i, j + 1);
+      add(a);
+      add(c);
+      add(b);
+      add(a);
+      add(d);
+      add(c);
+    }
+  }
+  data.num_vertexes = data.vertices.size() / 3;
+  return data;
+}
+
+} // namespace boomhs::test
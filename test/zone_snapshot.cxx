@@ -0,0 +1,283 @@
+#include <boomhs/billboard.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/item.hpp>
+#include <boomhs/item_factory.hpp>
+#include <boomhs/leveldata.hpp>
+#include <boomhs/npc.hpp>
+#include <boomhs/player.hpp>
+#include <boomhs/zone_snapshot.hpp>
+
+#include <common/binary_io.hpp>
+#include <common/log.hpp>
+
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace boomhs;
+using common::test::check;
+
+// Saves a zone's LevelData and EntityRegistry into a ZoneSnapshot and loads it back, including
+// snapshots that are truncated, corrupt or hold counts larger than the snapshot itself.
+namespace
+{
+
+// Column id's of the snapshot format.
+uint32_t constexpr IS_RENDERABLE_COLUMN = 5;
+
+// Offset of the first component of a column, after the column's header and entity array.
+size_t
+column_values_offset(ZoneSnapshot::Buffer const& buffer, uint32_t const id)
+{
+  auto const read_u32 = [&buffer](size_t const offset) {
+    uint32_t value = 0;
+    std::memcpy(&value, buffer.data() + offset, sizeof(value));
+    return value;
+  };
+  auto const read_u64 = [&buffer](size_t const offset) {
+    uint64_t value = 0;
+    std::memcpy(&value, buffer.data() + offset, sizeof(value));
+    return value;
+  };
+
+  // magic, version and the level data (prefixed by it's size)
+  size_t offset = 16 + read_u64(8);
+  offset += 4 + (read_u32(offset) * sizeof(EntityID));
+
+  auto const num_columns = read_u32(offset);
+  offset += 4;
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    auto const column = read_u32(offset);
+    auto const count  = read_u32(offset + 4);
+    if (column == id) {
+      return offset + 16 + (count * sizeof(EntityID));
+    }
+    offset += 16 + read_u64(offset + 8);
+  }
+  std::abort();
+}
+
+auto
+make_leveldata()
+{
+  GlobalLight glight{ColorRGB{0.5f, 0.5f, 0.5f}, DirectionalLight{}};
+  return LevelData{TerrainGrid{TerrainGridConfig{}}, Fog{}, glight, MaterialTable{}, ObjStore{}};
+}
+
+void
+test_roundtrip(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+
+  auto const a = registry.create();
+  registry.assign<Name>(a, "a");
+  registry.assign<Transform>(a).translation = glm::vec3{1, 2, 3};
+  registry.assign<Selectable>(a).selected   = true;
+
+  auto const b = registry.create();
+  registry.assign<Name>(b, "b");
+  registry.assign<IsRenderable>(b, true);
+
+  ldata.fog.density = 0.25f;
+  auto const buffer = ZoneSnapshot::save(ldata, registry);
+
+  // Change the zone after the snapshot was taken.
+  ldata.fog.density                       = 1.0f;
+  registry.get<Transform>(a).translation  = glm::vec3{0};
+  registry.get<Name>(a).value             = "changed";
+  registry.assign<Selectable>(b).selected = true;
+  registry.get<IsRenderable>(b).hidden    = false;
+  registry.remove<Selectable>(a);
+
+  check(ZoneSnapshot::load(logger, ldata, registry, buffer).isOk(), "snapshot loads");
+  check(0.25f == ldata.fog.density, "fog restored");
+  check(glm::vec3{1, 2, 3} == registry.get<Transform>(a).translation, "translation restored");
+  check("a" == registry.get<Name>(a).value, "name restored");
+  check(registry.has<Selectable>(a) && registry.get<Selectable>(a).selected,
+        "removed component restored");
+  check(!registry.has<Selectable>(b), "component added after the snapshot removed");
+  check(registry.get<IsRenderable>(b).hidden, "bool restored");
+}
+
+void
+test_corrupt(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+  auto const     eid = registry.create();
+  registry.assign<Name>(eid, "a");
+  registry.assign<Transform>(eid);
+
+  auto const buffer = ZoneSnapshot::save(ldata, registry);
+  check(ZoneSnapshot::load(logger, ldata, registry, buffer).isOk(), "snapshot loads");
+
+  auto truncated = buffer;
+  truncated.pop_back();
+  check(ZoneSnapshot::load(logger, ldata, registry, truncated).isErr(), "truncated rejected");
+
+  auto bad_magic = buffer;
+  bad_magic[0]   = 'X';
+  check(ZoneSnapshot::load(logger, ldata, registry, bad_magic).isErr(), "bad magic rejected");
+
+  // The entity count follows the magic, version and level data (prefixed by it's size).
+  uint64_t leveldata_bytes = 0;
+  std::memcpy(&leveldata_bytes, buffer.data() + 8, sizeof(leveldata_bytes));
+
+  auto           huge_count = buffer;
+  uint32_t const count      = UINT32_MAX;
+  std::memcpy(huge_count.data() + 16 + leveldata_bytes, &count, sizeof(count));
+  check(ZoneSnapshot::load(logger, ldata, registry, huge_count).isErr(),
+        "entity count larger than the snapshot rejected");
+}
+
+void
+test_entities(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+
+  auto const a = registry.create();
+  registry.assign<Name>(a, "a");
+  auto const b = registry.create();
+  registry.assign<Name>(b, "b");
+  registry.assign<Transform>(b).translation = glm::vec3{4, 5, 6};
+  NPC::create(registry, NPC::NAMES[1], 7, glm::vec3{0});
+
+  auto const buffer = ZoneSnapshot::save(ldata, registry);
+
+  // Destroy an entity and create another one after the snapshot was taken.
+  registry.destroy(b);
+  auto const c = registry.create();
+  registry.assign<Name>(c, "c");
+  for (auto const eid : registry.view<NPCData>()) {
+    auto& npc          = registry.get<NPCData>(eid);
+    npc.health.current = 0;
+    npc.level          = 1;
+  }
+
+  auto const result = ZoneSnapshot::load(logger, ldata, registry, buffer);
+  check(result.isOk(), "snapshot loads");
+  check(1 == result.expect("recreated").size(), "destroyed entity created again");
+  check(!registry.valid(c), "entity created after the snapshot destroyed");
+
+  bool found_b = false;
+  for (auto const eid : registry.view<Name>()) {
+    if ("b" == registry.get<Name>(eid).value) {
+      found_b = true;
+      check(glm::vec3{4, 5, 6} == registry.get<Transform>(eid).translation,
+            "created entity's components restored");
+    }
+  }
+  check(found_b, "created entity has it's name");
+
+  for (auto const eid : registry.view<NPCData>()) {
+    auto const& npc = registry.get<NPCData>(eid);
+    check(NPC::NAMES[1] == npc.name, "npc name restored");
+    check(10 == npc.health.current && 7 == npc.level, "npc restored");
+  }
+}
+
+// A billboard destroyed after the snapshot is created again with everything copy_entity_gpu() needs
+// to upload it; the texture is named, it's resolved when the snapshot is loaded into a ZoneState.
+void
+test_billboard(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+
+  auto const eid = registry.create();
+  registry.assign<ShaderName>(eid, "billboard");
+  registry.assign<BillboardRenderable>(eid).value = BillboardType::Cylindrical;
+  registry.assign<TextureRenderable>(eid).texture = "sun";
+
+  auto const buffer = ZoneSnapshot::save(ldata, registry);
+  registry.destroy(eid);
+
+  auto const result = ZoneSnapshot::load(logger, ldata, registry, buffer);
+  check(result.isOk(), "snapshot loads");
+  auto const recreated = result.expect("recreated");
+  check(1 == recreated.size(), "destroyed billboard created again");
+  if (1 != recreated.size()) {
+    return;
+  }
+
+  auto const billboard = recreated[0];
+  check(registry.has<ShaderName>(billboard) &&
+            "billboard" == registry.get<ShaderName>(billboard).value,
+        "billboard's shader restored");
+  check(registry.has<BillboardRenderable>(billboard) &&
+            BillboardType::Cylindrical == registry.get<BillboardRenderable>(billboard).value,
+        "billboard restored");
+  check(registry.has<TextureRenderable>(billboard) &&
+            "sun" == registry.get<TextureRenderable>(billboard).texture,
+        "billboard's texture name restored");
+  check(!registry.get<TextureRenderable>(billboard).handle.valid(),
+        "billboard's texture left to be resolved");
+}
+
+void
+test_items(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+
+  WorldOrientation const orientation{glm::vec3{0, 0, -1}, glm::vec3{0, 1, 0}};
+  auto const             player_eid = registry.create();
+  auto& player = registry.assign<Player>(player_eid, logger, player_eid, registry, orientation);
+  player.name  = "player";
+
+  auto const book = ItemFactory::create_book(registry);
+  player.pickup_entity(book, registry);
+
+  auto const buffer = ZoneSnapshot::save(ldata, registry);
+
+  find_player(registry).drop_entity(logger, book, registry);
+  check(ZoneSnapshot::load(logger, ldata, registry, buffer).isOk(), "snapshot loads");
+
+  auto const& item      = registry.get<Item>(book);
+  auto const& inventory = find_player(registry).inventory;
+  check(item.is_pickedup && "Book" == item.name, "item restored");
+  check(inventory.slot(0).occupied() && book == inventory.slot(0).eid(), "inventory restored");
+  check(registry.has<Parent>(book) && registry.get<IsRenderable>(book).hidden,
+        "picked up item follows the player hidden");
+}
+
+void
+test_atomic(common::Logger& logger)
+{
+  auto           ldata = make_leveldata();
+  EntityRegistry registry;
+  auto const     eid = registry.create();
+  registry.assign<Transform>(eid).translation = glm::vec3{1, 2, 3};
+  registry.assign<IsRenderable>(eid, true);
+
+  ldata.fog.density = 0.25f;
+  auto buffer       = ZoneSnapshot::save(ldata, registry);
+  ldata.fog.density = 1.0f;
+  registry.get<Transform>(eid).translation = glm::vec3{0};
+
+  // The bool is checked only after the level data and the Transform column were read.
+  buffer[column_values_offset(buffer, IS_RENDERABLE_COLUMN)] = 2;
+  check(ZoneSnapshot::load(logger, ldata, registry, buffer).isErr(), "corrupt bool rejected");
+  check(1.0f == ldata.fog.density, "level data untouched by a failed load");
+  check(glm::vec3{0} == registry.get<Transform>(eid).translation,
+        "components untouched by a failed load");
+}
+
+} // namespace
+
+int
+main(int, char**)
+{
+  auto logger = common::LogFactory::make_stderr();
+  test_roundtrip(logger);
+  test_corrupt(logger);
+  test_entities(logger);
+  test_billboard(logger);
+  test_items(logger);
+  test_atomic(logger);
+  return common::test::exit_status();
+}
@@ -0,0 +1,144 @@
+// Headless simulation.
+//
+// Loads a level through the CPU half of boomhs::LevelLoader and generates the rest of the world with
+// the StartAreaGenerator, like the game does. Then runs the gameplay simulation (see
+// boomhs::Simulation) at a fixed tick rate, as fast as the CPU allows. No window, OpenGL context or
+// audio device is created, so this runs on build/batch servers.
+//
+// Reports how many simulation ticks per second were achieved, to catch CPU performance
+// regressions.
+//
+// usage: headless_simulation [level] [ticks] [torches]
+//   level   -- level file inside levels/ to load (default: area0.toml)
+//   ticks   -- number of simulation ticks to run (default: 10000)
+//   torches -- number of extra flickering torches to spawn on top of the level's, half of them
+//              attached to another entity through a Parent component (default: 0)
+#include <boomhs/bounding_object.hpp>
+#include <boomhs/components.hpp>
+#include <boomhs/entity.hpp>
+#include <boomhs/frame_time.hpp>
+#include <boomhs/item_factory.hpp>
+#include <boomhs/level_loader.hpp>
+#include <boomhs/leveldata.hpp>
+#include <boomhs/nearby_targets.hpp>
+#include <boomhs/random.hpp>
+#include <boomhs/simulation.hpp>
+#include <boomhs/start_area_generator.hpp>
+#include <boomhs/transform.hpp>
+#include <boomhs/world_object.hpp>
+
+#include <common/frame_arena.hpp>
+#include <common/log.hpp>
+
+#include <extlibs/glm.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+
+using namespace boomhs;
+
+namespace
+{
+
+// The simulation runs at a fixed 60 ticks per (simulated) second.
+freq_t constexpr TICK_FREQUENCY = 1'000'000;
+ticks_t constexpr TICK_DELTA    = TICK_FREQUENCY / 60.0;
+
+size_t constexpr FRAME_ARENA_CAPACITY = 64 * 1024;
+
+// The orientation of the game's 3D perspective (see main.cxx).
+WorldOrientation constexpr WORLD_ORIENTATION{-math::constants::Z_UNIT_VECTOR,
+                                             math::constants::Y_UNIT_VECTOR};
+
+// Load the level and generate the world around it, the same way the game creates a zone.
+std::optional<TerrainGrid>
+load_world(common::Logger& logger, EntityRegistry& registry, RNG& rng, std::string const& level)
+{
+  auto source_r = LevelLoader::read_level(logger, level);
+  if (!source_r) {
+    LOG_ERROR_SPRINTF("Error loading level %s: %s", level, source_r.unwrapErrMove());
+    return std::nullopt;
+  }
+  auto source = source_r.unwrap_moveout();
+  if (!source.heightmap) {
+    LOG_ERROR_SPRINTF("Level %s has no heightmap", level);
+    return std::nullopt;
+  }
+  LevelLoader::instantiate_entities(logger, registry, source.level);
+
+  auto const material_table = LevelLoader::load_materials(source.level);
+  auto       gendata = StartAreaGenerator::gen_level(logger, registry, rng, material_table,
+                                                     *source.heightmap, WORLD_ORIENTATION);
+  AABoundingBox::add_to_all_entities(logger, source.obj_store, registry);
+  return MOVE(gendata.terrain);
+}
+
+void
+spawn_torches(EntityRegistry& registry, RNG& rng, int const count)
+{
+  EntityID previous = EntityIDMAX;
+  for (int i = 0; i < count; ++i) {
+    auto const eid = registry.create();
+    registry.assign<Name>(eid, "Torch");
+    ItemFactory::add_torchlight(registry, eid);
+
+    auto& transform       = registry.assign<Transform>(eid);
+    transform.translation = glm::vec3{rng.gen_float_range(-100.0f, 100.0f), 0.0f,
+                                      rng.gen_float_range(-100.0f, 100.0f)};
+
+    // Chain every other torch to the previous one, so the hierarchy pass has work to do.
+    if ((i % 2) == 1) {
+      auto& parent             = registry.assign<Parent>(eid, previous);
+      parent.local.translation = glm::vec3{0.0f, 1.0f, 0.0f};
+    }
+    previous = eid;
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  auto logger = common::LogFactory::make_stderr();
+
+  std::string const level   = argc > 1 ? argv[1] : "area0.toml";
+  long const        ticks   = argc > 2 ? std::atol(argv[2]) : 10000;
+  int const         torches = argc > 3 ? std::atoi(argv[3]) : 0;
+
+  EntityRegistry registry;
+  RNG            rng;
+  auto           terrain = load_world(logger, registry, rng, level);
+  if (!terrain) {
+    return EXIT_FAILURE;
+  }
+  spawn_torches(registry, rng, torches);
+
+  // Nobody drives the player, it stands still while the rest of the world is simulated.
+  NearbyTargets         nearby_targets;
+  MovementState const   movement{};
+  SimulationZone        zone{registry, *terrain, nearby_targets};
+  SimulationInput const input{movement, false, true};
+
+  common::FrameArena arena{FRAME_ARENA_CAPACITY};
+
+  using clock      = std::chrono::steady_clock;
+  auto const start = clock::now();
+  for (long i = 0; i < ticks; ++i) {
+    // The game's first frame already has a non-zero time since start, so start counting at 1.
+    FrameTime const ft{TICK_DELTA, TICK_DELTA * (i + 1), TICK_FREQUENCY};
+    Simulation::tick(logger, zone, input, arena, rng, ft);
+    arena.reset();
+  }
+  std::chrono::duration<double> const elapsed = clock::now() - start;
+
+  auto const seconds = elapsed.count();
+  std::cout << "level:            " << level << "\n"
+            << "ticks:            " << ticks << "\n"
+            << "seconds:          " << seconds << "\n"
+            << "ticks per second: " << (ticks / seconds) << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+// Level compiler.
+//
+// Compiles the TOML sources of a level (engine.toml, levels/resources.toml and levels/<level>) into
+// the binary format read by boomhs::LevelLoader (see boomhs/level_compiler.hpp), so the game
+// doesn't parse TOML or resolve references by name when loading a level.
+//
+// Run from the directory containing engine.toml, after editing any of the level's TOML sources.
+//
+// usage: level_compiler [level...]
+//   level -- level file(s) inside levels/ to compile (default: area0.toml)
+#include <boomhs/level_compiler.hpp>
+#include <boomhs/mesh_optimizer.hpp>
+
+#include <common/binary_io.hpp>
+#include <common/log.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace boomhs;
+
+namespace
+{
+
+bool
+compile_level(common::Logger& logger, std::string const& level)
+{
+  auto compiled = LevelCompiler::compile(logger, level);
+  if (!compiled) {
+    std::cerr << "error compiling '" << level << "': " << compiled.unwrapErrMove() << std::endl;
+    return false;
+  }
+
+  auto const path           = LevelCompiler::compiled_path(level);
+  auto const compiled_level = compiled.expect_moveout("compiled level");
+  auto const buffer         = LevelCompiler::serialize(compiled_level);
+  if (!common::write_file_bytes(path, buffer)) {
+    std::cerr << "error writing '" << path << "'" << std::endl;
+    return false;
+  }
+  std::cout << level << " -> " << path << " (" << buffer.size() << " bytes)" << std::endl;
+
+  // The cooked meshes, with the ACMR they are drawn with.
+  for (auto const& mesh : compiled_level.meshes) {
+    auto const& obj = mesh.obj;
+    std::cout << "  mesh '" << mesh.name << "': " << obj.num_vertexes << " vertices, "
+              << (obj.indices.size() / 3) << " triangles, ACMR "
+              << MeshOptimizer::acmr(obj.indices, obj.num_vertexes) << ", " << mesh.lods.size()
+              << " LODs" << std::endl;
+  }
+  return true;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  auto logger = common::LogFactory::make_stderr();
+
+  std::vector<std::string> levels{argv + 1, argv + argc};
+  if (levels.empty()) {
+    levels.emplace_back("area0.toml");
+  }
+
+  bool ok = true;
+  for (auto const& level : levels) {
+    ok &= compile_level(logger, level);
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}